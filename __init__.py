@@ -134,6 +134,13 @@ class LolAddonPreferences(bpy.types.AddonPreferences):
         default=False
     )
 
+    game_folder: StringProperty(
+        name="League Game Folder",
+        description="League of Legends \"Game\" folder. When set, SKN import reads BINs and textures missing on disk from the champion's .wad.client archive",
+        subtype='DIR_PATH',
+        default=""
+    )
+
     # History Properties (Moved from history.py)
     skn_history: CollectionProperty(type=history.LOLHistoryItem)
     anm_history: CollectionProperty(type=history.LOLHistoryItem)
@@ -245,6 +252,9 @@ class LolAddonPreferences(bpy.types.AddonPreferences):
         # Drag & Drop Setting
         box.prop(self, "direct_drag_drop")
 
+        # WAD fallback for texture lookup
+        box.prop(self, "game_folder")
+
         box = layout.box()
         box.label(text="History (Stored Automatically)")
 
@@ -290,7 +300,9 @@ class ImportSKN(bpy.types.Operator, ImportHelper):
 
     def execute(self, context):
         from .io import import_skn
-        result = import_skn.load(self, context, self.filepath, self.load_skl, self.split_by_material, self.auto_load_textures)
+        prefs = get_preferences(context)
+        result = import_skn.load(self, context, self.filepath, self.load_skl, self.split_by_material, self.auto_load_textures,
+                                 game_folder=prefs.game_folder)
         if result == {'FINISHED'}:
             history.add_to_history(context, self.filepath, 'SKN')
         return result
@@ -409,7 +421,8 @@ class ImportSKN_DragDrop(bpy.types.Operator):
             result = import_skn.load(self, context, self.filepath,
                                    load_skl_file=True,
                                    split_by_material=True,
-                                   auto_load_textures=True)
+                                   auto_load_textures=True,
+                                   game_folder=prefs.game_folder)
             if result == {'FINISHED'}:
                 history.add_to_history(context, self.filepath, 'SKN')
             return result
@@ -957,6 +970,7 @@ def register():
     bpy.utils.register_class(history.LOL_OT_OpenFromHistory)
     bpy.utils.register_class(history.LOL_OT_ClearHistory)
     bpy.utils.register_class(texture_ops.LOL_OT_ReloadTextures)
+    bpy.utils.register_class(texture_ops.LOL_OT_SaveTextureAsTex)
     
     # Check preferences to load Extras
     # We defer this slightly or wrap in try-except because on fresh install prefs might not exist
@@ -1084,6 +1098,7 @@ def unregister():
     bpy.utils.unregister_class(history.LOL_OT_OpenFromHistory)
     bpy.utils.unregister_class(history.LOL_OT_ClearHistory)
     
+    bpy.utils.unregister_class(texture_ops.LOL_OT_SaveTextureAsTex)
     bpy.utils.unregister_class(texture_ops.LOL_OT_ReloadTextures)
 
     bpy.utils.unregister_class(updater.LOL_OT_RefreshPatchNotes)
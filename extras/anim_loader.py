@@ -242,7 +242,7 @@ class LOL_OT_LoadAnimation(Operator):
             props.status_text = f"Importing animation 1/1..."
             bpy.ops.wm.redraw_timer(type='DRAW_WIN_SWAP', iterations=1)
 
-            anm = import_anm.read_anm(self.filepath)
+            anm = import_anm.read_anm_native(self.filepath) or import_anm.read_anm(self.filepath)
 
             # Create animation data if needed
             if not armature_obj.animation_data:
@@ -381,7 +381,7 @@ class LOL_OT_ImportAllToNLA(Operator):
 
             try:
                 # Read the animation
-                anm = import_anm.read_anm(anim_item.filepath)
+                anm = import_anm.read_anm_native(anim_item.filepath) or import_anm.read_anm(anim_item.filepath)
 
                 # Create new action
                 action_name = anim_item.name
@@ -2,10 +2,12 @@
 # https://github.com/shteeve3d/blender-wiggle-2
 # Integrated into io_scene_lol for convenience.
 
-import bpy, math
+import bpy, math, ctypes
+import numpy as np
 from mathutils import Vector, Matrix, Euler, Quaternion, geometry
 from bpy.app.handlers import persistent
 from ..ui import icons
+from ..utils import texture_manager, native_bvh
 
 #return m2 in m1 space
 def relative_matrix(m1,m2):
@@ -85,6 +87,22 @@ def collider_poll(self, object):
 def wind_poll(self, object):
     return object.field and object.field.type =='WIND'
 
+# Native BVH per collider name, built from the evaluated mesh once per simulated frame
+_collider_bvhs = {}
+
+def closest_point(collider,co,dg):
+    """(location, normal) on collider nearest to co in its local space, or None for an empty mesh"""
+    if not native_bvh.available():
+        p = collider.closest_point_on_mesh(co, depsgraph=dg)
+        return p[1], p[2]
+    bvh = _collider_bvhs.get(collider.name)
+    if bvh is None:
+        bvh = _collider_bvhs[collider.name] = native_bvh.NativeBVH.from_mesh(collider.evaluated_get(dg).data)
+    hit = bvh.closest([co])[0]
+    if hit['primitive'] < 0:
+        return None
+    return Vector(hit['point']), Vector(hit['normal'])
+
 def collide(b,dg,head=False):
     dt = bpy.context.scene.wiggle.dt
     
@@ -129,9 +147,11 @@ def collide(b,dg,head=False):
     col = False
     for collider in colliders:
         cmw = collider.matrix_world
-        p = collider.closest_point_on_mesh(cmw.inverted() @ pos, depsgraph=dg)
-        n = (cmw.to_quaternion().to_matrix().to_4x4() @ p[2]).normalized()
-        i = cmw @ p[1]
+        p = closest_point(collider, cmw.inverted() @ pos, dg)
+        if p is None:
+            continue
+        n = (cmw.to_quaternion().to_matrix().to_4x4() @ p[1]).normalized()
+        i = cmw @ p[0]
         v = i-pos
         
         if (n.dot(v.normalized()) > 0.01) or (v.length < radius) or (co and (v.length < (radius+sticky))):
@@ -503,6 +523,7 @@ def wiggle_post(scene,dg):
     if scene.wiggle.is_preroll: frames_elapsed = 1
     scene.wiggle.dt = 1/scene.render.fps * frames_elapsed
     scene.wiggle.lastframe = scene.frame_current
+    _collider_bvhs.clear()
 
     for wo in scene.wiggle.list:
         ob = scene.objects[wo.name]
@@ -534,6 +555,7 @@ def wiggle_post(scene,dg):
                 b.wiggle.velocity_head = (b.wiggle.position_head - b.wiggle.position_last_head)/max(frames_elapsed,1) + vb
                 b.wiggle.position_last = b.wiggle.position
                 b.wiggle.position_last_head = b.wiggle.position_head
+    _collider_bvhs.clear()
                 
 @persistent        
 def wiggle_render_pre(scene):
@@ -553,6 +575,327 @@ def wiggle_load(scene):
     s = bpy.context.scene
     s.wiggle.is_rendering = False
             
+# --- Native bake (lol_native wiggle_solver_create / _run / _free) ---
+WIGGLE_BONE_CHAIN = 0x1
+WIGGLE_BONE_CONNECTED = 0x2
+WIGGLE_STEP_RESET = 0x1
+WIGGLE_STEP_HOLD = 0x2
+
+# Matches WIGGLE_STEP in native/physics.cpp
+_STEP_DTYPE = np.dtype([('sample', '<i4'), ('frames', '<i4'), ('flags', '<u4'), ('output', '<i4')])
+
+class _WiggleScene(ctypes.Structure):
+    _fields_ = [
+        ('bone_count', ctypes.c_uint32),
+        ('sample_count', ctypes.c_uint32),
+        ('collider_count', ctypes.c_uint32),
+        ('iterations', ctypes.c_uint32),
+        ('fps', ctypes.c_float),
+        ('gravity', ctypes.c_float * 3),
+        ('parents', ctypes.c_void_p),
+        ('flags', ctypes.c_void_p),
+        ('params', ctypes.c_void_p),
+        ('collider_offsets', ctypes.c_void_p),
+        ('collider_indices', ctypes.c_void_p),
+        ('object_matrices', ctypes.c_void_p),
+        ('pose_matrices', ctypes.c_void_p),
+        ('wind', ctypes.c_void_p),
+        ('collider_matrices', ctypes.c_void_p),
+        ('collider_bvhs', ctypes.c_void_p),
+    ]
+
+_SIGNATURES = {
+    'wiggle_solver_create': ([ctypes.POINTER(_WiggleScene), ctypes.POINTER(ctypes.c_void_p)], ctypes.c_int),
+    'wiggle_solver_run': ([ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_void_p,
+                           ctypes.c_void_p], ctypes.c_int),
+    'wiggle_solver_free': ([ctypes.c_void_p], None),
+}
+
+def _native_wiggle(name):
+    """lol_native wiggle_solver_* export, or None if it or the native BVH is unavailable"""
+    if not native_bvh.available(): return None
+    return texture_manager.bind_native(name, *_SIGNATURES[name])
+
+def native_bake_bones(scene, ob):
+    """
+    The bones wiggle_post would step for ob, if the native stepper covers all
+    of them (tail physics, full scale inheritance, no constraints), else None
+    """
+    if not _native_wiggle('wiggle_solver_run'): return None
+    if not scene.wiggle_enable or ob.type != 'ARMATURE' or ob.wiggle_mute or ob.wiggle_freeze: return None
+    if scene.frame_end <= scene.frame_start: return None
+    wo = scene.wiggle.list.get(ob.name)
+    if not wo: return None
+    bones = []
+    for wb in wo.list:
+        b = ob.pose.bones.get(wb.name)
+        if not b: return None
+        if b.wiggle_mute or not (b.wiggle_head or b.wiggle_tail): continue
+        if not b.wiggle_tail or (b.wiggle_head and not b.bone.use_connect): return None
+        if b.bone.inherit_scale != 'FULL' or any(c.enabled for c in b.constraints): return None
+        bones.append(b)
+    if not bones: return None
+    names = {b.name for b in bones}
+    for b in bones:
+        p = get_parent(b)
+        if p and p.name not in names: return None
+    return bones
+
+def tail_colliders(b):
+    """Collider objects collide() tests for a bone's tail"""
+    colliders = []
+    if b.wiggle_collider_type == 'Object' and b.wiggle_collider:
+        if b.wiggle_collider.name in bpy.context.scene.objects:
+            colliders = [b.wiggle_collider]
+    if b.wiggle_collider_type == 'Collection' and b.wiggle_collider_collection:
+        if b.wiggle_collider_collection in bpy.context.scene.collection.children_recursive:
+            colliders = [ob for ob in b.wiggle_collider_collection.objects if ob.type == 'MESH']
+    return colliders
+
+def bake_schedule(scene, bake_start):
+    """
+    Replays the frame changes WiggleBake makes (reset, preroll, then every
+    baked frame) through the wiggle_post rules. Returns (frame, frames_elapsed,
+    flags, output) tuples; output is the baked frame's index or -1.
+    """
+    w = scene.wiggle
+    lastframe = scene.frame_current
+    steps = [(lastframe, 0, WIGGLE_STEP_RESET, -1)]
+
+    def frame_set(frame, is_preroll, output=-1):
+        nonlocal lastframe
+        if frame == lastframe:
+            steps.append((frame, 0, WIGGLE_STEP_HOLD, output))
+            return
+        if frame <= 0 or (frame <= max(1, scene.frame_start) and not w.loop and not is_preroll):
+            steps.append((frame, 0, WIGGLE_STEP_RESET, output))
+            lastframe = max(frame, 0)
+            return
+        if frame >= lastframe:
+            frames_elapsed = frame - lastframe
+        else:
+            e1 = (scene.frame_end - lastframe) + (frame - scene.frame_start) + 1
+            e2 = lastframe - frame
+            frames_elapsed = min(e1,e2)
+        if frames_elapsed > 4: frames_elapsed = 1
+        if is_preroll: frames_elapsed = 1
+        lastframe = frame
+        steps.append((frame, frames_elapsed, 0, output))
+
+    duration = scene.frame_end - scene.frame_start
+    preroll = w.preroll
+    is_preroll = False
+    while preroll >= 0:
+        frame_set(scene.frame_end - (preroll%duration) if w.loop else scene.frame_start, is_preroll)
+        is_preroll = True
+        preroll -= 1
+    for i, frame in enumerate(range(bake_start, scene.frame_end + 1)):
+        frame_set(frame, True, i)
+    return steps
+
+def _action_fcurves(action):
+    """FCurve collection of an action (legacy or layered), or None"""
+    if hasattr(action, 'fcurves'):
+        return action.fcurves
+    try:
+        return action.layers[0].strips[0].channelbag(action.slots[0]).fcurves
+    except (AttributeError, IndexError):
+        return None
+
+def _write_keys(b, prop, frames, values):
+    """Key values (len(frames), channels) on a pose bone property, replacing keys in the frame range"""
+    setattr(b, prop, values[0])
+    b.keyframe_insert(data_path=prop, frame=frames[0])
+    action = b.id_data.animation_data.action
+    fcurves = _action_fcurves(action)
+    data_path = b.path_from_id(prop)
+    for i in range(values.shape[1]):
+        fc = fcurves.find(data_path, index=i) if fcurves is not None else None
+        if fc is None:
+            for frame, value in zip(frames, values):
+                setattr(b, prop, value)
+                b.keyframe_insert(data_path=prop, index=i, frame=frame)
+            continue
+        points = fc.keyframe_points
+        for k in reversed(range(len(points))):
+            if frames[0] <= points[k].co[0] <= frames[-1]:
+                points.remove(points[k], fast=True)
+        start = len(points)
+        points.add(len(frames))
+        co = np.empty(len(points) * 2, dtype=np.float32)
+        points.foreach_get('co', co)
+        co[start*2::2] = frames
+        co[start*2+1::2] = values[:, i]
+        points.foreach_set('co', co)
+        fc.update()
+
+def bake_native(context, ob):
+    """
+    Bake ob's wiggle bones with lol_native: sample the animated poses and
+    colliders once per needed frame with the handlers paused, simulate the
+    whole bake in one call, then key the results. False if the native
+    stepper can't take this object and the handler bake should run instead.
+    """
+    scene = context.scene
+    bones = native_bake_bones(scene, ob)
+    if not bones: return False
+
+    bake_start = max(1, scene.frame_start)
+    steps = bake_schedule(scene, bake_start)
+    frames = sorted({s[0] for s in steps})
+    sample_of = {f: i for i, f in enumerate(frames)}
+    index_of = {b.name: i for i, b in enumerate(bones)}
+    n, S = len(bones), len(frames)
+
+    parents = np.full(n, -1, dtype=np.int32)
+    flags = np.zeros(n, dtype=np.uint32)
+    params = np.zeros((n, 10), dtype=np.float32)
+    colliders, collider_index, offsets, indices = [], {}, [0], []
+    for i, b in enumerate(bones):
+        p = get_parent(b)
+        if p:
+            parents[i] = index_of[p.name]
+            if b.wiggle_chain: flags[i] |= WIGGLE_BONE_CHAIN
+            if p == b.parent and b.bone.use_connect: flags[i] |= WIGGLE_BONE_CONNECTED
+        params[i] = (b.wiggle_mass, b.wiggle_stiff, b.wiggle_stretch, b.wiggle_damp, b.wiggle_gravity, b.bone.length,
+                     b.wiggle_radius, b.wiggle_friction, b.wiggle_bounce, b.wiggle_sticky)
+        for c in tail_colliders(b):
+            if c.name not in collider_index:
+                collider_index[c.name] = len(colliders)
+                colliders.append(c)
+            indices.append(collider_index[c.name])
+        offsets.append(len(indices))
+    offsets = np.array(offsets, dtype=np.uint32)
+    indices = np.array(indices, dtype=np.uint32)
+    C = len(colliders)
+    # Colliders without deforming modifiers or shape keys keep one tree for every frame
+    rigid = [not c.is_deform_modified(scene, 'PREVIEW') and not c.data.shape_keys for c in colliders]
+
+    object_matrices = np.empty((S, 4, 4), dtype=np.float32)
+    pose_matrices = np.empty((S, n, 4, 4), dtype=np.float32)
+    wind = np.zeros((S, n, 4), dtype=np.float32)
+    collider_matrices = np.empty((S, max(C, 1), 4, 4), dtype=np.float32)
+    collider_bvhs = (ctypes.c_void_p * max(S * C, 1))()
+    trees = {}
+
+    step_array = np.array([(sample_of[f], e, fl, o) for f, e, fl, o in steps], dtype=_STEP_DTYPE)
+    out_count = scene.frame_end + 1 - bake_start
+    rotations = np.zeros((out_count, n, 4), dtype=np.float32)
+    rotations[:, :, 0] = 1.0
+    scales = np.ones((out_count, n), dtype=np.float32)
+
+    desc = _WiggleScene()
+    desc.bone_count, desc.sample_count, desc.collider_count = n, S, C
+    desc.iterations = scene.wiggle.iterations
+    desc.fps = scene.render.fps
+    desc.gravity[:] = tuple(scene.gravity)
+    desc.parents, desc.flags, desc.params = parents.ctypes.data, flags.ctypes.data, params.ctypes.data
+    desc.collider_offsets, desc.collider_indices = offsets.ctypes.data, indices.ctypes.data
+    desc.object_matrices, desc.pose_matrices, desc.wind = object_matrices.ctypes.data, pose_matrices.ctypes.data, wind.ctypes.data
+    desc.collider_matrices = collider_matrices.ctypes.data
+    desc.collider_bvhs = ctypes.cast(collider_bvhs, ctypes.c_void_p)
+    solver = ctypes.c_void_p()
+    result = _native_wiggle('wiggle_solver_create')(ctypes.byref(desc), ctypes.byref(solver))
+    if result != 0:
+        print(f"Aventurine: native wiggle bake failed (error {result}), using the frame handlers")
+        return False
+
+    # Samples are taken in schedule order and the steps run up to the next
+    # unsampled frame, so deforming colliders only keep trees for samples a
+    # later step still uses instead of one per sample for the whole bake
+    last_use = {}
+    for i, st in enumerate(step_array):
+        last_use[int(st['sample'])] = i
+
+    def run(start, end):
+        if end <= start: return 0
+        return _native_wiggle('wiggle_solver_run')(solver, step_array[start:end].ctypes.data, end - start, out_count,
+                                                   rotations.ctypes.data, scales.ctypes.data)
+
+    def release(done):
+        for key in [k for k in trees if not isinstance(k, int) and last_use[k[1]] < done]:
+            collider_bvhs[key[1] * C + key[0]] = None
+            trees.pop(key).close()
+
+    def take_sample(s):
+        scene.frame_set(frames[s])
+        for b in bones:
+            b.location = Vector((0,0,0))
+            b.rotation_quaternion = Quaternion((1,0,0,0))
+            b.rotation_euler = Vector((0,0,0))
+            b.scale = Vector((1,1,1))
+        context.view_layer.update()
+        dg = context.evaluated_depsgraph_get()
+        mw = ob.matrix_world
+        object_matrices[s] = mw
+        for i, b in enumerate(bones):
+            pose_matrices[s, i] = mw @ b.matrix
+            if b.wiggle_wind_ob:
+                field = b.wiggle_wind_ob.field
+                dir = b.wiggle_wind_ob.matrix_world.to_quaternion().to_matrix().to_4x4() @ Vector((0,0,1))
+                wind[s, i, :3] = dir * field.strength * b.wiggle_wind / b.wiggle_mass
+                wind[s, i, 3] = field.wind_factor
+        for c, collider in enumerate(colliders):
+            collider_matrices[s, c] = collider.matrix_world
+            key = c if rigid[c] else (c, s)
+            if key not in trees:
+                trees[key] = native_bvh.NativeBVH.from_mesh(collider.evaluated_get(dg).data)
+            collider_bvhs[s * C + c] = trees[key]._handle.value
+
+    frame_back = scene.frame_current
+    was_rendering = scene.wiggle.is_rendering
+    scene.wiggle.is_rendering = True # pause the frame handlers while sampling
+    try:
+        sampled, start = set(), 0
+        for i, st in enumerate(step_array):
+            s = int(st['sample'])
+            if s in sampled: continue
+            result = run(start, i)
+            if result != 0: break
+            release(i)
+            start = i
+            take_sample(s)
+            sampled.add(s)
+        else:
+            result = run(start, len(step_array))
+        scene.frame_set(frame_back)
+    finally:
+        scene.wiggle.is_rendering = was_rendering
+        _native_wiggle('wiggle_solver_free')(solver)
+        for tree in trees.values():
+            tree.close()
+    if result != 0:
+        print(f"Aventurine: native wiggle bake failed (error {result}), using the frame handlers")
+        return False
+
+    # Keep quaternion signs continuous like visual keying does
+    dots = np.einsum('fbi,fbi->fb', rotations[1:], rotations[:-1])
+    rotations[1:] *= np.cumprod(np.where(dots < 0, -1.0, 1.0), axis=0)[:, :, None]
+
+    if not ob.animation_data:
+        ob.animation_data_create()
+    if not scene.wiggle.bake_overwrite or not ob.animation_data.action:
+        ob.animation_data.action = bpy.data.actions.new('WiggleAction')
+    key_frames = np.arange(bake_start, scene.frame_end + 1, dtype=np.float32)
+    for i, b in enumerate(bones):
+        _write_keys(b, 'location', key_frames, np.zeros((out_count, 3), dtype=np.float32))
+        if b.rotation_mode == 'QUATERNION':
+            _write_keys(b, 'rotation_quaternion', key_frames, rotations[:, i])
+        elif b.rotation_mode == 'AXIS_ANGLE':
+            axis_angles = [(a, *axis) for axis, a in (Quaternion(q).to_axis_angle() for q in rotations[:, i])]
+            _write_keys(b, 'rotation_axis_angle', key_frames, np.array(axis_angles, dtype=np.float32))
+        else:
+            eulers, prev = [], None
+            for q in rotations[:, i]:
+                prev = Quaternion(q).to_euler(b.rotation_mode, prev) if prev else Quaternion(q).to_euler(b.rotation_mode)
+                eulers.append(prev)
+            _write_keys(b, 'rotation_euler', key_frames, np.array(eulers, dtype=np.float32))
+        sc = np.ones((out_count, 3), dtype=np.float32)
+        sc[:, 1] = scales[:, i]
+        _write_keys(b, 'scale', key_frames, sc)
+    scene.frame_set(frame_back)
+    return True
+
 class WiggleCopy(bpy.types.Operator):
     """Copy active wiggle settings to selected bones"""
     bl_idname = "wiggle.copy"
@@ -682,30 +1025,32 @@ class WiggleBake(bpy.types.Operator):
         push_nla()
         
         bpy.ops.wiggle.reset()
-            
-        #preroll
-        duration = context.scene.frame_end - context.scene.frame_start
-        preroll = context.scene.wiggle.preroll
-        context.scene.wiggle.is_preroll = False
-        bpy.ops.wiggle.select()
-        bpy.ops.wiggle.reset()
-        while preroll >= 0:
-            if context.scene.wiggle.loop:
-                frame = context.scene.frame_end - (preroll%duration)
-                context.scene.frame_set(frame)
-            else:
-                context.scene.frame_set(context.scene.frame_start)
-            context.scene.wiggle.is_preroll = True
-            preroll -= 1
-        #bake - LoL animations start at frame 1, skip frame 0
         bake_start = max(1, context.scene.frame_start)
-        bpy.ops.nla.bake(frame_start = bake_start,
-                        frame_end = context.scene.frame_end,
-                        only_selected = True,
-                        visual_keying = True,
-                        use_current_action = context.scene.wiggle.bake_overwrite,
-                        bake_types={'POSE'})
-        context.scene.wiggle.is_preroll = False
+        
+        #whole range in one native call when the rig allows it
+        if not bake_native(context, context.object):
+            #preroll
+            duration = context.scene.frame_end - context.scene.frame_start
+            preroll = context.scene.wiggle.preroll
+            context.scene.wiggle.is_preroll = False
+            bpy.ops.wiggle.select()
+            bpy.ops.wiggle.reset()
+            while preroll >= 0:
+                if context.scene.wiggle.loop:
+                    frame = context.scene.frame_end - (preroll%duration)
+                    context.scene.frame_set(frame)
+                else:
+                    context.scene.frame_set(context.scene.frame_start)
+                context.scene.wiggle.is_preroll = True
+                preroll -= 1
+            #bake - LoL animations start at frame 1, skip frame 0
+            bpy.ops.nla.bake(frame_start = bake_start,
+                            frame_end = context.scene.frame_end,
+                            only_selected = True,
+                            visual_keying = True,
+                            use_current_action = context.scene.wiggle.bake_overwrite,
+                            bake_types={'POSE'})
+            context.scene.wiggle.is_preroll = False
         
         # Seamless Loop: Delete blend frames, then copy first frame to last frame
         if context.scene.wiggle.seamless_loop:
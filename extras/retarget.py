@@ -4,10 +4,13 @@ Transfer animations between LoL skeletons with different bone structures
 """
 
 import bpy
+import mathutils
 import re
+import numpy as np
 from bpy.types import Panel, Operator, PropertyGroup
 from bpy.props import StringProperty, PointerProperty, CollectionProperty, EnumProperty
 from ..ui import icons
+from ..utils import native_anim
 
 
 # Common bone name aliases for LoL rigs
@@ -68,6 +71,122 @@ def find_best_match(source_bone_name, target_bones):
     return None  # No match found
 
 
+# Transform channels that get the rest orientation compensation, with
+# their rest values and native_anim key bits
+TRANSFORM_CHANNELS = {
+    'location': ((0.0, 0.0, 0.0), native_anim.KEY_TRANSLATION),
+    'rotation_quaternion': ((1.0, 0.0, 0.0, 0.0), native_anim.KEY_ROTATION),
+    'scale': ((1.0, 1.0, 1.0), native_anim.KEY_SCALE),
+}
+
+
+def rest_delta(source_arm, source_bone, target_arm, target_bone):
+    """
+    Rotation D between the two bones' rest orientations (armature space).
+    A source pose basis B maps to D^-1 @ B @ D on the target bone.
+    """
+    rest_source = source_arm.data.bones[source_bone].matrix_local.to_3x3().normalized()
+    rest_target = target_arm.data.bones[target_bone].matrix_local.to_3x3().normalized()
+    return (rest_source.inverted() @ rest_target).to_4x4()
+
+
+def is_identity(matrix, tolerance=1e-5):
+    return all(abs(matrix[r][c] - (1.0 if r == c else 0.0)) <= tolerance for r in range(4) for c in range(4))
+
+
+def read_keys(fcurve):
+    """Flat (frame, value) float32 pairs of an F-curve"""
+    co = np.empty(len(fcurve.keyframe_points) * 2, dtype=np.float32)
+    fcurve.keyframe_points.foreach_get('co', co)
+    return co
+
+
+def sample_group(curves, default):
+    """
+    (frames, values) for a channel group given {array_index: fcurve}: the
+    union of the curves' key frames, with curves whose keys don't line up
+    evaluated there and missing indices left at the rest value.
+    """
+    keys = {i: read_keys(fc) for i, fc in curves.items()}
+    frames = np.unique(np.concatenate([co[0::2] for co in keys.values()]))
+    values = np.tile(np.asarray(default, dtype=np.float32), (len(frames), 1))
+    for i, fc in curves.items():
+        co = keys[i]
+        if len(co) // 2 == len(frames) and np.array_equal(co[0::2], frames):
+            values[:, i] = co[1::2]
+        else:
+            values[:, i] = [fc.evaluate(f) for f in frames.tolist()]
+    return frames, values
+
+
+def sign_continuous(curves):
+    """Flip quaternion keys (w, x, y, z curves of (frame, value) pairs) so neighbours stay in the same hemisphere"""
+    quats = np.stack([co[1::2] for co in curves], axis=1)
+    if len(quats) < 2:
+        return curves
+    flips = np.concatenate(([0], np.cumsum(np.einsum('ij,ij->i', quats[1:], quats[:-1]) < 0) % 2))
+    signs = np.where(flips == 1, -1.0, 1.0).astype(np.float32)
+    result = []
+    for co in curves:
+        co = co.copy()
+        co[1::2] *= signs
+        result.append(co)
+    return result
+
+
+def conjugate_groups(bones):
+    """
+    Apply D^-1 @ basis @ D to sampled channel groups. bones is a list of
+    (delta, {prop: (frames, values)}); returns one {prop: [co, ...]} per bone
+    with a flat (frame, value) array per array index.
+    """
+    if not native_anim.available():
+        return [_conjugate_python(delta, groups) for delta, groups in bones]
+
+    # One frame slot per distinct frame, one track per bone
+    slot_frames = np.unique(np.concatenate([frames for _, groups in bones for frames, _ in groups.values()]))
+    key_flags = np.zeros((len(bones), len(slot_frames)), dtype=np.uint8)
+    translations = np.zeros((len(bones), len(slot_frames), 3), dtype=np.float32)
+    rotations = np.zeros((len(bones), len(slot_frames), 4), dtype=np.float32)
+    scales = np.zeros((len(bones), len(slot_frames), 3), dtype=np.float32)
+    arrays = {'location': translations, 'rotation_quaternion': rotations, 'scale': scales}
+
+    for t, (_, groups) in enumerate(bones):
+        for prop, (frames, values) in groups.items():
+            slots = np.searchsorted(slot_frames, frames)
+            key_flags[t, slots] |= TRANSFORM_CHANNELS[prop][1]
+            # Quaternions go in as (x, y, z, w)
+            arrays[prop][t, slots] = values[:, [1, 2, 3, 0]] if prop == 'rotation_quaternion' else values
+
+    deltas = [delta for delta, _ in bones]
+    defaults = np.tile(np.array((0, 0, 0, 0, 0, 0, 1, 1, 1, 1), dtype=np.float32), (len(bones), 1))
+    return native_anim.bake_fcurves(key_flags, translations, rotations, scales, slot_frames,
+                                    np.arange(len(bones), dtype=np.int32),
+                                    native_anim.matrices([d.inverted() for d in deltas]),
+                                    native_anim.matrices(deltas), defaults)
+
+
+def _conjugate_python(delta, groups):
+    """conjugate_groups for one bone without the native DLL"""
+    delta_inv = delta.inverted()
+    keyed = {prop: dict(zip(frames.tolist(), values.tolist())) for prop, (frames, values) in groups.items()}
+    result = {prop: [[] for _ in range(values.shape[1])] for prop, (_, values) in groups.items()}
+
+    for frame in sorted(set().union(*keyed.values())):
+        # Channels without a key on this frame sit at their rest value, like the native kernel
+        current = {prop: keyed.get(prop, {}).get(frame, rest) for prop, (rest, _) in TRANSFORM_CHANNELS.items()}
+        basis = mathutils.Matrix.LocRotScale(current['location'], mathutils.Quaternion(current['rotation_quaternion']),
+                                             current['scale'])
+        loc, rot, sca = (delta_inv @ basis @ delta).decompose()
+        decomposed = {'location': loc, 'rotation_quaternion': rot, 'scale': sca}
+        for prop, curves in result.items():
+            if frame in keyed[prop]:
+                for i, curve in enumerate(curves):
+                    curve += (frame, decomposed[prop][i])
+
+    return {prop: [np.asarray(curve, dtype=np.float32) for curve in curves] for prop, curves in result.items()}
+
+
 class BoneMappingItem(PropertyGroup):
     """Single bone mapping entry"""
     source_bone: StringProperty(name="Source Bone")
@@ -100,6 +219,11 @@ class LOLRetargetProperties(PropertyGroup):
         description="Exclude Buffbones, Hair, Face, Weapon, etc. from mapping",
         default=True
     )
+    compensate_rest: bpy.props.BoolProperty(
+        name="Compensate Rest Orientation",
+        description="Convert location, rotation and scale keys between bones whose rest orientations differ, instead of copying the values as-is",
+        default=False
+    )
     mapping_generated: bpy.props.BoolProperty(default=False)
     active_mapping_index: bpy.props.IntProperty(default=0)
 
@@ -296,9 +420,8 @@ class LOL_OT_ApplyRetarget(Operator):
             if item.enabled and item.target_bone:
                 mapping[item.source_bone] = item.target_bone
         
-        # Copy keyframes
-        copied_curves = 0
-        
+        # Group the mapped source curves by bone
+        bone_curves = {}
         for fcurve in source_action.fcurves:
             # Parse the data path to get bone name
             # Format: pose.bones["BoneName"].location/rotation_quaternion/scale
@@ -313,31 +436,64 @@ class LOL_OT_ApplyRetarget(Operator):
             if source_bone_name not in mapping:
                 continue
             
-            target_bone_name = mapping[source_bone_name]
-            
             # Check target bone exists
-            if target_bone_name not in target_arm.pose.bones:
+            if mapping[source_bone_name] not in target_arm.pose.bones:
                 continue
             
-            # Create new fcurve for target - check if exists first
+            curves = bone_curves.setdefault(source_bone_name, {})
+            curves.setdefault(property_name, {})[fcurve.array_index] = fcurve
+        
+        def target_curve(target_bone_name, property_name, index):
             new_data_path = f'pose.bones["{target_bone_name}"].{property_name}'
             
             # Check if this curve already exists
-            existing_curve = new_action.fcurves.find(new_data_path, index=fcurve.array_index)
+            existing_curve = new_action.fcurves.find(new_data_path, index=index)
             
             if existing_curve:
                 # If it exists, clear its keyframes so we overwrite it properly
                 existing_curve.keyframe_points.clear()
-                new_fcurve = existing_curve
-            else:
-                # Create new
-                new_fcurve = new_action.fcurves.new(data_path=new_data_path, index=fcurve.array_index)
+                return existing_curve
+            # Create new
+            return new_action.fcurves.new(data_path=new_data_path, index=index)
+        
+        # Bones whose rest orientations differ have their transform channels
+        # conjugated by the rest delta; everything else is copied as-is
+        compensated = []
+        copied_curves = 0
+        
+        for source_bone_name, curves in bone_curves.items():
+            target_bone_name = mapping[source_bone_name]
+            delta = None
+            if (props.compensate_rest and source_bone_name in source_arm.data.bones and
+                    'rotation_euler' not in curves and 'rotation_axis_angle' not in curves):
+                delta = rest_delta(source_arm, source_bone_name, target_arm, target_bone_name)
+                if is_identity(delta):
+                    delta = None
             
-            # Copy all keyframes
-            for kp in fcurve.keyframe_points:
-                new_fcurve.keyframe_points.insert(kp.co.x, kp.co.y)
+            groups = {}
+            for property_name, indexed in curves.items():
+                if delta is not None and property_name in TRANSFORM_CHANNELS:
+                    groups[property_name] = sample_group(indexed, TRANSFORM_CHANNELS[property_name][0])
+                    continue
+                
+                # Copy all keyframes
+                for index, fcurve in indexed.items():
+                    native_anim.set_keys(target_curve(target_bone_name, property_name, index), read_keys(fcurve))
+                    copied_curves += 1
             
-            copied_curves += 1
+            if groups:
+                compensated.append((target_bone_name, delta, groups))
+        
+        if compensated:
+            baked = conjugate_groups([(delta, groups) for _, delta, groups in compensated])
+            for (target_bone_name, _, _), channels in zip(compensated, baked):
+                for property_name, keys in channels.items():
+                    if property_name == 'rotation_quaternion':
+                        # Decomposed quaternions come back with w >= 0
+                        keys = sign_continuous(keys)
+                    for index, co in enumerate(keys):
+                        native_anim.set_keys(target_curve(target_bone_name, property_name, index), co)
+                        copied_curves += 1
         
         # Final update
         context.view_layer.update()
@@ -415,6 +571,7 @@ class LOL_PT_RetargetPanel(Panel):
         box.label(text="Options", icon='PREFERENCES')
         box.prop(props, "map_root_to_pelvis", text="Map Source Root → Target Hip")
         box.prop(props, "ignore_extras", text="Ignore Extras (Buffbones/Hair)")
+        box.prop(props, "compensate_rest", text="Compensate Rest Orientation")
         
         # Actions
         row = layout.row(align=True)
@@ -1,13 +1,52 @@
 import bpy
+import ctypes
 import os
 import struct
 import mathutils
 import math
+import numpy as np
 from ..utils.binary_utils import BinaryStream, Hash
+from ..utils import texture_manager
 from . import import_skl
 
+# --- Native writer (lol_native write_anm) ---
+def _native_write_anm():
+    """lol_native write_anm, or None if unavailable"""
+    return texture_manager.bind_native('write_anm', [ctypes.c_char_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_float,
+                                                     ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p])
+
+
+def write_anm_native(writer, filepath, joint_keys, frame_count, fps):
+    """
+    Write the sampled keys as a compressed-quaternion v5 ANM.
+    joint_keys maps joint hash -> list of (translation, scale, rotation) per frame.
+    """
+    hashes = sorted(joint_keys.keys())
+    track_count = len(hashes)
+    translations = np.zeros((track_count, frame_count, 3), dtype=np.float32)
+    scales = np.ones((track_count, frame_count, 3), dtype=np.float32)
+    rotations = np.zeros((track_count, frame_count, 4), dtype=np.float32)
+    rotations[:, :, 3] = 1.0
+
+    for i, h in enumerate(hashes):
+        for f_idx, (t, s, r) in enumerate(joint_keys[h]):
+            translations[i, f_idx] = (t.x, t.y, t.z)
+            scales[i, f_idx] = (s.x, s.y, s.z)
+            rotations[i, f_idx] = (r.x, r.y, r.z, r.w)
+
+    joint_hashes = np.array(hashes, dtype=np.uint32)
+    result = writer(filepath.encode('utf-8'), track_count, frame_count, fps,
+                           joint_hashes.ctypes.data, translations.ctypes.data,
+                           rotations.ctypes.data, scales.ctypes.data)
+    if result == -7:
+        raise Exception("Animation has more than 65536 distinct vectors or rotations, shorten it or split it into multiple files")
+    if result != 0:
+        raise Exception(f"Aventurine: native ANM export failed (error {result})")
+    return True
+
+
 def write_anm(filepath, armature_obj, fps=30.0, disable_scaling=False, disable_transforms=False, flip=False):
-    """Write Blender animation to ANM file (Uncompressed v4 format)"""
+    """Write Blender animation to ANM file (v5 with compressed quaternions natively, uncompressed v4 otherwise)"""
 
     if not armature_obj.animation_data or not armature_obj.animation_data.action:
         raise Exception("No animation data found on armature")
@@ -118,7 +157,7 @@ def write_anm(filepath, armature_obj, fps=30.0, disable_scaling=False, disable_t
             corrections[pbone.name] = mathutils.Matrix.Identity(4)
 
     # --- 3. Collect Frame Data ---
-    joint_data = {}  # joint_hash -> list of (t_id, s_id, r_id) per frame
+    joint_keys = {}  # joint_hash -> list of (translation, scale, rotation) per frame
     
     current_frame_orig = bpy.context.scene.frame_current
     
@@ -178,25 +217,31 @@ def write_anm(filepath, armature_obj, fps=30.0, disable_scaling=False, disable_t
                     t = mathutils.Vector((-t.x, t.y, t.z))
                     r = mathutils.Quaternion((r.w, r.x, -r.y, -r.z))
 
-                # Add to palettes (scale translations back to game units)
+                # Scale translations back to game units
                 scale = 1.0 if disable_scaling else import_skl.EXPORT_SCALE
-                t_id = add_to_vec_palette(t * scale)
-                s_id = add_to_vec_palette(s)
-                r_id = add_to_quat_palette(r)
-                
+
                 # Hash the bone name (strip .001 suffixes)
                 bone_name = pbone.name.split('.')[0] if '.' in pbone.name else pbone.name
                 h = Hash.elf(bone_name)
                 
-                if h not in joint_data:
-                    joint_data[h] = []
+                if h not in joint_keys:
+                    joint_keys[h] = []
                 
-                if len(joint_data[h]) == f_idx:
-                    joint_data[h].append((t_id, s_id, r_id))
+                if len(joint_keys[h]) == f_idx:
+                    joint_keys[h].append((t * scale, s, r.normalized()))
                     
     finally:
         bpy.context.scene.frame_set(current_frame_orig)
 
+    native_writer = _native_write_anm()
+    if native_writer:
+        return write_anm_native(native_writer, filepath, joint_keys, frame_count, fps)
+
+    # Python fallback: uncompressed v4 with deduplicated palettes
+    joint_data = {}  # joint_hash -> list of (t_id, s_id, r_id) per frame
+    for h, keys in joint_keys.items():
+        joint_data[h] = [(add_to_vec_palette(t), add_to_vec_palette(s), add_to_quat_palette(r)) for t, s, r in keys]
+
     # --- 4. Write Binary File ---
     sorted_hashes = sorted(joint_data.keys())
     
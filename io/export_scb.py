@@ -4,6 +4,8 @@ Native SCB (Static Object Binary) exporter for League of Legends
 """
 
 import bpy
+import ctypes
+import numpy as np
 import os
 import struct
 import math
@@ -11,6 +13,85 @@ from bpy.types import Operator
 from bpy.props import StringProperty, FloatProperty, BoolProperty
 from bpy_extras.io_utils import ExportHelper
 from mathutils import Vector
+from ..utils import texture_manager
+
+
+# --- Native writer (lol_native write_scb / write_sco) ---
+
+STATIC_EXPORT_PIVOT = 0x1   # Write a PivotPoint (SCO only)
+
+class _NativeStaticExportMesh(ctypes.Structure):
+    # Matches STATIC_EXPORT_MESH in native/mesh_io.cpp
+    _fields_ = [
+        ('vertex_count', ctypes.c_uint32),
+        ('positions', ctypes.c_void_p),
+        ('loop_count', ctypes.c_uint32),
+        ('loop_vertices', ctypes.c_void_p),
+        ('loop_uvs', ctypes.c_void_p),
+        ('polygon_count', ctypes.c_uint32),
+        ('polygon_loop_starts', ctypes.c_void_p),
+        ('polygon_loop_totals', ctypes.c_void_p),
+        ('matrix', ctypes.c_float * 16),
+        ('central', ctypes.c_float * 3),
+        ('pivot', ctypes.c_float * 3),
+        ('flags', ctypes.c_uint32),
+        ('scb_flag', ctypes.c_uint32),
+        ('scale', ctypes.c_float),
+        ('name', ctypes.c_char_p),
+        ('material', ctypes.c_char_p),
+    ]
+
+
+def _native_static_writer(kind):
+    """lol_native write_scb (kind 'scb') or write_sco, or None if unavailable"""
+    return texture_manager.bind_native(f'write_{kind}', [ctypes.c_char_p, ctypes.POINTER(_NativeStaticExportMesh)])
+
+
+def write_static_native(kind, filepath, eval_obj, eval_mesh, scale, material, name=b'', scb_flag=0, pivot=None):
+    """
+    Write an evaluated mesh with lol_native write_scb (kind 'scb') or write_sco.
+    material / name are bytes, pivot a world space position or None.
+    Returns False if the native writer is unavailable.
+    """
+    writer = _native_static_writer(kind)
+    if not writer:
+        return False
+
+    vertex_count, loop_count, polygon_count = len(eval_mesh.vertices), len(eval_mesh.loops), len(eval_mesh.polygons)
+    positions = np.empty(vertex_count * 3, dtype=np.float32)
+    eval_mesh.vertices.foreach_get('co', positions)
+    loop_vertices = np.empty(loop_count, dtype=np.int32)
+    eval_mesh.loops.foreach_get('vertex_index', loop_vertices)
+    loop_uvs = np.empty(loop_count * 2, dtype=np.float32)
+    eval_mesh.uv_layers.active.data.foreach_get('uv', loop_uvs)
+    loop_starts = np.empty(polygon_count, dtype=np.int32)
+    eval_mesh.polygons.foreach_get('loop_start', loop_starts)
+    loop_totals = np.empty(polygon_count, dtype=np.int32)
+    eval_mesh.polygons.foreach_get('loop_total', loop_totals)
+
+    native = _NativeStaticExportMesh()
+    native.vertex_count = vertex_count
+    native.positions = positions.ctypes.data
+    native.loop_count = loop_count
+    native.loop_vertices = loop_vertices.ctypes.data
+    native.loop_uvs = loop_uvs.ctypes.data
+    native.polygon_count = polygon_count
+    native.polygon_loop_starts = loop_starts.ctypes.data
+    native.polygon_loop_totals = loop_totals.ctypes.data
+    native.matrix[:] = [eval_obj.matrix_world[r][c] for r in range(4) for c in range(4)]
+    native.central[:] = list(eval_obj.matrix_world.translation)
+    if pivot is not None:
+        native.pivot[:] = list(pivot)
+        native.flags = STATIC_EXPORT_PIVOT
+    native.scb_flag = scb_flag
+    native.scale = scale
+    native.name = name
+    native.material = material
+
+    result = writer(filepath.encode('utf-8'), ctypes.byref(native))
+    if result != 0:
+        raise Exception(f"Aventurine: native {kind.upper()} export failed (error {result})")
+    return True
 
 
 class ExportSCB(Operator, ExportHelper):
@@ -157,6 +238,28 @@ class ExportSCB(Operator, ExportHelper):
         eval_obj = obj.evaluated_get(depsgraph)
         eval_mesh = eval_obj.data
         
+        # Get UV layer
+        if not eval_mesh.uv_layers.active:
+            raise ValueError("Mesh has no UV coordinates")
+        
+        # Get material name
+        material_name = 'lambert69'
+        if eval_mesh.materials and eval_mesh.materials[0]:
+            material_name = eval_mesh.materials[0].name
+            if len(material_name) > 64:
+                material_name = material_name[:64]
+        
+        # Get SCB flag
+        scb_flag = 2  # Default: local origin locator
+        if riot_data:
+            scb_flag = riot_data['scb_flag']
+        elif 'lol_scb_flag' in obj:
+            scb_flag = obj['lol_scb_flag']
+        
+        if write_static_native('scb', filepath, eval_obj, eval_mesh, scale_factor,
+                               material_name.encode('ascii', errors='ignore')[:64], scb_flag=int(scb_flag)):
+            return
+        
         # Get mesh data - vertices in Blender world space
         # Maya exporter gets vertices in world space and central as transform translation
         vertices_world = []
@@ -200,10 +303,6 @@ class ExportSCB(Operator, ExportHelper):
         # Central point in SCB format (absolute position)
         central = central_scb
         
-        # Get UV layer
-        if not eval_mesh.uv_layers.active:
-            raise ValueError("Mesh has no UV coordinates")
-        
         uv_layer = eval_mesh.uv_layers.active
         
         # Triangulate if needed using bmesh (preserves UVs)
@@ -248,20 +347,6 @@ class ExportSCB(Operator, ExportHelper):
         
         bm.free()
         
-        # Get material name
-        material_name = 'lambert69'
-        if eval_mesh.materials and eval_mesh.materials[0]:
-            material_name = eval_mesh.materials[0].name
-            if len(material_name) > 64:
-                material_name = material_name[:64]
-        
-        # Get SCB flag
-        scb_flag = 2  # Default: local origin locator
-        if riot_data:
-            scb_flag = riot_data['scb_flag']
-        elif 'lol_scb_flag' in obj:
-            scb_flag = obj['lol_scb_flag']
-        
         # Write SCB file
         with open(filepath, 'wb') as f:
             # Write magic
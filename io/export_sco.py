@@ -11,6 +11,7 @@ from bpy.types import Operator
 from bpy.props import StringProperty, FloatProperty, BoolProperty
 from bpy_extras.io_utils import ExportHelper
 from mathutils import Vector
+from .export_scb import write_static_native
 
 
 class ExportSCO(Operator, ExportHelper):
@@ -170,6 +171,22 @@ class ExportSCO(Operator, ExportHelper):
         eval_obj = obj.evaluated_get(depsgraph)
         eval_mesh = eval_obj.data
         
+        # Find pivot bone (if exists) - pass depsgraph and eval_mesh to avoid recreating
+        pivot_bone_world = self.find_pivot_bone(context, obj, depsgraph, eval_mesh)
+        
+        # Get UV layer
+        if not eval_mesh.uv_layers.active:
+            raise ValueError("Mesh has no UV coordinates")
+        
+        # Get material name
+        material_name = 'lambert69'
+        if eval_mesh.materials and eval_mesh.materials[0]:
+            material_name = eval_mesh.materials[0].name
+        
+        if write_static_native('sco', filepath, eval_obj, eval_mesh, 1.0 / scale_factor, material_name.encode('utf-8'),
+                               name=obj.name[:64].encode('utf-8'), pivot=pivot_bone_world):
+            return
+        
         # Get mesh data - vertices in Blender world space
         # Maya exporter gets vertices in world space and central as transform translation
         vertices_world = []
@@ -182,9 +199,6 @@ class ExportSCO(Operator, ExportHelper):
         origin_world = eval_obj.matrix_world.translation
         central_world = origin_world
         
-        # Find pivot bone (if exists) - pass depsgraph and eval_mesh to avoid recreating
-        pivot_bone_world = self.find_pivot_bone(context, obj, depsgraph, eval_mesh)
-        
         # Scale to SCB units (before coordinate transform)
         scale_inv = 1.0 / scale_factor
         vertices_scaled = [v * scale_inv for v in vertices_world]
@@ -218,10 +232,6 @@ class ExportSCO(Operator, ExportHelper):
             # Pivot is stored as: central - bone_position (offset from central)
             pivot_scb = central_scb - pivot_scb_transformed
         
-        # Get UV layer
-        if not eval_mesh.uv_layers.active:
-            raise ValueError("Mesh has no UV coordinates")
-        
         uv_layer = eval_mesh.uv_layers.active
         
         # Triangulate if needed using bmesh (preserves UVs)
@@ -266,11 +276,6 @@ class ExportSCO(Operator, ExportHelper):
         
         bm.free()
         
-        # Get material name
-        material_name = 'lambert69'
-        if eval_mesh.materials and eval_mesh.materials[0]:
-            material_name = eval_mesh.materials[0].name
-        
         # Write SCO file (text format)
         with open(filepath, 'w') as f:
             # Write magic
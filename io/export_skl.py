@@ -1,9 +1,45 @@
 import bpy
+import ctypes
 import mathutils
 import os
 from ..utils.binary_utils import BinaryStream, Hash
+from ..utils import texture_manager
 from . import import_skl
 
+def _native_write_skl():
+    """lol_native write_skl, or None if unavailable"""
+    return texture_manager.bind_native('write_skl', [ctypes.c_char_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_char_p),
+                                                     ctypes.POINTER(ctypes.c_int16), ctypes.POINTER(ctypes.c_float),
+                                                     ctypes.POINTER(ctypes.c_float)])
+
+def write_skl_native(writer, filepath, bone_list, bone_name_to_index, league_matrices, scale):
+    """Write the joints with lol_native; same layout as the Python writer below"""
+    joint_count = len(bone_list)
+    names = (ctypes.c_char_p * joint_count)()
+    parents = (ctypes.c_int16 * joint_count)()
+    local_trs = (ctypes.c_float * (joint_count * 10))()
+    inverse_bind_trs = (ctypes.c_float * (joint_count * 10))()
+
+    for i, pbone in enumerate(bone_list):
+        clean_name = pbone.name.split('.')[0] if '.' in pbone.name else pbone.name
+        names[i] = clean_name.encode('ascii', errors='replace')
+        parents[i] = bone_name_to_index.get(pbone.parent.name, -1) if pbone.parent else -1
+
+        l_mat_global, l_mat_local = league_matrices[i]
+        try:
+            ig_mat = l_mat_global.inverted()
+        except ValueError:
+            ig_mat = mathutils.Matrix.Identity(4)
+
+        for out, (t, r, s) in ((local_trs, l_mat_local.decompose()), (inverse_bind_trs, ig_mat.decompose())):
+            t = t * scale
+            out[i * 10:i * 10 + 10] = [t.x, t.y, t.z, s.x, s.y, s.z, r.x, r.y, r.z, r.w]
+
+    result = writer(filepath.encode('utf-8'), joint_count, names, parents, local_trs, inverse_bind_trs)
+    if result != 0:
+        raise Exception(f"Aventurine: native SKL export failed (error {result})")
+    return True
+
 def write_skl(filepath, armature_obj, disable_scaling=False, disable_transforms=False, use_visual_pose=False):
     """Write Blender armature to SKL file (Version 0)"""
 
@@ -109,6 +145,11 @@ def write_skl(filepath, armature_obj, disable_scaling=False, disable_transforms=
     for i in range(joint_count):
         calc_league_matrix(i)
 
+    scale = 1.0 if disable_scaling else import_skl.EXPORT_SCALE
+    native_writer = _native_write_skl()
+    if native_writer:
+        return write_skl_native(native_writer, filepath, bone_list, bone_name_to_index, league_matrices, scale)
+
     with open(filepath, 'wb') as f:
         bs = BinaryStream(f)
         
@@ -165,7 +206,6 @@ def write_skl(filepath, armature_obj, disable_scaling=False, disable_transforms=
             l_t, l_r, l_s = l_mat_local.decompose()
 
             # Scale translations back to game units (native_bind_t is at 0.01 scale)
-            scale = 1.0 if disable_scaling else import_skl.EXPORT_SCALE
             bs.write_vec3(l_t * scale)
             bs.write_vec3(l_s)
             bs.write_quat(l_r)
@@ -1,9 +1,12 @@
 import bpy
+import ctypes
 import mathutils
+import numpy as np
 import struct
 import os
 import re
 from ..utils.binary_utils import BinaryStream
+from ..utils import texture_manager
 from . import import_skl
 
 def clean_blender_name(name):
@@ -16,31 +19,52 @@ def check_shared_vertices_between_materials(mesh_obj):
     Returns a list of material names that share vertices, or empty list if none.
     """
     mesh = mesh_obj.data
-    mesh.calc_loop_triangles()
 
     if len(mesh.materials) <= 1:
         return []
 
-    # Map each vertex to the set of material indices that use it
-    vertex_materials = {}
-    for tri in mesh.loop_triangles:
-        mat_idx = tri.material_index
-        for v_idx in tri.vertices:
-            if v_idx not in vertex_materials:
-                vertex_materials[v_idx] = set()
-            vertex_materials[v_idx].add(mat_idx)
+    loop_vertices = np.empty(len(mesh.loops), dtype=np.int32)
+    mesh.loops.foreach_get('vertex_index', loop_vertices)
+    loop_starts = np.empty(len(mesh.polygons), dtype=np.int32)
+    mesh.polygons.foreach_get('loop_start', loop_starts)
+    loop_totals = np.empty(len(mesh.polygons), dtype=np.int32)
+    mesh.polygons.foreach_get('loop_total', loop_totals)
+    poly_materials = np.empty(len(mesh.polygons), dtype=np.int32)
+    mesh.polygons.foreach_get('material_index', poly_materials)
+
+    # (vertex, material) for every face corner
+    corner_offsets = np.arange(loop_totals.sum()) - np.repeat(np.cumsum(loop_totals) - loop_totals, loop_totals)
+    corner_vertices = loop_vertices[np.repeat(loop_starts, loop_totals) + corner_offsets].astype(np.int64)
+    corner_materials = np.repeat(poly_materials, loop_totals).astype(np.int64)
+
+    # Vertices used by multiple materials
+    stride = int(poly_materials.max()) + 1 if len(poly_materials) else 1
+    pairs = np.unique(corner_vertices * stride + corner_materials)
+    pair_vertices = pairs // stride
+    vertices, counts = np.unique(pair_vertices, return_counts=True)
+    shared_pairs = pairs[np.isin(pair_vertices, vertices[counts > 1])]
 
-    # Find vertices used by multiple materials
     shared_materials = set()
-    for v_idx, mat_indices in vertex_materials.items():
-        if len(mat_indices) > 1:
-            for mat_idx in mat_indices:
-                if mat_idx < len(mesh.materials) and mesh.materials[mat_idx]:
-                    shared_materials.add(mesh.materials[mat_idx].name)
+    for mat_idx in np.unique(shared_pairs % stride):
+        mat_idx = int(mat_idx)
+        if mat_idx < len(mesh.materials) and mesh.materials[mat_idx]:
+            shared_materials.add(mesh.materials[mat_idx].name)
 
     return list(shared_materials)
 
 
+def group_bone_indices(mesh_obj, bone_to_idx):
+    """Map vertex group indices to SKL bone indices"""
+    group_to_bone_idx = {}
+    for group in mesh_obj.vertex_groups:
+        clean_name = group.name.split('.')[0] if '.' in group.name else group.name
+        if clean_name in bone_to_idx:
+            group_to_bone_idx[group.index] = bone_to_idx[clean_name]
+        elif group.name in bone_to_idx:
+            group_to_bone_idx[group.index] = bone_to_idx[group.name]
+    return group_to_bone_idx
+
+
 def collect_mesh_data(mesh_obj, armature_obj, bone_to_idx, submesh_name, material_index=None, disable_scaling=False, disable_transforms=False, deformed_positions=None, deformed_poly_normals=None):
     """
     Collect geometry data from a single mesh object.
@@ -61,13 +85,7 @@ def collect_mesh_data(mesh_obj, armature_obj, bone_to_idx, submesh_name, materia
     scale = 1.0 if disable_scaling else import_skl.EXPORT_SCALE
 
     # Map vertex groups to SKL bone indices
-    group_to_bone_idx = {}
-    for group in mesh_obj.vertex_groups:
-        clean_name = group.name.split('.')[0] if '.' in group.name else group.name
-        if clean_name in bone_to_idx:
-            group_to_bone_idx[group.index] = bone_to_idx[clean_name]
-        elif group.name in bone_to_idx:
-            group_to_bone_idx[group.index] = bone_to_idx[group.name]
+    group_to_bone_idx = group_bone_indices(mesh_obj, bone_to_idx)
 
     # Get UV data
     if not mesh.uv_layers.active:
@@ -196,6 +214,179 @@ def collect_mesh_data(mesh_obj, armature_obj, bone_to_idx, submesh_name, materia
     }
 
 
+# --- Native writer (lol_native write_skn) ---
+SKN_EXPORT_NO_TRANSFORM = 0x1
+
+
+class _NativeExportMesh(ctypes.Structure):
+    _fields_ = [
+        ('vertex_count', ctypes.c_uint32),
+        ('positions', ctypes.c_void_p),
+        ('weight_offsets', ctypes.c_void_p),
+        ('weight_bones', ctypes.c_void_p),
+        ('weight_values', ctypes.c_void_p),
+        ('loop_count', ctypes.c_uint32),
+        ('loop_vertices', ctypes.c_void_p),
+        ('loop_uvs', ctypes.c_void_p),
+        ('polygon_count', ctypes.c_uint32),
+        ('polygon_loop_starts', ctypes.c_void_p),
+        ('polygon_loop_totals', ctypes.c_void_p),
+        ('polygon_materials', ctypes.c_void_p),
+        ('polygon_normals', ctypes.c_void_p),
+        ('matrix', ctypes.c_float * 16),
+    ]
+
+
+class _NativeExportSubmesh(ctypes.Structure):
+    _fields_ = [
+        ('name', ctypes.c_char * 64),
+        ('mesh', ctypes.c_uint32),
+        ('material', ctypes.c_int32),
+        ('vertex_count', ctypes.c_uint32),
+        ('index_count', ctypes.c_uint32),
+    ]
+
+
+def _native_write_skn():
+    """lol_native write_skn, or None if unavailable"""
+    return texture_manager.bind_native('write_skn', [ctypes.c_char_p, ctypes.POINTER(_NativeExportMesh), ctypes.c_uint32,
+                                                     ctypes.POINTER(_NativeExportSubmesh), ctypes.c_uint32, ctypes.c_float,
+                                                     ctypes.c_uint32])
+
+
+def native_mesh_arrays(mesh_obj, armature_obj, bone_to_idx, deformed_positions=None, deformed_poly_normals=None):
+    """
+    foreach_get arrays of a mesh for write_skn.
+    Returns (_NativeExportMesh, arrays); arrays must stay alive while the structure is used.
+    """
+    mesh = mesh_obj.data
+    if not mesh.uv_layers.active:
+        raise Exception(f"Mesh '{mesh_obj.name}' has no active UV layer")
+
+    vertex_count, loop_count, polygon_count = len(mesh.vertices), len(mesh.loops), len(mesh.polygons)
+
+    # The evaluated mesh of Use Visual Pose must still match the original one
+    # vertex for vertex: the writer indexes both with the same loops
+    if ((deformed_positions is not None and len(deformed_positions) != vertex_count * 3) or
+            (deformed_poly_normals is not None and len(deformed_poly_normals) != polygon_count * 3)):
+        raise Exception(f"Mesh '{mesh_obj.name}' has modifiers that change its vertex or face count. "
+                        f"Apply or disable them, or export without Use Visual Pose.")
+
+    if deformed_positions is not None:
+        positions = np.ascontiguousarray(deformed_positions, dtype=np.float32)
+    else:
+        positions = np.empty(vertex_count * 3, dtype=np.float32)
+        mesh.vertices.foreach_get('co', positions)
+    if deformed_poly_normals is not None:
+        poly_normals = np.ascontiguousarray(deformed_poly_normals, dtype=np.float32)
+    else:
+        poly_normals = np.empty(polygon_count * 3, dtype=np.float32)
+        mesh.polygons.foreach_get('normal', poly_normals)
+
+    loop_vertices = np.empty(loop_count, dtype=np.int32)
+    mesh.loops.foreach_get('vertex_index', loop_vertices)
+    loop_uvs = np.empty(loop_count * 2, dtype=np.float32)
+    mesh.uv_layers.active.data.foreach_get('uv', loop_uvs)
+    loop_starts = np.empty(polygon_count, dtype=np.int32)
+    mesh.polygons.foreach_get('loop_start', loop_starts)
+    loop_totals = np.empty(polygon_count, dtype=np.int32)
+    mesh.polygons.foreach_get('loop_total', loop_totals)
+    poly_materials = np.empty(polygon_count, dtype=np.int32)
+    mesh.polygons.foreach_get('material_index', poly_materials)
+
+    # Weights as rows per vertex, only groups that map to bones. Blender has no
+    # bulk getter for vertex group membership, so it's read in one flat pass
+    # and everything else is done on the arrays.
+    group_to_bone_idx = group_bone_indices(mesh_obj, bone_to_idx)
+    memberships = np.array([(v.index, g.group, g.weight) for v in mesh.vertices for g in v.groups],
+                           dtype=np.float64).reshape(-1, 3)
+    member_vertices = memberships[:, 0].astype(np.int64)
+    member_groups = memberships[:, 1].astype(np.int64)
+    group_lookup = np.full(max(len(mesh_obj.vertex_groups), int(member_groups.max(initial=-1)) + 1), -1, dtype=np.int32)
+    for group, bone in group_to_bone_idx.items():
+        group_lookup[group] = bone
+    member_bones = group_lookup[member_groups]
+    kept = member_bones >= 0
+
+    weight_offsets = np.zeros(vertex_count + 1, dtype=np.uint32)
+    weight_offsets[1:] = np.cumsum(np.bincount(member_vertices[kept], minlength=vertex_count))
+    weight_bones = member_bones[kept].astype(np.uint16)
+    weight_values = memberships[kept, 2].astype(np.float32)
+
+    arrays = (positions, poly_normals, loop_vertices, loop_uvs, loop_starts, loop_totals, poly_materials,
+              weight_offsets, weight_bones, weight_values)
+
+    world_to_armature = armature_obj.matrix_world.inverted() @ mesh_obj.matrix_world
+    native = _NativeExportMesh()
+    native.vertex_count = vertex_count
+    native.positions = positions.ctypes.data
+    native.weight_offsets = weight_offsets.ctypes.data
+    native.weight_bones = weight_bones.ctypes.data if len(weight_bones) else None
+    native.weight_values = weight_values.ctypes.data if len(weight_bones) else None
+    native.loop_count = loop_count
+    native.loop_vertices = loop_vertices.ctypes.data
+    native.loop_uvs = loop_uvs.ctypes.data
+    native.polygon_count = polygon_count
+    native.polygon_loop_starts = loop_starts.ctypes.data
+    native.polygon_loop_totals = loop_totals.ctypes.data
+    native.polygon_materials = poly_materials.ctypes.data
+    native.polygon_normals = poly_normals.ctypes.data
+    native.matrix[:] = [world_to_armature[r][c] for r in range(4) for c in range(4)]
+    return native, arrays
+
+
+def write_skn_native(writer, filepath, parts, armature_obj, bone_to_idx, deformed_data, disable_scaling=False, disable_transforms=False):
+    """Write the (mesh_obj, submesh_name, material_index) parts with lol_native. Returns (submesh count, vertex count)."""
+    scale = 1.0 if disable_scaling else import_skl.EXPORT_SCALE
+
+    mesh_indices = {}
+    meshes = []
+    keep_alive = []
+    for mesh_obj, _, _ in parts:
+        if mesh_obj.name in mesh_indices:
+            continue
+        deformed_pos, deformed_norms = deformed_data.get(mesh_obj.name, (None, None))
+        native, arrays = native_mesh_arrays(mesh_obj, armature_obj, bone_to_idx, deformed_pos, deformed_norms)
+        mesh_indices[mesh_obj.name] = len(meshes)
+        meshes.append(native)
+        keep_alive.append(arrays)
+
+    submeshes = (_NativeExportSubmesh * len(parts))()
+    for i, (mesh_obj, submesh_name, material_index) in enumerate(parts):
+        submeshes[i].name = submesh_name.encode('ascii', errors='replace')[:64]
+        submeshes[i].mesh = mesh_indices[mesh_obj.name]
+        submeshes[i].material = -1 if material_index is None else material_index
+
+    mesh_array = (_NativeExportMesh * len(meshes))(*meshes)
+    flags = SKN_EXPORT_NO_TRANSFORM if disable_transforms else 0
+    result = writer(filepath.encode('utf-8'), mesh_array, len(meshes), submeshes, len(parts), scale, flags)
+
+    total_vertex_count = 0
+    total_index_count = 0
+    written = 0
+    for i in range(len(parts)):
+        sm = submeshes[i]
+        if not sm.index_count:
+            continue
+        print(f"  Submesh: '{parts[i][1]}' | verts: {sm.vertex_count} (start: {total_vertex_count}) | indices: {sm.index_count} (start: {total_index_count})")
+        total_vertex_count += sm.vertex_count
+        total_index_count += sm.index_count
+        written += 1
+
+    print(f"Total: {written} submeshes, {total_vertex_count} vertices, {total_index_count} indices")
+    print("=== END DEBUG ===\n")
+
+    if result == -8:
+        raise Exception("No geometry found to export")
+    if result == -7:
+        if total_vertex_count > 65535:
+            raise Exception(f"Too many vertices: {total_vertex_count}, max allowed: 65535. Reduce mesh complexity or split into multiple files.")
+        raise Exception(f"Too many submeshes/materials: {written}, max allowed: 32. Reduce number of materials.")
+    if result != 0:
+        raise Exception(f"Aventurine: native SKN export failed (error {result})")
+    return written, total_vertex_count
+
+
 def write_skn_multi(filepath, mesh_objects, armature_obj, clean_names=True, disable_scaling=False, disable_transforms=False, use_visual_pose=False):
     """Write multiple Blender meshes to a single SKN file with multiple submeshes"""
 
@@ -228,6 +419,7 @@ def write_skn_multi(filepath, mesh_objects, armature_obj, clean_names=True, disa
 
     # If use_visual_pose, evaluate meshes at frame 0 with armature deformation
     # This gives us vertex positions that match the new bind pose from the SKL
+    native_writer = _native_write_skn()
     deformed_data = {}
     if use_visual_pose:
         current_frame = bpy.context.scene.frame_current
@@ -239,22 +431,25 @@ def write_skn_multi(filepath, mesh_objects, armature_obj, clean_names=True, disa
                 continue
             eval_obj = obj.evaluated_get(depsgraph)
             eval_mesh = eval_obj.to_mesh()
-            positions = {vi: eval_mesh.vertices[vi].co.copy() for vi in range(len(eval_mesh.vertices))}
-            poly_normals = {p.index: p.normal.copy() for p in eval_mesh.polygons}
+            if native_writer:
+                positions = np.empty(len(eval_mesh.vertices) * 3, dtype=np.float32)
+                eval_mesh.vertices.foreach_get('co', positions)
+                poly_normals = np.empty(len(eval_mesh.polygons) * 3, dtype=np.float32)
+                eval_mesh.polygons.foreach_get('normal', poly_normals)
+            else:
+                positions = {vi: eval_mesh.vertices[vi].co.copy() for vi in range(len(eval_mesh.vertices))}
+                poly_normals = {p.index: p.normal.copy() for p in eval_mesh.polygons}
             deformed_data[obj.name] = (positions, poly_normals)
             eval_obj.to_mesh_clear()
         bpy.context.scene.frame_set(current_frame)
 
-    submesh_data = []
-    total_vertex_count = 0
-    total_index_count = 0
-
+    # One part per material slot (or per mesh without materials): (mesh_obj, submesh_name, material_index)
+    parts = []
     for mesh_obj in mesh_objects:
         if mesh_obj.type != 'MESH':
             continue
 
         mesh = mesh_obj.data
-        deformed_pos, deformed_norms = deformed_data.get(mesh_obj.name, (None, None))
         print(f"Processing mesh: '{mesh_obj.name}' with {len(mesh.materials)} material slots")
         for i, mat in enumerate(mesh.materials):
             mat_name = mat.name if mat else "(None)"
@@ -271,74 +466,54 @@ def write_skn_multi(filepath, mesh_objects, armature_obj, clean_names=True, disa
         # Process each material on the mesh as a separate submesh
         if mesh.materials:
             for mat_idx, material in enumerate(mesh.materials):
-                if material is None:
-                    submesh_name = mesh_obj.name
-                else:
-                    submesh_name = material.name
-
-                # Clean up Maya-style "mesh_" prefix
-                if submesh_name.startswith("mesh_"):
-                    submesh_name = submesh_name[5:]
-
-                if clean_names:
-                    submesh_name = clean_blender_name(submesh_name)
-
-                data = collect_mesh_data(mesh_obj, armature_obj, bone_to_idx, submesh_name,
-                                        material_index=mat_idx,
-                                        disable_scaling=disable_scaling,
-                                        disable_transforms=disable_transforms,
-                                        deformed_positions=deformed_pos,
-                                        deformed_poly_normals=deformed_norms)
-
-                if data is None or not data['indices']:
-                    continue
-
-                submesh_info = {
-                    'name': data['name'],
-                    'vertex_start': total_vertex_count,
-                    'vertex_count': len(data['vertices']),
-                    'index_start': total_index_count,
-                    'index_count': len(data['indices']),
-                    'vertices': data['vertices'],
-                    'indices': [idx + total_vertex_count for idx in data['indices']]
-                }
-
-                print(f"  Submesh: '{submesh_info['name']}' | verts: {submesh_info['vertex_count']} (start: {submesh_info['vertex_start']}) | indices: {submesh_info['index_count']} (start: {submesh_info['index_start']})")
-                submesh_data.append(submesh_info)
-                total_vertex_count += len(data['vertices'])
-                total_index_count += len(data['indices'])
+                submesh_name = mesh_obj.name if material is None else material.name
+                parts.append((mesh_obj, submesh_name, mat_idx))
         else:
             # No materials - use mesh object name
-            submesh_name = mesh_obj.name
-            if submesh_name.startswith("mesh_"):
-                submesh_name = submesh_name[5:]
-            if clean_names:
-                submesh_name = clean_blender_name(submesh_name)
-
-            data = collect_mesh_data(mesh_obj, armature_obj, bone_to_idx, submesh_name,
-                                    material_index=None,
-                                    disable_scaling=disable_scaling,
-                                    disable_transforms=disable_transforms,
-                                    deformed_positions=deformed_pos,
-                                    deformed_poly_normals=deformed_norms)
-
-            if data is None or not data['indices']:
-                continue
+            parts.append((mesh_obj, mesh_obj.name, None))
+
+    for i, (mesh_obj, submesh_name, mat_idx) in enumerate(parts):
+        # Clean up Maya-style "mesh_" prefix
+        if submesh_name.startswith("mesh_"):
+            submesh_name = submesh_name[5:]
+        if clean_names:
+            submesh_name = clean_blender_name(submesh_name)
+        parts[i] = (mesh_obj, submesh_name, mat_idx)
+
+    if native_writer:
+        return write_skn_native(native_writer, filepath, parts, armature_obj, bone_to_idx, deformed_data,
+                                disable_scaling, disable_transforms)
+
+    submesh_data = []
+    total_vertex_count = 0
+    total_index_count = 0
+
+    for mesh_obj, submesh_name, mat_idx in parts:
+        deformed_pos, deformed_norms = deformed_data.get(mesh_obj.name, (None, None))
+        data = collect_mesh_data(mesh_obj, armature_obj, bone_to_idx, submesh_name,
+                                material_index=mat_idx,
+                                disable_scaling=disable_scaling,
+                                disable_transforms=disable_transforms,
+                                deformed_positions=deformed_pos,
+                                deformed_poly_normals=deformed_norms)
+
+        if data is None or not data['indices']:
+            continue
 
-            submesh_info = {
-                'name': data['name'],
-                'vertex_start': total_vertex_count,
-                'vertex_count': len(data['vertices']),
-                'index_start': total_index_count,
-                'index_count': len(data['indices']),
-                'vertices': data['vertices'],
-                'indices': [idx + total_vertex_count for idx in data['indices']]
-            }
-
-            print(f"  Submesh: '{submesh_info['name']}' | verts: {submesh_info['vertex_count']} (start: {submesh_info['vertex_start']}) | indices: {submesh_info['index_count']} (start: {submesh_info['index_start']})")
-            submesh_data.append(submesh_info)
-            total_vertex_count += len(data['vertices'])
-            total_index_count += len(data['indices'])
+        submesh_info = {
+            'name': data['name'],
+            'vertex_start': total_vertex_count,
+            'vertex_count': len(data['vertices']),
+            'index_start': total_index_count,
+            'index_count': len(data['indices']),
+            'vertices': data['vertices'],
+            'indices': [idx + total_vertex_count for idx in data['indices']]
+        }
+
+        print(f"  Submesh: '{submesh_info['name']}' | verts: {submesh_info['vertex_count']} (start: {submesh_info['vertex_start']}) | indices: {submesh_info['index_count']} (start: {submesh_info['index_start']})")
+        submesh_data.append(submesh_info)
+        total_vertex_count += len(data['vertices'])
+        total_index_count += len(data['indices'])
 
     print(f"Total: {len(submesh_data)} submeshes, {total_vertex_count} vertices, {total_index_count} indices")
     print("=== END DEBUG ===\n")
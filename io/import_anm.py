@@ -3,7 +3,10 @@ import bpy
 import mathutils
 import math
 import os
+import ctypes
+import numpy as np
 from ..utils.binary_utils import BinaryStream, Vector, Quaternion, Hash
+from ..utils import texture_manager, native_anim
 from . import import_skl
 
 
@@ -24,14 +27,88 @@ class ANMTrack:
         self.poses = {} # f -> ANMPose
 
 
+class ANMKeys:
+    """
+    Keys as flat arrays laid out [track][frame slot], like the native reader
+    returns them. Translations are in Blender units and rotations (x, y, z, w).
+    """
+    __slots__ = ('joint_hashes', 'key_flags', 'translations', 'rotations', 'scales')
+
+    def __init__(self, joint_hashes, key_flags, translations, rotations, scales):
+        self.joint_hashes = joint_hashes
+        self.key_flags = key_flags
+        self.translations = translations
+        self.rotations = rotations
+        self.scales = scales
+
+    @classmethod
+    def from_tracks(cls, tracks):
+        slots = max((max(t.poses, default=-1) + 1 for t in tracks), default=0)
+        key_flags = np.zeros((len(tracks), slots), dtype=np.uint8)
+        translations = np.zeros((len(tracks), slots, 3), dtype=np.float32)
+        rotations = np.zeros((len(tracks), slots, 4), dtype=np.float32)
+        scales = np.zeros((len(tracks), slots, 3), dtype=np.float32)
+
+        for t, track in enumerate(tracks):
+            for frame, pose in track.poses.items():
+                if pose.translation is not None:
+                    key_flags[t, frame] |= ANM_KEY_TRANSLATION
+                    translations[t, frame] = pose.translation
+                if pose.rotation is not None:
+                    key_flags[t, frame] |= ANM_KEY_ROTATION
+                    r = pose.rotation
+                    rotations[t, frame] = (r.x, r.y, r.z, r.w)
+                if pose.scale is not None:
+                    key_flags[t, frame] |= ANM_KEY_SCALE
+                    scales[t, frame] = pose.scale
+
+        return cls([t.joint_hash for t in tracks], key_flags, translations, rotations, scales)
+
+    def to_tracks(self):
+        Vec = mathutils.Vector
+        Quat = mathutils.Quaternion
+        tracks = []
+        for t, joint_hash in enumerate(self.joint_hashes):
+            track = ANMTrack(joint_hash)
+            track_flags = self.key_flags[t]
+            frames = np.nonzero(track_flags)[0]
+            t_rows = self.translations[t][frames].tolist()
+            r_rows = self.rotations[t][frames][:, [3, 0, 1, 2]].tolist()  # (w, x, y, z)
+            s_rows = self.scales[t][frames].tolist()
+
+            for i, (frame, key) in enumerate(zip(frames.tolist(), track_flags[frames].tolist())):
+                pose = ANMPose()
+                if key & ANM_KEY_TRANSLATION:
+                    pose.translation = Vec(t_rows[i])
+                if key & ANM_KEY_ROTATION:
+                    pose.rotation = Quat(r_rows[i])
+                if key & ANM_KEY_SCALE:
+                    pose.scale = Vec(s_rows[i])
+                track.poses[frame] = pose
+            tracks.append(track)
+        return tracks
+
+
 class ANMData:
-    __slots__ = ('fps', 'duration', 'tracks', 'frame_count')
+    __slots__ = ('fps', 'duration', '_tracks', 'frame_count', 'keys')
     
     def __init__(self):
         self.fps = 30.0
         self.duration = 0.0
-        self.tracks = []
+        self._tracks = []
         self.frame_count = 0
+        self.keys = None  # ANMKeys from the native reader, tracks are built from it on first use
+
+    @property
+    def tracks(self):
+        if self._tracks is None:
+            self._tracks = self.keys.to_tracks()
+        return self._tracks
+
+    @tracks.setter
+    def tracks(self, tracks):
+        self._tracks = tracks
+        self.keys = None
 
 
 def decompress_quat(bytes_data):
@@ -280,6 +357,210 @@ def read_anm(filepath):
     return anm
 
 
+# --- Native reader (lol_native parse_anm) ---
+ANM_KEY_TRANSLATION = 0x1
+ANM_KEY_ROTATION = 0x2
+ANM_KEY_SCALE = 0x4
+
+
+class _NativeAnm(ctypes.Structure):
+    _fields_ = [
+        ('format', ctypes.c_uint32),
+        ('version', ctypes.c_uint32),
+        ('track_count', ctypes.c_uint32),
+        ('frame_count', ctypes.c_uint32),
+        ('frame_slots', ctypes.c_uint32),
+        ('fps', ctypes.c_float),
+        ('duration', ctypes.c_float),
+        ('joint_hashes', ctypes.POINTER(ctypes.c_uint32)),
+        ('key_flags', ctypes.POINTER(ctypes.c_uint8)),
+        ('translations', ctypes.POINTER(ctypes.c_float)),
+        ('rotations', ctypes.POINTER(ctypes.c_float)),
+        ('scales', ctypes.POINTER(ctypes.c_float)),
+    ]
+
+
+def _native_parse_anm():
+    """lol_native parse_anm, or None if unavailable"""
+    return texture_manager.bind_native('parse_anm', [ctypes.c_char_p, ctypes.POINTER(ctypes.POINTER(_NativeAnm))])
+
+
+def read_anm_native(filepath):
+    """read_anm through lol_native. Returns ANMData, or None if the native reader can't be used."""
+    parse_anm = _native_parse_anm()
+    if not parse_anm:
+        return None
+
+    anm_ptr = ctypes.POINTER(_NativeAnm)()
+    result = parse_anm(filepath.encode('utf-8'), ctypes.byref(anm_ptr))
+    if result != 0:
+        print(f"Aventurine: native ANM parse failed (error {result}), using Python reader")
+        return None
+
+    try:
+        data = anm_ptr.contents
+        anm = ANMData()
+        anm.fps = float(data.fps)
+        anm.duration = float(data.duration)
+        anm.frame_count = data.frame_count
+
+        tracks, slots = data.track_count, data.frame_slots
+        if tracks == 0:
+            return anm
+
+        hashes = np.ctypeslib.as_array(data.joint_hashes, shape=(tracks,)).tolist()
+        if slots == 0:
+            anm.tracks = [ANMTrack(h) for h in hashes]
+            return anm
+
+        flags = np.ctypeslib.as_array(data.key_flags, shape=(tracks, slots)).copy()
+        translations = np.ctypeslib.as_array(data.translations, shape=(tracks, slots, 3)) * import_skl.IMPORT_SCALE
+        rotations = np.ctypeslib.as_array(data.rotations, shape=(tracks, slots, 4)).copy()
+        scales = np.ctypeslib.as_array(data.scales, shape=(tracks, slots, 3)).copy()
+    finally:
+        texture_manager.free_native_bytes(anm_ptr)
+
+    # Per-key ANMPose objects are only built if something asks for anm.tracks;
+    # apply_anm bakes straight from the arrays
+    anm.keys = ANMKeys(hashes, flags, translations, rotations, scales)
+    anm._tracks = None
+    return anm
+
+
+def _bone_rest_data(pbone, corrections):
+    """Per-bone inputs of the native -> basis conversion: parent/child corrections, rest local inverse and bind defaults"""
+    # Get correction matrices
+    C_child = corrections[pbone.name]
+    if pbone.parent:
+        C_parent = corrections[pbone.parent.name]
+    else:
+        C_parent = mathutils.Matrix.Identity(4)
+
+    try:
+        C_parent_inv = C_parent.inverted()
+    except ValueError:
+        C_parent_inv = mathutils.Matrix.Identity(4)
+
+    # Get rest visual local matrix (computed once per bone)
+    if pbone.parent:
+        rest_v_parent = pbone.parent.bone.matrix_local
+        rest_v_child = pbone.bone.matrix_local
+        try:
+            rest_v_local = rest_v_parent.inverted() @ rest_v_child
+        except ValueError:
+            rest_v_local = rest_v_child
+    else:
+        rest_v_local = pbone.bone.matrix_local
+    try:
+        rest_v_local_inv = rest_v_local.inverted()
+    except ValueError:
+        rest_v_local_inv = mathutils.Matrix.Identity(4)
+
+    # Fallback values (native bind pose)
+    nb_t = pbone.get("native_bind_t")
+    if nb_t:
+        def_t = mathutils.Vector(nb_t)
+        def_r = mathutils.Quaternion(pbone.get("native_bind_r"))
+        s_val = pbone.get("native_bind_s")
+        def_s = mathutils.Vector(s_val) if s_val else mathutils.Vector((1,1,1))
+    else:
+        def_t = mathutils.Vector((0,0,0))
+        def_r = mathutils.Quaternion((1,0,0,0))
+        def_s = mathutils.Vector((1,1,1))
+
+    return C_parent_inv, C_child, rest_v_local_inv, def_t, def_r, def_s
+
+
+def _find_fcurves(action):
+    """The action's F-curve collection, or None if it can't be reached directly"""
+    # Blender 5.0 moved fcurves to a new location in the layered action system
+    if hasattr(action, 'fcurves'):
+        # Blender 4.3 and earlier - fcurves directly on action
+        return action.fcurves
+    if hasattr(action, 'layers') and len(action.layers) > 0:
+        # Blender 4.4+ / 5.0+ - Layered/Slotted Actions
+        # FCurves are now at: action.layers[0].strips[0].channelbag(slot).fcurves
+        # But for armatures, we need to ensure we have the right slot binding
+        try:
+            layer = action.layers[0]
+            if len(layer.strips) > 0:
+                strip = layer.strips[0]
+                # Get the appropriate slot - for armatures, usually the first or default
+                if hasattr(action, 'slots') and len(action.slots) > 0:
+                    slot = action.slots[0]
+                    channelbag = strip.channelbag(slot)
+                    if hasattr(channelbag, 'fcurves'):
+                        return channelbag.fcurves
+        except:
+            # If anything fails, fall back to slow but safe method
+            pass
+    return None
+
+
+def _bake_anm_native(anm, armature_obj, corrections, P, P_inv, frame_offset, flip):
+    """Steps 3 and 4 of apply_anm in one native call, with each F-curve written through foreach_set"""
+    keys = anm.keys if anm.keys is not None else ANMKeys.from_tracks(anm.tracks)
+    track_index = {h: t for t, h in enumerate(keys.joint_hashes)}
+
+    pbones = list(armature_obj.pose.bones)
+    bone_tracks = np.full(len(pbones), -1, dtype=np.int32)
+    identity = mathutils.Matrix.Identity(4)
+    pre = [identity] * len(pbones)
+    post = [identity] * len(pbones)
+    defaults = np.zeros((len(pbones), 10), dtype=np.float32)
+
+    for i, pbone in enumerate(pbones):
+        track = track_index.get(Hash.elf(pbone.name))
+        if track is None:
+            continue
+        bone_tracks[i] = track
+
+        # basis = rest_v_local_inv @ C_parent_inv @ (P @ L @ P_inv) @ C_child
+        C_parent_inv, C_child, rest_v_local_inv, def_t, def_r, def_s = _bone_rest_data(pbone, corrections)
+        pre[i] = rest_v_local_inv @ C_parent_inv @ P
+        post[i] = P_inv @ C_child
+        defaults[i] = (def_t.x, def_t.y, def_t.z, def_r.x, def_r.y, def_r.z, def_r.w, def_s.x, def_s.y, def_s.z)
+
+    flags = native_anim.BAKE_FLIP if flip else 0
+    if frame_offset == 0:
+        # Keyframe 0 (Bind Pose) - Only when creating new action
+        flags |= native_anim.BAKE_BIND_KEY
+    slot_frames = frame_offset + 1 + np.arange(keys.key_flags.shape[1], dtype=np.float32)
+
+    baked = native_anim.bake_fcurves(keys.key_flags, keys.translations, keys.rotations, keys.scales, slot_frames,
+                                     bone_tracks, native_anim.matrices(pre), native_anim.matrices(post), defaults,
+                                     flags=flags, bind_frame=0.0)
+
+    print(f"Matched {int((bone_tracks >= 0).sum())} tracks to bones")
+    print(f"Bones with keyframe data: {sum(1 for channels in baked if channels)}")
+
+    action = armature_obj.animation_data.action
+    fcurves_collection = None
+    total_keyframes = 0
+
+    for pbone, channels in zip(pbones, baked):
+        for prop_name, curves in channels.items():
+            # keyframe_insert once to create the FCurves (and the action slot on layered actions)
+            pbone.keyframe_insert(data_path=prop_name, frame=float(curves[0][0]))
+            if fcurves_collection is None:
+                fcurves_collection = _find_fcurves(action)
+
+            data_path = f'pose.bones["{pbone.name}"].{prop_name}'
+            for i, co in enumerate(curves):
+                fc = fcurves_collection.find(data_path, index=i) if fcurves_collection is not None else None
+                if fc:
+                    native_anim.set_keys(fc, co)
+                else:
+                    # Slow path: keyframe_insert per key
+                    values = getattr(pbone, prop_name)
+                    for frame, value in co.reshape(-1, 2).tolist():
+                        values[i] = value
+                        pbone.keyframe_insert(data_path=prop_name, index=i, frame=frame)
+                total_keyframes += len(co) // 2
+
+    print(f"Inserted {total_keyframes} keyframe channels")
+
+
 def apply_anm(anm, armature_obj, frame_offset=0, flip=False):
     """Apply ANM animation to armature using fast batch FCurve operations."""
     if armature_obj.type != 'ARMATURE':
@@ -361,6 +642,13 @@ def apply_anm(anm, armature_obj, frame_offset=0, flip=False):
         except ValueError:
             corrections[pbone.name] = mathutils.Matrix.Identity(4)
 
+    if native_anim.available():
+        _bake_anm_native(anm, armature_obj, corrections, P, P_inv, frame_offset, flip)
+        bpy.ops.object.mode_set(mode='OBJECT')
+        bpy.context.view_layer.update()
+        bpy.context.scene.frame_set(bpy.context.scene.frame_start)
+        return
+
     # --- 3. Collect all keyframe data (first pass) ---
     tracks_dict = {t.joint_hash: t for t in anm.tracks}
 
@@ -378,44 +666,7 @@ def apply_anm(anm, armature_obj, frame_offset=0, flip=False):
         if track:
             matched_count += 1
 
-        # Get correction matrices
-        C_child = corrections[pbone.name]
-        if pbone.parent:
-            C_parent = corrections[pbone.parent.name]
-        else:
-            C_parent = mathutils.Matrix.Identity(4)
-
-        try:
-            C_parent_inv = C_parent.inverted()
-        except ValueError:
-            C_parent_inv = mathutils.Matrix.Identity(4)
-
-        # Get rest visual local matrix (computed once per bone)
-        if pbone.parent:
-            rest_v_parent = pbone.parent.bone.matrix_local
-            rest_v_child = pbone.bone.matrix_local
-            try:
-                rest_v_local = rest_v_parent.inverted() @ rest_v_child
-            except ValueError:
-                rest_v_local = rest_v_child
-        else:
-            rest_v_local = pbone.bone.matrix_local
-        try:
-            rest_v_local_inv = rest_v_local.inverted()
-        except ValueError:
-            rest_v_local_inv = mathutils.Matrix.Identity(4)
-
-        # Fallback values (native bind pose)
-        nb_t = pbone.get("native_bind_t")
-        if nb_t:
-            def_t = mathutils.Vector(nb_t)
-            def_r = mathutils.Quaternion(pbone.get("native_bind_r"))
-            s_val = pbone.get("native_bind_s")
-            def_s = mathutils.Vector(s_val) if s_val else mathutils.Vector((1,1,1))
-        else:
-            def_t = mathutils.Vector((0,0,0))
-            def_r = mathutils.Quaternion((1,0,0,0))
-            def_s = mathutils.Vector((1,1,1))
+        C_parent_inv, C_child, rest_v_local_inv, def_t, def_r, def_s = _bone_rest_data(pbone, corrections)
 
         # Initialize keyframe storage for this bone
         bone_data = {
@@ -497,32 +748,8 @@ def apply_anm(anm, armature_obj, frame_offset=0, flip=False):
     total_keyframes = 0
 
     # Detect how to access fcurves based on Blender version/API
-    fcurves_collection = None
-    use_fast_path = False
-    
-    # Try different methods to access fcurves
-    if hasattr(action, 'fcurves'):
-        # Blender 4.3 and earlier - fcurves directly on action
-        fcurves_collection = action.fcurves
-        use_fast_path = True
-    elif hasattr(action, 'layers') and len(action.layers) > 0:
-        # Blender 4.4+ / 5.0+ - Layered/Slotted Actions
-        # FCurves are now at: action.layers[0].strips[0].channelbag(slot).fcurves
-        # But for armatures, we need to ensure we have the right slot binding
-        try:
-            layer = action.layers[0]
-            if len(layer.strips) > 0:
-                strip = layer.strips[0]
-                # Get the appropriate slot - for armatures, usually the first or default
-                if hasattr(action, 'slots') and len(action.slots) > 0:
-                    slot = action.slots[0]
-                    channelbag = strip.channelbag(slot)
-                    if hasattr(channelbag, 'fcurves'):
-                        fcurves_collection = channelbag.fcurves
-                        use_fast_path = True
-        except:
-            # If anything fails, fall back to slow but safe method
-            use_fast_path = False
+    fcurves_collection = _find_fcurves(action)
+    use_fast_path = fcurves_collection is not None
 
     for bone_name, bone_data in bone_keyframes.items():
 
@@ -595,7 +822,9 @@ def load(operator, context, filepath, create_new_action=True, insert_frame=0, fl
         return {'CANCELLED'}
         
     try:
-        anm = read_anm(filepath)
+        anm = read_anm_native(filepath)
+        if anm is None:
+            anm = read_anm(filepath)
         
         # Get action name from filename (without extension)
         action_name = os.path.splitext(os.path.basename(filepath))[0]
@@ -1,7 +1,10 @@
 import bpy
 import os
 import struct
+import ctypes
 import mathutils
+import numpy as np
+from ..utils import texture_manager
 
 def read_scb(filepath):
     """Read SCB file and return data structure"""
@@ -67,7 +70,7 @@ def read_scb(filepath):
             
             # Read material name (64 bytes, padded)
             material_bytes = f.read(64)
-            if i == 0: # Only grab first material for now, often SCB has 1 material
+            if material is None: # Only grab the first kept face's material, often SCB has 1 material
                 material = material_bytes.split(b'\x00')[0].decode('ascii', errors='ignore')
             
             # Read UVs (6 floats: u1, u2, u3, v1, v2, v3)
@@ -87,6 +90,130 @@ def read_scb(filepath):
         'scb_flag': scb_flag
     }
 
+# --- Native reader (lol_native parse_scb / parse_sco) ---
+STATIC_MESH_HAS_PIVOT = 0x1
+
+
+class _NativeStaticMesh(ctypes.Structure):
+    _fields_ = [
+        ('format', ctypes.c_uint32),
+        ('major', ctypes.c_uint32),
+        ('minor', ctypes.c_uint32),
+        ('flags', ctypes.c_uint32),
+        ('scb_flag', ctypes.c_uint32),
+        ('vertex_count', ctypes.c_uint32),
+        ('face_count', ctypes.c_uint32),
+        ('central', ctypes.c_float * 3),
+        ('pivot', ctypes.c_float * 3),
+        ('name', ctypes.c_char * 64),
+        ('material', ctypes.c_char * 64),
+        ('positions', ctypes.POINTER(ctypes.c_float)),
+        ('indices', ctypes.POINTER(ctypes.c_uint32)),
+        ('uvs', ctypes.POINTER(ctypes.c_float)),
+    ]
+
+
+def _native_static_parser(kind):
+    """lol_native parse_scb (kind 'scb') or parse_sco, or None if unavailable"""
+    return texture_manager.bind_native(f'parse_{kind}', [ctypes.c_char_p, ctypes.POINTER(ctypes.POINTER(_NativeStaticMesh))])
+
+
+class StaticArrays:
+    """
+    Structure-of-arrays SCB/SCO data: positions (Blender axes), indices,
+    per-corner UVs (Blender orientation) and the points in Blender axes.
+    Faces are already free of degenerate triangles.
+    """
+    __slots__ = ('name', 'positions', 'indices', 'uvs', 'material', 'central', 'pivot', 'scb_flag')
+
+
+def _read_static_native(parse, filepath):
+    mesh_ptr = ctypes.POINTER(_NativeStaticMesh)()
+    result = parse(filepath.encode('utf-8'), ctypes.byref(mesh_ptr))
+    if result != 0:
+        print(f"Aventurine: native static mesh parse failed (error {result}), using Python reader")
+        return None
+
+    def to_blender(p):
+        # Same axis conversion as the Python readers: (-x, -z, y)
+        return mathutils.Vector((-p[0], -p[2], p[1]))
+
+    try:
+        mesh = mesh_ptr.contents
+        vc, fc = mesh.vertex_count, mesh.face_count
+        raw = (np.ctypeslib.as_array(mesh.positions, shape=(vc, 3)) if vc else np.zeros((0, 3), dtype=np.float32))
+
+        arrays = StaticArrays()
+        arrays.positions = np.empty((vc, 3), dtype=np.float32)
+        arrays.positions[:, 0] = -raw[:, 0]
+        arrays.positions[:, 1] = -raw[:, 2]
+        arrays.positions[:, 2] = raw[:, 1]
+        if fc:
+            arrays.indices = np.ctypeslib.as_array(mesh.indices, shape=(fc * 3,)).astype(np.int32)
+            arrays.uvs = np.ctypeslib.as_array(mesh.uvs, shape=(fc * 3, 2)).copy()
+            arrays.uvs[:, 1] = 1.0 - arrays.uvs[:, 1]  # Flip V
+        else:
+            arrays.indices = np.zeros(0, dtype=np.int32)
+            arrays.uvs = np.zeros((0, 2), dtype=np.float32)
+
+        arrays.name = mesh.name.decode('utf-8', errors='replace')
+        arrays.material = mesh.material.decode('ascii', errors='ignore')
+        arrays.central = to_blender(mesh.central)
+        arrays.pivot = to_blender(mesh.pivot) if mesh.flags & STATIC_MESH_HAS_PIVOT else None
+        arrays.scb_flag = mesh.scb_flag
+        return arrays
+    finally:
+        texture_manager.free_native_bytes(mesh_ptr)
+
+
+def read_scb_native(filepath):
+    """read_scb through lol_native. Returns StaticArrays, or None if the native reader can't be used."""
+    parse = _native_static_parser('scb')
+    if not parse:
+        return None
+    arrays = _read_static_native(parse, filepath)
+    if arrays is not None:
+        arrays.name = os.path.splitext(os.path.basename(filepath))[0]
+        arrays.material = arrays.material or 'lambert69'
+    return arrays
+
+
+def read_sco_native(filepath):
+    """read_sco through lol_native. Returns StaticArrays, or None if the native reader can't be used."""
+    parse = _native_static_parser('sco')
+    if not parse:
+        return None
+    arrays = _read_static_native(parse, filepath)
+    if arrays is not None:
+        arrays.name = arrays.name or 'sco_mesh'
+        arrays.material = arrays.material or 'lambert1'
+    return arrays
+
+
+def create_mesh_native(arrays):
+    """create_mesh for StaticArrays: same result, filled with foreach_set instead of per-face loops"""
+    face_count = len(arrays.indices) // 3
+
+    mesh = bpy.data.meshes.new(arrays.name)
+    mesh.vertices.add(len(arrays.positions))
+    mesh.vertices.foreach_set('co', arrays.positions.ravel())
+    mesh.loops.add(len(arrays.indices))
+    mesh.loops.foreach_set('vertex_index', arrays.indices)
+    mesh.polygons.add(face_count)
+    mesh.polygons.foreach_set('loop_start', np.arange(0, face_count * 3, 3, dtype=np.int32))
+    mesh.update(calc_edges=True)
+
+    uv_layer = mesh.uv_layers.new(name="UVMap")
+    uv_layer.data.foreach_set('uv', arrays.uvs.ravel())
+
+    # Material
+    mat = bpy.data.materials.new(name=arrays.material)
+    mat.use_nodes = True
+    mesh.materials.append(mat)
+
+    return mesh
+
+
 def create_mesh(scb_data):
     """Create Blender mesh from SCB data"""
     mesh = bpy.data.meshes.new(scb_data['name'])
@@ -134,10 +261,16 @@ def create_mesh(scb_data):
 
 def load(operator, context, filepath):
     try:
-        scb_data = read_scb(filepath)
-        mesh = create_mesh(scb_data)
+        scb_arrays = read_scb_native(filepath)
+        if scb_arrays is not None:
+            name = scb_arrays.name
+            mesh = create_mesh_native(scb_arrays)
+        else:
+            scb_data = read_scb(filepath)
+            name = scb_data['name']
+            mesh = create_mesh(scb_data)
         
-        obj = bpy.data.objects.new(scb_data['name'], mesh)
+        obj = bpy.data.objects.new(name, mesh)
         context.collection.objects.link(obj)
         
         # Store import path for export convenience
@@ -148,7 +281,7 @@ def load(operator, context, filepath):
         context.view_layer.objects.active = obj
         obj.select_set(True)
         
-        operator.report({'INFO'}, f"Imported SCB: {scb_data['name']}")
+        operator.report({'INFO'}, f"Imported SCB: {name}")
         return {'FINISHED'}
     except Exception as e:
         operator.report({'ERROR'}, f"Failed to load SCB: {str(e)}")
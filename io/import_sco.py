@@ -1,6 +1,7 @@
 import bpy
 import os
 import mathutils
+from . import import_scb
 
 def sanitize_name(name):
     if not name: return "unnamed"
@@ -62,11 +63,12 @@ def read_sco(filepath):
                 if idx[0] == idx[1] or idx[1] == idx[2] or idx[0] == idx[2]:
                     continue
                     
-                data['indices'].extend(idx)
-                
-                if f_idx == 0:
+                # Material of the first kept face
+                if not data['indices']:
                     data['material'] = fp[4]
                     
+                data['indices'].extend(idx)
+                    
                 data['uvs'].append(mathutils.Vector((float(fp[5]), float(fp[6]))))
                 data['uvs'].append(mathutils.Vector((float(fp[7]), float(fp[8]))))
                 data['uvs'].append(mathutils.Vector((float(fp[9]), float(fp[10]))))
@@ -113,12 +115,15 @@ def create_mesh_and_obj(context, data):
     mat.use_nodes = True
     mesh.materials.append(mat)
     
-    obj = bpy.data.objects.new(data['name'], mesh)
+    return link_object(context, data['name'], mesh, data['pivot'])
+
+def link_object(context, name, mesh, pivot):
+    obj = bpy.data.objects.new(name, mesh)
     context.collection.objects.link(obj)
     
     # Pivot Bone logic (Optional, but useful for static objs with pivots)
-    if data['pivot']:
-        arm_name = data['name'] + "_Armature"
+    if pivot:
+        arm_name = name + "_Armature"
         arm_data = bpy.data.armatures.new(arm_name)
         arm_obj = bpy.data.objects.new(arm_name, arm_data)
         context.collection.objects.link(arm_obj)
@@ -155,8 +160,15 @@ def create_mesh_and_obj(context, data):
 
 def load(operator, context, filepath):
     try:
-        data = read_sco(filepath)
-        obj = create_mesh_and_obj(context, data)
+        sco_arrays = import_scb.read_sco_native(filepath)
+        if sco_arrays is not None:
+            name = sco_arrays.name
+            mesh = import_scb.create_mesh_native(sco_arrays)
+            obj = link_object(context, name, mesh, sco_arrays.pivot)
+        else:
+            data = read_sco(filepath)
+            name = data['name']
+            obj = create_mesh_and_obj(context, data)
         
         # Store import path for export convenience
         obj["lol_sco_filepath"] = filepath
@@ -165,7 +177,7 @@ def load(operator, context, filepath):
         context.view_layer.objects.active = obj
         obj.select_set(True)
         
-        operator.report({'INFO'}, f"Imported SCO: {data['name']}")
+        operator.report({'INFO'}, f"Imported SCO: {name}")
         return {'FINISHED'}
     except Exception as e:
         operator.report({'ERROR'}, f"Failed to load SCO: {str(e)}")
@@ -1,7 +1,9 @@
 """SKN mesh importer - fixed to match skeleton coordinate system and binding"""
 import bpy
 import os
+import ctypes
 import mathutils
+import numpy as np
 from ..utils.binary_utils import BinaryStream, Vector
 from . import import_skl
 from ..utils import texture_manager
@@ -97,6 +99,96 @@ def read_skn(filepath):
     return indices, vertices, submeshes
 
 
+# --- Native reader (lol_native parse_skn) ---
+class _NativeSubmesh(ctypes.Structure):
+    _pack_ = 1
+    _fields_ = [
+        ('name', ctypes.c_char * 64),
+        ('vertex_start', ctypes.c_uint32),
+        ('vertex_count', ctypes.c_uint32),
+        ('index_start', ctypes.c_uint32),
+        ('index_count', ctypes.c_uint32),
+    ]
+
+
+class _NativeMesh(ctypes.Structure):
+    _fields_ = [
+        ('major', ctypes.c_uint32),
+        ('minor', ctypes.c_uint32),
+        ('vertex_type', ctypes.c_uint32),
+        ('vertex_count', ctypes.c_uint32),
+        ('index_count', ctypes.c_uint32),
+        ('submesh_count', ctypes.c_uint32),
+        ('positions', ctypes.POINTER(ctypes.c_float)),
+        ('normals', ctypes.POINTER(ctypes.c_float)),
+        ('uvs', ctypes.POINTER(ctypes.c_float)),
+        ('bone_indices', ctypes.POINTER(ctypes.c_uint8)),
+        ('weights', ctypes.POINTER(ctypes.c_float)),
+        ('colors', ctypes.POINTER(ctypes.c_uint8)),
+        ('tangents', ctypes.POINTER(ctypes.c_float)),
+        ('indices', ctypes.POINTER(ctypes.c_uint32)),
+        ('submeshes', ctypes.POINTER(_NativeSubmesh)),
+    ]
+
+
+def _native_parse_skn():
+    """lol_native parse_skn, or None if unavailable"""
+    return texture_manager.bind_native('parse_skn', [ctypes.c_char_p, ctypes.POINTER(ctypes.POINTER(_NativeMesh))])
+
+
+class SKNArrays:
+    """Structure-of-arrays SKN data. Faces are already free of degenerate triangles."""
+    __slots__ = ('positions', 'normals', 'uvs', 'bone_indices', 'weights', 'indices', 'submeshes')
+
+    @property
+    def vertex_count(self):
+        return len(self.positions)
+
+
+def read_skn_native(filepath):
+    """Parse an SKN with lol_native. Returns SKNArrays, or None if the native reader can't be used."""
+    parse_skn = _native_parse_skn()
+    if not parse_skn:
+        return None
+
+    mesh_ptr = ctypes.POINTER(_NativeMesh)()
+    result = parse_skn(filepath.encode('utf-8'), ctypes.byref(mesh_ptr))
+    if result != 0:
+        print(f"Aventurine: native SKN parse failed (error {result}), using Python reader")
+        return None
+
+    try:
+        mesh = mesh_ptr.contents
+        vc, ic = mesh.vertex_count, mesh.index_count
+
+        def take(ptr, count, width, dtype):
+            if count == 0:
+                return np.zeros((0, width) if width else 0, dtype=dtype)
+            return np.ctypeslib.as_array(ptr, shape=(count, width) if width else (count,)).copy()
+
+        arrays = SKNArrays()
+        arrays.positions = take(mesh.positions, vc, 3, np.float32)
+        arrays.normals = take(mesh.normals, vc, 3, np.float32)
+        arrays.uvs = take(mesh.uvs, vc, 2, np.float32)
+        arrays.bone_indices = take(mesh.bone_indices, vc, 4, np.uint8)
+        arrays.weights = take(mesh.weights, vc, 4, np.float32)
+        arrays.indices = take(mesh.indices, ic, 0, np.uint32)
+
+        arrays.submeshes = []
+        for i in range(mesh.submesh_count):
+            src = mesh.submeshes[i]
+            submesh = SKNSubmesh()
+            submesh.name = src.name.decode('ascii', errors='replace')
+            submesh.vertex_start = src.vertex_start
+            submesh.vertex_count = src.vertex_count
+            submesh.index_start = src.index_start
+            submesh.index_count = src.index_count
+            arrays.submeshes.append(submesh)
+        return arrays
+    finally:
+        texture_manager.free_native_bytes(mesh_ptr)
+
+
 def create_mesh(indices, vertices, submeshes, name, armature_obj=None, joints=None, influences=None):
     # Coordinate system: X -> X, Y -> Z, Z -> -Y (Standing Up)
     # Apply import scale (0.01) to match Maya/LtMAO units
@@ -167,9 +259,115 @@ def create_mesh(indices, vertices, submeshes, name, armature_obj=None, joints=No
     return obj
 
 
-def load(operator, context, filepath, load_skl_file=True, split_by_material=False, auto_load_textures=True):
+def create_mesh_native(skn, name, armature_obj=None, joints=None, influences=None):
+    """create_mesh for SKNArrays: same result, filled with foreach_set instead of per-vertex loops"""
+    scale = import_skl.IMPORT_SCALE
+    vertex_count = skn.vertex_count
+    face_count = len(skn.indices) // 3
+
+    # Same axis conversion as create_mesh
+    co = np.empty((vertex_count, 3), dtype=np.float32)
+    co[:, 0] = -skn.positions[:, 0] * scale
+    co[:, 1] = -skn.positions[:, 2] * scale
+    co[:, 2] = skn.positions[:, 1] * scale
+
+    mesh = bpy.data.meshes.new(name)
+    mesh.vertices.add(vertex_count)
+    mesh.vertices.foreach_set('co', co.ravel())
+    mesh.loops.add(len(skn.indices))
+    mesh.loops.foreach_set('vertex_index', skn.indices.astype(np.int32))
+    mesh.polygons.add(face_count)
+    mesh.polygons.foreach_set('loop_start', np.arange(0, face_count * 3, 3, dtype=np.int32))
+    mesh.update(calc_edges=True)
+
+    obj = bpy.data.objects.new(name, mesh)
+    bpy.context.scene.collection.objects.link(obj)
+
+    uv_layer = mesh.uv_layers.new(name="UVMap")
+    loop_uvs = skn.uvs[skn.indices].copy()
+    loop_uvs[:, 1] = 1.0 - loop_uvs[:, 1]
+    uv_layer.data.foreach_set('uv', loop_uvs.ravel())
+
+    material_indices = np.zeros(face_count, dtype=np.int32)
+    for submesh in skn.submeshes:
+        mat = bpy.data.materials.new(submesh.name)
+        mat.use_nodes = True
+        mesh.materials.append(mat)
+
+        face_start = submesh.index_start // 3
+        face_end = (submesh.index_start + submesh.index_count) // 3
+        material_indices[face_start:min(face_end, face_count)] = len(mesh.materials) - 1
+    mesh.polygons.foreach_set('material_index', material_indices)
+
+    # Bind to armature
+    if armature_obj and joints:
+        obj.parent = armature_obj
+        obj.matrix_parent_inverse = armature_obj.matrix_world.inverted()
+
+        group_map = {}
+        for i, joint in enumerate(joints):
+            vg = obj.vertex_groups.new(name=joint.name)
+            group_map[i] = vg
+
+        mod = obj.modifiers.new(name='Armature', type='ARMATURE')
+        mod.object = armature_obj
+        mod.use_vertex_groups = True
+        mod.use_bone_envelopes = False
+
+        # Map influence slots to joints, then merge slots of a vertex that
+        # land on the same joint like create_mesh does
+        joint_ids = skn.bone_indices.astype(np.int64)
+        if influences:
+            remap = np.asarray(influences, dtype=np.int64)
+            in_range = joint_ids < len(remap)
+            joint_ids = np.where(in_range, remap[np.minimum(joint_ids, len(remap) - 1)], joint_ids)
+
+        valid = (skn.weights > 0.0001) & (joint_ids < len(joints))
+        vtx = np.broadcast_to(np.arange(vertex_count, dtype=np.int64)[:, None], joint_ids.shape)[valid]
+        jnt = joint_ids[valid]
+        wgt = skn.weights[valid].astype(np.float64)
+
+        if len(vtx):
+            keys = vtx * len(joints) + jnt
+            unique_keys, inverse = np.unique(keys, return_inverse=True)
+            merged = np.zeros(len(unique_keys), dtype=np.float64)
+            np.add.at(merged, inverse, wgt)
+
+            # One add() per (joint, weight) run instead of per vertex: rigid
+            # and evenly split influences share a handful of weight values
+            vtx_ids, jnt_ids = np.divmod(unique_keys, len(joints))
+            weights = merged.astype(np.float32)
+            order = np.lexsort((weights, jnt_ids))
+            vtx_ids, jnt_ids, weights = vtx_ids[order], jnt_ids[order], weights[order]
+            starts = np.flatnonzero(np.r_[True, (np.diff(jnt_ids) != 0) | (np.diff(weights) != 0)])
+            ends = np.r_[starts[1:], len(order)]
+            for start, end in zip(starts.tolist(), ends.tolist()):
+                group_map[int(jnt_ids[start])].add(vtx_ids[start:end].tolist(), float(weights[start]), 'REPLACE')
+
+    return obj
+
+
+def load(operator, context, filepath, load_skl_file=True, split_by_material=False, auto_load_textures=True, game_folder=""):
+    prefetch = None
+    wad = None
     try:
-        indices, vertices, submeshes = read_skn(filepath)
+        # Textures decode on native threads while the mesh is built
+        if auto_load_textures:
+            try:
+                # Files extracted since the last import are found on a miss
+                texture_manager.reset_fs_index_misses()
+                # What isn't extracted is read from the champion's WAD
+                wad = texture_manager.open_character_wad(game_folder, filepath)
+                prefetch = texture_manager.TexturePrefetch(filepath, wad=wad)
+            except Exception as e:
+                print(f"Texture prefetch failed: {e}")
+
+        skn_arrays = read_skn_native(filepath)
+        if skn_arrays is None:
+            indices, vertices, submeshes = read_skn(filepath)
+            vertex_count = len(vertices)
+        else:
+            vertex_count = skn_arrays.vertex_count
         
         armature_obj = None
         joints = None
@@ -188,11 +386,14 @@ def load(operator, context, filepath, load_skl_file=True, split_by_material=Fals
                     operator.report({'WARNING'}, f'SKL load failed: {str(e)}')
         
         name = os.path.splitext(os.path.basename(filepath))[0]
-        mesh_obj = create_mesh(indices, vertices, submeshes, name, armature_obj, joints, influences)
+        if skn_arrays is None:
+            mesh_obj = create_mesh(indices, vertices, submeshes, name, armature_obj, joints, influences)
+        else:
+            mesh_obj = create_mesh_native(skn_arrays, name, armature_obj, joints, influences)
 
         if auto_load_textures:
             try:
-                texture_manager.import_textures(mesh_obj, filepath)
+                texture_manager.import_textures(mesh_obj, filepath, prefetch)
             except Exception as e:
                 print(f"Texture import warnings: {e}")
                 import traceback
@@ -235,7 +436,7 @@ def load(operator, context, filepath, load_skl_file=True, split_by_material=Fals
             # Save to custom property as JSON
             armature_obj["lol_bind_pose"] = json.dumps(bind_pose_data)
         
-        operator.report({'INFO'}, f'Imported {len(vertices)} vertices')
+        operator.report({'INFO'}, f'Imported {vertex_count} vertices')
         return {'FINISHED'}
     
     except Exception as e:
@@ -243,3 +444,8 @@ def load(operator, context, filepath, load_skl_file=True, split_by_material=Fals
         import traceback
         traceback.print_exc()
         return {'CANCELLED'}
+    finally:
+        if prefetch:
+            prefetch.close()
+        if wad:
+            wad.close()
@@ -2,7 +2,13 @@ import bpy
 import os
 import tempfile
 import numpy as np
-from ..utils.texture_manager import tex_to_dds_bytes
+from bpy.props import StringProperty, EnumProperty, BoolProperty
+from bpy_extras.io_utils import ExportHelper
+from ..utils.texture_manager import tex_to_dds_bytes_batch, tex_to_dds_file, tex_cache_stats, native_decoder_available, decode_tex_pixels
+from ..utils.texture_manager import native_encoder_available, encode_tex_pixels, TEX_FORMAT_DXT1, TEX_FORMAT_DXT5, TEX_FORMAT_BGRA8
+
+# TEX files converted per native batch call (bounds DDS bytes held in memory)
+RELOAD_BATCH_SIZE = 16
 
 
 class LOL_OT_ReloadTextures(bpy.types.Operator):
@@ -13,52 +19,188 @@ class LOL_OT_ReloadTextures(bpy.types.Operator):
     def execute(self, context):
         count = 0
 
+        reload_list = []
         for img in bpy.data.images:
             source_path = img.get("lol_source_path")
-            if not source_path or not os.path.exists(source_path):
-                continue
+            if source_path and os.path.exists(source_path):
+                reload_list.append((img, source_path))
+
+        for start in range(0, len(reload_list), RELOAD_BATCH_SIZE):
+            chunk = reload_list[start:start + RELOAD_BATCH_SIZE]
+
+            # TEX files are decoded straight to pixels when possible; the
+            # rest (and the files the decoder rejects) go through DDS
+            pending = []
+            for img, source_path in chunk:
+                if source_path.lower().endswith('.tex') and native_decoder_available() and self.decode_image(img, source_path):
+                    count += 1
+                else:
+                    pending.append((img, source_path))
+
+            # Convert the remaining TEX files in one parallel native call,
+            # unless they come from the DDS cache
+            tex_paths = [path for _, path in pending if path.lower().endswith('.tex')]
+            dds_map = {}
+            if tex_paths and tex_cache_stats() is None:
+                try:
+                    dds_map = dict(zip(tex_paths, tex_to_dds_bytes_batch(tex_paths)))
+                except Exception as e:
+                    print(f"Aventurine: {e}")
+
+            for img, source_path in pending:
+                if self.reload_image(img, source_path, dds_map):
+                    count += 1
+
+        self.report({'INFO'}, f"Reloaded {count} textures")
+        return {'FINISHED'}
+
+    @staticmethod
+    def decode_image(img, source_path):
+        """Direct decode: no temp file, no intermediate Blender image"""
+        try:
+            width, height, pixels = decode_tex_pixels(source_path)
+            if img.size[0] != width or img.size[1] != height:
+                img.scale(width, height)
+            img.pixels.foreach_set(pixels)
+            return True
+        except Exception as e:
+            print(f"Aventurine: Direct decode of {img.name} failed, reloading through DDS: {e}")
+            return False
 
-            temp_dds_path = None
-            try:
-                load_path = source_path
+    @staticmethod
+    def reload_image(img, source_path, dds_map):
+        temp_dds_path = None
+        try:
+            load_path = source_path
 
-                # Convert TEX to temp DDS if needed
-                if source_path.lower().endswith('.tex'):
-                    dds_bytes = tex_to_dds_bytes(source_path)
+            # Write converted TEX to temp DDS if needed
+            if source_path.lower().endswith('.tex'):
+                dds_bytes = dds_map.get(source_path)
+                if dds_bytes is None:
+                    load_path, is_temp = tex_to_dds_file(source_path)
+                    if is_temp:
+                        temp_dds_path = load_path
+                else:
                     fd, temp_dds_path = tempfile.mkstemp(suffix='.dds')
                     os.close(fd)
                     with open(temp_dds_path, 'wb') as f:
                         f.write(dds_bytes)
                     load_path = temp_dds_path
 
-                # Load with Blender native
-                temp_img = bpy.data.images.load(load_path, check_existing=False)
+            # Load with Blender native
+            temp_img = bpy.data.images.load(load_path, check_existing=False)
 
-                # Get pixels and update existing image using fast numpy transfer
-                width, height = temp_img.size
+            # Get pixels and update existing image using fast numpy transfer
+            width, height = temp_img.size
 
-                if img.size[0] != width or img.size[1] != height:
-                    img.scale(width, height)
+            if img.size[0] != width or img.size[1] != height:
+                img.scale(width, height)
 
-                # Fast pixel transfer using foreach_get/foreach_set
-                pixel_count = width * height * 4
-                pixels = np.empty(pixel_count, dtype=np.float32)
-                temp_img.pixels.foreach_get(pixels)
-                img.pixels.foreach_set(pixels)
+            # Fast pixel transfer using foreach_get/foreach_set
+            pixel_count = width * height * 4
+            pixels = np.empty(pixel_count, dtype=np.float32)
+            temp_img.pixels.foreach_get(pixels)
+            img.pixels.foreach_set(pixels)
 
-                # Remove temp image
-                bpy.data.images.remove(temp_img)
+            # Remove temp image
+            bpy.data.images.remove(temp_img)
 
-                # Clean up temp file
-                if temp_dds_path and os.path.exists(temp_dds_path):
-                    os.remove(temp_dds_path)
+            # Clean up temp file
+            if temp_dds_path and os.path.exists(temp_dds_path):
+                os.remove(temp_dds_path)
 
-                count += 1
+            return True
 
-            except Exception as e:
-                print(f"Aventurine: Failed to reload {img.name}: {e}")
-                if temp_dds_path and os.path.exists(temp_dds_path):
-                    os.remove(temp_dds_path)
+        except Exception as e:
+            print(f"Aventurine: Failed to reload {img.name}: {e}")
+            if temp_dds_path and os.path.exists(temp_dds_path):
+                os.remove(temp_dds_path)
+            return False
 
-        self.report({'INFO'}, f"Reloaded {count} textures")
+
+class LOL_OT_SaveTextureAsTex(bpy.types.Operator, ExportHelper):
+    """Saves an image as a League TEX file (BC1/BC3/BGRA8 with mipmaps)"""
+    bl_idname = "lol.save_texture_as_tex"
+    bl_label = "Save as TEX"
+
+    filename_ext = ".tex"
+    filter_glob: StringProperty(default="*.tex", options={'HIDDEN'})
+
+    image_name: StringProperty(name="Image", description="Image to save")
+
+    tex_format: EnumProperty(
+        name="Format",
+        items=[
+            (str(TEX_FORMAT_DXT5), "DXT5 (BC3)", "Compressed with full alpha"),
+            (str(TEX_FORMAT_DXT1), "DXT1 (BC1)", "Compressed, alpha below 0.5 becomes transparent"),
+            (str(TEX_FORMAT_BGRA8), "BGRA8", "Uncompressed"),
+        ],
+        default=str(TEX_FORMAT_DXT5)
+    )
+
+    mipmaps: BoolProperty(name="Mipmaps", description="Generate the full mip chain", default=True)
+
+    kaiser: BoolProperty(
+        name="Sharp Mips",
+        description="Filter mips with a Kaiser-windowed sinc instead of a 2x2 box",
+        default=False
+    )
+
+    @classmethod
+    def poll(cls, context):
+        return native_encoder_available()
+
+    def invoke(self, context, event):
+        image = self.context_image(context)
+        if image:
+            self.image_name = image.name
+            # Next to the source, but never onto it: the encode is lossy and
+            # the source is usually the game's own TEX
+            source_path = image.get("lol_source_path") or image.filepath
+            if source_path:
+                self.filepath = os.path.splitext(bpy.path.abspath(source_path))[0] + "_edited.tex"
+            else:
+                self.filepath = bpy.path.clean_name(image.name) + "_edited.tex"
+        return super().invoke(context, event)
+
+    @staticmethod
+    def context_image(context):
+        """Image of the image editor, or of the active material's first image node"""
+        space = context.space_data
+        if space and space.type == 'IMAGE_EDITOR' and space.image:
+            return space.image
+        obj = context.active_object
+        mat = obj.active_material if obj else None
+        if mat and mat.node_tree:
+            for node in mat.node_tree.nodes:
+                if node.type == 'TEX_IMAGE' and node.image:
+                    return node.image
+        return None
+
+    def draw(self, context):
+        layout = self.layout
+        layout.prop_search(self, "image_name", bpy.data, "images")
+        layout.prop(self, "tex_format")
+        layout.prop(self, "mipmaps")
+        if self.mipmaps:
+            layout.prop(self, "kaiser")
+
+    def execute(self, context):
+        image = bpy.data.images.get(self.image_name)
+        if not image or image.size[0] == 0 or image.size[1] == 0:
+            self.report({'ERROR'}, "No image with pixels selected")
+            return {'CANCELLED'}
+
+        width, height = image.size
+        pixels = np.empty(width * height * 4, dtype=np.float32)
+        image.pixels.foreach_get(pixels)
+        try:
+            encode_tex_pixels(self.filepath, width, height, pixels, tex_format=int(self.tex_format),
+                              mipmaps=self.mipmaps, kaiser=self.kaiser,
+                              srgb=image.colorspace_settings.name == 'sRGB')
+        except Exception as e:
+            self.report({'ERROR'}, f"Failed to save {image.name}: {e}")
+            return {'CANCELLED'}
+
+        self.report({'INFO'}, f"Saved {image.name} as {os.path.basename(self.filepath)}")
         return {'FINISHED'}
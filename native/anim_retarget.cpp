@@ -0,0 +1,309 @@
+/*
+ * Animation baking - turns keyed TRS tracks into pose bone F-curve keys
+ * Compiled into lol_native.dll alongside lol_native.cpp
+ *
+ * Every key is rebuilt as basis = pre @ (T @ R @ S) @ post and decomposed
+ * back into location / rotation_quaternion / scale the way mathutils'
+ * Matrix.decompose does. pre and post carry each bone's rest-pose delta:
+ * the LoL -> Blender space change and bind corrections for apply_anm, or
+ * the rest orientation difference between two rigs for the retarget tool.
+ * Results come back as (frame, value) pairs per F-curve, ready for
+ * keyframe_points.foreach_set('co'). Matrices are row-major 4x4 like
+ * mathutils, acting on column vectors.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "platform.h"
+#include "thread_pool.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define LOL_NATIVE_X64 1
+    #include <immintrin.h>
+#endif
+
+// ============================================================================
+// Bake Description
+// ============================================================================
+
+// Same bits as ANM_DATA.key_flags in lol_native.cpp
+#define ANM_KEY_TRANSLATION  0x1
+#define ANM_KEY_ROTATION     0x2
+#define ANM_KEY_SCALE        0x4
+
+#define ANM_BAKE_FLIP        0x1   // Mirror track values across X first: t = (-x, y, z), r = (x, -y, -z, w)
+#define ANM_BAKE_BIND_KEY    0x2   // Also key every tracked bone at bind_frame from its defaults (never flipped)
+
+// Per-bone defaults, ANM_BAKE_DEFAULTS floats per bone: translation xyz,
+// rotation xyzw, scale xyz. Used for channels a key doesn't carry.
+#define ANM_BAKE_DEFAULTS    10
+
+// Output channels per bone: location xyz, rotation_quaternion wxyz, scale xyz
+#define ANM_BAKE_CHANNELS    10
+
+typedef struct {
+    uint32_t track_count;
+    uint32_t frame_slots;
+    const uint8_t* key_flags;       // track_count * frame_slots, ANM_KEY_* (ANM_DATA layout)
+    const float* translations;      // track_count * frame_slots * 3
+    const float* rotations;         // track_count * frame_slots * 4 (x, y, z, w)
+    const float* scales;            // track_count * frame_slots * 3
+    const float* slot_frames;       // frame_slots: Blender frame each slot is keyed at
+
+    uint32_t bone_count;
+    uint32_t flags;                 // ANM_BAKE_*
+    const int32_t* bone_tracks;     // bone_count: track driving each bone, or -1
+    const float* pre;               // bone_count * 16
+    const float* post;              // bone_count * 16
+    const float* defaults;          // bone_count * ANM_BAKE_DEFAULTS
+    float translation_scale;        // Applied to track translations (not to defaults)
+    float bind_frame;
+} ANM_BAKE;
+
+// ============================================================================
+// Matrix Math
+// ============================================================================
+
+static inline void mat4_mul(const float* a, const float* b, float* out) {
+#ifdef LOL_NATIVE_X64
+    const __m128 b0 = _mm_loadu_ps(b);
+    const __m128 b1 = _mm_loadu_ps(b + 4);
+    const __m128 b2 = _mm_loadu_ps(b + 8);
+    const __m128 b3 = _mm_loadu_ps(b + 12);
+    for (int r = 0; r < 4; r++) {
+        const float* row = a + r * 4;
+        __m128 v = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+        _mm_storeu_ps(out + r * 4, v);
+    }
+#else
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 4; c++) {
+            out[r * 4 + c] = a[r * 4] * b[c] + a[r * 4 + 1] * b[4 + c] +
+                             a[r * 4 + 2] * b[8 + c] + a[r * 4 + 3] * b[12 + c];
+        }
+    }
+#endif
+}
+
+// T @ R @ S from a translation, an (x, y, z, w) quaternion and a scale
+static inline void compose_trs(const float* t, const float* q, const float* s, float* out) {
+    float x = q[0], y = q[1], z = q[2], w = q[3];
+    float xx = 2.0f * x * x, yy = 2.0f * y * y, zz = 2.0f * z * z;
+    float xy = 2.0f * x * y, xz = 2.0f * x * z, yz = 2.0f * y * z;
+    float wx = 2.0f * w * x, wy = 2.0f * w * y, wz = 2.0f * w * z;
+
+    out[0] = (1.0f - yy - zz) * s[0]; out[1] = (xy - wz) * s[1];        out[2] = (xz + wy) * s[2];         out[3] = t[0];
+    out[4] = (xy + wz) * s[0];        out[5] = (1.0f - xx - zz) * s[1]; out[6] = (yz - wx) * s[2];         out[7] = t[1];
+    out[8] = (xz - wy) * s[0];        out[9] = (yz + wx) * s[1];        out[10] = (1.0f - xx - yy) * s[2]; out[11] = t[2];
+    out[12] = 0.0f;                   out[13] = 0.0f;                   out[14] = 0.0f;                    out[15] = 1.0f;
+}
+
+// Matrix.decompose: location, (w, x, y, z) rotation and scale, with a
+// negative determinant folded into the scale
+static inline void decompose(const float* m, float* loc, float* quat, float* size) {
+    float rot[3][3];
+    for (int c = 0; c < 3; c++) {
+        float len = sqrtf(m[c] * m[c] + m[4 + c] * m[4 + c] + m[8 + c] * m[8 + c]);
+        float inv = len > 1e-35f ? 1.0f / len : 0.0f;
+        for (int r = 0; r < 3; r++) rot[r][c] = m[r * 4 + c] * inv;
+        size[c] = len;
+    }
+
+    float det = rot[0][0] * (rot[1][1] * rot[2][2] - rot[1][2] * rot[2][1]) -
+                rot[0][1] * (rot[1][0] * rot[2][2] - rot[1][2] * rot[2][0]) +
+                rot[0][2] * (rot[1][0] * rot[2][1] - rot[1][1] * rot[2][0]);
+    if (det < 0.0f) {
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) rot[r][c] = -rot[r][c];
+        }
+        for (int c = 0; c < 3; c++) size[c] = -size[c];
+    }
+
+    loc[0] = m[3]; loc[1] = m[7]; loc[2] = m[11];
+
+    float w, x, y, z;
+    float trace = rot[0][0] + rot[1][1] + rot[2][2];
+    if (trace > 0.0f) {
+        float s = 0.5f / sqrtf(trace + 1.0f);
+        w = 0.25f / s;
+        x = (rot[2][1] - rot[1][2]) * s;
+        y = (rot[0][2] - rot[2][0]) * s;
+        z = (rot[1][0] - rot[0][1]) * s;
+    } else if (rot[0][0] > rot[1][1] && rot[0][0] > rot[2][2]) {
+        float s = 2.0f * sqrtf(1.0f + rot[0][0] - rot[1][1] - rot[2][2]);
+        w = (rot[2][1] - rot[1][2]) / s;
+        x = 0.25f * s;
+        y = (rot[0][1] + rot[1][0]) / s;
+        z = (rot[0][2] + rot[2][0]) / s;
+    } else if (rot[1][1] > rot[2][2]) {
+        float s = 2.0f * sqrtf(1.0f + rot[1][1] - rot[0][0] - rot[2][2]);
+        w = (rot[0][2] - rot[2][0]) / s;
+        x = (rot[0][1] + rot[1][0]) / s;
+        y = 0.25f * s;
+        z = (rot[1][2] + rot[2][1]) / s;
+    } else {
+        float s = 2.0f * sqrtf(1.0f + rot[2][2] - rot[0][0] - rot[1][1]);
+        w = (rot[1][0] - rot[0][1]) / s;
+        x = (rot[0][2] + rot[2][0]) / s;
+        y = (rot[1][2] + rot[2][1]) / s;
+        z = 0.25f * s;
+    }
+
+    // Canonical sign (w >= 0) and unit length, like mat3_normalized_to_quat
+    float len = sqrtf(w * w + x * x + y * y + z * z);
+    float inv = len > 1e-35f ? (w < 0.0f ? -1.0f : 1.0f) / len : 0.0f;
+    quat[0] = w * inv; quat[1] = x * inv; quat[2] = y * inv; quat[3] = z * inv;
+}
+
+// ============================================================================
+// Baking
+// ============================================================================
+
+/*
+ * Bake keyed tracks into per-F-curve (frame, value) pairs.
+ *
+ * For each bone with a track, every slot with a key becomes
+ * basis = pre @ (T @ R @ S) @ post, with channels the key lacks taken
+ * from the bone's defaults, and is written only to the channel groups the
+ * key carries (location for ANM_KEY_TRANSLATION, and so on).
+ *
+ * Parameters:
+ *   bake       - Tracks, bone mapping and per-bone rest deltas
+ *   out_counts - bone_count * 3 keys per channel group (location, rotation,
+ *                scale); every F-curve in a group has that many keys
+ *   out_keys   - Receives the pairs (free with free_bytes), NULL when nothing
+ *                was keyed. Laid out bone by bone, then location x, y, z,
+ *                rotation_quaternion w, x, y, z and scale x, y, z, each
+ *                count * 2 floats in slot order with the bind key first.
+ *
+ * Returns: 0 on success, -4 allocation failure, -5 invalid arguments
+ */
+DLL_EXPORT int anm_bake_fcurves(const ANM_BAKE* bake, uint32_t* out_counts, float** out_keys) {
+    if (!bake || !out_counts || !out_keys) return -5;
+    *out_keys = nullptr;
+
+    const uint32_t bone_count = bake->bone_count;
+    const uint32_t slots = bake->frame_slots;
+    if (bone_count == 0) return 0;
+    if (!bake->bone_tracks || !bake->pre || !bake->post || !bake->defaults) return -5;
+    if (bake->track_count > 0 && slots > 0 &&
+        (!bake->key_flags || !bake->translations || !bake->rotations || !bake->scales || !bake->slot_frames)) {
+        return -5;
+    }
+
+    const bool bind_key = (bake->flags & ANM_BAKE_BIND_KEY) != 0;
+    const bool flip = (bake->flags & ANM_BAKE_FLIP) != 0;
+
+    float* keys = nullptr;
+    try {
+        // Keys per channel group, then each bone's float offset into the output
+        std::vector<size_t> offsets(bone_count + 1, 0);
+        for (uint32_t b = 0; b < bone_count; b++) {
+            uint32_t* counts = out_counts + (size_t)b * 3;
+            counts[0] = counts[1] = counts[2] = 0;
+
+            int32_t track = bake->bone_tracks[b];
+            if (track < 0 || (uint32_t)track >= bake->track_count) {
+                offsets[b + 1] = offsets[b];
+                continue;
+            }
+
+            if (bind_key) counts[0] = counts[1] = counts[2] = 1;
+            const uint8_t* flags = bake->key_flags + (size_t)track * slots;
+            for (uint32_t s = 0; s < slots; s++) {
+                counts[0] += (flags[s] & ANM_KEY_TRANSLATION) != 0;
+                counts[1] += (flags[s] & ANM_KEY_ROTATION) != 0;
+                counts[2] += (flags[s] & ANM_KEY_SCALE) != 0;
+            }
+            offsets[b + 1] = offsets[b] + ((size_t)counts[0] * 3 + (size_t)counts[1] * 4 + (size_t)counts[2] * 3) * 2;
+        }
+
+        if (offsets[bone_count] == 0) return 0;
+        keys = (float*)malloc(offsets[bone_count] * sizeof(float));
+        if (!keys) return -4;
+
+        global_thread_pool().parallel_for(bone_count, 0, [&](size_t b) {
+            const uint32_t* counts = out_counts + b * 3;
+            if (offsets[b + 1] == offsets[b]) return;
+
+            // Channel c of this bone starts at channel[c]; each group's
+            // curves advance together, one (frame, value) pair per key
+            float* channel[ANM_BAKE_CHANNELS];
+            float* cursor = keys + offsets[b];
+            for (int c = 0; c < ANM_BAKE_CHANNELS; c++) {
+                channel[c] = cursor;
+                cursor += (size_t)counts[c < 3 ? 0 : (c < 7 ? 1 : 2)] * 2;
+            }
+
+            const float* pre = bake->pre + b * 16;
+            const float* post = bake->post + b * 16;
+            const float* def = bake->defaults + b * ANM_BAKE_DEFAULTS;
+            size_t written[3] = { 0, 0, 0 };
+
+            auto emit = [&](float frame, uint32_t groups, const float* t, const float* r, const float* s) {
+                float local[16], tmp[16], basis[16];
+                compose_trs(t, r, s, local);
+                mat4_mul(pre, local, tmp);
+                mat4_mul(tmp, post, basis);
+
+                float values[ANM_BAKE_CHANNELS];
+                decompose(basis, values, values + 3, values + 7);
+
+                static const int group_first[3] = { 0, 3, 7 };
+                static const int group_size[3] = { 3, 4, 3 };
+                for (int g = 0; g < 3; g++) {
+                    if (!(groups & (1u << g))) continue;
+                    size_t k = written[g]++;
+                    for (int i = 0; i < group_size[g]; i++) {
+                        int c = group_first[g] + i;
+                        channel[c][k * 2] = frame;
+                        channel[c][k * 2 + 1] = values[c];
+                    }
+                }
+            };
+
+            if (bind_key) {
+                emit(bake->bind_frame, ANM_KEY_TRANSLATION | ANM_KEY_ROTATION | ANM_KEY_SCALE,
+                     def, def + 3, def + 7);
+            }
+
+            const size_t track = (size_t)bake->bone_tracks[b];
+            const uint8_t* flags = bake->key_flags + track * slots;
+            for (uint32_t s = 0; s < slots; s++) {
+                uint32_t key = flags[s] & (ANM_KEY_TRANSLATION | ANM_KEY_ROTATION | ANM_KEY_SCALE);
+                if (!key) continue;
+
+                size_t slot = track * slots + s;
+                float t[3], r[4], sc[3];
+                if (key & ANM_KEY_TRANSLATION) {
+                    for (int i = 0; i < 3; i++) t[i] = bake->translations[slot * 3 + i] * bake->translation_scale;
+                } else {
+                    memcpy(t, def, sizeof(t));
+                }
+                memcpy(r, key & ANM_KEY_ROTATION ? bake->rotations + slot * 4 : def + 3, sizeof(r));
+                memcpy(sc, key & ANM_KEY_SCALE ? bake->scales + slot * 3 : def + 7, sizeof(sc));
+
+                if (flip) {
+                    t[0] = -t[0];
+                    r[1] = -r[1];
+                    r[2] = -r[2];
+                }
+                emit(bake->slot_frames[s], key, t, r, sc);
+            }
+        });
+
+        *out_keys = keys;
+        return 0;
+    } catch (const std::bad_alloc&) {
+        free(keys);
+        return -4;
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/*
+ * Monotonic arena for ritobin parse trees
+ *
+ * ritobin containers use the default allocator, so the arena is reached
+ * through operator new: while an ArenaScope is active on a thread, the
+ * DLL's operator new carves small blocks out of that scope's arena and
+ * operator delete ignores them. A tree built that way is never destroyed;
+ * releasing the arena drops it in one go.
+ *
+ * Memory bumped from an arena must only be freed on the thread and scope
+ * it came from (delete checks the current arena), or not at all. Blocks
+ * the arena can't provide fall back to the heap and are freed normally.
+ *
+ * That only holds where all std code runs inside the DLL, i.e. with the
+ * header-only MSVC STL. libstdc++ and libc++ instantiate basic_string in
+ * the shared runtime, whose growth and destructor paths use the runtime's
+ * own operator delete and would free() arena blocks. Elsewhere the DLL
+ * keeps the default operator new and parses onto the heap.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#define BIN_ARENA_SUPPORTED 1
+#else
+#define BIN_ARENA_SUPPORTED 0
+#endif
+
+class BinArena {
+public:
+    BinArena() = default;
+    ~BinArena() { release(); }
+
+    BinArena(const BinArena&) = delete;
+    BinArena& operator=(const BinArena&) = delete;
+
+    // 16-byte aligned block, or NULL when out of memory
+    void* allocate(size_t size) {
+        size = size ? (size + 15) & ~(size_t)15 : 16;
+        if (!head_ || head_->capacity - head_->used < size) {
+            if (!grow(size)) return nullptr;
+        }
+        uint8_t* p = data(head_) + head_->used;
+        head_->used += size;
+        return p;
+    }
+
+    bool owns(const void* p) const {
+        for (const Chunk* c = head_; c; c = c->next) {
+            const uint8_t* begin = data(c);
+            if (p >= begin && p < begin + c->used) return true;
+        }
+        return false;
+    }
+
+    void release() {
+        while (head_) {
+            Chunk* next = head_->next;
+            free(head_);
+            head_ = next;
+        }
+        reserved_ = 0;
+    }
+
+    // Bytes held in chunks
+    size_t reserved() const { return reserved_; }
+
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t capacity;
+        size_t used;
+        size_t pad;             // Keeps the data 16-byte aligned
+    };
+
+    static const size_t FIRST_CHUNK = 64 * 1024;
+    static const size_t MAX_CHUNK = 4 * 1024 * 1024;
+
+    static uint8_t* data(const Chunk* c) { return (uint8_t*)(c + 1); }
+
+    // Chunks double up to MAX_CHUNK, so a parse needs few of them and owns() stays short
+    bool grow(size_t size) {
+        size_t capacity = head_ ? head_->capacity * 2 : FIRST_CHUNK;
+        if (capacity > MAX_CHUNK) capacity = MAX_CHUNK;
+        if (capacity < size) capacity = size;
+
+        Chunk* chunk = (Chunk*)malloc(sizeof(Chunk) + capacity);
+        if (!chunk) return false;
+        chunk->next = head_;
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        head_ = chunk;
+        reserved_ += capacity;
+        return true;
+    }
+
+    Chunk* head_ = nullptr;
+    size_t reserved_ = 0;
+};
+
+inline BinArena*& current_arena() {
+    static thread_local BinArena* arena = nullptr;
+    return arena;
+}
+
+// Routes this thread's small allocations to arena until destroyed (NULL: heap)
+class ArenaScope {
+public:
+    explicit ArenaScope(BinArena* arena) : previous_(current_arena()) { current_arena() = arena; }
+    ~ArenaScope() { current_arena() = previous_; }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    BinArena* previous_;
+};
+
+// Bodies of the DLL's operator new/delete
+inline void* arena_operator_new(size_t size) {
+    BinArena* arena = current_arena();
+    if (arena) {
+        if (void* p = arena->allocate(size)) return p;
+    }
+    return malloc(size ? size : 1);
+}
+
+inline void arena_operator_delete(void* p) {
+    if (!p) return;
+    BinArena* arena = current_arena();
+    if (arena && arena->owns(p)) return;
+    free(p);
+}
+
+#endif // ARENA_H
@@ -0,0 +1,71 @@
+#ifndef BIN_FIELD_INDEX_H
+#define BIN_FIELD_INDEX_H
+
+/*
+ * Hash index over the fields of a ritobin Embed or Pointer, for embeds
+ * that are queried for several fields
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../ritobin-master/ritobin_lib/src/ritobin/bin_types.hpp"
+
+class FieldIndex {
+public:
+    // The index refers to fields, which must outlive it
+    explicit FieldIndex(const std::vector<ritobin::Field>& fields) : fields_(fields) {
+        if (fields.size() <= LINEAR_LIMIT) return;
+
+        size_t capacity = 16;
+        while (capacity < fields.size() * 2) capacity <<= 1;
+        mask_ = (uint32_t)capacity - 1;
+        slots_.assign(capacity, Slot{ 0, EMPTY });
+
+        for (uint32_t i = 0; i < (uint32_t)fields.size(); i++) {
+            uint32_t hash = fields[i].key.hash();
+            uint32_t s = slot_of(hash);
+            while (slots_[s].index != EMPTY && slots_[s].hash != hash) s = (s + 1) & mask_;
+            // Keep the first field of a hash, like a linear scan would
+            if (slots_[s].index == EMPTY) slots_[s] = Slot{ hash, i };
+        }
+    }
+
+    const ritobin::Field* find(uint32_t hash) const {
+        if (slots_.empty()) return scan(fields_, hash);
+
+        for (uint32_t s = slot_of(hash);; s = (s + 1) & mask_) {
+            const Slot& slot = slots_[s];
+            if (slot.index == EMPTY) return nullptr;
+            if (slot.hash == hash) return &fields_[slot.index];
+        }
+    }
+
+    // Single lookups don't pay for building a table
+    static const ritobin::Field* scan(const std::vector<ritobin::Field>& fields, uint32_t hash) {
+        for (const auto& field : fields) {
+            if (field.key.hash() == hash) return &field;
+        }
+        return nullptr;
+    }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t index;
+    };
+
+    // Embeds this small are faster to scan than to hash
+    static const size_t LINEAR_LIMIT = 8;
+    static const uint32_t EMPTY = 0xffffffff;
+
+    // Field keys are FNV-1a already; fold the high bits in for small tables
+    uint32_t slot_of(uint32_t hash) const { return (hash ^ (hash >> 16)) & mask_; }
+
+    const std::vector<ritobin::Field>& fields_;
+    std::vector<Slot> slots_;
+    uint32_t mask_ = 0;
+};
+
+#endif // BIN_FIELD_INDEX_H
@@ -2,17 +2,32 @@
  * BIN Parser DLL - Fast BIN texture path extraction for Blender addon
  */
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cstdint>
+#include <cwctype>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <fstream>
-#include <sstream>
+#include <new>
+
+#include "arena.h"
+#include "bin_field_index.h"
+#include "binary_reader.h"
+#include "file_map.h"
+#include "native_stats.h"
+#include "platform.h"
+#include "thread_pool.h"
+
+#ifndef _WIN32
+    #include <sys/stat.h>
+#endif
 
 #include "../ritobin-master/ritobin_lib/src/ritobin/bin_types.hpp"
 #include "../ritobin-master/ritobin_lib/src/ritobin/bin_types_helper.hpp"
@@ -37,12 +52,6 @@ namespace ritobin::io {
     static BinCompatDefault g_compat_default;
 }
 
-#ifdef BUILD_DLL
-    #define DLL_EXPORT extern "C" __declspec(dllexport)
-#else
-    #define DLL_EXPORT extern "C" __declspec(dllimport)
-#endif
-
 // Hash constants for BIN field lookup
 static const uint32_t HASH_SKIN_MESH_PROPERTIES = 0x45ff5904;
 static const uint32_t HASH_TEXTURE = 0x3c6468f4;
@@ -52,6 +61,9 @@ static const uint32_t HASH_MATERIAL_LINK = 0xd2e4d060;
 static const uint32_t HASH_SAMPLER_VALUES = 0x0a6f0eb5;
 static const uint32_t HASH_PROP_NAME = 0xb311d4ef;
 static const uint32_t HASH_PROP_VALUE = 0xf0a363e3;
+static const uint32_t HASH_PARAM_VALUES = 0xd0ab46b8;
+static const uint32_t HASH_PARAM_NAME = 0x8d39bde6;
+static const uint32_t HASH_PARAM_VALUE = 0x425ed3ca;
 
 static std::string get_string(const ritobin::Value& val) {
     if (auto* s = std::get_if<ritobin::String>(&val)) {
@@ -80,33 +92,69 @@ static const ritobin::List2* get_list2(const ritobin::Value& val) {
 }
 
 static const ritobin::Field* find_field(const ritobin::Embed& embed, uint32_t hash) {
-    for (const auto& field : embed.items) {
-        if (field.key.hash() == hash) {
-            return &field;
-        }
-    }
-    return nullptr;
+    return FieldIndex::scan(embed.items, hash);
 }
 
-static std::string extract_textures(const ritobin::Bin& bin) {
-    std::unordered_map<std::string, std::string> results;
-    std::unordered_map<uint32_t, const ritobin::Embed*> entries_map;
+// ============================================================================
+// Submesh Bindings
+// ============================================================================
+
+// What skinMeshProperties assigns to one submesh: its default ("BASE") or a
+// materialOverride entry
+struct SubmeshBinding {
+    std::string name;
+    std::string texture;                            // Direct texture field, may be empty
+    uint32_t material_hash = 0;                     // Linked StaticMaterialDef, 0 if none
+    const ritobin::Embed* material = nullptr;       // NULL when the link isn't in this file
+    const FieldIndex* material_fields = nullptr;
+    bool is_default = false;
+};
 
+static const ritobin::Map* get_entries(const ritobin::Bin& bin) {
     auto entries_it = bin.sections.find("entries");
-    if (entries_it == bin.sections.end()) return "";
+    if (entries_it == bin.sections.end()) return nullptr;
+    return std::get_if<ritobin::Map>(&entries_it->second);
+}
+
+// Calls visit for every binding of every skinMeshProperties of bins[0], in
+// file order. Material links resolve against the entries of all bins; the
+// skin BIN comes first, then its linked BINs in the order given.
+template <typename Visit>
+static void walk_submesh_bindings(const std::vector<const ritobin::Bin*>& bins, Visit&& visit) {
+    std::unordered_map<uint32_t, const ritobin::Embed*> entries_map;
+    // Materials are often linked from several overrides, so their index is kept
+    std::unordered_map<const ritobin::Embed*, FieldIndex> material_fields;
 
-    const auto* entries_map_val = std::get_if<ritobin::Map>(&entries_it->second);
-    if (!entries_map_val) return "";
+    if (bins.empty()) return;
+    const auto* entries_map_val = get_entries(*bins[0]);
+    if (!entries_map_val) return;
 
-    // Build hash->entry map
-    for (const auto& pair : entries_map_val->items) {
-        if (auto* key_hash = std::get_if<ritobin::Hash>(&pair.key)) {
-            if (auto* entry = std::get_if<ritobin::Embed>(&pair.value)) {
-                entries_map[key_hash->value.hash()] = entry;
+    // Build hash->entry map. Later bins go in first so earlier ones override
+    // them; within a file the last entry of a hash wins
+    for (size_t b = bins.size(); b-- > 0;) {
+        const auto* bin_entries = get_entries(*bins[b]);
+        if (!bin_entries) continue;
+        for (const auto& pair : bin_entries->items) {
+            if (auto* key_hash = std::get_if<ritobin::Hash>(&pair.key)) {
+                if (auto* entry = std::get_if<ritobin::Embed>(&pair.value)) {
+                    entries_map[key_hash->value.hash()] = entry;
+                }
             }
         }
     }
 
+    auto resolve_material = [&](const FieldIndex& fields, SubmeshBinding& binding) {
+        if (auto* mat_field = fields.find(HASH_MATERIAL_LINK)) {
+            binding.material_hash = get_link(mat_field->value);
+        }
+        if (binding.material_hash == 0) return;
+
+        auto mat_it = entries_map.find(binding.material_hash);
+        if (mat_it == entries_map.end()) return;
+        binding.material = mat_it->second;
+        binding.material_fields = &material_fields.try_emplace(binding.material, binding.material->items).first->second;
+    };
+
     // Find skinMeshProperties entries
     for (const auto& pair : entries_map_val->items) {
         const auto* entry = get_embed(pair.value);
@@ -117,17 +165,20 @@ static std::string extract_textures(const ritobin::Bin& bin) {
 
         const auto* skin_mesh = get_embed(smp_field->value);
         if (!skin_mesh) continue;
+        FieldIndex skin_fields(skin_mesh->items);
 
-        // Get BASE texture
-        if (auto* tex_field = find_field(*skin_mesh, HASH_TEXTURE)) {
-            std::string tex = get_string(tex_field->value);
-            if (!tex.empty()) {
-                results["BASE"] = tex;
-            }
+        // BASE texture and material
+        SubmeshBinding base;
+        base.name = "BASE";
+        base.is_default = true;
+        if (auto* tex_field = skin_fields.find(HASH_TEXTURE)) {
+            base.texture = get_string(tex_field->value);
         }
+        resolve_material(skin_fields, base);
+        if (!base.texture.empty() || base.material_hash != 0) visit(base);
 
         // Process material overrides
-        const auto* mo_field = find_field(*skin_mesh, HASH_MATERIAL_OVERRIDE);
+        const auto* mo_field = skin_fields.find(HASH_MATERIAL_OVERRIDE);
         if (!mo_field) continue;
 
         const auto* override_list = get_list(mo_field->value);
@@ -137,111 +188,1088 @@ static std::string extract_textures(const ritobin::Bin& bin) {
             const auto* override_embed = get_embed(override_item.value);
             if (!override_embed) continue;
 
-            std::string mat_name;
-            std::string tex_path;
-            uint32_t linked_mat_hash = 0;
-
-            if (auto* name_field = find_field(*override_embed, HASH_SUBMESH)) {
-                mat_name = get_string(name_field->value);
+            SubmeshBinding binding;
+            FieldIndex override_fields(override_embed->items);
+            if (auto* name_field = override_fields.find(HASH_SUBMESH)) {
+                binding.name = get_string(name_field->value);
             }
+            if (binding.name.empty()) continue;
 
-            if (auto* tex_field = find_field(*override_embed, HASH_TEXTURE)) {
-                tex_path = get_string(tex_field->value);
+            if (auto* tex_field = override_fields.find(HASH_TEXTURE)) {
+                binding.texture = get_string(tex_field->value);
             }
+            resolve_material(override_fields, binding);
+            visit(binding);
+        }
+    }
+}
 
-            if (auto* mat_field = find_field(*override_embed, HASH_MATERIAL_LINK)) {
-                linked_mat_hash = get_link(mat_field->value);
-            }
+// Calls visit on each embed of a List or List2 field
+template <typename Visit>
+static void for_each_embed(const ritobin::Field& field, Visit&& visit) {
+    auto visit_item = [&](const ritobin::Element& item) {
+        if (const auto* embed = get_embed(item.value)) visit(*embed);
+    };
+
+    // Try List, then List2
+    if (auto* lst = get_list(field.value)) {
+        for (const auto& item : lst->items) visit_item(item);
+    } else if (auto* lst2 = get_list2(field.value)) {
+        for (const auto& item : lst2->items) visit_item(item);
+    }
+}
+
+// Samplers of a StaticMaterialDef that have both a name and a path
+static void collect_samplers(const SubmeshBinding& binding,
+                             std::vector<std::pair<std::string, std::string>>& out) {
+    if (!binding.material_fields) return;
+    const auto* samplers_field = binding.material_fields->find(HASH_SAMPLER_VALUES);
+    if (!samplers_field) return;
 
-            // Follow material link if no direct texture
-            if (tex_path.empty() && linked_mat_hash != 0) {
-                auto mat_it = entries_map.find(linked_mat_hash);
-                if (mat_it != entries_map.end()) {
-                    const ritobin::Embed* mat_entry = mat_it->second;
-
-                    if (auto* props_field = find_field(*mat_entry, HASH_SAMPLER_VALUES)) {
-                        auto process_prop = [&](const ritobin::Value& item_val) {
-                            const auto* prop_embed = get_embed(item_val);
-                            if (!prop_embed) return false;
-
-                            std::string p_name, p_val;
-                            if (auto* pn = find_field(*prop_embed, HASH_PROP_NAME)) {
-                                p_name = get_string(pn->value);
-                            }
-                            if (auto* pv = find_field(*prop_embed, HASH_PROP_VALUE)) {
-                                p_val = get_string(pv->value);
-                            }
-
-                            if (p_name == "Diffuse_Texture" && !p_val.empty()) {
-                                tex_path = p_val;
-                                return true;
-                            }
-                            return false;
-                        };
-
-                        // Try List, List2, then Map
-                        if (auto* lst = get_list(props_field->value)) {
-                            for (const auto& item : lst->items) {
-                                if (process_prop(item.value)) break;
-                            }
-                        } else if (auto* lst2 = get_list2(props_field->value)) {
-                            for (const auto& item : lst2->items) {
-                                if (process_prop(item.value)) break;
-                            }
-                        }
+    for_each_embed(*samplers_field, [&](const ritobin::Embed& prop_embed) {
+        std::string p_name, p_val;
+        if (auto* pn = find_field(prop_embed, HASH_PROP_NAME)) {
+            p_name = get_string(pn->value);
+        }
+        if (auto* pv = find_field(prop_embed, HASH_PROP_VALUE)) {
+            p_val = get_string(pv->value);
+        }
+        if (!p_name.empty() && !p_val.empty()) {
+            out.emplace_back(std::move(p_name), std::move(p_val));
+        }
+    });
+}
+
+// Results keyed by submesh in first-seen order. A later binding of the same
+// submesh replaces the earlier one if it resolved to something.
+template <typename T>
+class SubmeshResults {
+public:
+    void add(const std::string& name, T&& value, bool resolved) {
+        auto it = index_.find(name);
+        if (it == index_.end()) {
+            index_.emplace(name, items_.size());
+            items_.emplace_back(name, std::move(value));
+        } else if (resolved) {
+            items_[it->second].second = std::move(value);
+        }
+    }
+
+    std::vector<std::pair<std::string, T>>& items() { return items_; }
+
+private:
+    std::vector<std::pair<std::string, T>> items_;
+    std::unordered_map<std::string, size_t> index_;
+};
+
+// A string in the pool of a result table
+typedef struct {
+    uint32_t offset;
+    uint32_t length;            // In bytes, not NUL terminated
+} BIN_STRING_REF;
+
+// Strings of a result table, stored once each (texture paths repeat across submeshes)
+class StringPool {
+public:
+    BIN_STRING_REF add(const std::string& str) {
+        auto it = offsets_.find(str);
+        if (it != offsets_.end()) return BIN_STRING_REF{ it->second, (uint32_t)str.size() };
+        uint32_t offset = (uint32_t)data_.size();
+        data_ += str;
+        offsets_.emplace(str, offset);
+        return BIN_STRING_REF{ offset, (uint32_t)str.size() };
+    }
+
+    const std::string& data() const { return data_; }
+
+private:
+    std::string data_;
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
+
+// ============================================================================
+// Texture Extraction
+// ============================================================================
+
+#define BIN_TEXTURE_PRIMARY 0x1     // The texture used for the submesh (what parse_bin_textures reports)
+
+// Texture of a submesh, or one of the samplers of its linked material
+struct TextureRow {
+    std::string submesh;        // "BASE" for the skinMeshProperties default
+    std::string texture;
+    std::string sampler;        // Empty for a direct texture field
+    uint32_t flags;
+};
+
+// Rows are grouped by submesh, primary row first
+static std::vector<TextureRow> extract_textures(const std::vector<const ritobin::Bin*>& bins) {
+    struct SubmeshTextures {
+        std::string texture;
+        std::string sampler;
+        std::vector<std::pair<std::string, std::string>> samplers;
+    };
+    SubmeshResults<SubmeshTextures> results;
+
+    walk_submesh_bindings(bins, [&](const SubmeshBinding& binding) {
+        SubmeshTextures textures;
+        textures.texture = binding.texture;
+
+        // Follow the material link for its samplers; Diffuse_Texture is the
+        // submesh texture when the override sets none. BASE only uses its
+        // direct texture.
+        if (!binding.is_default) {
+            collect_samplers(binding, textures.samplers);
+            if (textures.texture.empty()) {
+                for (const auto& sampler : textures.samplers) {
+                    if (sampler.first == "Diffuse_Texture") {
+                        textures.texture = sampler.second;
+                        textures.sampler = sampler.first;
+                        break;
                     }
                 }
             }
+        }
+
+        if (!textures.texture.empty() || !textures.samplers.empty()) {
+            bool resolved = !textures.texture.empty();
+            results.add(binding.name, std::move(textures), resolved);
+        }
+    });
+
+    std::vector<TextureRow> rows;
+    for (auto& [name, textures] : results.items()) {
+        if (!textures.texture.empty()) {
+            rows.push_back(TextureRow{ name, textures.texture, textures.sampler, BIN_TEXTURE_PRIMARY });
+        }
+        for (auto& sampler : textures.samplers) {
+            // The primary row already carries this one
+            if (!textures.sampler.empty() && sampler.first == textures.sampler) continue;
+            rows.push_back(TextureRow{ name, std::move(sampler.second), std::move(sampler.first), 0 });
+        }
+    }
+    return rows;
+}
+
+typedef struct {
+    BIN_STRING_REF submesh;
+    BIN_STRING_REF texture;
+    BIN_STRING_REF sampler;     // Empty for a direct texture field
+    uint32_t flags;             // BIN_TEXTURE_*
+} BIN_TEXTURE_ROW;
+
+// Layout of parse_bin_texture_table results: this header, row_count rows of
+// row_size bytes at offset 16, then the UTF-8 string pool at pool_offset.
+// Readers should step by row_size, rows may grow in later versions.
+typedef struct {
+    uint32_t row_count;
+    uint32_t row_size;
+    uint32_t pool_offset;
+    uint32_t pool_size;
+} BIN_TEXTURE_TABLE;
+
+static std::string build_texture_table(const std::vector<TextureRow>& rows) {
+    StringPool pool;
+    std::vector<BIN_TEXTURE_ROW> table_rows;
+    table_rows.reserve(rows.size());
+    for (const auto& row : rows) {
+        table_rows.push_back(BIN_TEXTURE_ROW{ pool.add(row.submesh), pool.add(row.texture), pool.add(row.sampler), row.flags });
+    }
 
-            if (!mat_name.empty() && !tex_path.empty()) {
-                results[mat_name] = tex_path;
+    BIN_TEXTURE_TABLE header;
+    header.row_count = (uint32_t)table_rows.size();
+    header.row_size = sizeof(BIN_TEXTURE_ROW);
+    header.pool_offset = (uint32_t)(sizeof(BIN_TEXTURE_TABLE) + table_rows.size() * sizeof(BIN_TEXTURE_ROW));
+    header.pool_size = (uint32_t)pool.data().size();
+
+    std::string table;
+    table.reserve(header.pool_offset + header.pool_size);
+    table.append((const char*)&header, sizeof(header));
+    table.append((const char*)table_rows.data(), table_rows.size() * sizeof(BIN_TEXTURE_ROW));
+    table += pool.data();
+    return table;
+}
+
+// The "submesh=path\n" text of parse_bin_textures, from a built table
+static std::string format_texture_lines(const std::string& table) {
+    BIN_TEXTURE_TABLE header;
+    memcpy(&header, table.data(), sizeof(header));
+    const char* pool = table.data() + header.pool_offset;
+
+    std::string lines;
+    for (uint32_t i = 0; i < header.row_count; i++) {
+        BIN_TEXTURE_ROW row;
+        memcpy(&row, table.data() + sizeof(header) + (size_t)i * sizeof(row), sizeof(row));
+        if (!(row.flags & BIN_TEXTURE_PRIMARY)) continue;
+        lines.append(pool + row.submesh.offset, row.submesh.length);
+        lines += '=';
+        lines.append(pool + row.texture.offset, row.texture.length);
+        lines += '\n';
+    }
+    return lines;
+}
+
+// ============================================================================
+// Material Extraction
+// ============================================================================
+
+#define BIN_MATERIAL_RESOLVED 0x1   // The linked material was found in the file
+
+// A paramValues entry; vectors shorter than 4 are zero padded
+struct MaterialParam {
+    std::string name;
+    float value[4];
+    uint32_t components;
+};
+
+static void collect_params(const SubmeshBinding& binding, std::vector<MaterialParam>& out) {
+    if (!binding.material_fields) return;
+    const auto* params_field = binding.material_fields->find(HASH_PARAM_VALUES);
+    if (!params_field) return;
+
+    for_each_embed(*params_field, [&](const ritobin::Embed& param_embed) {
+        MaterialParam param = {};
+        if (auto* pn = find_field(param_embed, HASH_PARAM_NAME)) {
+            param.name = get_string(pn->value);
+        }
+        const auto* pv = find_field(param_embed, HASH_PARAM_VALUE);
+        if (param.name.empty() || !pv) return;
+
+        if (auto* v4 = std::get_if<ritobin::Vec4>(&pv->value)) {
+            memcpy(param.value, v4->value.data(), 16);
+            param.components = 4;
+        } else if (auto* v3 = std::get_if<ritobin::Vec3>(&pv->value)) {
+            memcpy(param.value, v3->value.data(), 12);
+            param.components = 3;
+        } else if (auto* v2 = std::get_if<ritobin::Vec2>(&pv->value)) {
+            memcpy(param.value, v2->value.data(), 8);
+            param.components = 2;
+        } else if (auto* f = std::get_if<ritobin::F32>(&pv->value)) {
+            param.value[0] = f->value;
+            param.components = 1;
+        } else {
+            return;
+        }
+        out.push_back(std::move(param));
+    });
+}
+
+typedef struct {
+    BIN_STRING_REF submesh;
+    BIN_STRING_REF texture;     // Direct texture field, may be empty
+    uint32_t material_hash;     // Linked StaticMaterialDef entry, 0 if none
+    uint32_t flags;             // BIN_MATERIAL_*
+    uint32_t sampler_start;     // Range in the sampler rows
+    uint32_t sampler_count;
+    uint32_t param_start;       // Range in the param rows
+    uint32_t param_count;
+} BIN_MATERIAL_ROW;
+
+typedef struct {
+    BIN_STRING_REF name;        // textureName, e.g. "Diffuse_Texture"
+    BIN_STRING_REF texture;
+} BIN_SAMPLER_ROW;
+
+typedef struct {
+    BIN_STRING_REF name;
+    uint32_t components;        // 1 to 4
+    float value[4];
+} BIN_PARAM_ROW;
+
+// Layout of parse_bin_materials results: this header, then the submesh,
+// sampler and param rows at their offsets (each row *_size bytes), then the
+// UTF-8 string pool. Readers should step by the row sizes.
+typedef struct {
+    uint32_t material_count;
+    uint32_t material_size;
+    uint32_t material_offset;
+    uint32_t sampler_count;
+    uint32_t sampler_size;
+    uint32_t sampler_offset;
+    uint32_t param_count;
+    uint32_t param_size;
+    uint32_t param_offset;
+    uint32_t pool_offset;
+    uint32_t pool_size;
+} BIN_MATERIAL_TABLE;
+
+// Returns false when no submesh has a material or texture
+static bool extract_materials(const std::vector<const ritobin::Bin*>& bins, std::string& table) {
+    struct SubmeshMaterial {
+        std::string texture;
+        uint32_t material_hash;
+        bool resolved;
+        std::vector<std::pair<std::string, std::string>> samplers;
+        std::vector<MaterialParam> params;
+    };
+    SubmeshResults<SubmeshMaterial> results;
+
+    walk_submesh_bindings(bins, [&](const SubmeshBinding& binding) {
+        SubmeshMaterial material;
+        material.texture = binding.texture;
+        material.material_hash = binding.material_hash;
+        material.resolved = binding.material != nullptr;
+        collect_samplers(binding, material.samplers);
+        collect_params(binding, material.params);
+
+        bool resolved = !material.texture.empty() || material.resolved;
+        results.add(binding.name, std::move(material), resolved);
+    });
+
+    StringPool pool;
+    std::vector<BIN_MATERIAL_ROW> rows;
+    std::vector<BIN_SAMPLER_ROW> samplers;
+    std::vector<BIN_PARAM_ROW> params;
+    for (const auto& [name, material] : results.items()) {
+        BIN_MATERIAL_ROW row;
+        row.submesh = pool.add(name);
+        row.texture = pool.add(material.texture);
+        row.material_hash = material.material_hash;
+        row.flags = material.resolved ? BIN_MATERIAL_RESOLVED : 0;
+        row.sampler_start = (uint32_t)samplers.size();
+        row.sampler_count = (uint32_t)material.samplers.size();
+        row.param_start = (uint32_t)params.size();
+        row.param_count = (uint32_t)material.params.size();
+        rows.push_back(row);
+
+        for (const auto& sampler : material.samplers) {
+            samplers.push_back(BIN_SAMPLER_ROW{ pool.add(sampler.first), pool.add(sampler.second) });
+        }
+        for (const auto& param : material.params) {
+            BIN_PARAM_ROW param_row;
+            param_row.name = pool.add(param.name);
+            param_row.components = param.components;
+            memcpy(param_row.value, param.value, sizeof(param_row.value));
+            params.push_back(param_row);
+        }
+    }
+
+    BIN_MATERIAL_TABLE header;
+    header.material_count = (uint32_t)rows.size();
+    header.material_size = sizeof(BIN_MATERIAL_ROW);
+    header.material_offset = sizeof(BIN_MATERIAL_TABLE);
+    header.sampler_count = (uint32_t)samplers.size();
+    header.sampler_size = sizeof(BIN_SAMPLER_ROW);
+    header.sampler_offset = (uint32_t)(header.material_offset + rows.size() * sizeof(BIN_MATERIAL_ROW));
+    header.param_count = (uint32_t)params.size();
+    header.param_size = sizeof(BIN_PARAM_ROW);
+    header.param_offset = (uint32_t)(header.sampler_offset + samplers.size() * sizeof(BIN_SAMPLER_ROW));
+    header.pool_offset = (uint32_t)(header.param_offset + params.size() * sizeof(BIN_PARAM_ROW));
+    header.pool_size = (uint32_t)pool.data().size();
+
+    table.clear();
+    table.reserve(header.pool_offset + header.pool_size);
+    table.append((const char*)&header, sizeof(header));
+    table.append((const char*)rows.data(), rows.size() * sizeof(BIN_MATERIAL_ROW));
+    table.append((const char*)samplers.data(), samplers.size() * sizeof(BIN_SAMPLER_ROW));
+    table.append((const char*)params.data(), params.size() * sizeof(BIN_PARAM_ROW));
+    table += pool.data();
+    return !rows.empty();
+}
+
+// ============================================================================
+// Selective Parsing
+// ============================================================================
+
+// Class hashes (FNV-1a of the lowercased name) of the entries extract_textures reads
+static const uint32_t HASH_CLASS_SKIN_CHARACTER_DATA = 0x9b67e9f6;   // SkinCharacterDataProperties
+static const uint32_t HASH_CLASS_STATIC_MATERIAL_DEF = 0xff9d3409;   // StaticMaterialDef
+
+static const uint32_t TEXTURE_ENTRY_CLASSES[] = {
+    HASH_CLASS_SKIN_CHARACTER_DATA,
+    HASH_CLASS_STATIC_MATERIAL_DEF,
+};
+
+/*
+ * Build a copy of a PROP file that holds only the entries of the given classes
+ *
+ * Entry headers are walked by their length prefix, so skipped entries (VFX
+ * systems, mostly) are never decoded. Returns false when the layout is not
+ * a plain PROP file (patch files, trailing data, truncation); callers then
+ * parse the original.
+ */
+static bool filter_bin_entries(const uint8_t* data, size_t size, const uint32_t* classes,
+                               size_t class_count, std::vector<char>& out) {
+    ByteReader r = { data, size, 0 };
+
+    uint32_t magic, version;
+    if (!r.u32(magic) || memcmp(&magic, "PROP", 4) != 0) return false;
+    if (!r.u32(version)) return false;
+
+    if (version >= 2) {
+        uint32_t linked_count;
+        if (!r.u32(linked_count)) return false;
+        for (uint32_t i = 0; i < linked_count; i++) {
+            uint16_t len;
+            if (!r.u16(len) || !r.skip(len)) return false;
+        }
+    }
+    const size_t header_size = r.pos;
+
+    uint32_t entry_count;
+    if (!r.u32(entry_count) || !r.has((size_t)entry_count * 4)) return false;
+    const uint8_t* types = r.here();
+    r.skip((size_t)entry_count * 4);
+
+    std::vector<uint32_t> kept_types;
+    std::vector<std::pair<size_t, size_t>> kept_ranges;    // offset, size incl. length prefix
+    for (uint32_t i = 0; i < entry_count; i++) {
+        size_t start = r.pos;
+        uint32_t length;
+        if (!r.u32(length) || !r.skip(length)) return false;
+
+        uint32_t type;
+        memcpy(&type, types + (size_t)i * 4, 4);
+        for (size_t c = 0; c < class_count; c++) {
+            if (type == classes[c]) {
+                kept_types.push_back(type);
+                kept_ranges.emplace_back(start, r.pos - start);
+                break;
             }
         }
     }
+    if (r.pos != size) return false;
 
-    std::ostringstream oss;
-    for (const auto& [key, value] : results) {
-        oss << key << "=" << value << "\n";
+    size_t total = header_size + 4 + kept_types.size() * 4;
+    for (const auto& range : kept_ranges) total += range.second;
+
+    out.resize(total);
+    char* dst = out.data();
+    memcpy(dst, data, header_size);
+    dst += header_size;
+    uint32_t kept_count = (uint32_t)kept_types.size();
+    memcpy(dst, &kept_count, 4);
+    dst += 4;
+    if (kept_count) memcpy(dst, kept_types.data(), (size_t)kept_count * 4);
+    dst += (size_t)kept_count * 4;
+    for (const auto& range : kept_ranges) {
+        memcpy(dst, data + range.first, range.second);
+        dst += range.second;
     }
-    return oss.str();
+    return true;
 }
 
-DLL_EXPORT int parse_bin_textures(const char* bin_path, uint8_t** out_data, uint32_t* out_size) {
-    std::ifstream file(bin_path, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) return -1;
+static std::atomic<bool> g_bin_arena_enabled{ BIN_ARENA_SUPPORTED != 0 };
+
+// A parse tree built in its own arena: every allocation of the parse is
+// bumped from the arena, and the tree is dropped together with it instead
+// of freeing its vectors and strings one by one. Trees parsed with the
+// arena disabled are ordinary heap trees.
+class ArenaBin {
+public:
+    ArenaBin() = default;
+    ~ArenaBin() {
+        if (!in_arena_) delete bin_;
+    }
+
+    ArenaBin(const ArenaBin&) = delete;
+    ArenaBin& operator=(const ArenaBin&) = delete;
+
+    const ritobin::Bin* get() const { return bin_; }
+
+    // Parses into a new tree; returns false when data isn't a valid BIN
+    bool parse(std::span<const char> data) {
+        in_arena_ = g_bin_arena_enabled.load(std::memory_order_relaxed);
+        ArenaScope scope(in_arena_ ? &arena_ : nullptr);
+        bin_ = new ritobin::Bin();
+        std::string error = ritobin::io::read_binary(*bin_, data, &ritobin::io::g_compat_default);
+        return error.empty();
+    }
+
+private:
+    BinArena arena_;
+    ritobin::Bin* bin_ = nullptr;
+    bool in_arena_ = false;
+};
+
+// Parse either the entries of the given classes or, when classes is NULL or
+// the file can't be filtered, the whole file. filtered tells which happened.
+static int read_bin(std::span<const uint8_t> src, const uint32_t* classes, size_t class_count,
+                    ArenaBin& bin, bool& filtered) {
+    std::vector<char> subset;
+    std::span<const char> data((const char*)src.data(), src.size());
+    filtered = classes && filter_bin_entries(src.data(), src.size(), classes, class_count, subset);
+    if (filtered) data = std::span<const char>(subset.data(), subset.size());
+
+    StatsTimer timer(NATIVE_STAGE_PARSE);
+    return bin.parse(data) ? 0 : -2;
+}
+
+// ============================================================================
+// Result Cache
+// ============================================================================
+
+// A file as it is on disk right now: canonical path plus size and last write
+// time, so an edited BIN misses the cache even though its path is unchanged
+struct FileStamp {
+    std::string path;
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+};
+
+static bool get_file_stamp(const char* utf8_path, FileStamp& stamp) {
+#ifdef _WIN32
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, utf8_path, -1, nullptr, 0);
+    if (wlen <= 0) return false;
+    std::wstring wpath((size_t)wlen, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, utf8_path, -1, &wpath[0], wlen);
+
+    DWORD full_len = GetFullPathNameW(wpath.c_str(), 0, nullptr, nullptr);
+    if (full_len == 0) return false;
+    std::wstring full((size_t)full_len, L'\0');
+    full_len = GetFullPathNameW(wpath.c_str(), full_len, &full[0], nullptr);
+    if (full_len == 0) return false;
+    full.resize(full_len);
+
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExW(full.c_str(), GetFileExInfoStandard, &attr)) return false;
+    if (attr.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) return false;
+
+    // NTFS paths are case-insensitive
+    for (auto& c : full) c = (wchar_t)towlower(c);
+    int ulen = WideCharToMultiByte(CP_UTF8, 0, full.c_str(), (int)full.size(), nullptr, 0, nullptr, nullptr);
+    stamp.path.assign((size_t)ulen, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, full.c_str(), (int)full.size(), &stamp.path[0], ulen, nullptr, nullptr);
+
+    stamp.size = ((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+    stamp.mtime = ((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    return true;
+#else
+    char* full = realpath(utf8_path, nullptr);
+    if (!full) return false;
+    stamp.path = full;
+    free(full);
+
+    struct stat st;
+    if (stat(stamp.path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+
+    stamp.size = (uint64_t)st.st_size;
+    stamp.mtime = platform_stat_mtime_ns(&st);
+    return true;
+#endif
+}
+
+// What was extracted from a BIN; each kind is cached separately
+enum BinResultKind : uint32_t {
+    BIN_RESULT_TEXTURES = 0,        // BIN_TEXTURE_TABLE, also formatted for parse_bin_textures
+    BIN_RESULT_MATERIALS = 1,       // BIN_MATERIAL_TABLE
+};
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;          // Includes lookups that found a stale entry
+    uint64_t evictions;
+    uint64_t bytes;           // Size of the cached results
+    uint32_t entries;
+    uint32_t capacity;
+} BIN_CACHE_STATS;
+
+static const uint32_t BIN_CACHE_DEFAULT_CAPACITY = 64;
+
+// LRU of extraction results. Parsing happens outside the lock, so two
+// threads missing on the same file both parse it and the later put wins.
+class BinResultCache {
+public:
+    bool get(BinResultKind kind, const FileStamp& stamp, std::string& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(make_key(kind, stamp));
+        if (it == index_.end() || it->second->size != stamp.size || it->second->mtime != stamp.mtime) {
+            stats_.misses++;
+            stats_add(NATIVE_COUNTER_CACHE_MISSES, 1);
+            return false;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second);
+        out = it->second->result;
+        stats_.hits++;
+        stats_add(NATIVE_COUNTER_CACHE_HITS, 1);
+        return true;
+    }
+
+    void put(BinResultKind kind, const FileStamp& stamp, const std::string& result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capacity_ == 0) return;
+
+        std::string key = make_key(kind, stamp);
+        auto it = index_.find(key);
+        if (it != index_.end()) erase(it->second);
+
+        lru_.push_front(Entry{ key, stamp.size, stamp.mtime, result });
+        index_[key] = lru_.begin();
+        stats_.bytes += result.size();
+        trim();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lru_.clear();
+        index_.clear();
+        stats_ = BIN_CACHE_STATS();
+    }
+
+    void set_capacity(uint32_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        trim();
+    }
+
+    BIN_CACHE_STATS stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        BIN_CACHE_STATS out = stats_;
+        out.entries = (uint32_t)lru_.size();
+        out.capacity = capacity_;
+        return out;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t size;
+        uint64_t mtime;
+        std::string result;
+    };
+
+    static std::string make_key(BinResultKind kind, const FileStamp& stamp) {
+        return std::to_string((uint32_t)kind) + '|' + stamp.path;
+    }
+
+    void erase(std::list<Entry>::iterator entry) {
+        stats_.bytes -= entry->result.size();
+        index_.erase(entry->key);
+        lru_.erase(entry);
+    }
+
+    void trim() {
+        while (lru_.size() > capacity_) {
+            erase(std::prev(lru_.end()));
+            stats_.evictions++;
+        }
+    }
 
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
+    std::mutex mutex_;
+    std::list<Entry> lru_;      // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    uint32_t capacity_ = BIN_CACHE_DEFAULT_CAPACITY;
+    BIN_CACHE_STATS stats_ = {};
+};
 
-    std::vector<char> buffer(size);
-    if (!file.read(buffer.data(), size)) return -1;
-    file.close();
+static BinResultCache g_bin_cache;
 
-    ritobin::Bin bin;
-    std::string error = ritobin::io::read_binary(bin, buffer, &ritobin::io::g_compat_default);
-    if (!error.empty()) return -2;
+// Linked BINs only contribute materials
+static const uint32_t LINKED_ENTRY_CLASSES[] = {
+    HASH_CLASS_STATIC_MATERIAL_DEF,
+};
 
-    std::string result = extract_textures(bin);
+// One cache stamp for a skin BIN and its linked BINs: paths joined by
+// newlines, sizes and write times mixed so that editing any file misses
+static void combine_stamps(const std::vector<FileStamp>& stamps, FileStamp& out) {
+    out = stamps[0];
+    for (size_t i = 1; i < stamps.size(); i++) {
+        out.path += '\n';
+        out.path += stamps[i].path;
+        out.size = out.size * 1099511628211ull ^ stamps[i].size;
+        out.mtime = out.mtime * 1099511628211ull ^ stamps[i].mtime;
+    }
+}
 
-    uint32_t result_size = (uint32_t)result.size();
-    uint8_t* result_data = (uint8_t*)malloc(result_size + 1);
-    if (!result_data) return -4;
+// Result table of a skin BIN (file 0) and its linked BINs. Files are parsed
+// in parallel; only SkinCharacterDataProperties and StaticMaterialDef entries
+// of the skin BIN and StaticMaterialDef entries of linked BINs are decoded.
+// open(i, bytes) supplies file i on a worker thread (file 0 must already be
+// available); linked BINs it can't supply or that are invalid are skipped.
+// extract(bins, table) builds the table and returns false when it found nothing.
+template <typename Open, typename Extract>
+static int extract_bin_set(size_t count, Open&& open, Extract&& extract, std::string& table) {
+    std::vector<std::span<const uint8_t>> data(count);
+    std::vector<ArenaBin> bins(count);
+    std::vector<int> results(count, -1);
+    std::vector<char> filtered(count, 0);
+    global_thread_pool().parallel_for(count, 0, [&](size_t i) {
+        if (!open(i, data[i])) return;
+        const uint32_t* classes = i == 0 ? TEXTURE_ENTRY_CLASSES : LINKED_ENTRY_CLASSES;
+        size_t class_count = i == 0 ? sizeof(TEXTURE_ENTRY_CLASSES) / sizeof(TEXTURE_ENTRY_CLASSES[0])
+                                    : sizeof(LINKED_ENTRY_CLASSES) / sizeof(LINKED_ENTRY_CLASSES[0]);
+        bool was_filtered;
+        results[i] = read_bin(data[i], classes, class_count, bins[i], was_filtered);
+        filtered[i] = was_filtered;
+    });
 
-    memcpy(result_data, result.c_str(), result_size + 1);
-    *out_data = result_data;
-    *out_size = result_size;
+    std::vector<const ritobin::Bin*> parsed = { bins[0].get() };
+    for (size_t i = 1; i < count; i++) {
+        if (results[i] == 0) parsed.push_back(bins[i].get());
+    }
+
+    // Entries of other classes can still hold skinMeshProperties in
+    // unusual files, so an empty selective result falls back to a full parse
+    int rc = results[0];
+    bool found;
+    {
+        StatsTimer timer(NATIVE_STAGE_LINK_RESOLVE);
+        found = rc == 0 && extract(parsed, table);
+    }
+    if (filtered[0] && !found) {
+        ArenaBin full;
+        bool was_filtered;
+        rc = read_bin(data[0], nullptr, 0, full, was_filtered);
+        parsed[0] = full.get();
+        if (rc == 0) {
+            StatsTimer timer(NATIVE_STAGE_LINK_RESOLVE);
+            extract(parsed, table);
+        }
+    }
+    return rc;
+}
+
+// extract_bin_set over files on disk, through the cache. paths[0] is the
+// skin BIN.
+template <typename Extract>
+static int load_bin_result(BinResultKind kind, const std::vector<const char*>& paths, Extract&& extract,
+                           std::string& table) {
+    std::vector<FileStamp> stamps(paths.size());
+    bool cacheable = true;
+    for (size_t i = 0; i < paths.size() && cacheable; i++) {
+        cacheable = get_file_stamp(paths[i], stamps[i]);
+    }
+    FileStamp stamp;
+    if (cacheable) {
+        combine_stamps(stamps, stamp);
+        if (g_bin_cache.get(kind, stamp, table)) return 0;
+    }
+
+    std::vector<MappedFile> mapped(paths.size());
+    if (!open_mapped(mapped[0], paths[0])) return -1;
+
+    int rc = extract_bin_set(paths.size(), [&](size_t i, std::span<const uint8_t>& out) {
+        if (i > 0 && !open_mapped(mapped[i], paths[i])) return false;
+        out = std::span<const uint8_t>(mapped[i].data(), mapped[i].size());
+        return true;
+    }, extract, table);
+    if (rc != 0) return rc;
+
+    if (cacheable) g_bin_cache.put(kind, stamp, table);
     return 0;
 }
 
+static bool extract_texture_table(const std::vector<const ritobin::Bin*>& bins, std::string& table) {
+    std::vector<TextureRow> rows = extract_textures(bins);
+    table = build_texture_table(rows);
+    return !rows.empty();
+}
+
+static int load_texture_table(const std::vector<const char*>& paths, std::string& table) {
+    return load_bin_result(BIN_RESULT_TEXTURES, paths, extract_texture_table, table);
+}
+
+// Copies a result table into a block for the caller
+static int return_table(const std::string& table, uint8_t** out_data, uint32_t* out_size) {
+    uint8_t* table_data = (uint8_t*)malloc(table.size());
+    if (!table_data) return -4;
+    stats_add(NATIVE_COUNTER_ALLOC_BYTES, table.size());
+
+    memcpy(table_data, table.data(), table.size());
+    *out_data = table_data;
+    *out_size = (uint32_t)table.size();
+    return 0;
+}
+
+/*
+ * Extract the texture assignments of a skin BIN as "submesh=path" lines
+ *
+ * Results are cached per file (canonical path, size and write time), so
+ * importing several meshes of one skin parses its BIN once.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be read, -2 if it isn't a valid BIN,
+ *   -4 on allocation failure
+ */
+DLL_EXPORT int parse_bin_textures(const char* bin_path, uint8_t** out_data, uint32_t* out_size) {
+    try {
+        std::string table;
+        int rc = load_texture_table({ bin_path }, table);
+        if (rc != 0) return rc;
+        std::string result = format_texture_lines(table);
+
+        uint32_t result_size = (uint32_t)result.size();
+        uint8_t* result_data = (uint8_t*)malloc(result_size + 1);
+        if (!result_data) return -4;
+        stats_add(NATIVE_COUNTER_ALLOC_BYTES, result_size + 1);
+
+        memcpy(result_data, result.c_str(), result_size + 1);
+        *out_data = result_data;
+        *out_size = result_size;
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Extract the texture assignments of a skin BIN as a binary table
+ *
+ * Parameters:
+ *   bin_path  - Path to the .bin file (UTF-8)
+ *   out_data  - Receives a BIN_TEXTURE_TABLE (free with free_bin_result)
+ *   out_size  - Receives the size of the table in bytes
+ *
+ * Besides the submesh textures parse_bin_textures reports (flag
+ * BIN_TEXTURE_PRIMARY), the table lists every other sampler of the linked
+ * materials, like Normal and Mask textures. Shares the parse_bin_textures cache.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be read, -2 if it isn't a valid BIN,
+ *   -4 on allocation failure, -5 on invalid arguments
+ */
+DLL_EXPORT int parse_bin_texture_table(const char* bin_path, uint8_t** out_data, uint32_t* out_size) {
+    if (!bin_path || !out_data || !out_size) return -5;
+    *out_data = nullptr;
+    *out_size = 0;
+
+    try {
+        std::string table;
+        int rc = load_texture_table({ bin_path }, table);
+        if (rc != 0) return rc;
+        return return_table(table, out_data, out_size);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Extract the material of every submesh of a skin BIN as a binary table
+ *
+ * Parameters:
+ *   bin_path  - Path to the .bin file (UTF-8)
+ *   out_data  - Receives a BIN_MATERIAL_TABLE (free with free_bin_result)
+ *   out_size  - Receives the size of the table in bytes
+ *
+ * Each submesh row (BASE included) holds its direct texture, the hash of
+ * the linked StaticMaterialDef and ranges into the sampler rows (every
+ * textureName/texturePath pair) and param rows (paramValues, vectors and
+ * floats). Results are cached like parse_bin_textures.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be read, -2 if it isn't a valid BIN,
+ *   -4 on allocation failure, -5 on invalid arguments
+ */
+DLL_EXPORT int parse_bin_materials(const char* bin_path, uint8_t** out_data, uint32_t* out_size) {
+    if (!bin_path || !out_data || !out_size) return -5;
+    *out_data = nullptr;
+    *out_size = 0;
+
+    try {
+        std::string table;
+        int rc = load_bin_result(BIN_RESULT_MATERIALS, { bin_path }, extract_materials, table);
+        if (rc != 0) return rc;
+        return return_table(table, out_data, out_size);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Extract the textures or materials of a skin BIN together with its linked BINs
+ *
+ * Parameters:
+ *   bin_path      - Path to the skin .bin file (UTF-8)
+ *   linked_paths  - Paths to BINs its materials may live in (UTF-8), usually
+ *                   the files of its "linked" section
+ *   linked_count  - Number of entries in linked_paths
+ *   kind          - BIN_RESULT_TEXTURES for a BIN_TEXTURE_TABLE or
+ *                   BIN_RESULT_MATERIALS for a BIN_MATERIAL_TABLE
+ *   out_data      - Receives the table (free with free_bin_result)
+ *   out_size      - Receives the size of the table in bytes
+ *
+ * All files are parsed in parallel and materialLink resolves across their
+ * merged entries, preferring the skin BIN and then the order given. Linked
+ * BINs that can't be read or parsed are ignored. The result is cached for
+ * the exact set of files.
+ *
+ * Returns:
+ *   0 on success, -1 if the skin BIN can't be read, -2 if it isn't a valid
+ *   BIN, -3 for an unknown kind, -4 on allocation failure, -5 on invalid arguments
+ */
+DLL_EXPORT int parse_bin_batch(const char* bin_path, const char* const* linked_paths, uint32_t linked_count,
+                               uint32_t kind, uint8_t** out_data, uint32_t* out_size) {
+    if (!bin_path || (linked_count && !linked_paths) || !out_data || !out_size) return -5;
+    *out_data = nullptr;
+    *out_size = 0;
+
+    try {
+        std::vector<const char*> paths = { bin_path };
+        for (uint32_t i = 0; i < linked_count; i++) {
+            if (!linked_paths[i]) return -5;
+            paths.push_back(linked_paths[i]);
+        }
+
+        std::string table;
+        int rc;
+        if (kind == BIN_RESULT_TEXTURES) {
+            rc = load_texture_table(paths, table);
+        } else if (kind == BIN_RESULT_MATERIALS) {
+            rc = load_bin_result(BIN_RESULT_MATERIALS, paths, extract_materials, table);
+        } else {
+            return -3;
+        }
+        if (rc != 0) return rc;
+        return return_table(table, out_data, out_size);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Same as parse_bin_batch on BINs that are already in memory
+ *
+ * Parameters:
+ *   datas     - Contents of the skin BIN (datas[0]) and of its linked BINs
+ *   sizes     - Size in bytes of each entry of datas
+ *   count     - Number of entries in datas, at least 1
+ *   kind      - BIN_RESULT_TEXTURES or BIN_RESULT_MATERIALS
+ *   out_data  - Receives the table (free with free_bin_result)
+ *   out_size  - Receives the size of the table in bytes
+ *
+ * Meant for BINs read out of a WAD archive. A NULL linked entry is skipped;
+ * nothing is cached, since the buffers have no stamp to check.
+ *
+ * Returns:
+ *   0 on success, -2 if the skin BIN isn't a valid BIN, -3 for an unknown
+ *   kind, -4 on allocation failure, -5 on invalid arguments
+ */
+DLL_EXPORT int parse_bin_batch_from_memory(const uint8_t* const* datas, const uint32_t* sizes, uint32_t count,
+                                           uint32_t kind, uint8_t** out_data, uint32_t* out_size) {
+    if (!datas || !sizes || count == 0 || !datas[0] || !out_data || !out_size) return -5;
+    *out_data = nullptr;
+    *out_size = 0;
+
+    auto open = [&](size_t i, std::span<const uint8_t>& out) {
+        if (!datas[i]) return false;
+        out = std::span<const uint8_t>(datas[i], sizes[i]);
+        return true;
+    };
+
+    try {
+        std::string table;
+        int rc;
+        if (kind == BIN_RESULT_TEXTURES) {
+            rc = extract_bin_set(count, open, extract_texture_table, table);
+        } else if (kind == BIN_RESULT_MATERIALS) {
+            rc = extract_bin_set(count, open, extract_materials, table);
+        } else {
+            return -3;
+        }
+        if (rc != 0) return rc;
+        return return_table(table, out_data, out_size);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
 DLL_EXPORT void free_bin_result(uint8_t* data) {
     if (data) free(data);
 }
 
+/*
+ * Drop every cached BIN result and reset the statistics
+ */
+DLL_EXPORT void bin_cache_clear() {
+    g_bin_cache.clear();
+}
+
+/*
+ * Report cache usage
+ *
+ * Parameters:
+ *   out_stats - Receives the counters since the last bin_cache_clear
+ *
+ * Returns:
+ *   0 on success, -5 if out_stats is NULL
+ */
+DLL_EXPORT int bin_cache_stats(BIN_CACHE_STATS* out_stats) {
+    if (!out_stats) return -5;
+    *out_stats = g_bin_cache.stats();
+    return 0;
+}
+
+/*
+ * Set how many BIN results are kept (default 64, 0 disables caching)
+ */
+DLL_EXPORT void bin_cache_set_capacity(uint32_t capacity) {
+    g_bin_cache.set_capacity(capacity);
+}
+
+/*
+ * Parse BIN trees into per-parse arenas (default) or onto the heap
+ *
+ * Parameters:
+ *   enabled - Non-zero to use arenas; takes effect for parses started later
+ *
+ * Arenas need the MSVC STL (see arena.h); other builds always parse onto
+ * the heap and ignore enabled.
+ *
+ * Returns:
+ *   1 if arenas were enabled before the call, 0 otherwise
+ */
+DLL_EXPORT int bin_arena_set_enabled(int enabled) {
+    if (!BIN_ARENA_SUPPORTED) return 0;
+    return g_bin_arena_enabled.exchange(enabled != 0) ? 1 : 0;
+}
+
+/*
+ * Read the per-stage timers and counters of this DLL
+ *
+ * Same as native_stats_get in lol_native; BIN cache lookups are counted in
+ * cache_hits / cache_misses.
+ */
+DLL_EXPORT int native_stats_get(NATIVE_STATS* out_stats) {
+    if (!out_stats) return -5;
+    stats_snapshot(*out_stats);
+    return 0;
+}
+
+DLL_EXPORT void native_stats_reset() {
+    stats_reset();
+}
+
+DLL_EXPORT void native_trace_start(uint32_t events_per_thread) {
+    stats_trace_start(events_per_thread);
+}
+
+DLL_EXPORT int native_trace_dump(const char* json_path) {
+    if (!json_path) return -5;
+    return stats_trace_dump(json_path, "bin_parser") ? 0 : -1;
+}
+
 DLL_EXPORT const char* get_bin_parser_version() {
-    return "bin_parser 1.1";
+    return "bin_parser 1.9";
 }
 
+#if BIN_ARENA_SUPPORTED
+// Allocations of this DLL honour the calling thread's ArenaScope. Other
+// modules keep their own operator new, so nothing crosses the boundary.
+void* operator new(size_t size) {
+    void* p = arena_operator_new(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = arena_operator_new(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return arena_operator_new(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return arena_operator_new(size); }
+
+void operator delete(void* p) noexcept { arena_operator_delete(p); }
+void operator delete[](void* p) noexcept { arena_operator_delete(p); }
+void operator delete(void* p, size_t) noexcept { arena_operator_delete(p); }
+void operator delete[](void* p, size_t) noexcept { arena_operator_delete(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { arena_operator_delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { arena_operator_delete(p); }
+#endif
+
+#ifdef _WIN32
 BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpReserved) {
     (void)hinstDLL; (void)lpReserved;
     return TRUE;
 }
+#endif
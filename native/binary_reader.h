@@ -0,0 +1,155 @@
+#ifndef BINARY_READER_H
+#define BINARY_READER_H
+
+/*
+ * Helpers for the native file parsers: bounds-checked reads over an
+ * in-memory file, a text tokenizer and single-allocation result layouts
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Bounds-checked little-endian reader over an in-memory file
+struct ByteReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+
+    bool has(size_t n) const { return n <= size - pos; }
+    bool seek(size_t p) { if (p > size) return false; pos = p; return true; }
+    bool skip(size_t n) { if (!has(n)) return false; pos += n; return true; }
+    bool read(void* out, size_t n) {
+        if (!has(n)) return false;
+        memcpy(out, data + pos, n);
+        pos += n;
+        return true;
+    }
+    bool u16(uint16_t& v) { return read(&v, 2); }
+    bool u32(uint32_t& v) { return read(&v, 4); }
+    bool i32(int32_t& v) { return read(&v, 4); }
+    bool f32(float& v) { return read(&v, 4); }
+    const uint8_t* here() const { return data + pos; }
+};
+
+// Parses a decimal float ([+-]digits[.digits][e[+-]digits]) that spans the
+// whole of [begin, end). No locale, no NUL terminator and no allocation.
+inline bool parse_float(const char* begin, const char* end, float& out) {
+    static const double exact_pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+    // Up to 19 significant digits fit the mantissa; the rest only move the exponent
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool any = false;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, any = true) {
+        if (digits < 19) { mantissa = mantissa * 10 + (uint64_t)(*p - '0'); if (mantissa) digits++; }
+        else exponent++;
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, any = true) {
+            if (digits < 19) { mantissa = mantissa * 10 + (uint64_t)(*p - '0'); if (mantissa) digits++; exponent--; }
+        }
+    }
+    if (!any) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) exp_negative = *p++ == '-';
+        if (p == end || *p < '0' || *p > '9') return false;
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (e < 10000) e = e * 10 + (*p - '0');
+        }
+        exponent += exp_negative ? -e : e;
+    }
+    if (p != end) return false;
+
+    double value = (double)mantissa;
+    if (mantissa == 0) value = 0.0;
+    else if (exponent >= 0 && exponent <= 22) value *= exact_pow10[exponent];
+    else if (exponent < 0 && exponent >= -22) value /= exact_pow10[-exponent];
+    else value *= pow(10.0, (double)exponent);
+
+    out = (float)(negative ? -value : value);
+    return true;
+}
+
+// Parses an unsigned decimal integer that spans the whole of [begin, end)
+inline bool parse_u32(const char* begin, const char* end, uint32_t& out) {
+    if (begin == end) return false;
+    uint64_t value = 0;
+    for (const char* p = begin; p < end; p++) {
+        if (*p < '0' || *p > '9') return false;
+        value = value * 10 + (uint64_t)(*p - '0');
+        if (value > 0xffffffffu) return false;
+    }
+    out = (uint32_t)value;
+    return true;
+}
+
+// Line and token reader over an in-memory text file. Tokens and lines are
+// pointer ranges into the file, nothing is copied.
+struct TextReader {
+    const char* p;
+    const char* end;
+
+    static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+    // Next line with surrounding whitespace trimmed; false at the end of the file
+    bool line(TextReader& out) {
+        if (p >= end) return false;
+        const char* stop = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* next = stop ? stop + 1 : end;
+        if (!stop) stop = end;
+        const char* begin = p;
+        while (begin < stop && is_space(*begin)) begin++;
+        while (stop > begin && is_space(stop[-1])) stop--;
+        out = { begin, stop };
+        p = next;
+        return true;
+    }
+
+    // Next whitespace separated token; false when none are left
+    bool token(const char*& begin, const char*& stop) {
+        while (p < end && (is_space(*p) || *p == '\n')) p++;
+        if (p >= end) return false;
+        begin = p;
+        while (p < end && !is_space(*p) && *p != '\n') p++;
+        stop = p;
+        return true;
+    }
+
+    bool f32(float& v) { const char* b; const char* e; return token(b, e) && parse_float(b, e, v); }
+    bool u32(uint32_t& v) { const char* b; const char* e; return token(b, e) && parse_u32(b, e, v); }
+
+    // Consumes prefix if the remaining text starts with it
+    bool starts_with(const char* prefix) {
+        size_t n = strlen(prefix);
+        if ((size_t)(end - p) < n || memcmp(p, prefix, n) != 0) return false;
+        p += n;
+        return true;
+    }
+    bool empty() const { return p >= end; }
+};
+
+// Hands out 16-byte aligned slices of one allocation
+struct BlockLayout {
+    size_t size = 0;
+
+    size_t add(size_t bytes) {
+        size_t offset = (size + 15) & ~(size_t)15;
+        size = offset + bytes;
+        return offset;
+    }
+};
+
+#endif // BINARY_READER_H
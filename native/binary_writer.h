@@ -0,0 +1,59 @@
+#ifndef BINARY_WRITER_H
+#define BINARY_WRITER_H
+
+/*
+ * Helpers for the native file writers: a little-endian byte buffer and
+ * writing it out under a UTF-8 path
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#endif
+
+// Growable little-endian buffer; patch() rewrites bytes already written
+struct ByteWriter {
+    std::vector<uint8_t> data;
+
+    size_t pos() const { return data.size(); }
+    void write(const void* src, size_t n) {
+        const uint8_t* p = (const uint8_t*)src;
+        data.insert(data.end(), p, p + n);
+    }
+    void zeros(size_t n) { data.resize(data.size() + n, 0); }
+    void u8(uint8_t v) { data.push_back(v); }
+    void u16(uint16_t v) { write(&v, 2); }
+    void i16(int16_t v) { write(&v, 2); }
+    void u32(uint32_t v) { write(&v, 4); }
+    void i32(int32_t v) { write(&v, 4); }
+    void f32(float v) { write(&v, 4); }
+    void patch(size_t at, const void* src, size_t n) { memcpy(data.data() + at, src, n); }
+};
+
+// Replaces the file at path with data; false if it can't be written
+inline bool write_file(const char* path, const void* data, size_t size) {
+#ifdef _WIN32
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+    if (wlen <= 0) return false;
+    std::wstring wpath((size_t)wlen, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, &wpath[0], wlen);
+    FILE* f = _wfopen(wpath.c_str(), L"wb");
+#else
+    FILE* f = fopen(path, "wb");
+#endif
+    if (!f) return false;
+    bool ok = fwrite(data, 1, size, f) == size;
+    ok = fclose(f) == 0 && ok;
+    return ok;
+}
+
+#endif // BINARY_WRITER_H
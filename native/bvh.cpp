@@ -0,0 +1,858 @@
+/*
+ * BVH - bounding volume hierarchy over triangles or capsules
+ * Compiled into lol_native.dll alongside lol_native.cpp
+ *
+ * Built top-down with a binned surface area heuristic into one flat array of
+ * nodes in depth-first order: a node's left child is the next node, so the
+ * common descent is a sequential read, and primitives are copied into leaf
+ * order so a leaf's triangles sit next to each other. Triangle trees serve
+ * collider meshes, capsule trees (bone segments with a radius) serve the
+ * skinning tools. Queries are batched and run on the shared thread pool.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "bvh.h"
+#include "platform.h"
+#include "thread_pool.h"
+
+// ============================================================================
+// Building
+// ============================================================================
+
+#define BVH_TRIANGLES       1
+#define BVH_CAPSULES        2
+
+#define BVH_LEAF_SIZE       4
+#define BVH_SAH_BINS        16
+#define BVH_MAX_NEAREST     16
+#define BVH_MAX_DEPTH       48      // Deeper ranges become one (large) leaf
+#define BVH_STACK_SIZE      64      // Traversal needs at most depth + 1 entries
+
+static const size_t BVH_QUERY_CHUNK = 256;
+
+// count == 0: interior node whose left child is the next node and right
+// child is nodes[first]; otherwise leaf over prims [first, first + count)
+struct BvhNode {
+    float lo[3];
+    uint32_t first;
+    float hi[3];
+    uint32_t count;
+};
+
+struct BVH {
+    uint32_t kind;
+    uint32_t stride;                // Floats per primitive: 9 (triangle a, b, c) or 7 (capsule a, b, radius)
+    std::vector<BvhNode> nodes;
+    std::vector<int32_t> ids;       // Original primitive index, leaf order
+    std::vector<float> prims;       // Primitive data, leaf order
+};
+
+struct BvhBox {
+    float lo[3] = {INFINITY, INFINITY, INFINITY};
+    float hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+    void grow(const float* p) {
+        for (int c = 0; c < 3; c++) {
+            lo[c] = p[c] < lo[c] ? p[c] : lo[c];
+            hi[c] = p[c] > hi[c] ? p[c] : hi[c];
+        }
+    }
+    void grow(const BvhBox& b) {
+        grow(b.lo);
+        grow(b.hi);
+    }
+    float area() const {
+        float d[3];
+        for (int c = 0; c < 3; c++) d[c] = hi[c] > lo[c] ? hi[c] - lo[c] : 0.0f;
+        return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+    }
+};
+
+struct BvhBuilder {
+    std::vector<BvhBox> boxes;
+    std::vector<float> centroids;   // 3 per primitive
+    std::vector<uint32_t> index;    // Permuted in place while splitting
+    std::vector<BvhNode> nodes;
+
+    void build(uint32_t begin, uint32_t end, uint32_t depth) {
+        uint32_t node = (uint32_t)nodes.size();
+        nodes.emplace_back();
+
+        BvhBox bounds, centers;
+        for (uint32_t i = begin; i < end; i++) {
+            bounds.grow(boxes[index[i]]);
+            centers.grow(&centroids[(size_t)index[i] * 3]);
+        }
+        memcpy(nodes[node].lo, bounds.lo, 12);
+        memcpy(nodes[node].hi, bounds.hi, 12);
+
+        uint32_t count = end - begin;
+        uint32_t mid = count > BVH_LEAF_SIZE && depth < BVH_MAX_DEPTH ? split(begin, end, bounds, centers) : begin;
+        if (mid == begin) {
+            nodes[node].first = begin;
+            nodes[node].count = count;
+            return;
+        }
+
+        build(begin, mid, depth + 1);
+        nodes[node].first = (uint32_t)nodes.size();
+        nodes[node].count = 0;
+        build(mid, end, depth + 1);
+    }
+
+    // Binned SAH over the centroid bounds; falls back to a median split on
+    // the longest axis when no bin boundary beats it. begin means "make a leaf".
+    uint32_t split(uint32_t begin, uint32_t end, const BvhBox& bounds, const BvhBox& centers) {
+        int best_axis = -1;
+        int best_bin = 0;
+        float best_cost = bounds.area() * (float)(end - begin);
+
+        for (int axis = 0; axis < 3; axis++) {
+            float extent = centers.hi[axis] - centers.lo[axis];
+            if (!(extent > 0.0f)) continue;
+
+            BvhBox bins[BVH_SAH_BINS];
+            uint32_t counts[BVH_SAH_BINS] = {};
+            const float scale = BVH_SAH_BINS / extent;
+            for (uint32_t i = begin; i < end; i++) {
+                int b = bin_of(centroids[(size_t)index[i] * 3 + axis], centers.lo[axis], scale);
+                bins[b].grow(boxes[index[i]]);
+                counts[b]++;
+            }
+
+            // Right-to-left sweep for the right side areas, then left-to-right
+            float right_area[BVH_SAH_BINS];
+            uint32_t right_count[BVH_SAH_BINS];
+            BvhBox acc;
+            uint32_t n = 0;
+            for (int b = BVH_SAH_BINS - 1; b > 0; b--) {
+                acc.grow(bins[b]);
+                n += counts[b];
+                right_area[b] = acc.area();
+                right_count[b] = n;
+            }
+            acc = BvhBox();
+            n = 0;
+            for (int b = 0; b < BVH_SAH_BINS - 1; b++) {
+                acc.grow(bins[b]);
+                n += counts[b];
+                if (!n || !right_count[b + 1]) continue;
+                float cost = acc.area() * n + right_area[b + 1] * right_count[b + 1];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = b;
+                }
+            }
+        }
+
+        if (best_axis < 0) {
+            if (end - begin <= BVH_LEAF_SIZE * 4) return begin;
+            int axis = 0;
+            for (int c = 1; c < 3; c++) {
+                if (centers.hi[c] - centers.lo[c] > centers.hi[axis] - centers.lo[axis]) axis = c;
+            }
+            uint32_t mid = begin + (end - begin) / 2;
+            std::nth_element(index.begin() + begin, index.begin() + mid, index.begin() + end,
+                             [&](uint32_t a, uint32_t b) {
+                                 return centroids[(size_t)a * 3 + axis] < centroids[(size_t)b * 3 + axis];
+                             });
+            return mid;
+        }
+
+        const float scale = BVH_SAH_BINS / (centers.hi[best_axis] - centers.lo[best_axis]);
+        auto middle = std::partition(index.begin() + begin, index.begin() + end, [&](uint32_t p) {
+            return bin_of(centroids[(size_t)p * 3 + best_axis], centers.lo[best_axis], scale) <= best_bin;
+        });
+        return (uint32_t)(middle - index.begin());
+    }
+
+    static int bin_of(float c, float lo, float scale) {
+        int b = (int)((c - lo) * scale);
+        return b < 0 ? 0 : (b >= BVH_SAH_BINS ? BVH_SAH_BINS - 1 : b);
+    }
+};
+
+// Runs the builder over prepared boxes and copies primitives into leaf order
+static BVH* bvh_finish(BvhBuilder& builder, uint32_t kind, uint32_t stride, const float* data) {
+    const uint32_t count = (uint32_t)builder.boxes.size();
+    builder.index.resize(count);
+    for (uint32_t i = 0; i < count; i++) builder.index[i] = i;
+    builder.nodes.reserve(count ? (size_t)count * 2 / BVH_LEAF_SIZE + 1 : 1);
+    if (count) builder.build(0, count, 0);
+
+    BVH* bvh = new BVH();
+    bvh->kind = kind;
+    bvh->stride = stride;
+    bvh->nodes = std::move(builder.nodes);
+    bvh->ids.resize(count);
+    bvh->prims.resize((size_t)count * stride);
+    for (uint32_t i = 0; i < count; i++) {
+        bvh->ids[i] = (int32_t)builder.index[i];
+        memcpy(&bvh->prims[(size_t)i * stride], data + (size_t)builder.index[i] * stride, stride * sizeof(float));
+    }
+    return bvh;
+}
+
+/*
+ * Build a BVH over triangles
+ *
+ * Parameters:
+ *   positions       - vertex_count * 3 floats
+ *   vertex_count    - Number of vertices
+ *   triangles       - triangle_count * 3 vertex indices
+ *   triangle_count  - Number of triangles
+ *   out_bvh         - Receives the tree (free with bvh_free)
+ *
+ * Returns:
+ *   0 on success, -4 if out of memory, -5 on invalid arguments or out of range indices
+ */
+DLL_EXPORT int bvh_build_triangles(const float* positions, uint32_t vertex_count, const int32_t* triangles,
+                                   uint32_t triangle_count, BVH** out_bvh) {
+    if (!out_bvh || (triangle_count && (!positions || !triangles))) return -5;
+    *out_bvh = nullptr;
+    for (size_t i = 0; i < (size_t)triangle_count * 3; i++) {
+        if (triangles[i] < 0 || (uint32_t)triangles[i] >= vertex_count) return -5;
+    }
+
+    try {
+        BvhBuilder builder;
+        std::vector<float> data((size_t)triangle_count * 9);
+        builder.boxes.resize(triangle_count);
+        builder.centroids.resize((size_t)triangle_count * 3);
+        for (size_t t = 0; t < triangle_count; t++) {
+            float* tri = &data[t * 9];
+            for (int k = 0; k < 3; k++) {
+                memcpy(tri + k * 3, positions + (size_t)triangles[t * 3 + k] * 3, 12);
+                builder.boxes[t].grow(tri + k * 3);
+            }
+            for (int c = 0; c < 3; c++) builder.centroids[t * 3 + c] = (tri[c] + tri[3 + c] + tri[6 + c]) / 3.0f;
+        }
+        *out_bvh = bvh_finish(builder, BVH_TRIANGLES, 9, data.data());
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Build a BVH over capsules (segments with a radius, e.g. bones)
+ *
+ * Parameters:
+ *   segments  - count * 6 floats: head xyz, tail xyz
+ *   radii     - count radii, or NULL for plain segments
+ *   count     - Number of capsules
+ *   out_bvh   - Receives the tree (free with bvh_free)
+ *
+ * Returns:
+ *   0 on success, -4 if out of memory, -5 on invalid arguments
+ */
+DLL_EXPORT int bvh_build_capsules(const float* segments, const float* radii, uint32_t count, BVH** out_bvh) {
+    if (!out_bvh || (count && !segments)) return -5;
+    *out_bvh = nullptr;
+
+    try {
+        BvhBuilder builder;
+        std::vector<float> data((size_t)count * 7);
+        builder.boxes.resize(count);
+        builder.centroids.resize((size_t)count * 3);
+        for (size_t i = 0; i < count; i++) {
+            float* cap = &data[i * 7];
+            memcpy(cap, segments + i * 6, 24);
+            cap[6] = radii ? radii[i] : 0.0f;
+            if (!(cap[6] >= 0.0f)) return -5;
+            for (int c = 0; c < 3; c++) {
+                float lo = cap[c] < cap[3 + c] ? cap[c] : cap[3 + c];
+                float hi = cap[c] < cap[3 + c] ? cap[3 + c] : cap[c];
+                builder.boxes[i].lo[c] = lo - cap[6];
+                builder.boxes[i].hi[c] = hi + cap[6];
+                builder.centroids[i * 3 + c] = (cap[c] + cap[3 + c]) * 0.5f;
+            }
+        }
+        *out_bvh = bvh_finish(builder, BVH_CAPSULES, 7, data.data());
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+DLL_EXPORT void bvh_free(BVH* bvh) {
+    delete bvh;
+}
+
+// ============================================================================
+// Geometry
+// ============================================================================
+
+static inline float dot3(const float* a, const float* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+static inline void sub3(const float* a, const float* b, float* out) {
+    for (int c = 0; c < 3; c++) out[c] = a[c] - b[c];
+}
+static inline void cross3(const float* a, const float* b, float* out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+static inline float dist_sq3(const float* a, const float* b) {
+    float d[3];
+    sub3(a, b, d);
+    return dot3(d, d);
+}
+static inline void normalize_or(float* v, const float* fallback) {
+    float len = sqrtf(dot3(v, v));
+    if (len > 0.0f) {
+        for (int c = 0; c < 3; c++) v[c] /= len;
+    } else {
+        memcpy(v, fallback, 12);
+    }
+}
+
+static const float BVH_UP[3] = {0.0f, 0.0f, 1.0f};
+
+static float box_dist_sq(const BvhNode& n, const float* p) {
+    float d = 0.0f;
+    for (int c = 0; c < 3; c++) {
+        float e = p[c] < n.lo[c] ? n.lo[c] - p[c] : (p[c] > n.hi[c] ? p[c] - n.hi[c] : 0.0f);
+        d += e * e;
+    }
+    return d;
+}
+
+// Lower bound for anything in node n against anything in box [lo, hi]
+static float box_box_dist_sq(const BvhNode& n, const float* lo, const float* hi) {
+    float d = 0.0f;
+    for (int c = 0; c < 3; c++) {
+        float e = hi[c] < n.lo[c] ? n.lo[c] - hi[c] : (lo[c] > n.hi[c] ? lo[c] - n.hi[c] : 0.0f);
+        d += e * e;
+    }
+    return d;
+}
+
+// Closest point to p on segment ab, as a parameter in [0, 1]
+static float segment_param(const float* p, const float* a, const float* b) {
+    float ab[3], ap[3];
+    sub3(b, a, ab);
+    sub3(p, a, ap);
+    float len_sq = dot3(ab, ab);
+    float t = len_sq > 0.0f ? dot3(ap, ab) / len_sq : 0.0f;
+    return t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+}
+
+static void lerp3(const float* a, const float* b, float t, float* out) {
+    for (int c = 0; c < 3; c++) out[c] = a[c] + (b[c] - a[c]) * t;
+}
+
+// Closest point on triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5)
+static void closest_on_triangle(const float* p, const float* a, const float* b, const float* c, float* out) {
+    float ab[3], ac[3], ap[3], bp[3], cp[3];
+    sub3(b, a, ab);
+    sub3(c, a, ac);
+    sub3(p, a, ap);
+    float d1 = dot3(ab, ap), d2 = dot3(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) { memcpy(out, a, 12); return; }
+
+    sub3(p, b, bp);
+    float d3 = dot3(ab, bp), d4 = dot3(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) { memcpy(out, b, 12); return; }
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) { lerp3(a, b, d1 / (d1 - d3), out); return; }
+
+    sub3(p, c, cp);
+    float d5 = dot3(ab, cp), d6 = dot3(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) { memcpy(out, c, 12); return; }
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) { lerp3(a, c, d2 / (d2 - d6), out); return; }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        lerp3(b, c, (d4 - d3) / ((d4 - d3) + (d5 - d6)), out);
+        return;
+    }
+
+    float denom = 1.0f / (va + vb + vc);
+    float v = vb * denom, w = vc * denom;
+    for (int k = 0; k < 3; k++) out[k] = a[k] + ab[k] * v + ac[k] * w;
+}
+
+// Closest points between segments p1q1 and p2q2 (Ericson 5.1.9)
+static void closest_segment_segment(const float* p1, const float* q1, const float* p2, const float* q2,
+                                    float* c1, float* c2) {
+    float d1[3], d2[3], r[3];
+    sub3(q1, p1, d1);
+    sub3(q2, p2, d2);
+    sub3(p1, p2, r);
+    float a = dot3(d1, d1), e = dot3(d2, d2), f = dot3(d2, r);
+    float s, t;
+    if (a <= 1e-12f && e <= 1e-12f) {
+        s = t = 0.0f;
+    } else if (a <= 1e-12f) {
+        s = 0.0f;
+        t = f / e;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    } else {
+        float c = dot3(d1, r);
+        if (e <= 1e-12f) {
+            t = 0.0f;
+            s = -c / a;
+            s = s < 0.0f ? 0.0f : (s > 1.0f ? 1.0f : s);
+        } else {
+            float b = dot3(d1, d2), denom = a * e - b * b;
+            s = denom != 0.0f ? (b * f - c * e) / denom : 0.0f;
+            s = s < 0.0f ? 0.0f : (s > 1.0f ? 1.0f : s);
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = -c / a;
+                s = s < 0.0f ? 0.0f : (s > 1.0f ? 1.0f : s);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = (b - c) / a;
+                s = s < 0.0f ? 0.0f : (s > 1.0f ? 1.0f : s);
+            }
+        }
+    }
+    lerp3(p1, q1, s, c1);
+    lerp3(p2, q2, t, c2);
+}
+
+// Two-sided Moller-Trumbore; t along dir, or -1 on a miss
+static float ray_triangle(const float* o, const float* dir, const float* a, const float* b, const float* c) {
+    float e1[3], e2[3], pv[3], tv[3], qv[3];
+    sub3(b, a, e1);
+    sub3(c, a, e2);
+    cross3(dir, e2, pv);
+    float det = dot3(e1, pv);
+    if (fabsf(det) < 1e-12f) return -1.0f;
+    float inv = 1.0f / det;
+    sub3(o, a, tv);
+    float u = dot3(tv, pv) * inv;
+    if (u < 0.0f || u > 1.0f) return -1.0f;
+    cross3(tv, e1, qv);
+    float v = dot3(dir, qv) * inv;
+    if (v < 0.0f || u + v > 1.0f) return -1.0f;
+    return dot3(e2, qv) * inv;
+}
+
+// Ray against capsule (segment ab, radius r) for a unit dir; t or -1
+static float ray_capsule(const float* o, const float* dir, const float* a, const float* b, float r) {
+    float ba[3], oa[3];
+    sub3(b, a, ba);
+    sub3(o, a, oa);
+    float baba = dot3(ba, ba), bard = dot3(ba, dir), baoa = dot3(ba, oa);
+    float rdoa = dot3(dir, oa), oaoa = dot3(oa, oa);
+    float qa = baba - bard * bard;
+    float qb = baba * rdoa - baoa * bard;
+    float qc = baba * oaoa - baoa * baoa - r * r * baba;
+    if (qa > 1e-12f) {
+        float h = qb * qb - qa * qc;
+        if (h >= 0.0f) {
+            float t = (-qb - sqrtf(h)) / qa;
+            float y = baoa + t * bard;
+            if (y > 0.0f && y < baba) return t;
+        }
+    }
+    // Caps
+    float best = -1.0f;
+    for (int cap = 0; cap < 2; cap++) {
+        const float* center = cap ? b : a;
+        float oc[3];
+        sub3(o, center, oc);
+        float hb = dot3(oc, dir), hc = dot3(oc, oc) - r * r;
+        float h = hb * hb - hc;
+        if (h < 0.0f) continue;
+        float t = -hb - sqrtf(h);
+        if (t >= 0.0f && (best < 0.0f || t < best)) best = t;
+    }
+    return best;
+}
+
+static void triangle_normal(const float* tri, float* out) {
+    float e1[3], e2[3];
+    sub3(tri + 3, tri, e1);
+    sub3(tri + 6, tri, e2);
+    cross3(e1, e2, out);
+    normalize_or(out, BVH_UP);
+}
+
+// Closest surface point of primitive i to p; returns the squared surface distance
+static float prim_closest(const BVH& bvh, uint32_t i, const float* p, float* point, float* normal) {
+    const float* prim = &bvh.prims[(size_t)i * bvh.stride];
+    if (bvh.kind == BVH_TRIANGLES) {
+        closest_on_triangle(p, prim, prim + 3, prim + 6, point);
+        triangle_normal(prim, normal);
+        return dist_sq3(p, point);
+    }
+
+    float axis[3];
+    lerp3(prim, prim + 3, segment_param(p, prim, prim + 3), axis);
+    sub3(p, axis, normal);
+    float d = sqrtf(dot3(normal, normal));
+    normalize_or(normal, BVH_UP);
+    float surface = d > prim[6] ? d - prim[6] : 0.0f;
+    for (int c = 0; c < 3; c++) point[c] = axis[c] + normal[c] * (d > prim[6] ? prim[6] : d);
+    return surface * surface;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+void bvh_closest_one(const BVH& bvh, const float* p, float max_dist_sq, BVH_HIT& hit) {
+    hit.primitive = -1;
+    hit.distance = INFINITY;
+    if (bvh.nodes.empty()) return;
+
+    float best = max_dist_sq;
+    uint32_t stack[BVH_STACK_SIZE];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top) {
+        uint32_t n = stack[--top];
+        const BvhNode& node = bvh.nodes[n];
+        if (box_dist_sq(node, p) > best) continue;
+        if (node.count) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                float point[3], normal[3];
+                float d = prim_closest(bvh, i, p, point, normal);
+                if (d <= best) {
+                    best = d;
+                    hit.primitive = (int32_t)i;
+                    memcpy(hit.point, point, 12);
+                    memcpy(hit.normal, normal, 12);
+                }
+            }
+            continue;
+        }
+        // Nearer child on top of the stack
+        uint32_t left = n + 1, right = node.first;
+        float dl = box_dist_sq(bvh.nodes[left], p), dr = box_dist_sq(bvh.nodes[right], p);
+        if (dl < dr) {
+            stack[top++] = right;
+            stack[top++] = left;
+        } else {
+            stack[top++] = left;
+            stack[top++] = right;
+        }
+    }
+    if (hit.primitive >= 0) {
+        hit.distance = sqrtf(best);
+        hit.primitive = bvh.ids[hit.primitive];
+    }
+}
+
+static bool valid_points(const void* tree, const float* points, uint32_t count, const void* out) {
+    return tree && out && (count == 0 || points);
+}
+
+/*
+ * Closest primitive surface point for a batch of points
+ *
+ * Parameters:
+ *   bvh           - Tree from bvh_build_*
+ *   points        - count * 3 floats
+ *   count         - Number of points
+ *   max_distance  - Ignore primitives further than this (INFINITY for no limit)
+ *   out_hits      - Receives count hits (primitive -1 past max_distance)
+ *
+ * Returns:
+ *   0 on success, -5 on invalid arguments
+ */
+DLL_EXPORT int bvh_closest(const BVH* bvh, const float* points, uint32_t count, float max_distance,
+                           BVH_HIT* out_hits) {
+    if (!valid_points(bvh, points, count, out_hits) || !(max_distance >= 0.0f)) return -5;
+    const float max_dist_sq = max_distance * max_distance;
+    global_thread_pool().parallel_for((count + BVH_QUERY_CHUNK - 1) / BVH_QUERY_CHUNK, 0, [&](size_t chunk) {
+        size_t end = std::min((size_t)count, (chunk + 1) * BVH_QUERY_CHUNK);
+        for (size_t q = chunk * BVH_QUERY_CHUNK; q < end; q++) bvh_closest_one(*bvh, points + q * 3, max_dist_sq, out_hits[q]);
+    });
+    return 0;
+}
+
+/*
+ * k nearest primitives for a batch of points
+ *
+ * Parameters:
+ *   bvh            - Tree from bvh_build_*
+ *   points         - count * 3 floats
+ *   count          - Number of points
+ *   k              - Primitives per point (1-16)
+ *   max_distance   - Ignore primitives further than this (INFINITY for no limit)
+ *   out_prims      - Receives count * k primitive indices, nearest first, -1 past the last found
+ *   out_distances  - Receives count * k surface distances (INFINITY past the last found)
+ *
+ * Returns:
+ *   0 on success, -5 on invalid arguments
+ */
+DLL_EXPORT int bvh_nearest(const BVH* bvh, const float* points, uint32_t count, uint32_t k, float max_distance,
+                           int32_t* out_prims, float* out_distances) {
+    if (!valid_points(bvh, points, count, out_prims) || !out_distances) return -5;
+    if (k < 1 || k > BVH_MAX_NEAREST || !(max_distance >= 0.0f)) return -5;
+    const float max_dist_sq = max_distance * max_distance;
+
+    global_thread_pool().parallel_for((count + BVH_QUERY_CHUNK - 1) / BVH_QUERY_CHUNK, 0, [&](size_t chunk) {
+        size_t end = std::min((size_t)count, (chunk + 1) * BVH_QUERY_CHUNK);
+        for (size_t q = chunk * BVH_QUERY_CHUNK; q < end; q++) {
+            const float* p = points + q * 3;
+            int32_t prims[BVH_MAX_NEAREST];
+            float dists[BVH_MAX_NEAREST];   // Squared, ascending
+            uint32_t found = 0;
+            auto bound = [&]() { return found == k ? dists[k - 1] : max_dist_sq; };
+
+            uint32_t stack[BVH_STACK_SIZE];
+            uint32_t top = 0;
+            if (!bvh->nodes.empty()) stack[top++] = 0;
+            while (top) {
+                uint32_t n = stack[--top];
+                const BvhNode& node = bvh->nodes[n];
+                if (box_dist_sq(node, p) > bound()) continue;
+                if (node.count) {
+                    for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                        float point[3], normal[3];
+                        float d = prim_closest(*bvh, i, p, point, normal);
+                        if (d > bound() || (found == k && d == dists[k - 1])) continue;
+                        uint32_t slot = found < k ? found++ : k - 1;
+                        while (slot > 0 && d < dists[slot - 1]) {
+                            dists[slot] = dists[slot - 1];
+                            prims[slot] = prims[slot - 1];
+                            slot--;
+                        }
+                        dists[slot] = d;
+                        prims[slot] = bvh->ids[i];
+                    }
+                    continue;
+                }
+                uint32_t left = n + 1, right = node.first;
+                float dl = box_dist_sq(bvh->nodes[left], p), dr = box_dist_sq(bvh->nodes[right], p);
+                if (dl < dr) {
+                    stack[top++] = right;
+                    stack[top++] = left;
+                } else {
+                    stack[top++] = left;
+                    stack[top++] = right;
+                }
+            }
+
+            for (uint32_t j = 0; j < k; j++) {
+                out_prims[q * k + j] = j < found ? prims[j] : -1;
+                out_distances[q * k + j] = j < found ? sqrtf(dists[j]) : INFINITY;
+            }
+        }
+    });
+    return 0;
+}
+
+/*
+ * First hit along a batch of rays
+ *
+ * Parameters:
+ *   bvh           - Tree from bvh_build_*
+ *   origins       - count * 3 floats
+ *   directions    - count * 3 floats (normalized internally)
+ *   count         - Number of rays
+ *   max_distance  - Ray length (INFINITY for no limit)
+ *   out_hits      - Receives count hits; distance is along the ray, normal faces the ray origin
+ *
+ * Returns:
+ *   0 on success, -5 on invalid arguments
+ */
+DLL_EXPORT int bvh_raycast(const BVH* bvh, const float* origins, const float* directions, uint32_t count,
+                           float max_distance, BVH_HIT* out_hits) {
+    if (!valid_points(bvh, origins, count, out_hits) || (count && !directions) || !(max_distance >= 0.0f)) return -5;
+
+    global_thread_pool().parallel_for((count + BVH_QUERY_CHUNK - 1) / BVH_QUERY_CHUNK, 0, [&](size_t chunk) {
+        size_t end = std::min((size_t)count, (chunk + 1) * BVH_QUERY_CHUNK);
+        for (size_t q = chunk * BVH_QUERY_CHUNK; q < end; q++) {
+            const float* o = origins + q * 3;
+            float dir[3] = {directions[q * 3], directions[q * 3 + 1], directions[q * 3 + 2]};
+            BVH_HIT& hit = out_hits[q];
+            hit.primitive = -1;
+            hit.distance = INFINITY;
+            float len = sqrtf(dot3(dir, dir));
+            if (!(len > 0.0f) || bvh->nodes.empty()) continue;
+            float inv[3];
+            for (int c = 0; c < 3; c++) {
+                dir[c] /= len;
+                inv[c] = 1.0f / dir[c];
+            }
+
+            float best = max_distance;
+            int32_t best_prim = -1;
+            auto slab = [&](const BvhNode& n) {
+                float t0 = 0.0f, t1 = best;
+                for (int c = 0; c < 3; c++) {
+                    float a = (n.lo[c] - o[c]) * inv[c], b = (n.hi[c] - o[c]) * inv[c];
+                    if (a > b) std::swap(a, b);
+                    t0 = a > t0 ? a : t0;
+                    t1 = b < t1 ? b : t1;
+                    if (t0 > t1) return INFINITY;
+                }
+                return t0;
+            };
+
+            uint32_t stack[BVH_STACK_SIZE];
+            uint32_t top = 0;
+            stack[top++] = 0;
+            while (top) {
+                uint32_t n = stack[--top];
+                const BvhNode& node = bvh->nodes[n];
+                if (slab(node) == INFINITY) continue;
+                if (node.count) {
+                    for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                        const float* prim = &bvh->prims[(size_t)i * bvh->stride];
+                        float t = bvh->kind == BVH_TRIANGLES ? ray_triangle(o, dir, prim, prim + 3, prim + 6)
+                                                             : ray_capsule(o, dir, prim, prim + 3, prim[6]);
+                        if (t >= 0.0f && t <= best) {
+                            best = t;
+                            best_prim = (int32_t)i;
+                        }
+                    }
+                    continue;
+                }
+                uint32_t left = n + 1, right = node.first;
+                float tl = slab(bvh->nodes[left]), tr = slab(bvh->nodes[right]);
+                if (tl < tr) {
+                    if (tr != INFINITY) stack[top++] = right;
+                    stack[top++] = left;
+                } else {
+                    if (tl != INFINITY) stack[top++] = left;
+                    if (tr != INFINITY) stack[top++] = right;
+                }
+            }
+            if (best_prim < 0) continue;
+
+            const float* prim = &bvh->prims[(size_t)best_prim * bvh->stride];
+            for (int c = 0; c < 3; c++) hit.point[c] = o[c] + dir[c] * best;
+            if (bvh->kind == BVH_TRIANGLES) {
+                triangle_normal(prim, hit.normal);
+                if (dot3(hit.normal, dir) > 0.0f) {
+                    for (int c = 0; c < 3; c++) hit.normal[c] = -hit.normal[c];
+                }
+            } else {
+                float axis[3];
+                lerp3(prim, prim + 3, segment_param(hit.point, prim, prim + 3), axis);
+                sub3(hit.point, axis, hit.normal);
+                normalize_or(hit.normal, BVH_UP);
+            }
+            hit.primitive = bvh->ids[best_prim];
+            hit.distance = best;
+        }
+    });
+    return 0;
+}
+
+// Closest points between query segment pq and primitive i; squared surface distance
+static float prim_segment_closest(const BVH& bvh, uint32_t i, const float* p, const float* q, float* point,
+                                  float* normal) {
+    const float* prim = &bvh.prims[(size_t)i * bvh.stride];
+    if (bvh.kind == BVH_CAPSULES) {
+        float on_query[3], axis[3];
+        closest_segment_segment(p, q, prim, prim + 3, on_query, axis);
+        sub3(on_query, axis, normal);
+        float d = sqrtf(dot3(normal, normal));
+        normalize_or(normal, BVH_UP);
+        float surface = d > prim[6] ? d - prim[6] : 0.0f;
+        for (int c = 0; c < 3; c++) point[c] = axis[c] + normal[c] * (d > prim[6] ? prim[6] : d);
+        return surface * surface;
+    }
+
+    triangle_normal(prim, normal);
+    float dir[3];
+    sub3(q, p, dir);
+    float t = ray_triangle(p, dir, prim, prim + 3, prim + 6);
+    if (t >= 0.0f && t <= 1.0f) {
+        lerp3(p, q, t, point);
+        return 0.0f;
+    }
+
+    // Endpoints against the face, then the segment against every edge
+    float best = INFINITY;
+    float candidate[3], on_query[3];
+    closest_on_triangle(p, prim, prim + 3, prim + 6, candidate);
+    if (dist_sq3(p, candidate) < best) { best = dist_sq3(p, candidate); memcpy(point, candidate, 12); }
+    closest_on_triangle(q, prim, prim + 3, prim + 6, candidate);
+    if (dist_sq3(q, candidate) < best) { best = dist_sq3(q, candidate); memcpy(point, candidate, 12); }
+    for (int e = 0; e < 3; e++) {
+        closest_segment_segment(p, q, prim + e * 3, prim + ((e + 1) % 3) * 3, on_query, candidate);
+        float d = dist_sq3(on_query, candidate);
+        if (d < best) { best = d; memcpy(point, candidate, 12); }
+    }
+    return best;
+}
+
+/*
+ * Closest primitive to each of a batch of capsules, reported when it is
+ * within the capsule radius
+ *
+ * Parameters:
+ *   bvh        - Tree from bvh_build_*
+ *   segments   - count * 6 floats: start xyz, end xyz
+ *   radii      - count capsule radii
+ *   count      - Number of capsules
+ *   out_hits   - Receives count hits (primitive -1 when nothing is within the radius);
+ *                distance is the gap between the capsule axis and the primitive surface
+ *
+ * Returns:
+ *   0 on success, -5 on invalid arguments
+ */
+DLL_EXPORT int bvh_capsule_query(const BVH* bvh, const float* segments, const float* radii, uint32_t count,
+                                 BVH_HIT* out_hits) {
+    if (!valid_points(bvh, segments, count, out_hits) || (count && !radii)) return -5;
+
+    global_thread_pool().parallel_for((count + BVH_QUERY_CHUNK - 1) / BVH_QUERY_CHUNK, 0, [&](size_t chunk) {
+        size_t end = std::min((size_t)count, (chunk + 1) * BVH_QUERY_CHUNK);
+        for (size_t q = chunk * BVH_QUERY_CHUNK; q < end; q++) {
+            const float* a = segments + q * 6;
+            const float* b = a + 3;
+            BVH_HIT& hit = out_hits[q];
+            hit.primitive = -1;
+            hit.distance = INFINITY;
+            if (!(radii[q] >= 0.0f) || bvh->nodes.empty()) continue;
+
+            float lo[3], hi[3];
+            for (int c = 0; c < 3; c++) {
+                lo[c] = a[c] < b[c] ? a[c] : b[c];
+                hi[c] = a[c] < b[c] ? b[c] : a[c];
+            }
+            float best = radii[q] * radii[q];
+            int32_t best_prim = -1;
+
+            uint32_t stack[BVH_STACK_SIZE];
+            uint32_t top = 0;
+            stack[top++] = 0;
+            while (top) {
+                uint32_t n = stack[--top];
+                const BvhNode& node = bvh->nodes[n];
+                if (box_box_dist_sq(node, lo, hi) > best) continue;
+                if (node.count) {
+                    for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                        float point[3], normal[3];
+                        float d = prim_segment_closest(*bvh, i, a, b, point, normal);
+                        if (d <= best) {
+                            best = d;
+                            best_prim = (int32_t)i;
+                            memcpy(hit.point, point, 12);
+                            memcpy(hit.normal, normal, 12);
+                        }
+                    }
+                    continue;
+                }
+                stack[top++] = node.first;
+                stack[top++] = n + 1;
+            }
+            if (best_prim >= 0) {
+                hit.primitive = bvh->ids[best_prim];
+                hit.distance = sqrtf(best);
+            }
+        }
+    });
+    return 0;
+}
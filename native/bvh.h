@@ -0,0 +1,24 @@
+#ifndef BVH_H
+#define BVH_H
+
+/*
+ * Shared declarations for the BVH in bvh.cpp, for native code that queries
+ * trees built through the bvh_build_* exports
+ */
+
+#include <cstdint>
+
+struct BVH;
+
+// Result of a closest point, ray or capsule query; primitive is -1 on a miss
+typedef struct {
+    int32_t primitive;          // Index as passed to the build call
+    float distance;             // Surface distance (ray: distance along the normalized direction)
+    float point[3];             // Point on the primitive
+    float normal[3];            // Triangle: face normal; capsule: outward from the axis
+} BVH_HIT;
+
+// Closest primitive surface point to p within sqrt(max_dist_sq), single-threaded
+void bvh_closest_one(const BVH& bvh, const float* p, float max_dist_sq, BVH_HIT& hit);
+
+#endif // BVH_H
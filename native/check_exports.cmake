@@ -0,0 +1,27 @@
+# Fails if a library exports C++ (mangled) symbols; its API is extern "C" only
+#
+#   cmake -DNM=<nm> -DLIBRARY=<shared library> -P check_exports.cmake
+
+if(APPLE)
+    set(NM_ARGS -g -U)
+else()
+    set(NM_ARGS -D --defined-only)
+endif()
+
+execute_process(
+    COMMAND "${NM}" ${NM_ARGS} "${LIBRARY}"
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${LIBRARY}")
+endif()
+
+# Mach-O prefixes every symbol with an underscore
+string(REGEX MATCHALL "[ \t]_?_Z[^\n]*" exported "${symbols}")
+if(exported)
+    list(LENGTH exported count)
+    list(GET exported 0 first)
+    string(STRIP "${first}" first)
+    message(FATAL_ERROR "${LIBRARY} exports ${count} C++ symbols (first: ${first}); "
+                        "keep them local (bin_parser.ver, -fvisibility-inlines-hidden)")
+endif()
@@ -0,0 +1,106 @@
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+/*
+ * Read-only memory mapping of a whole file (UTF-8 path)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file; returns false if it can't be opened or is empty
+    bool open(const char* path) {
+        close();
+#ifdef _WIN32
+        int wlen = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+        if (wlen <= 0) return false;
+        std::wstring wpath((size_t)wlen, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path, -1, &wpath[0], wlen);
+
+        file_ = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_, &file_size) || file_size.QuadPart == 0) {
+            close();
+            return false;
+        }
+
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) { close(); return false; }
+
+        data_ = (const uint8_t*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (!data_) { close(); return false; }
+        size_ = (size_t)file_size.QuadPart;
+#else
+        fd_ = ::open(path, O_RDONLY);
+        if (fd_ < 0) return false;
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0 || st.st_size == 0) {
+            close();
+            return false;
+        }
+
+        void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (view == MAP_FAILED) { close(); return false; }
+        data_ = (const uint8_t*)view;
+        size_ = (size_t)st.st_size;
+        madvise(view, size_, MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_) munmap((void*)data_, size_);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+#endif // FILE_MAP_H
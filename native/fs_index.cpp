@@ -0,0 +1,732 @@
+/*
+ * Filesystem Index - in-memory listing of an extracted WAD tree
+ * Compiled into lol_native.dll alongside lol_native.cpp
+ *
+ * One recursive walk records every directory and file under a root, so
+ * BIN discovery and texture resolution become hash lookups instead of
+ * exists()/glob() probes (each of which is a round trip on network shares).
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_reader.h"
+#include "file_map.h"
+#include "platform.h"
+
+#ifndef _WIN32
+    #include <dirent.h>
+#endif
+
+// ============================================================================
+// Directory Listing
+// ============================================================================
+
+#define FS_FIND_RECURSIVE   0x1     // Also search below dir
+
+#define FS_INDEX_MAGIC      0x58495346  // "FSIX"
+#define FS_INDEX_VERSION    1
+
+#ifdef _WIN32
+static const char PATH_SEP = '\\';
+#else
+static const char PATH_SEP = '/';
+#endif
+
+struct FsFile {
+    std::string name;
+    uint64_t size;
+    uint64_t mtime;             // Only compared for equality, units are platform specific
+};
+
+// A directory as it was listed. Its own mtime changes whenever an entry is
+// added, removed or renamed, which is what refresh relies on.
+struct FsDir {
+    std::string path;           // Relative to the root, '/' separated, original case
+    uint64_t mtime = 0;
+    std::vector<FsFile> files;
+    std::vector<std::string> subdirs;
+};
+
+static void ascii_lower(std::string& s) {
+    for (auto& c : s) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+}
+
+// Lowercase, '/' separated, no leading, trailing or doubled separators
+static std::string normalize_key(const char* rel_path) {
+    std::string key;
+    for (const char* p = rel_path; *p; p++) {
+        char c = *p == '\\' ? '/' : *p;
+        if (c == '/' && (key.empty() || key.back() == '/')) continue;
+        key += c;
+    }
+    if (!key.empty() && key.back() == '/') key.pop_back();
+    ascii_lower(key);
+    return key;
+}
+
+static std::string join_rel(const std::string& dir, const std::string& name) {
+    return dir.empty() ? name : dir + '/' + name;
+}
+
+static std::string to_native(const std::string& root, const std::string& rel) {
+    std::string full = root;
+    if (!rel.empty()) {
+        full += PATH_SEP;
+        for (char c : rel) full += c == '/' ? PATH_SEP : c;
+    }
+    return full;
+}
+
+#ifdef _WIN32
+static std::wstring widen(const std::string& utf8) {
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, nullptr, 0);
+    if (wlen <= 0) return std::wstring();
+    std::wstring wide((size_t)wlen, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wide[0], wlen);
+    wide.resize((size_t)wlen - 1);
+    return wide;
+}
+
+static std::string narrow(const wchar_t* wide) {
+    int len = WideCharToMultiByte(CP_UTF8, 0, wide, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return std::string();
+    std::string utf8((size_t)len, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, wide, -1, &utf8[0], len, nullptr, nullptr);
+    utf8.resize((size_t)len - 1);
+    return utf8;
+}
+
+static uint64_t filetime_u64(const FILETIME& ft) {
+    return ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
+#endif
+
+// Modification time of a directory; false if it is gone or not a directory
+static bool stat_dir(const std::string& full_path, uint64_t& mtime) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExW(widen(full_path).c_str(), GetFileExInfoStandard, &attr)) return false;
+    if (!(attr.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) return false;
+    mtime = filetime_u64(attr.ftLastWriteTime);
+#else
+    struct stat st;
+    if (stat(full_path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+    mtime = platform_stat_mtime_ns(&st);
+#endif
+    return true;
+}
+
+// Reads the entries of one directory (not recursive)
+static bool list_dir(const std::string& full_path, FsDir& dir) {
+    dir.files.clear();
+    dir.subdirs.clear();
+#ifdef _WIN32
+    WIN32_FIND_DATAW data;
+    HANDLE find = FindFirstFileExW(widen(full_path + "\\*").c_str(), FindExInfoBasic, &data,
+                                   FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (find == INVALID_HANDLE_VALUE) return false;
+    do {
+        if (wcscmp(data.cFileName, L".") == 0 || wcscmp(data.cFileName, L"..") == 0) continue;
+        // Junctions and symlinks could loop back into the tree
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+
+        std::string name = narrow(data.cFileName);
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            dir.subdirs.push_back(std::move(name));
+        } else {
+            uint64_t size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+            dir.files.push_back(FsFile{ std::move(name), size, filetime_u64(data.ftLastWriteTime) });
+        }
+    } while (FindNextFileW(find, &data));
+    FindClose(find);
+#else
+    DIR* handle = opendir(full_path.c_str());
+    if (!handle) return false;
+    int dir_fd = dirfd(handle);
+    while (struct dirent* ent = readdir(handle)) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+
+        struct stat st;
+        if (fstatat(dir_fd, ent->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            dir.subdirs.push_back(ent->d_name);
+        } else if (S_ISREG(st.st_mode)) {
+            dir.files.push_back(FsFile{ ent->d_name, (uint64_t)st.st_size, platform_stat_mtime_ns(&st) });
+        }
+    }
+    closedir(handle);
+#endif
+    return true;
+}
+
+// Matches a file name against a '*'/'?' pattern, ASCII case-insensitive
+static bool match_pattern(const char* pattern, const char* name) {
+    const char* star = nullptr;
+    const char* resume = nullptr;
+    while (*name) {
+        char p = *pattern, n = *name;
+        if (p >= 'A' && p <= 'Z') p = (char)(p - 'A' + 'a');
+        if (n >= 'A' && n <= 'Z') n = (char)(n - 'A' + 'a');
+
+        if (p == '*') {
+            star = pattern++;
+            resume = name;
+        } else if (p == '?' || p == n) {
+            pattern++;
+            name++;
+        } else if (star) {
+            pattern = star + 1;
+            name = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '*') pattern++;
+    return *pattern == '\0';
+}
+
+// ============================================================================
+// Index
+// ============================================================================
+
+struct FS_INDEX {
+    std::string root;                                   // As given, without trailing separator
+    std::unordered_map<std::string, FsDir> dirs;        // Keyed by lowercase relative path
+
+    // Derived from dirs by rebuild_lookup
+    std::unordered_map<std::string, std::pair<const FsDir*, size_t>> files;    // Lowercase path -> file
+    std::unordered_map<std::string, std::vector<std::string>> names;            // Lowercase name -> paths
+
+    void rebuild_lookup() {
+        files.clear();
+        names.clear();
+        for (const auto& [key, dir] : dirs) {
+            for (size_t i = 0; i < dir.files.size(); i++) {
+                std::string name = dir.files[i].name;
+                ascii_lower(name);
+                std::string file_key = join_rel(key, name);
+                names[name].push_back(file_key);
+                files.emplace(std::move(file_key), std::make_pair(&dir, i));
+            }
+        }
+    }
+
+    // After an allocation failure part way through changing dirs, files may
+    // point at moved entries: drop the lookup so the index only misses until
+    // the next successful refresh
+    void drop_lookup() {
+        files.clear();
+        names.clear();
+    }
+
+    // Lists key and everything below it. Directories whose mtime is unchanged
+    // in previous are reused without listing them again.
+    void walk(const std::string& key, const std::string& rel, std::unordered_map<std::string, FsDir>* previous,
+              uint32_t& listed) {
+        std::string full = to_native(root, rel);
+        uint64_t mtime;
+        if (!stat_dir(full, mtime)) return;
+
+        FsDir dir;
+        auto old = previous ? previous->find(key) : std::unordered_map<std::string, FsDir>::iterator();
+        if (previous && old != previous->end() && old->second.mtime == mtime) {
+            dir = std::move(old->second);
+        } else {
+            if (!list_dir(full, dir)) return;
+            dir.mtime = mtime;
+            listed++;
+        }
+        dir.path = rel;
+
+        std::vector<std::string> subdirs = dir.subdirs;
+        dirs[key] = std::move(dir);
+
+        for (const auto& sub : subdirs) {
+            std::string sub_key = sub;
+            ascii_lower(sub_key);
+            walk(join_rel(key, sub_key), join_rel(rel, sub), previous, listed);
+        }
+    }
+
+    // Moves key and every directory below it out of dirs into out (if given)
+    void take_subtree(const std::string& key, std::unordered_map<std::string, FsDir>* out) {
+        for (auto it = dirs.begin(); it != dirs.end();) {
+            const std::string& k = it->first;
+            bool inside = key.empty() || k == key ||
+                          (k.size() > key.size() && k.compare(0, key.size(), key) == 0 && k[key.size()] == '/');
+            if (!inside) {
+                ++it;
+                continue;
+            }
+            if (out) out->emplace(k, std::move(it->second));
+            it = dirs.erase(it);
+        }
+    }
+
+    // Lists an indexed directory again if its mtime changed, dropping the
+    // subdirectories it no longer has. False if it is gone (and dropped).
+    bool refresh_one(const std::string& key, uint32_t& listed) {
+        FsDir& dir = dirs.at(key);
+        std::string full = to_native(root, dir.path);
+        uint64_t mtime;
+        if (!stat_dir(full, mtime)) {
+            take_subtree(key, nullptr);
+            return false;
+        }
+        if (mtime == dir.mtime) return true;
+
+        FsDir fresh;
+        if (!list_dir(full, fresh)) return true;
+        fresh.mtime = mtime;
+        fresh.path = dir.path;
+        listed++;
+
+        std::vector<std::string> kept;
+        for (const auto& sub : fresh.subdirs) {
+            kept.push_back(sub);
+            ascii_lower(kept.back());
+        }
+        for (std::string sub : dir.subdirs) {
+            ascii_lower(sub);
+            if (std::find(kept.begin(), kept.end(), sub) == kept.end()) take_subtree(join_rel(key, sub), nullptr);
+        }
+        // Erasing other entries leaves references to this one valid
+        dir = std::move(fresh);
+        return true;
+    }
+};
+
+static std::string trim_root(const char* root) {
+    std::string trimmed = root;
+    while (trimmed.size() > 1 && (trimmed.back() == '/' || trimmed.back() == '\\')) trimmed.pop_back();
+    return trimmed;
+}
+
+static int return_lines(const std::vector<std::string>& lines, uint8_t** out_data, uint32_t* out_size) {
+    std::string text;
+    for (const auto& line : lines) {
+        text += line;
+        text += '\n';
+    }
+
+    uint8_t* data = (uint8_t*)malloc(text.size() + 1);
+    if (!data) return -4;
+    memcpy(data, text.c_str(), text.size() + 1);
+    *out_data = data;
+    *out_size = (uint32_t)text.size();
+    return 0;
+}
+
+/*
+ * Index every directory and file under a root
+ *
+ * Parameters:
+ *   root       - Folder to index (UTF-8), usually the extracted WAD root
+ *   out_index  - Receives the index (free with fs_index_free)
+ *
+ * Symlinks and junctions are not followed. An index must not be refreshed
+ * while another thread uses it.
+ *
+ * Returns:
+ *   0 on success, -1 if root is not a readable directory, -4 on allocation
+ *   failure, -5 on invalid arguments
+ */
+DLL_EXPORT int fs_index_build(const char* root, FS_INDEX** out_index) {
+    if (!root || !out_index) return -5;
+    *out_index = nullptr;
+
+    FS_INDEX* index = new (std::nothrow) FS_INDEX();
+    if (!index) return -4;
+
+    try {
+        index->root = trim_root(root);
+
+        uint32_t listed = 0;
+        index->walk("", "", nullptr, listed);
+        if (index->dirs.empty()) {
+            delete index;
+            return -1;
+        }
+        index->rebuild_lookup();
+    } catch (const std::bad_alloc&) {
+        delete index;
+        return -4;
+    }
+    *out_index = index;
+    return 0;
+}
+
+/*
+ * Bring an index up to date with the disk
+ *
+ * Each known directory is stat'ed once; only directories whose modification
+ * time changed are listed again, and removed ones drop out with everything
+ * below them. Files edited in place keep their recorded size and time.
+ *
+ * Parameters:
+ *   index         - Index to update
+ *   out_listed    - Receives the number of directories that were re-listed (optional)
+ *
+ * Returns:
+ *   0 on success, -1 if the root is gone, -4 on allocation failure (the
+ *   index then finds nothing until a refresh succeeds), -5 on invalid arguments
+ */
+DLL_EXPORT int fs_index_refresh(FS_INDEX* index, uint32_t* out_listed) {
+    if (!index) return -5;
+
+    try {
+        std::unordered_map<std::string, FsDir> previous = std::move(index->dirs);
+        index->dirs.clear();
+
+        uint32_t listed = 0;
+        index->walk("", "", &previous, listed);
+        index->rebuild_lookup();
+        if (out_listed) *out_listed = listed;
+        return index->dirs.empty() ? -1 : 0;
+    } catch (const std::bad_alloc&) {
+        index->drop_lookup();
+        return -4;
+    }
+}
+
+/*
+ * Bring one directory of an index up to date with the disk
+ *
+ * Every directory on the way from the root to dir is stat'ed and re-listed
+ * if it changed, so a new dir is found; one that wasn't indexed yet is
+ * listed with everything below it. With FS_FIND_RECURSIVE the directories
+ * below dir are refreshed as well, as fs_index_refresh does for the root.
+ * Cheaper than fs_index_refresh when a lookup or find in dir missed.
+ *
+ * Parameters:
+ *   index         - Index to update
+ *   dir           - Directory relative to the root ("" for the root)
+ *   flags         - FS_FIND_RECURSIVE to refresh the subdirectories of dir too
+ *   out_listed    - Receives the number of directories that were re-listed (optional)
+ *
+ * Returns:
+ *   0 on success (also when dir doesn't exist), -1 if the root is gone,
+ *   -4 on allocation failure (as for fs_index_refresh), -5 on invalid arguments
+ */
+DLL_EXPORT int fs_index_refresh_dir(FS_INDEX* index, const char* dir, uint32_t flags, uint32_t* out_listed) {
+    if (!index || !dir) return -5;
+
+    try {
+        const std::string target = normalize_key(dir);
+        const size_t dir_count = index->dirs.size();
+        uint32_t listed = 0;
+        bool moved = false;
+
+        std::string key;
+        size_t pos = 0;
+        while (index->dirs.count(key)) {
+            if (key == target) {
+                if (flags & FS_FIND_RECURSIVE) {
+                    std::unordered_map<std::string, FsDir> previous;
+                    index->take_subtree(key, &previous);
+                    std::string rel = previous.at(key).path;
+                    index->walk(key, rel, &previous, listed);
+                    moved = true;
+                } else {
+                    index->refresh_one(key, listed);
+                }
+                break;
+            }
+            if (!index->refresh_one(key, listed)) break;
+
+            // Next component of target, in its on-disk case
+            size_t end = target.find('/', pos);
+            if (end == std::string::npos) end = target.size();
+            std::string name = target.substr(pos, end - pos);
+            pos = end + 1;
+
+            const FsDir& parent = index->dirs.at(key);
+            const std::string* sub = nullptr;
+            for (const auto& candidate : parent.subdirs) {
+                std::string lower = candidate;
+                ascii_lower(lower);
+                if (lower == name) {
+                    sub = &candidate;
+                    break;
+                }
+            }
+            if (!sub) break;
+
+            std::string child = join_rel(key, name);
+            if (!index->dirs.count(child)) {
+                std::string rel = join_rel(parent.path, *sub);
+                index->walk(child, rel, nullptr, listed);
+                break;
+            }
+            key = std::move(child);
+        }
+
+        // files points into dirs, so any change to dirs needs a rebuild
+        if (listed || moved || index->dirs.size() != dir_count) index->rebuild_lookup();
+        if (out_listed) *out_listed = listed;
+        return index->dirs.empty() ? -1 : 0;
+    } catch (const std::bad_alloc&) {
+        index->drop_lookup();
+        return -4;
+    }
+}
+
+/*
+ * Resolve a path relative to the index root, ignoring case
+ *
+ * Parameters:
+ *   index     - Index to search
+ *   rel_path  - Relative path, '/' or '\' separated (e.g. "ASSETS/Characters/x.tex")
+ *   out_path  - Receives the absolute path with its on-disk case (NUL terminated)
+ *   out_cap   - Size of out_path in bytes
+ *   out_len   - Receives the length of the path, also when out_path is too small (optional)
+ *
+ * Returns:
+ *   0 on success, 1 if no such file is indexed, -4 on allocation failure,
+ *   -5 on invalid arguments, -6 if out_path is too small
+ */
+DLL_EXPORT int fs_index_lookup(const FS_INDEX* index, const char* rel_path, char* out_path, uint32_t out_cap,
+                               uint32_t* out_len) {
+    if (!index || !rel_path || (!out_path && out_cap)) return -5;
+
+    try {
+        auto it = index->files.find(normalize_key(rel_path));
+        if (it == index->files.end()) return 1;
+
+        const FsDir& dir = *it->second.first;
+        std::string full = to_native(index->root, join_rel(dir.path, dir.files[it->second.second].name));
+        if (out_len) *out_len = (uint32_t)full.size();
+        if (full.size() + 1 > out_cap) return -6;
+        memcpy(out_path, full.c_str(), full.size() + 1);
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Find files by name pattern
+ *
+ * Parameters:
+ *   index     - Index to search
+ *   dir       - Directory relative to the root to search in ("" for the root)
+ *   pattern   - File name pattern with '*' and '?', case-insensitive (e.g. "skin*.bin")
+ *   flags     - FS_FIND_RECURSIVE to include subdirectories of dir
+ *   out_data  - Receives absolute paths, one per line (free with free_bytes)
+ *   out_size  - Receives the size of the text in bytes
+ *
+ * Patterns without wildcards searched recursively use the name table, so
+ * resolving a texture by file name doesn't scan the tree.
+ *
+ * Returns:
+ *   0 on success (also when nothing matched), 1 if dir is not indexed,
+ *   -4 on allocation failure, -5 on invalid arguments
+ */
+DLL_EXPORT int fs_index_find(const FS_INDEX* index, const char* dir, const char* pattern, uint32_t flags,
+                             uint8_t** out_data, uint32_t* out_size) {
+    if (!index || !dir || !pattern || !out_data || !out_size) return -5;
+    *out_data = nullptr;
+    *out_size = 0;
+
+    try {
+        std::string dir_key = normalize_key(dir);
+        auto start = index->dirs.find(dir_key);
+        if (start == index->dirs.end()) return 1;
+
+        const bool recursive = (flags & FS_FIND_RECURSIVE) != 0;
+        std::vector<std::string> matches;
+
+        if (recursive && !strpbrk(pattern, "*?")) {
+            std::string name = pattern;
+            ascii_lower(name);
+            auto named = index->names.find(name);
+            if (named != index->names.end()) {
+                for (const auto& file_key : named->second) {
+                    bool inside = dir_key.empty() ||
+                                  (file_key.compare(0, dir_key.size(), dir_key) == 0 && file_key[dir_key.size()] == '/');
+                    if (!inside) continue;
+                    const auto& file = index->files.at(file_key);
+                    matches.push_back(to_native(index->root, join_rel(file.first->path, file.first->files[file.second].name)));
+                }
+            }
+            return return_lines(matches, out_data, out_size);
+        }
+
+        std::vector<std::string> pending = { dir_key };
+        while (!pending.empty()) {
+            std::string key = std::move(pending.back());
+            pending.pop_back();
+            auto it = index->dirs.find(key);
+            if (it == index->dirs.end()) continue;
+
+            const FsDir& d = it->second;
+            for (const auto& file : d.files) {
+                if (match_pattern(pattern, file.name.c_str())) {
+                    matches.push_back(to_native(index->root, join_rel(d.path, file.name)));
+                }
+            }
+            if (!recursive) break;
+            for (const auto& sub : d.subdirs) {
+                std::string sub_key = sub;
+                ascii_lower(sub_key);
+                pending.push_back(join_rel(key, sub_key));
+            }
+        }
+        return return_lines(matches, out_data, out_size);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+// ============================================================================
+// Persistence
+// ============================================================================
+
+static void put_u32(std::string& out, uint32_t v) { out.append((const char*)&v, 4); }
+static void put_u64(std::string& out, uint64_t v) { out.append((const char*)&v, 8); }
+static void put_str(std::string& out, const std::string& s) {
+    put_u32(out, (uint32_t)s.size());
+    out += s;
+}
+
+static bool get_u64(ByteReader& r, uint64_t& v) { return r.read(&v, 8); }
+static bool get_str(ByteReader& r, std::string& s) {
+    uint32_t len;
+    if (!r.u32(len) || !r.has(len)) return false;
+    s.assign((const char*)r.here(), len);
+    return r.skip(len);
+}
+
+/*
+ * Write an index to a file, to be loaded and refreshed by a later session
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be written, -4 on allocation failure,
+ *   -5 on invalid arguments
+ */
+DLL_EXPORT int fs_index_save(const FS_INDEX* index, const char* index_path) {
+    if (!index || !index_path) return -5;
+
+    std::string out;
+    try {
+        put_u32(out, FS_INDEX_MAGIC);
+        put_u32(out, FS_INDEX_VERSION);
+        put_str(out, index->root);
+        put_u32(out, (uint32_t)index->dirs.size());
+        for (const auto& [key, dir] : index->dirs) {
+            put_str(out, dir.path);
+            put_u64(out, dir.mtime);
+            put_u32(out, (uint32_t)dir.files.size());
+            for (const auto& file : dir.files) {
+                put_str(out, file.name);
+                put_u64(out, file.size);
+                put_u64(out, file.mtime);
+            }
+            put_u32(out, (uint32_t)dir.subdirs.size());
+            for (const auto& sub : dir.subdirs) put_str(out, sub);
+        }
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+
+#ifdef _WIN32
+    FILE* f = _wfopen(widen(index_path).c_str(), L"wb");
+#else
+    FILE* f = fopen(index_path, "wb");
+#endif
+    if (!f) return -1;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    ok = fclose(f) == 0 && ok;
+    return ok ? 0 : -1;
+}
+
+/*
+ * Load an index written by fs_index_save
+ *
+ * Parameters:
+ *   index_path - File written by fs_index_save (UTF-8)
+ *   root       - Root the index must have been built for (compared ignoring case)
+ *   out_index  - Receives the index (free with fs_index_free)
+ *
+ * The loaded index reflects the disk at the time it was saved; call
+ * fs_index_refresh before relying on it.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be read, -2 if it is invalid or was
+ *   built for another root, -4 on allocation failure, -5 on invalid arguments
+ */
+DLL_EXPORT int fs_index_load(const char* index_path, const char* root, FS_INDEX** out_index) {
+    if (!index_path || !root || !out_index) return -5;
+    *out_index = nullptr;
+
+    MappedFile mapped;
+    if (!mapped.open(index_path)) return -1;
+    ByteReader r = { mapped.data(), mapped.size(), 0 };
+
+    uint32_t magic, version, dir_count;
+    if (!r.u32(magic) || magic != FS_INDEX_MAGIC) return -2;
+    if (!r.u32(version) || version != FS_INDEX_VERSION) return -2;
+
+    FS_INDEX* index = new (std::nothrow) FS_INDEX();
+    if (!index) return -4;
+
+    try {
+        index->root = trim_root(root);
+
+        std::string saved_root;
+        bool ok = get_str(r, saved_root) && normalize_key(saved_root.c_str()) == normalize_key(index->root.c_str());
+        ok = ok && r.u32(dir_count);
+        for (uint32_t d = 0; ok && d < dir_count; d++) {
+            FsDir dir;
+            uint32_t file_count, subdir_count;
+            ok = get_str(r, dir.path) && get_u64(r, dir.mtime) && r.u32(file_count);
+            for (uint32_t i = 0; ok && i < file_count; i++) {
+                FsFile file;
+                ok = get_str(r, file.name) && get_u64(r, file.size) && get_u64(r, file.mtime);
+                dir.files.push_back(std::move(file));
+            }
+            ok = ok && r.u32(subdir_count);
+            for (uint32_t i = 0; ok && i < subdir_count; i++) {
+                std::string sub;
+                ok = get_str(r, sub);
+                dir.subdirs.push_back(std::move(sub));
+            }
+            if (ok) index->dirs[normalize_key(dir.path.c_str())] = std::move(dir);
+        }
+
+        if (!ok || index->dirs.find("") == index->dirs.end()) {
+            delete index;
+            return -2;
+        }
+        index->rebuild_lookup();
+    } catch (const std::bad_alloc&) {
+        delete index;
+        return -4;
+    }
+    *out_index = index;
+    return 0;
+}
+
+/*
+ * Number of indexed directories and files
+ */
+DLL_EXPORT int fs_index_count(const FS_INDEX* index, uint32_t* out_dirs, uint32_t* out_files) {
+    if (!index) return -5;
+    if (out_dirs) *out_dirs = (uint32_t)index->dirs.size();
+    if (out_files) *out_files = (uint32_t)index->files.size();
+    return 0;
+}
+
+DLL_EXPORT void fs_index_free(FS_INDEX* index) {
+    delete index;
+}
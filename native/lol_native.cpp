@@ -1,241 +1,1786 @@
 /*
  * LoL Native DLL - Fast TEX/BIN operations for Blender addon
- * Combines TEX→DDS conversion and BIN texture path extraction
+ * Combines TEX→DDS conversion, ANM parsing/writing and BIN texture path extraction
+ * Mesh readers and writers (mesh_io.cpp), the TEX encoder (tex_encode.cpp),
+ * the filesystem index (fs_index.cpp), the WAD reader (wad_reader.cpp), the
+ * skinning solver (skinning.cpp), the BVH queries (bvh.cpp), the wiggle
+ * physics stepper (physics.cpp) and the animation baker (anim_retarget.cpp)
+ * are linked into the same DLL (free_bytes is shared)
  */
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cstdint>
+#include <mutex>
+#include <new>
 #include <string>
 #include <vector>
 #include <unordered_map>
-#include <fstream>
 #include <sstream>
 
+#include "bin_field_index.h"
+#include "binary_reader.h"
+#include "binary_writer.h"
+#include "file_map.h"
+#include "native_stats.h"
+#include "platform.h"
+#include "tex_dds.h"
+#include "thread_pool.h"
+#include "xxhash64.h"
+
 // Include ritobin for BIN parsing
 #include "../ritobin-master/ritobin_lib/src/ritobin/bin_types.hpp"
 #include "../ritobin-master/ritobin_lib/src/ritobin/bin_io.hpp"
 
-#ifdef BUILD_DLL
-    #define DLL_EXPORT extern "C" __declspec(dllexport)
+// ============================================================================
+// TEX to DDS Conversion (core in tex_dds.c, shared with tex_converter)
+// ============================================================================
+
+// Convert tex_path with the shared core (tex_dds.c), timing the read and
+// mip reorder stages
+static int tex_convert_file(const char* tex_path, uint8_t* out_buf, uint32_t capacity,
+                            uint8_t** out_alloc, uint32_t* out_size) {
+    MappedFile mapped;
+    bool is_mapped;
+    {
+        StatsTimer timer(NATIVE_STAGE_FILE_READ);
+        is_mapped = mapped.open(tex_path);
+    }
+
+    int rc;
+    if (is_mapped) {
+        stats_add(NATIVE_COUNTER_READ_BYTES, mapped.size());
+        StatsTimer timer(NATIVE_STAGE_MIP_REORDER);
+        rc = tex_dds_convert(mapped.data(), mapped.size(), out_buf, capacity, out_alloc, out_size);
+    } else {
+        FILE* tex_file;
+        TEX_HEADER tex_header;
+        uint64_t file_size;
+        rc = tex_open_stdio(tex_path, &tex_file, &tex_header, &file_size);
+        if (rc != 0) return rc;
+        stats_add(NATIVE_COUNTER_READ_BYTES, file_size);
+
+        // Reading and reordering are one pass here
+        StatsTimer timer(NATIVE_STAGE_FILE_READ);
+        rc = tex_dds_convert_stdio(tex_file, &tex_header, file_size, out_buf, capacity, out_alloc, out_size);
+        fclose(tex_file);
+    }
+    if (rc == 0 && !out_buf && out_size) stats_add(NATIVE_COUNTER_ALLOC_BYTES, *out_size);
+    return rc;
+}
+
+/*
+ * TEX to DDS exports, with the same parameters and error codes as those of
+ * tex_converter (ritoddstex_dll.c). DDS data is freed with free_bytes.
+ */
+DLL_EXPORT int tex_to_dds_bytes(const char* tex_path, uint8_t** out_data, uint32_t* out_size) {
+    return tex_convert_file(tex_path, nullptr, 0, out_data, out_size);
+}
+
+DLL_EXPORT int tex_to_dds_query(const char* tex_path, uint32_t* out_size) {
+    return tex_dds_query(tex_path, out_size);
+}
+
+DLL_EXPORT int tex_to_dds_into(const char* tex_path, uint8_t* out_buf, uint32_t capacity, uint32_t* out_size) {
+    if (!out_buf) return -6;
+    return tex_convert_file(tex_path, out_buf, capacity, nullptr, out_size);
+}
+
+DLL_EXPORT int tex_to_dds_from_memory(const uint8_t* src, uint32_t src_len, uint8_t** out_data, uint32_t* out_size) {
+    if (!out_data || !out_size) return -5;
+    StatsTimer timer(NATIVE_STAGE_MIP_REORDER);
+    int rc = tex_dds_convert(src, src_len, nullptr, 0, out_data, out_size);
+    if (rc == 0) stats_add(NATIVE_COUNTER_ALLOC_BYTES, *out_size);
+    return rc;
+}
+
+DLL_EXPORT void free_bytes(uint8_t* data) {
+    if (data) free(data);
+}
+
+// tex_to_dds_batch of tex_converter, on the shared thread pool
+DLL_EXPORT int tex_to_dds_batch(const char* const* tex_paths, uint32_t count,
+                                uint8_t** out_data, uint32_t* out_sizes,
+                                int32_t* results, uint32_t max_threads) {
+    if (count == 0) return 0;
+    if (!tex_paths || !out_data || !out_sizes || !results) return -5;
+
+    std::atomic<int> failed{0};
+    global_thread_pool().parallel_for(count, max_threads, [&](size_t i) {
+        out_data[i] = nullptr;
+        out_sizes[i] = 0;
+        int rc = tex_paths[i] ? tex_to_dds_bytes(tex_paths[i], &out_data[i], &out_sizes[i]) : -1;
+        results[i] = rc;
+        if (rc != 0) failed.fetch_add(1);
+    });
+    return failed.load();
+}
+
+// ============================================================================
+// TEX Pixel Decoding
+// ============================================================================
+
+#define TEX_DECODE_FLIP_Y  0x1   // Write rows bottom-up (Blender image order)
+#define TEX_DECODE_LINEAR  0x2   // Float output: convert 8-bit color channels from sRGB to linear
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define LOL_NATIVE_X64 1
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+// MSVC accepts AVX2 intrinsics anywhere; GCC/Clang need them enabled per function
+#if defined(LOL_NATIVE_X64) && (defined(__GNUC__) || defined(__clang__))
+    #define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define TARGET_AVX2
+#endif
+
+enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2 = 1,
+    SIMD_AVX2 = 2,
+};
+
+static int detect_simd_level() {
+#ifdef LOL_NATIVE_X64
+    #ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+        __cpuid(info, 0);
+        if (os_avx && info[0] >= 7) {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5)) return SIMD_AVX2;
+        }
+    #else
+        if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    #endif
+    return SIMD_SSE2;
 #else
-    #define DLL_EXPORT extern "C" __declspec(dllimport)
+    return SIMD_SCALAR;
 #endif
+}
+
+static std::atomic<int> g_simd_cap{SIMD_AVX2};
+
+static int simd_level() {
+    static const int detected = detect_simd_level();
+    int cap = g_simd_cap.load(std::memory_order_relaxed);
+    return detected < cap ? detected : cap;
+}
+
+// Lookup tables for 8-bit -> float conversion, built once on first use
+struct DecodeTables {
+    float unorm8[256];
+    float srgb_to_linear[256];
+
+    DecodeTables() {
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            unorm8[i] = c;
+            srgb_to_linear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+        }
+    }
+};
+
+static const DecodeTables& decode_tables() {
+    static const DecodeTables tables;
+    return tables;
+}
+
+// Expand RGB565 to 8-bit RGB
+static inline void rgb565_to_rgb8(uint16_t c, uint8_t* out) {
+    uint8_t r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (uint8_t)((r << 3) | (r >> 2));
+    out[1] = (uint8_t)((g << 2) | (g >> 4));
+    out[2] = (uint8_t)((b << 3) | (b >> 2));
+}
+
+// Palettes of a group of up to 8 consecutive BC blocks, entry-major so the
+// SIMD paths can fill one entry for all blocks at once
+struct BcPaletteGroup {
+    uint32_t color[4][8];   // RGBA8 with R in the low byte
+    uint8_t alpha[8][8];    // BC3 only
+};
+
+static inline uint32_t pack_rgba8(const uint8_t* rgb, uint8_t a) {
+    return (uint32_t)rgb[0] | ((uint32_t)rgb[1] << 8) | ((uint32_t)rgb[2] << 16) | ((uint32_t)a << 24);
+}
+
+// BC1 color blocks with c0 <= c1 use three colors plus transparent black;
+// BC3 color blocks always use the four-color mode
+static void bc_palettes_scalar(const uint8_t* blocks, uint32_t count, bool dxt5, BcPaletteGroup& group) {
+    const uint32_t block_bytes = dxt5 ? 16 : 8;
+    const uint32_t color_offset = dxt5 ? 8 : 0;
+
+    for (uint32_t b = 0; b < count; b++) {
+        const uint8_t* block = blocks + b * block_bytes;
+        const uint8_t* cb = block + color_offset;
+        uint16_t c0 = (uint16_t)(cb[0] | (cb[1] << 8));
+        uint16_t c1 = (uint16_t)(cb[2] | (cb[3] << 8));
+
+        uint8_t p[4][3];
+        rgb565_to_rgb8(c0, p[0]);
+        rgb565_to_rgb8(c1, p[1]);
+
+        bool four_color = dxt5 || c0 > c1;
+        for (int ch = 0; ch < 3; ch++) {
+            if (four_color) {
+                p[2][ch] = (uint8_t)((2 * p[0][ch] + p[1][ch]) / 3);
+                p[3][ch] = (uint8_t)((p[0][ch] + 2 * p[1][ch]) / 3);
+            } else {
+                p[2][ch] = (uint8_t)((p[0][ch] + p[1][ch]) / 2);
+                p[3][ch] = 0;
+            }
+        }
+
+        group.color[0][b] = pack_rgba8(p[0], 255);
+        group.color[1][b] = pack_rgba8(p[1], 255);
+        group.color[2][b] = pack_rgba8(p[2], 255);
+        group.color[3][b] = pack_rgba8(p[3], four_color ? 255 : 0);
+
+        if (!dxt5) continue;
+
+        uint8_t a0 = block[0], a1 = block[1];
+        group.alpha[0][b] = a0;
+        group.alpha[1][b] = a1;
+        if (a0 > a1) {
+            for (int i = 1; i < 7; i++) {
+                group.alpha[i + 1][b] = (uint8_t)(((7 - i) * a0 + i * a1) / 7);
+            }
+        } else {
+            for (int i = 1; i < 5; i++) {
+                group.alpha[i + 1][b] = (uint8_t)(((5 - i) * a0 + i * a1) / 5);
+            }
+            group.alpha[6][b] = 0;
+            group.alpha[7][b] = 255;
+        }
+    }
+}
+
+// Write the 16 texels of each block into four RGBA8 rows (stride bytes apart)
+static void bc_expand_scalar(const uint8_t* blocks, uint32_t count, bool dxt5,
+                             const BcPaletteGroup& group, uint8_t* rows, size_t stride) {
+    const uint32_t block_bytes = dxt5 ? 16 : 8;
+    const uint32_t color_offset = dxt5 ? 8 : 0;
+
+    for (uint32_t b = 0; b < count; b++) {
+        const uint8_t* block = blocks + b * block_bytes;
+        const uint8_t* cb = block + color_offset;
+        uint32_t indices = (uint32_t)cb[4] | ((uint32_t)cb[5] << 8) |
+                           ((uint32_t)cb[6] << 16) | ((uint32_t)cb[7] << 24);
+
+        uint64_t alpha_indices = 0;
+        if (dxt5) {
+            for (int i = 0; i < 6; i++) alpha_indices |= (uint64_t)block[2 + i] << (8 * i);
+        }
+
+        for (uint32_t i = 0; i < 16; i++) {
+            uint32_t texel = group.color[(indices >> (2 * i)) & 3][b];
+            if (dxt5) {
+                texel = (texel & 0x00ffffff) | ((uint32_t)group.alpha[(alpha_indices >> (3 * i)) & 7][b] << 24);
+            }
+            memcpy(rows + (i >> 2) * stride + b * 16 + (i & 3) * 4, &texel, 4);
+        }
+    }
+}
+
+#ifdef LOL_NATIVE_X64
+
+// a where mask is set, b elsewhere
+static inline __m128i select_si128(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Eight 16-bit R, G, B, A lanes -> eight RGBA8 entries
+static inline void pack_rgba8_x8(__m128i r, __m128i g, __m128i b, __m128i a, uint32_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, zero), _mm_packus_epi16(g, zero));
+    __m128i ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, zero), _mm_packus_epi16(a, zero));
+    _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi16(rg, ba));
+}
+
+// Same result as bc_palettes_scalar, one block per 16-bit lane. The /3, /5
+// and /7 interpolations use multiply-high constants that are exact for the
+// 0..7*255 range involved.
+static void bc_palettes_sse2(const uint8_t* blocks, uint32_t count, bool dxt5, BcPaletteGroup& group) {
+    const uint32_t block_bytes = dxt5 ? 16 : 8;
+    const uint32_t color_offset = dxt5 ? 8 : 0;
+
+    alignas(16) uint16_t c0s[8] = {}, c1s[8] = {}, a0s[8] = {}, a1s[8] = {};
+    for (uint32_t b = 0; b < count; b++) {
+        const uint8_t* block = blocks + b * block_bytes;
+        const uint8_t* cb = block + color_offset;
+        c0s[b] = (uint16_t)(cb[0] | (cb[1] << 8));
+        c1s[b] = (uint16_t)(cb[2] | (cb[3] << 8));
+        a0s[b] = block[0];
+        a1s[b] = block[1];
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi16(255);
+    const __m128i mask5 = _mm_set1_epi16(31);
+    const __m128i mask6 = _mm_set1_epi16(63);
+    const __m128i div3 = _mm_set1_epi16(21846);
+    const __m128i sign = _mm_set1_epi16((short)0x8000);
+
+    __m128i c0 = _mm_load_si128((const __m128i*)c0s);
+    __m128i c1 = _mm_load_si128((const __m128i*)c1s);
+
+    auto expand5 = [](__m128i v) { return _mm_or_si128(_mm_slli_epi16(v, 3), _mm_srli_epi16(v, 2)); };
+    auto expand6 = [](__m128i v) { return _mm_or_si128(_mm_slli_epi16(v, 2), _mm_srli_epi16(v, 4)); };
+
+    __m128i ch0[3] = {
+        expand5(_mm_and_si128(_mm_srli_epi16(c0, 11), mask5)),
+        expand6(_mm_and_si128(_mm_srli_epi16(c0, 5), mask6)),
+        expand5(_mm_and_si128(c0, mask5)),
+    };
+    __m128i ch1[3] = {
+        expand5(_mm_and_si128(_mm_srli_epi16(c1, 11), mask5)),
+        expand6(_mm_and_si128(_mm_srli_epi16(c1, 5), mask6)),
+        expand5(_mm_and_si128(c1, mask5)),
+    };
+
+    // Unsigned c0 > c1 via the signed compare
+    __m128i four = dxt5 ? _mm_set1_epi16(-1)
+                        : _mm_cmpgt_epi16(_mm_xor_si128(c0, sign), _mm_xor_si128(c1, sign));
+
+    __m128i ch2[3], ch3[3];
+    for (int ch = 0; ch < 3; ch++) {
+        __m128i a = ch0[ch], b = ch1[ch];
+        __m128i two_a_b = _mm_add_epi16(_mm_add_epi16(a, a), b);
+        __m128i a_two_b = _mm_add_epi16(a, _mm_add_epi16(b, b));
+        ch2[ch] = select_si128(four, _mm_mulhi_epu16(two_a_b, div3), _mm_srli_epi16(_mm_add_epi16(a, b), 1));
+        ch3[ch] = _mm_and_si128(four, _mm_mulhi_epu16(a_two_b, div3));
+    }
+
+    pack_rgba8_x8(ch0[0], ch0[1], ch0[2], opaque, group.color[0]);
+    pack_rgba8_x8(ch1[0], ch1[1], ch1[2], opaque, group.color[1]);
+    pack_rgba8_x8(ch2[0], ch2[1], ch2[2], opaque, group.color[2]);
+    pack_rgba8_x8(ch3[0], ch3[1], ch3[2], _mm_and_si128(four, opaque), group.color[3]);
+
+    if (!dxt5) return;
+
+    const __m128i div7 = _mm_set1_epi16(9363);
+    const __m128i div5 = _mm_set1_epi16(13108);
+    __m128i a0 = _mm_load_si128((const __m128i*)a0s);
+    __m128i a1 = _mm_load_si128((const __m128i*)a1s);
+    __m128i eight = _mm_cmpgt_epi16(a0, a1);
+
+    __m128i entries[8];
+    entries[0] = a0;
+    entries[1] = a1;
+    for (int i = 1; i < 7; i++) {
+        __m128i v7 = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(a0, _mm_set1_epi16((short)(7 - i))),
+                                                   _mm_mullo_epi16(a1, _mm_set1_epi16((short)i))), div7);
+        __m128i v5;
+        if (i < 5) {
+            v5 = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(a0, _mm_set1_epi16((short)(5 - i))),
+                                               _mm_mullo_epi16(a1, _mm_set1_epi16((short)i))), div5);
+        } else {
+            v5 = i == 5 ? zero : opaque;
+        }
+        entries[i + 1] = select_si128(eight, v7, v5);
+    }
+    for (int k = 0; k < 8; k++) {
+        _mm_storel_epi64((__m128i*)group.alpha[k], _mm_packus_epi16(entries[k], zero));
+    }
+}
+
+// 2-bit indices of four texels (one index byte) as 32-bit lanes
+struct Bc1IndexTable {
+    __m128i lanes[256];
+
+    Bc1IndexTable() {
+        for (int i = 0; i < 256; i++) {
+            lanes[i] = _mm_setr_epi32(i & 3, (i >> 2) & 3, (i >> 4) & 3, (i >> 6) & 3);
+        }
+    }
+};
+
+static const Bc1IndexTable& bc1_index_table() {
+    static const Bc1IndexTable table;
+    return table;
+}
+
+static void bc_expand_sse2(const uint8_t* blocks, uint32_t count, bool dxt5,
+                           const BcPaletteGroup& group, uint8_t* rows, size_t stride) {
+    const uint32_t block_bytes = dxt5 ? 16 : 8;
+    const uint32_t color_offset = dxt5 ? 8 : 0;
+    const Bc1IndexTable& table = bc1_index_table();
+    const __m128i k1 = _mm_set1_epi32(1), k2 = _mm_set1_epi32(2), k3 = _mm_set1_epi32(3);
+    const __m128i rgb_mask = _mm_set1_epi32(0x00ffffff);
+
+    for (uint32_t b = 0; b < count; b++) {
+        const uint8_t* block = blocks + b * block_bytes;
+        const uint8_t* cb = block + color_offset;
+
+        __m128i p0 = _mm_set1_epi32((int)group.color[0][b]);
+        __m128i p1 = _mm_set1_epi32((int)group.color[1][b]);
+        __m128i p2 = _mm_set1_epi32((int)group.color[2][b]);
+        __m128i p3 = _mm_set1_epi32((int)group.color[3][b]);
+
+        uint64_t alpha_indices = 0;
+        if (dxt5) {
+            for (int i = 0; i < 6; i++) alpha_indices |= (uint64_t)block[2 + i] << (8 * i);
+        }
+
+        // Index byte r holds the four texels of block row r
+        for (uint32_t r = 0; r < 4; r++) {
+            __m128i idx = table.lanes[cb[4 + r]];
+            __m128i texels = _mm_or_si128(
+                _mm_or_si128(_mm_andnot_si128(_mm_cmpgt_epi32(idx, _mm_setzero_si128()), p0),
+                             _mm_and_si128(_mm_cmpeq_epi32(idx, k1), p1)),
+                _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(idx, k2), p2),
+                             _mm_and_si128(_mm_cmpeq_epi32(idx, k3), p3)));
+
+            if (dxt5) {
+                uint32_t bits = (uint32_t)(alpha_indices >> (12 * r));
+                __m128i alpha = _mm_setr_epi32(
+                    (int)((uint32_t)group.alpha[bits & 7][b] << 24),
+                    (int)((uint32_t)group.alpha[(bits >> 3) & 7][b] << 24),
+                    (int)((uint32_t)group.alpha[(bits >> 6) & 7][b] << 24),
+                    (int)((uint32_t)group.alpha[(bits >> 9) & 7][b] << 24));
+                texels = _mm_or_si128(_mm_and_si128(texels, rgb_mask), alpha);
+            }
+
+            _mm_storeu_si128((__m128i*)(rows + r * stride + b * 16), texels);
+        }
+    }
+}
+
+// Eight texels per permute: the palette sits in both 128-bit halves and the
+// per-texel indices come from variable shifts of the packed index word
+TARGET_AVX2 static void bc_expand_avx2(const uint8_t* blocks, uint32_t count, bool dxt5,
+                                       const BcPaletteGroup& group, uint8_t* rows, size_t stride) {
+    const uint32_t block_bytes = dxt5 ? 16 : 8;
+    const uint32_t color_offset = dxt5 ? 8 : 0;
+    const __m256i color_shifts = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m256i alpha_shifts = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i seven = _mm256_set1_epi32(7);
+    const __m256i rgb_mask = _mm256_set1_epi32(0x00ffffff);
+
+    for (uint32_t b = 0; b < count; b++) {
+        const uint8_t* block = blocks + b * block_bytes;
+        const uint8_t* cb = block + color_offset;
+        uint32_t indices = (uint32_t)cb[4] | ((uint32_t)cb[5] << 8) |
+                           ((uint32_t)cb[6] << 16) | ((uint32_t)cb[7] << 24);
+
+        __m256i palette = _mm256_setr_epi32(
+            (int)group.color[0][b], (int)group.color[1][b], (int)group.color[2][b], (int)group.color[3][b],
+            (int)group.color[0][b], (int)group.color[1][b], (int)group.color[2][b], (int)group.color[3][b]);
+
+        __m256i idx_lo = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(indices & 0xffff)), color_shifts), three);
+        __m256i idx_hi = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(indices >> 16)), color_shifts), three);
+        __m256i texels_lo = _mm256_permutevar8x32_epi32(palette, idx_lo);   // block rows 0-1
+        __m256i texels_hi = _mm256_permutevar8x32_epi32(palette, idx_hi);   // block rows 2-3
+
+        if (dxt5) {
+            uint64_t alpha_indices = 0;
+            for (int i = 0; i < 6; i++) alpha_indices |= (uint64_t)block[2 + i] << (8 * i);
+
+            __m256i alpha = _mm256_setr_epi32(
+                (int)((uint32_t)group.alpha[0][b] << 24), (int)((uint32_t)group.alpha[1][b] << 24),
+                (int)((uint32_t)group.alpha[2][b] << 24), (int)((uint32_t)group.alpha[3][b] << 24),
+                (int)((uint32_t)group.alpha[4][b] << 24), (int)((uint32_t)group.alpha[5][b] << 24),
+                (int)((uint32_t)group.alpha[6][b] << 24), (int)((uint32_t)group.alpha[7][b] << 24));
+            __m256i aidx_lo = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(alpha_indices & 0xffffff)), alpha_shifts), seven);
+            __m256i aidx_hi = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(alpha_indices >> 24)), alpha_shifts), seven);
+            texels_lo = _mm256_or_si256(_mm256_and_si256(texels_lo, rgb_mask), _mm256_permutevar8x32_epi32(alpha, aidx_lo));
+            texels_hi = _mm256_or_si256(_mm256_and_si256(texels_hi, rgb_mask), _mm256_permutevar8x32_epi32(alpha, aidx_hi));
+        }
+
+        uint8_t* out = rows + b * 16;
+        _mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(texels_lo));
+        _mm_storeu_si128((__m128i*)(out + stride), _mm256_extracti128_si256(texels_lo, 1));
+        _mm_storeu_si128((__m128i*)(out + 2 * stride), _mm256_castsi256_si128(texels_hi));
+        _mm_storeu_si128((__m128i*)(out + 3 * stride), _mm256_extracti128_si256(texels_hi, 1));
+    }
+}
+
+// Divides rather than multiplying by 1/255 so results match the scalar table bit for bit
+static void unorm8_to_float_sse2(const uint8_t* in, size_t count, float* out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scale = _mm_set1_ps(255.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+        _mm_storeu_ps(out + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+        _mm_storeu_ps(out + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+        _mm_storeu_ps(out + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+    }
+    const float* unorm8 = decode_tables().unorm8;
+    for (; i < count; i++) out[i] = unorm8[in[i]];
+}
+
+TARGET_AVX2 static void unorm8_to_float_avx2(const uint8_t* in, size_t count, float* out) {
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i lo = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + i)));
+        __m256i hi = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + i + 8)));
+        _mm256_storeu_ps(out + i, _mm256_div_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(out + i + 8, _mm256_div_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    const float* unorm8 = decode_tables().unorm8;
+    for (; i < count; i++) out[i] = unorm8[in[i]];
+}
+
+#endif // LOL_NATIVE_X64
+
+// Decode one row of BC blocks into four RGBA8 rows of blocks_x * 16 bytes each,
+// 8 blocks per palette pass
+static void decode_bc_block_row(const uint8_t* src, uint32_t blocks_x, bool dxt5, uint8_t* rows, int level) {
+    const size_t stride = (size_t)blocks_x * 16;
+    const uint32_t block_bytes = dxt5 ? 16 : 8;
+    BcPaletteGroup group;
+
+    for (uint32_t first = 0; first < blocks_x; first += 8) {
+        uint32_t count = blocks_x - first < 8 ? blocks_x - first : 8;
+        const uint8_t* blocks = src + (size_t)first * block_bytes;
+        uint8_t* out = rows + (size_t)first * 16;
+
+#ifdef LOL_NATIVE_X64
+        if (level >= SIMD_SSE2) {
+            bc_palettes_sse2(blocks, count, dxt5, group);
+            if (level >= SIMD_AVX2) {
+                bc_expand_avx2(blocks, count, dxt5, group, out, stride);
+            } else {
+                bc_expand_sse2(blocks, count, dxt5, group, out, stride);
+            }
+            continue;
+        }
+#else
+        (void)level;
+#endif
+        bc_palettes_scalar(blocks, count, dxt5, group);
+        bc_expand_scalar(blocks, count, dxt5, group, out, stride);
+    }
+}
+
+// One RGBA8 row -> float RGBA
+static void emit_row_float(const uint8_t* rgba8, uint32_t width, float* out, bool linear, int level) {
+    const size_t count = (size_t)width * 4;
+    const DecodeTables& tables = decode_tables();
+
+    if (linear) {
+        for (size_t i = 0; i < count; i += 4) {
+            out[i] = tables.srgb_to_linear[rgba8[i]];
+            out[i + 1] = tables.srgb_to_linear[rgba8[i + 1]];
+            out[i + 2] = tables.srgb_to_linear[rgba8[i + 2]];
+            out[i + 3] = tables.unorm8[rgba8[i + 3]];
+        }
+        return;
+    }
+
+#ifdef LOL_NATIVE_X64
+    if (level >= SIMD_AVX2) { unorm8_to_float_avx2(rgba8, count, out); return; }
+    if (level >= SIMD_SSE2) { unorm8_to_float_sse2(rgba8, count, out); return; }
+#else
+    (void)level;
+#endif
+    for (size_t i = 0; i < count; i++) out[i] = tables.unorm8[rgba8[i]];
+}
+
+// Destination of one decode call: float RGBA or RGBA8, width * 4 values per row
+struct DecodeTarget {
+    void* pixels;
+    bool rgba8;
+    bool linear;
+    bool flip;
+    uint32_t height;
+    size_t row_values;
+
+    void write_row(uint32_t y, const uint8_t* rgba8_row, uint32_t width, int level) const {
+        size_t offset = (size_t)(flip ? height - 1 - y : y) * row_values;
+        if (rgba8) {
+            memcpy((uint8_t*)pixels + offset, rgba8_row, (size_t)width * 4);
+        } else {
+            emit_row_float(rgba8_row, width, (float*)pixels + offset, linear, level);
+        }
+    }
+};
+
+// Rows handed to one worker; images below this many texels decode on the caller
+static const uint32_t DECODE_ROWS_PER_TASK = 32;
+static const uint64_t DECODE_PARALLEL_TEXELS = 512 * 512;
+
+// Decode the top mip of a TEX payload. src points at the top mip.
+static void decode_tex_pixels(const TEX_HEADER& tex, const uint8_t* src, const DecodeTarget& target) {
+    const uint32_t width = tex.image_width;
+    const uint32_t height = tex.image_height;
+    const int level = simd_level();
+    const bool bc = tex.tex_format == TEX_FORMAT_DXT1 || tex.tex_format == TEX_FORMAT_DXT5;
+    const bool dxt5 = tex.tex_format == TEX_FORMAT_DXT5;
+    const uint32_t blocks_x = (width + 3) / 4;
+    const size_t bc_row_bytes = (size_t)blocks_x * (dxt5 ? 16 : 8);
+
+    // Decode rows [y0, y1); BC work is aligned to whole block rows
+    auto decode_rows = [&](uint32_t y0, uint32_t y1) {
+        if (bc) {
+            std::vector<uint8_t> staging((size_t)blocks_x * 64);
+            const size_t stride = (size_t)blocks_x * 16;
+            for (uint32_t y = y0; y < y1; y += 4) {
+                decode_bc_block_row(src + (size_t)(y / 4) * bc_row_bytes, blocks_x, dxt5, staging.data(), level);
+                for (uint32_t py = 0; py < 4 && y + py < height; py++) {
+                    target.write_row(y + py, staging.data() + py * stride, width, level);
+                }
+            }
+            return;
+        }
+
+        if (tex.tex_format == TEX_FORMAT_BGRA8) {
+            std::vector<uint8_t> staging((size_t)width * 4);
+            for (uint32_t y = y0; y < y1; y++) {
+                const uint8_t* in = src + (size_t)y * width * 4;
+                for (uint32_t x = 0; x < width; x++, in += 4) {
+                    staging[x * 4] = in[2];
+                    staging[x * 4 + 1] = in[1];
+                    staging[x * 4 + 2] = in[0];
+                    staging[x * 4 + 3] = in[3];
+                }
+                target.write_row(y, staging.data(), width, level);
+            }
+            return;
+        }
+
+        // RGBA16: same interpretation as the DDS header we write (R16G16B16A16_SNORM)
+        for (uint32_t y = y0; y < y1; y++) {
+            const uint8_t* in = src + (size_t)y * width * 8;
+            size_t offset = (size_t)(target.flip ? height - 1 - y : y) * target.row_values;
+            for (uint32_t i = 0; i < width * 4; i++, in += 2) {
+                float f = (int16_t)(in[0] | (in[1] << 8)) / 32767.0f;
+                if (f < -1.0f) f = -1.0f;
+                if (target.rgba8) {
+                    ((uint8_t*)target.pixels)[offset + i] = (uint8_t)(f <= 0.0f ? 0 : (int)(f * 255.0f + 0.5f));
+                } else {
+                    ((float*)target.pixels)[offset + i] = f;
+                }
+            }
+        }
+    };
+
+    uint32_t tasks = (height + DECODE_ROWS_PER_TASK - 1) / DECODE_ROWS_PER_TASK;
+    if ((uint64_t)width * height < DECODE_PARALLEL_TEXELS || tasks < 2) {
+        decode_rows(0, height);
+        return;
+    }
+
+    global_thread_pool().parallel_for(tasks, 0, [&](size_t t) {
+        uint32_t y0 = (uint32_t)t * DECODE_ROWS_PER_TASK;
+        uint32_t y1 = y0 + DECODE_ROWS_PER_TASK < height ? y0 + DECODE_ROWS_PER_TASK : height;
+        decode_rows(y0, y1);
+    });
+}
+
+// Shared by the decode exports: validate src and locate the top mip
+static int tex_decode_prepare(const uint8_t* src, size_t src_len, TEX_HEADER& tex,
+                              const uint8_t*& top_mip, uint32_t* out_width, uint32_t* out_height) {
+    if (!src || src_len < sizeof(TEX_HEADER)) return -2;
+    memcpy(&tex, src, sizeof(TEX_HEADER));
+
+    DDS_LAYOUT layout;
+    int rc = tex_build_layout(&tex, src_len, &layout);
+    if (rc != 0) return rc;
+
+    if (out_width) *out_width = tex.image_width;
+    if (out_height) *out_height = tex.image_height;
+
+    // TEX stores mips smallest-first, so the full-size image is last
+    uint32_t top_size = tex_mip_size(&tex, 0);
+    if (top_size > layout.data_size) return -2;
+    top_mip = src + sizeof(TEX_HEADER) + (tex.has_mipmaps ? layout.data_size - top_size : 0);
+    return 0;
+}
+
+// Shared by the float and RGBA8 exports; capacity is counted in values (floats or bytes)
+static int tex_decode_common(const uint8_t* src, uint32_t src_len, void* out_pixels, bool rgba8,
+                             uint32_t capacity, uint32_t flags,
+                             uint32_t* out_width, uint32_t* out_height) {
+    TEX_HEADER tex;
+    const uint8_t* top_mip = nullptr;
+    int rc = tex_decode_prepare(src, src_len, tex, top_mip, out_width, out_height);
+    if (rc != 0) return rc;
+
+    if (!out_pixels || capacity / 4 < (uint32_t)tex.image_width * tex.image_height) return -6;
+
+    DecodeTarget target;
+    target.pixels = out_pixels;
+    target.rgba8 = rgba8;
+    target.linear = !rgba8 && (flags & TEX_DECODE_LINEAR) != 0;
+    target.flip = (flags & TEX_DECODE_FLIP_Y) != 0;
+    target.height = tex.image_height;
+    target.row_values = (size_t)tex.image_width * 4;
+    StatsTimer timer(NATIVE_STAGE_DECODE);
+    decode_tex_pixels(tex, top_mip, target);
+    return 0;
+}
+
+/*
+ * Decode the full-size image of an in-memory TEX file to float32 RGBA
+ *
+ * Parameters:
+ *   src         - TEX file contents
+ *   src_len     - Size of src in bytes
+ *   out_pixels  - Destination for width * height * 4 floats, or NULL to query the size
+ *   capacity    - Number of floats out_pixels can hold
+ *   flags       - TEX_DECODE_FLIP_Y to write rows bottom-up (Blender order),
+ *                 TEX_DECODE_LINEAR to convert 8-bit color channels from sRGB to linear
+ *   out_width   - Receives the image width
+ *   out_height  - Receives the image height
+ *
+ * Without TEX_DECODE_LINEAR, 8-bit formats decode to [0, 1] without any color
+ * space conversion, which is what Blender's pixels hold for byte images.
+ *
+ * Returns:
+ *   0 on success, the tex_to_dds_bytes error codes -2, -3, or
+ *   -6: out_pixels is NULL or smaller than width * height * 4 floats
+ */
+DLL_EXPORT int tex_decode_rgba_from_memory(const uint8_t* src, uint32_t src_len, float* out_pixels,
+                                           uint32_t capacity, uint32_t flags,
+                                           uint32_t* out_width, uint32_t* out_height) {
+    return tex_decode_common(src, src_len, out_pixels, false, capacity, flags, out_width, out_height);
+}
+
+/*
+ * Decode the full-size image of a TEX file to float32 RGBA
+ *
+ * Same as tex_decode_rgba_from_memory, reading the file through a mapping.
+ * Additionally returns -1 when the file can't be opened.
+ */
+DLL_EXPORT int tex_decode_rgba(const char* tex_path, float* out_pixels, uint32_t capacity,
+                               uint32_t flags, uint32_t* out_width, uint32_t* out_height) {
+    MappedFile mapped;
+    if (!open_mapped(mapped, tex_path)) return -1;
+    if (mapped.size() > 0xffffffffu) return -2;
+    return tex_decode_rgba_from_memory(mapped.data(), (uint32_t)mapped.size(), out_pixels,
+                                       capacity, flags, out_width, out_height);
+}
+
+/*
+ * Decode the full-size image of an in-memory TEX file to 8-bit RGBA
+ *
+ * Same as tex_decode_rgba_from_memory, but out_pixels receives the stored
+ * (sRGB) bytes and capacity is counted in bytes. TEX_DECODE_LINEAR is ignored.
+ * RGBA16 textures are clamped to [0, 1] and rounded.
+ */
+DLL_EXPORT int tex_decode_rgba8_from_memory(const uint8_t* src, uint32_t src_len, uint8_t* out_pixels,
+                                            uint32_t capacity, uint32_t flags,
+                                            uint32_t* out_width, uint32_t* out_height) {
+    return tex_decode_common(src, src_len, out_pixels, true, capacity, flags, out_width, out_height);
+}
+
+/*
+ * Decode the full-size image of a TEX file to 8-bit RGBA
+ *
+ * Same as tex_decode_rgba8_from_memory, reading the file through a mapping.
+ * Additionally returns -1 when the file can't be opened.
+ */
+DLL_EXPORT int tex_decode_rgba8(const char* tex_path, uint8_t* out_pixels, uint32_t capacity,
+                                uint32_t flags, uint32_t* out_width, uint32_t* out_height) {
+    MappedFile mapped;
+    if (!open_mapped(mapped, tex_path)) return -1;
+    if (mapped.size() > 0xffffffffu) return -2;
+    return tex_decode_rgba8_from_memory(mapped.data(), (uint32_t)mapped.size(), out_pixels,
+                                        capacity, flags, out_width, out_height);
+}
+
+/*
+ * Limit the instruction set used by the decoders
+ *
+ * Parameters:
+ *   max_level - 0 = scalar, 1 = SSE2, 2 = AVX2, negative to leave unchanged
+ *
+ * The CPU is still checked, so asking for more than it supports is harmless.
+ * Meant for benchmarking and for ruling out a SIMD path when debugging.
+ *
+ * Returns:
+ *   The level the decoders will use from now on
+ */
+DLL_EXPORT int tex_decode_simd_level(int max_level) {
+    if (max_level >= 0) g_simd_cap.store(max_level, std::memory_order_relaxed);
+    return simd_level();
+}
 
 // ============================================================================
-// TEX to DDS Conversion (from ritoddstex)
+// TEX Decode Jobs
 // ============================================================================
 
-#define TEX_FORMAT_DXT1   0x0A
-#define TEX_FORMAT_DXT5   0x0C
-#define TEX_FORMAT_BGRA8  0x14
-#define TEX_FORMAT_RGBA16 0x15
-
-#define DDS_HEADER_FLAGS_TEXTURE  0x00001007
-#define DDS_HEADER_FLAGS_MIPMAP   0x00020000
-#define DDS_FOURCC                0x00000004
-#define DDS_RGBA                  0x00000041
-#define DDS_SURFACE_FLAGS_TEXTURE 0x00001000
-#define DDS_SURFACE_FLAGS_MIPMAP  0x00400008
-
-#pragma pack(push, 1)
-struct TEX_HEADER {
-    uint8_t magic[4];
-    uint16_t image_width;
-    uint16_t image_height;
-    uint8_t unk1;
-    uint8_t tex_format;
-    uint8_t unk2;
-    uint8_t has_mipmaps;
+#define TEX_JOB_PENDING       1             // Queued or decoding
+#define TEX_JOB_WAIT_FOREVER  0xffffffffu   // poll_tex_jobs timeout
+
+// One tex_decode_rgba call running on the thread pool. Owned by the caller
+// (until tex_job_free) and by the worker (until it has run); result, width,
+// height and pixels are written by the worker under tex_job_signal().mutex.
+// Jobs from submit_tex_job_from_memory decode data instead of opening path.
+struct TEX_JOB {
+    std::string path;
+    std::vector<uint8_t> data;
+    bool from_memory = false;
+    uint32_t flags = 0;
+    std::atomic<uint32_t> refs{2};
+    std::atomic<bool> abandoned{false};
+    int result = TEX_JOB_PENDING;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    float* pixels = nullptr;
 };
 
-struct DDS_PIXELFORMAT {
-    uint32_t dwSize;
-    uint32_t dwFlags;
-    uint8_t  dwFourCC[4];
-    uint32_t dwRGBBitCount;
-    uint32_t dwRBitMask;
-    uint32_t dwGBitMask;
-    uint32_t dwBBitMask;
-    uint32_t dwABitMask;
+// Signalled whenever any job finishes. Never destroyed, like the pool
+// whose workers use it: a freed job can still finish after exit starts.
+struct TexJobSignal {
+    std::mutex mutex;
+    std::condition_variable cv;
 };
 
-struct DDS_HEADER {
-    uint32_t        dwSize;
-    uint32_t        dwFlags;
-    uint32_t        dwHeight;
-    uint32_t        dwWidth;
-    uint32_t        dwPitchOrLinearSize;
-    uint32_t        dwDepth;
-    uint32_t        dwMipMapCount;
-    uint32_t        dwReserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    uint32_t        dwCaps;
-    uint32_t        dwCaps2;
-    uint32_t        dwCaps3;
-    uint32_t        dwCaps4;
-    uint32_t        dwReserved2;
+static TexJobSignal& tex_job_signal() {
+    static TexJobSignal* signal = new TexJobSignal();
+    return *signal;
+}
+
+static void tex_job_release(TEX_JOB* job) {
+    if (job->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        free(job->pixels);
+        delete job;
+    }
+}
+
+static int tex_job_decode(const TEX_JOB* job, const uint8_t* src, size_t src_len,
+                          float** out_pixels, uint32_t* out_width, uint32_t* out_height) {
+    if (src_len > 0xffffffffu) return -2;
+    int rc = tex_decode_rgba_from_memory(src, (uint32_t)src_len, nullptr, 0, job->flags, out_width, out_height);
+    if (rc != -6) return rc;
+
+    size_t count = (size_t)*out_width * *out_height * 4;
+    float* pixels = (float*)malloc(count * sizeof(float));
+    if (!pixels) return -4;
+    stats_add(NATIVE_COUNTER_ALLOC_BYTES, count * sizeof(float));
+    rc = tex_decode_rgba_from_memory(src, (uint32_t)src_len, pixels, (uint32_t)std::min<size_t>(count, 0xffffffffu),
+                                     job->flags, out_width, out_height);
+    if (rc != 0) {
+        free(pixels);
+        return rc;
+    }
+    *out_pixels = pixels;
+    return 0;
+}
+
+static void tex_job_run(TEX_JOB* job) {
+    int rc = -1;
+    uint32_t width = 0, height = 0;
+    float* pixels = nullptr;
+
+    // Jobs freed while still queued are skipped
+    if (!job->abandoned.load(std::memory_order_acquire)) {
+        if (job->from_memory) {
+            rc = tex_job_decode(job, job->data.data(), job->data.size(), &pixels, &width, &height);
+        } else {
+            MappedFile mapped;
+            if (open_mapped(mapped, job->path.c_str())) {
+                rc = tex_job_decode(job, mapped.data(), mapped.size(), &pixels, &width, &height);
+            }
+        }
+    }
+    // The source isn't needed once decoded
+    std::vector<uint8_t>().swap(job->data);
+
+    TexJobSignal& signal = tex_job_signal();
+    {
+        std::lock_guard<std::mutex> lock(signal.mutex);
+        job->result = rc;
+        job->width = width;
+        job->height = height;
+        job->pixels = pixels;
+    }
+    signal.cv.notify_all();
+    tex_job_release(job);
+}
+
+/*
+ * Start decoding a TEX file to float32 RGBA on the thread pool
+ *
+ * Parameters:
+ *   tex_path  - Path to the .tex file (UTF-8), copied
+ *   flags     - tex_decode_rgba flags (TEX_DECODE_FLIP_Y, TEX_DECODE_LINEAR)
+ *   out_job   - Receives the job (free with tex_job_free)
+ *
+ * The call returns right away; the file isn't opened until a worker picks
+ * the job up, so open errors are reported through poll_tex_jobs.
+ *
+ * Returns:
+ *   0 on success, -4 if the job can't be allocated, -5 on invalid arguments
+ */
+DLL_EXPORT int submit_tex_job(const char* tex_path, uint32_t flags, TEX_JOB** out_job) {
+    if (!tex_path || !out_job) return -5;
+    *out_job = nullptr;
+
+    TEX_JOB* job = new (std::nothrow) TEX_JOB();
+    if (!job) return -4;
+    job->flags = flags;
+
+    try {
+        job->path = tex_path;
+        global_thread_pool().submit([job] { tex_job_run(job); });
+    } catch (const std::bad_alloc&) {
+        // Nothing was queued, so the job is still ours to free
+        delete job;
+        return -4;
+    }
+    *out_job = job;
+    return 0;
+}
+
+/*
+ * Start decoding an in-memory TEX file to float32 RGBA on the thread pool
+ *
+ * Same as submit_tex_job, but src (e.g. an entry read with wad_read) is
+ * copied into the job, so nothing has to be written to disk for it. The
+ * copy is dropped once the job has run.
+ *
+ * Returns:
+ *   0 on success, -4 if the job can't be allocated, -5 on invalid arguments
+ */
+DLL_EXPORT int submit_tex_job_from_memory(const uint8_t* src, uint32_t src_len, uint32_t flags, TEX_JOB** out_job) {
+    if (!src || !out_job) return -5;
+    *out_job = nullptr;
+
+    TEX_JOB* job = new (std::nothrow) TEX_JOB();
+    if (!job) return -4;
+    job->flags = flags;
+    job->from_memory = true;
+
+    try {
+        job->data.assign(src, src + src_len);
+        stats_add(NATIVE_COUNTER_ALLOC_BYTES, src_len);
+        global_thread_pool().submit([job] { tex_job_run(job); });
+    } catch (const std::bad_alloc&) {
+        delete job;
+        return -4;
+    }
+    *out_job = job;
+    return 0;
+}
+
+/*
+ * Status of texture jobs, optionally waiting for them to finish
+ *
+ * Parameters:
+ *   jobs        - Array of count jobs from submit_tex_job
+ *   count       - Number of jobs
+ *   results     - Array of count statuses: TEX_JOB_PENDING, or the
+ *                 tex_decode_rgba result of a finished job (0 on success,
+ *                 -1, -2, -3, or -4 if the pixels couldn't be allocated)
+ *   timeout_ms  - How long to wait for all of them to finish:
+ *                 0 to only check, TEX_JOB_WAIT_FOREVER to wait until done
+ *
+ * Returns:
+ *   Number of jobs still pending, or -5 on invalid arguments
+ */
+DLL_EXPORT int poll_tex_jobs(TEX_JOB* const* jobs, uint32_t count, int32_t* results, uint32_t timeout_ms) {
+    if (count > 0 && (!jobs || !results)) return -5;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!jobs[i]) return -5;
+    }
+
+    int pending = 0;
+    auto done = [&] {
+        pending = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            results[i] = jobs[i]->result;
+            if (results[i] == TEX_JOB_PENDING) pending++;
+        }
+        return pending == 0;
+    };
+
+    TexJobSignal& signal = tex_job_signal();
+    std::unique_lock<std::mutex> lock(signal.mutex);
+    if (done() || timeout_ms == 0) return pending;
+    if (timeout_ms == TEX_JOB_WAIT_FOREVER) {
+        signal.cv.wait(lock, done);
+    } else {
+        signal.cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), done);
+    }
+    return pending;
+}
+
+/*
+ * Pixels of a finished texture job
+ *
+ * Parameters:
+ *   job         - Job from submit_tex_job
+ *   out_pixels  - Receives width * height * 4 floats, valid until tex_job_free
+ *   out_width   - Receives the image width
+ *   out_height  - Receives the image height
+ *
+ * Doesn't wait; use poll_tex_jobs for that.
+ *
+ * Returns:
+ *   Same as poll_tex_jobs reports for the job (out_pixels is only set on
+ *   0), or -5 on invalid arguments
+ */
+DLL_EXPORT int tex_job_result(TEX_JOB* job, const float** out_pixels, uint32_t* out_width, uint32_t* out_height) {
+    if (!job || !out_pixels || !out_width || !out_height) return -5;
+
+    std::lock_guard<std::mutex> lock(tex_job_signal().mutex);
+    *out_pixels = job->result == 0 ? job->pixels : nullptr;
+    *out_width = job->width;
+    *out_height = job->height;
+    return job->result;
+}
+
+/*
+ * Release a texture job and its pixels
+ *
+ * Doesn't wait: a job that hasn't started is skipped, and one that is
+ * decoding frees itself when it finishes.
+ */
+DLL_EXPORT void tex_job_free(TEX_JOB* job) {
+    if (!job) return;
+    job->abandoned.store(true, std::memory_order_release);
+    tex_job_release(job);
+}
+
+// ============================================================================
+// ANM Parsing
+// ============================================================================
+
+#define ANM_FORMAT_COMPRESSED  1   // r3d2canm
+#define ANM_FORMAT_V5          2   // r3d2anmd v5: shared vector/quaternion palettes
+#define ANM_FORMAT_V4          3   // r3d2anmd v4: palettes, hash per frame entry
+#define ANM_FORMAT_LEGACY      4   // r3d2anmd v3 and older, named tracks
+
+#define ANM_KEY_TRANSLATION  0x1
+#define ANM_KEY_ROTATION     0x2
+#define ANM_KEY_SCALE        0x4
+
+// Largest track_count * frame_slots accepted, keeps corrupt headers from
+// turning into multi-gigabyte allocations
+static const uint64_t ANM_MAX_KEYS = 1u << 26;
+
+// Result of parse_anm: one malloc'd block holding this header followed by
+// the arrays, all laid out [track][frame]. Frames without a key for a
+// channel are zero and have the matching ANM_KEY_* bit cleared.
+typedef struct {
+    uint32_t format;            // ANM_FORMAT_*
+    uint32_t version;
+    uint32_t track_count;
+    uint32_t frame_count;       // Animation length in frames
+    uint32_t frame_slots;       // Frames per track in the arrays (>= frame_count for compressed files)
+    float fps;
+    float duration;
+    uint32_t* joint_hashes;     // track_count, ELF hash of the joint name
+    uint8_t* key_flags;         // track_count * frame_slots
+    float* translations;        // track_count * frame_slots * 3, file units
+    float* rotations;           // track_count * frame_slots * 4 (x, y, z, w)
+    float* scales;              // track_count * frame_slots * 3
+} ANM_DATA;
+
+// 15-bit smallest-three quaternion: three components in [-1/sqrt2, 1/sqrt2]
+// and the index of the omitted (largest) one, rebuilt from unit length
+static const float QUAT_ONE_DIV_SQRT2 = 0.70710678118f;
+static const float QUAT_SQRT2_DIV_32767 = 0.00004315969f;
+
+static void decompress_quat_scalar(const uint8_t* src, float* out) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)src[i] << (8 * i);
+
+    uint32_t max_index = (uint32_t)(bits >> 45) & 3;
+    float a = ((bits >> 30) & 32767) * QUAT_SQRT2_DIV_32767 - QUAT_ONE_DIV_SQRT2;
+    float b = ((bits >> 15) & 32767) * QUAT_SQRT2_DIV_32767 - QUAT_ONE_DIV_SQRT2;
+    float c = (bits & 32767) * QUAT_SQRT2_DIV_32767 - QUAT_ONE_DIV_SQRT2;
+    float d2 = 1.0f - (a * a + b * b + c * c);
+    float d = sqrtf(d2 > 0.0f ? d2 : 0.0f);
+
+    // Output is x, y, z, w with d in slot max_index and a, b, c filling the rest
+    const float rest[3] = { a, b, c };
+    for (uint32_t k = 0, j = 0; k < 4; k++) {
+        out[k] = k == max_index ? d : rest[j++];
+    }
+}
+
+#ifdef LOL_NATIVE_X64
+
+// Per max_index lane masks for placing d among a, b, c
+struct QuatLaneMasks {
+    __m128 before[4];   // lanes < max_index keep a, b, c
+    __m128 at[4];       // lane == max_index takes d
+    __m128 after[4];    // lanes > max_index take the component one lane down
+
+    QuatLaneMasks() {
+        for (int m = 0; m < 4; m++) {
+            int32_t b[4], a[4], f[4];
+            for (int k = 0; k < 4; k++) {
+                b[k] = k < m ? -1 : 0;
+                a[k] = k == m ? -1 : 0;
+                f[k] = k > m ? -1 : 0;
+            }
+            before[m] = _mm_castsi128_ps(_mm_setr_epi32(b[0], b[1], b[2], b[3]));
+            at[m] = _mm_castsi128_ps(_mm_setr_epi32(a[0], a[1], a[2], a[3]));
+            after[m] = _mm_castsi128_ps(_mm_setr_epi32(f[0], f[1], f[2], f[3]));
+        }
+    }
 };
-#pragma pack(pop)
 
-static inline uint32_t calc_mipmap_count(uint32_t width, uint32_t height) {
-    uint32_t max_dim = (width > height) ? width : height;
-    uint32_t count = 0;
-    while (max_dim > 0) { count++; max_dim >>= 1; }
-    return count;
+static const QuatLaneMasks& quat_lane_masks() {
+    static const QuatLaneMasks masks;
+    return masks;
 }
 
-static int get_bytes_per_block(uint8_t format) {
-    switch (format) {
-        case TEX_FORMAT_DXT1:  return 8;
-        case TEX_FORMAT_DXT5:  return 16;
-        case TEX_FORMAT_BGRA8: return 4;
-        case TEX_FORMAT_RGBA16: return 8;
-        default: return 0;
+// q holds (a, b, c, d) of one quaternion
+static inline __m128 arrange_quat(__m128 q, uint32_t max_index, const QuatLaneMasks& masks) {
+    __m128 d = _mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128 shifted = _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 0, 0));
+    return _mm_or_ps(_mm_and_ps(masks.before[max_index], q),
+                     _mm_or_ps(_mm_and_ps(masks.at[max_index], d),
+                               _mm_and_ps(masks.after[max_index], shifted)));
+}
+
+// Split the packed words of four quaternions into 32-bit lanes
+static inline void load_quat_words(const uint8_t* src, uint32_t* lo, uint32_t* hi) {
+    for (int j = 0; j < 4; j++) {
+        memcpy(&lo[j], src + j * 6, 4);
+        hi[j] = (uint32_t)src[j * 6 + 4] | ((uint32_t)src[j * 6 + 5] << 8);
     }
 }
 
-static int get_block_size(uint8_t format) {
-    switch (format) {
-        case TEX_FORMAT_DXT1:
-        case TEX_FORMAT_DXT5:
-            return 4;
-        default:
-            return 1;
+static void decompress_quats_sse2(const uint8_t* src, size_t count, float* out) {
+    const QuatLaneMasks& masks = quat_lane_masks();
+    const __m128i mask15 = _mm_set1_epi32(32767);
+    const __m128 scale = _mm_set1_ps(QUAT_SQRT2_DIV_32767);
+    const __m128 bias = _mm_set1_ps(QUAT_ONE_DIV_SQRT2);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        alignas(16) uint32_t lo[4], hi[4], max_index[4];
+        load_quat_words(src + i * 6, lo, hi);
+        __m128i vlo = _mm_load_si128((const __m128i*)lo);
+        __m128i vhi = _mm_load_si128((const __m128i*)hi);
+
+        __m128i ci = _mm_and_si128(vlo, mask15);
+        __m128i bi = _mm_and_si128(_mm_srli_epi32(vlo, 15), mask15);
+        __m128i ai = _mm_and_si128(_mm_or_si128(_mm_srli_epi32(vlo, 30), _mm_slli_epi32(vhi, 2)), mask15);
+        _mm_store_si128((__m128i*)max_index, _mm_and_si128(_mm_srli_epi32(vhi, 13), _mm_set1_epi32(3)));
+
+        __m128 a = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(ai), scale), bias);
+        __m128 b = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(bi), scale), bias);
+        __m128 c = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(ci), scale), bias);
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+        __m128 d = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, sum), _mm_setzero_ps()));
+
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        _mm_storeu_ps(out + i * 4, arrange_quat(a, max_index[0], masks));
+        _mm_storeu_ps(out + i * 4 + 4, arrange_quat(b, max_index[1], masks));
+        _mm_storeu_ps(out + i * 4 + 8, arrange_quat(c, max_index[2], masks));
+        _mm_storeu_ps(out + i * 4 + 12, arrange_quat(d, max_index[3], masks));
     }
+    for (; i < count; i++) decompress_quat_scalar(src + i * 6, out + i * 4);
 }
 
-DLL_EXPORT int tex_to_dds_bytes(const char* tex_path, uint8_t** out_data, uint32_t* out_size) {
-    FILE* tex_file = fopen(tex_path, "rb");
-    if (!tex_file) return -1;
+TARGET_AVX2 static void decompress_quats_avx2(const uint8_t* src, size_t count, float* out) {
+    const QuatLaneMasks& masks = quat_lane_masks();
+    const __m256i mask15 = _mm256_set1_epi32(32767);
+    const __m256 scale = _mm256_set1_ps(QUAT_SQRT2_DIV_32767);
+    const __m256 bias = _mm256_set1_ps(QUAT_ONE_DIV_SQRT2);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        alignas(32) uint32_t lo[8], hi[8], max_index[8];
+        load_quat_words(src + i * 6, lo, hi);
+        load_quat_words(src + i * 6 + 24, lo + 4, hi + 4);
+        __m256i vlo = _mm256_load_si256((const __m256i*)lo);
+        __m256i vhi = _mm256_load_si256((const __m256i*)hi);
+
+        __m256i ci = _mm256_and_si256(vlo, mask15);
+        __m256i bi = _mm256_and_si256(_mm256_srli_epi32(vlo, 15), mask15);
+        __m256i ai = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi32(vlo, 30), _mm256_slli_epi32(vhi, 2)), mask15);
+        _mm256_store_si256((__m256i*)max_index, _mm256_and_si256(_mm256_srli_epi32(vhi, 13), _mm256_set1_epi32(3)));
+
+        __m256 a = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ai), scale), bias);
+        __m256 b = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(bi), scale), bias);
+        __m256 c = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ci), scale), bias);
+        __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b)), _mm256_mul_ps(c, c));
+        __m256 d = _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(one, sum), _mm256_setzero_ps()));
+
+        for (int half = 0; half < 2; half++) {
+            __m128 qa = half ? _mm256_extractf128_ps(a, 1) : _mm256_castps256_ps128(a);
+            __m128 qb = half ? _mm256_extractf128_ps(b, 1) : _mm256_castps256_ps128(b);
+            __m128 qc = half ? _mm256_extractf128_ps(c, 1) : _mm256_castps256_ps128(c);
+            __m128 qd = half ? _mm256_extractf128_ps(d, 1) : _mm256_castps256_ps128(d);
+            _MM_TRANSPOSE4_PS(qa, qb, qc, qd);
+
+            float* dst = out + (i + half * 4) * 4;
+            const uint32_t* mi = max_index + half * 4;
+            _mm_storeu_ps(dst, arrange_quat(qa, mi[0], masks));
+            _mm_storeu_ps(dst + 4, arrange_quat(qb, mi[1], masks));
+            _mm_storeu_ps(dst + 8, arrange_quat(qc, mi[2], masks));
+            _mm_storeu_ps(dst + 12, arrange_quat(qd, mi[3], masks));
+        }
+    }
+    decompress_quats_sse2(src + i * 6, count - i, out + i * 4);
+}
 
-    fseek(tex_file, 0, SEEK_END);
-    uint32_t file_size = (uint32_t)ftell(tex_file);
-    rewind(tex_file);
+#endif // LOL_NATIVE_X64
 
-    TEX_HEADER tex_header;
-    if (file_size < sizeof(TEX_HEADER) ||
-        fread(&tex_header, sizeof(TEX_HEADER), 1, tex_file) != 1 ||
-        memcmp(tex_header.magic, "TEX", 3) != 0) {
-        fclose(tex_file);
-        return -2;
-    }
-
-    DDS_PIXELFORMAT ddspf = {};
-    ddspf.dwSize = sizeof(DDS_PIXELFORMAT);
-    const char* fourcc = nullptr;
-    bool need_dx10 = false;
-
-    switch (tex_header.tex_format) {
-        case TEX_FORMAT_DXT1:
-            fourcc = "DXT1";
-            ddspf.dwFlags = DDS_FOURCC;
-            break;
-        case TEX_FORMAT_DXT5:
-            fourcc = "DXT5";
-            ddspf.dwFlags = DDS_FOURCC;
-            break;
-        case TEX_FORMAT_BGRA8:
-            ddspf.dwFlags = DDS_RGBA;
-            ddspf.dwRGBBitCount = 32;
-            ddspf.dwBBitMask = 0x000000ff;
-            ddspf.dwGBitMask = 0x0000ff00;
-            ddspf.dwRBitMask = 0x00ff0000;
-            ddspf.dwABitMask = 0xff000000;
-            break;
-        case TEX_FORMAT_RGBA16:
-            fourcc = "DX10";
-            ddspf.dwFlags = DDS_FOURCC;
-            need_dx10 = true;
-            break;
-        default:
-            fclose(tex_file);
-            return -3;
-    }
-
-    if (fourcc) memcpy(ddspf.dwFourCC, fourcc, 4);
-
-    DDS_HEADER dds_header = {};
-    dds_header.dwSize = sizeof(DDS_HEADER);
-    dds_header.dwFlags = DDS_HEADER_FLAGS_TEXTURE;
-    dds_header.dwHeight = tex_header.image_height;
-    dds_header.dwWidth = tex_header.image_width;
-    dds_header.ddspf = ddspf;
-    dds_header.dwCaps = DDS_SURFACE_FLAGS_TEXTURE;
-
-    uint32_t mipmap_count = 0;
-    if (tex_header.has_mipmaps) {
-        dds_header.dwFlags |= DDS_HEADER_FLAGS_MIPMAP;
-        dds_header.dwCaps |= DDS_SURFACE_FLAGS_MIPMAP;
-        mipmap_count = calc_mipmap_count(tex_header.image_width, tex_header.image_height);
-        dds_header.dwMipMapCount = mipmap_count;
-    }
-
-    uint32_t tex_data_size = file_size - sizeof(TEX_HEADER);
-    uint32_t header_size = 4 + sizeof(DDS_HEADER);
-    if (need_dx10) header_size += 20;
-    uint32_t total_size = header_size + tex_data_size;
-
-    uint8_t* dds_data = (uint8_t*)malloc(total_size);
-    if (!dds_data) { fclose(tex_file); return -4; }
-
-    uint8_t* ptr = dds_data;
-    memcpy(ptr, "DDS ", 4); ptr += 4;
-    memcpy(ptr, &dds_header, sizeof(DDS_HEADER)); ptr += sizeof(DDS_HEADER);
-
-    if (need_dx10) {
-        uint8_t dx10_header[20] = {};
-        dx10_header[0] = 0x0d;
-        dx10_header[4] = 0x03;
-        dx10_header[12] = 0x01;
-        dx10_header[16] = 0x01;
-        memcpy(ptr, dx10_header, 20);
-        ptr += 20;
-    }
-
-    uint8_t* tex_data = (uint8_t*)malloc(tex_data_size);
-    if (!tex_data) { free(dds_data); fclose(tex_file); return -4; }
-
-    if (fread(tex_data, 1, tex_data_size, tex_file) != tex_data_size) {
-        free(tex_data); free(dds_data); fclose(tex_file);
-        return -2;
-    }
-    fclose(tex_file);
-
-    if (tex_header.has_mipmaps && mipmap_count > 0) {
-        uint32_t block_size = get_block_size(tex_header.tex_format);
-        uint32_t bytes_per_block = get_bytes_per_block(tex_header.tex_format);
-        int32_t current_offset = tex_data_size;
-
-        for (uint32_t i = 0; i < mipmap_count; i++) {
-            uint32_t mip_width = (tex_header.image_width >> i);
-            uint32_t mip_height = (tex_header.image_height >> i);
-            if (mip_width < 1) mip_width = 1;
-            if (mip_height < 1) mip_height = 1;
-            uint32_t block_width = (mip_width + block_size - 1) / block_size;
-            uint32_t block_height = (mip_height + block_size - 1) / block_size;
-            uint32_t mip_size = bytes_per_block * block_width * block_height;
-
-            current_offset -= mip_size;
-            if (current_offset < 0) break;
-            memcpy(ptr, tex_data + current_offset, mip_size);
-            ptr += mip_size;
+static void decompress_quats_batch(const uint8_t* src, size_t count, float* out) {
+#ifdef LOL_NATIVE_X64
+    int level = simd_level();
+    if (level >= SIMD_AVX2) { decompress_quats_avx2(src, count, out); return; }
+    if (level >= SIMD_SSE2) { decompress_quats_sse2(src, count, out); return; }
+#endif
+    for (size_t i = 0; i < count; i++) decompress_quat_scalar(src + i * 6, out + i * 4);
+}
+
+/*
+ * Decompress 48-bit ANM quaternions
+ *
+ * Parameters:
+ *   in     - count * 6 bytes of packed quaternions
+ *   count  - Number of quaternions
+ *   out    - Receives count * 4 floats (x, y, z, w)
+ *
+ * Returns:
+ *   0 on success, -5 if in or out is NULL
+ */
+DLL_EXPORT int decompress_quats(const uint8_t* in, uint32_t count, float* out) {
+    if (count == 0) return 0;
+    if (!in || !out) return -5;
+    decompress_quats_batch(in, count, out);
+    return 0;
+}
+
+// ELF hash of a joint name, lowercased (matches Hash.elf on the Python side)
+static uint32_t elf_hash_lower(const char* s, size_t len) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] == '\0') continue;
+        char c = s[i] >= 'A' && s[i] <= 'Z' ? (char)(s[i] + 32) : s[i];
+        h = (h << 4) + (uint8_t)c;
+        uint32_t t = h & 0xF0000000;
+        if (t != 0) h ^= t >> 24;
+        h &= ~t;
+    }
+    return h;
+}
+
+static ANM_DATA* anm_alloc(uint32_t track_count, uint32_t frame_slots) {
+    const size_t keys = (size_t)track_count * frame_slots;
+
+    BlockLayout layout;
+    size_t off_header = layout.add(sizeof(ANM_DATA));
+    size_t off_hashes = layout.add((size_t)track_count * sizeof(uint32_t));
+    size_t off_flags = layout.add(keys);
+    size_t off_translations = layout.add(keys * 3 * sizeof(float));
+    size_t off_rotations = layout.add(keys * 4 * sizeof(float));
+    size_t off_scales = layout.add(keys * 3 * sizeof(float));
+
+    uint8_t* block = (uint8_t*)calloc(1, layout.size);
+    if (!block) return nullptr;
+
+    ANM_DATA* anm = (ANM_DATA*)(block + off_header);
+    anm->track_count = track_count;
+    anm->frame_slots = frame_slots;
+    anm->joint_hashes = (uint32_t*)(block + off_hashes);
+    anm->key_flags = block + off_flags;
+    anm->translations = (float*)(block + off_translations);
+    anm->rotations = (float*)(block + off_rotations);
+    anm->scales = (float*)(block + off_scales);
+    return anm;
+}
+
+static int anm_parse_compressed(ByteReader& r, ANM_DATA** out_anm) {
+    uint32_t joint_count, key_count;
+    float max_time, fps;
+    float translation_min[3], translation_max[3], scale_min[3], scale_max[3];
+    int32_t frames_offset, joint_hashes_offset;
+
+    if (!r.skip(12)) return -2;     // Resource size, format token, flags
+    if (!r.u32(joint_count) || !r.u32(key_count) || !r.skip(4)) return -2;
+    if (!r.f32(max_time) || !r.f32(fps) || !r.skip(24)) return -2;
+    if (!r.read(translation_min, 12) || !r.read(translation_max, 12)) return -2;
+    if (!r.read(scale_min, 12) || !r.read(scale_max, 12)) return -2;
+    if (!r.i32(frames_offset) || !r.skip(4) || !r.i32(joint_hashes_offset)) return -2;
+    if (!(fps > 0.0f) || !std::isfinite(max_time) || frames_offset < 0 || joint_hashes_offset < 0) return -2;
+
+    if (!r.seek((size_t)joint_hashes_offset + 12) || !r.has((size_t)joint_count * 4)) return -2;
+    const uint8_t* hashes = r.here();
+    if (!r.seek((size_t)frames_offset + 12) || !r.has((size_t)key_count * 10)) return -2;
+    const uint8_t* keys = r.here();
+
+    // Same double-precision rounding as the Python reader
+    const double duration = (double)max_time + 1.0 / fps;
+    const int64_t frame_count = (int64_t)nearbyint(duration * fps);
+    auto frame_of = [&](uint16_t compressed_time) {
+        double time = compressed_time / 65535.0 * max_time;
+        return (int64_t)nearbyint(time * fps);
+    };
+
+    int64_t last_frame = frame_count - 1;
+    for (uint32_t k = 0; k < key_count; k++) {
+        const uint8_t* key = keys + (size_t)k * 10;
+        uint16_t compressed_time, bits;
+        memcpy(&compressed_time, key, 2);
+        memcpy(&bits, key + 2, 2);
+        if ((bits & 16383) >= joint_count) continue;
+        int64_t frame = frame_of(compressed_time);
+        if (frame > last_frame) last_frame = frame;
+    }
+
+    uint64_t frame_slots = last_frame >= 0 ? (uint64_t)last_frame + 1 : 0;
+    if ((uint64_t)joint_count * frame_slots > ANM_MAX_KEYS) return -2;
+
+    ANM_DATA* anm = anm_alloc(joint_count, (uint32_t)frame_slots);
+    if (!anm) return -4;
+    anm->format = ANM_FORMAT_COMPRESSED;
+    anm->frame_count = frame_count > 0 ? (uint32_t)frame_count : 0;
+    anm->fps = fps;
+    anm->duration = (float)duration;
+    memcpy(anm->joint_hashes, hashes, (size_t)joint_count * 4);
+
+    // Rotations are gathered and decompressed in one batch; later keys for
+    // the same frame overwrite earlier ones like the Python reader
+    std::vector<uint8_t> packed_rotations;
+    std::vector<size_t> rotation_slots;
+
+    for (uint32_t k = 0; k < key_count; k++) {
+        const uint8_t* key = keys + (size_t)k * 10;
+        uint16_t compressed_time, bits, v[3];
+        memcpy(&compressed_time, key, 2);
+        memcpy(&bits, key + 2, 2);
+        memcpy(v, key + 4, 6);
+
+        uint32_t joint = bits & 16383;
+        int64_t frame = frame_of(compressed_time);
+        if (joint >= joint_count || frame < 0) continue;
+
+        size_t slot = (size_t)joint * anm->frame_slots + (size_t)frame;
+        switch (bits >> 14) {
+            case 0:
+                packed_rotations.insert(packed_rotations.end(), key + 4, key + 10);
+                rotation_slots.push_back(slot);
+                anm->key_flags[slot] |= ANM_KEY_ROTATION;
+                break;
+            case 1:
+                for (int c = 0; c < 3; c++) {
+                    anm->translations[slot * 3 + c] = (float)(
+                        ((double)translation_max[c] - translation_min[c]) / 65535.0 * v[c] + translation_min[c]);
+                }
+                anm->key_flags[slot] |= ANM_KEY_TRANSLATION;
+                break;
+            case 2:
+                for (int c = 0; c < 3; c++) {
+                    anm->scales[slot * 3 + c] = (float)(
+                        ((double)scale_max[c] - scale_min[c]) / 65535.0 * v[c] + scale_min[c]);
+                }
+                anm->key_flags[slot] |= ANM_KEY_SCALE;
+                break;
+            default:
+                break;
         }
+    }
+
+    std::vector<float> rotations(rotation_slots.size() * 4);
+    decompress_quats_batch(packed_rotations.data(), rotation_slots.size(), rotations.data());
+    for (size_t i = 0; i < rotation_slots.size(); i++) {
+        memcpy(anm->rotations + rotation_slots[i] * 4, rotations.data() + i * 4, 16);
+    }
+
+    *out_anm = anm;
+    return 0;
+}
+
+// v4 and v5 share the vector palette and index triplets; v5 quantizes the
+// quaternion palette and moves joint hashes to their own table
+static int anm_parse_palette(ByteReader& r, uint32_t version, ANM_DATA** out_anm) {
+    uint32_t track_count, frame_count;
+    float frame_duration;
+    int32_t joint_hashes_offset = 0, vecs_offset, quats_offset, frames_offset;
+
+    if (!r.skip(16)) return -2;     // Resource size, format token, version, flags
+    if (!r.u32(track_count) || !r.u32(frame_count) || !r.f32(frame_duration)) return -2;
+    if (version == 5) {
+        if (!r.i32(joint_hashes_offset) || !r.skip(8)) return -2;   // Asset name, time
     } else {
-        memcpy(ptr, tex_data, tex_data_size);
+        if (!r.skip(12)) return -2;
+    }
+    if (!r.i32(vecs_offset) || !r.i32(quats_offset) || !r.i32(frames_offset)) return -2;
+    if (!(frame_duration > 0.0f) || vecs_offset < 0 || quats_offset < 0 || frames_offset < 0) return -2;
+    if ((uint64_t)track_count * frame_count > ANM_MAX_KEYS) return -2;
+
+    const size_t quat_size = version == 5 ? 6 : 16;
+    const int32_t quats_end = version == 5 ? joint_hashes_offset : frames_offset;
+    const size_t vec_count = quats_offset > vecs_offset ? (size_t)(quats_offset - vecs_offset) / 12 : 0;
+    const size_t quat_count = quats_end > quats_offset ? (size_t)(quats_end - quats_offset) / quat_size : 0;
+
+    if (!r.seek((size_t)vecs_offset + 12) || !r.has(vec_count * 12)) return -2;
+    std::vector<float> vectors(vec_count * 3);
+    r.read(vectors.data(), vec_count * 12);
+
+    if (!r.seek((size_t)quats_offset + 12) || !r.has(quat_count * quat_size)) return -2;
+    std::vector<float> quats(quat_count * 4);
+    if (version == 5) {
+        decompress_quats_batch(r.here(), quat_count, quats.data());
+    } else {
+        r.read(quats.data(), quat_count * 16);
     }
 
-    free(tex_data);
-    *out_data = dds_data;
-    *out_size = total_size;
+    const size_t entry_size = version == 5 ? 6 : 12;   // v4: hash, indices, padding
+    if (!r.seek((size_t)frames_offset + 12) || !r.has((size_t)frame_count * track_count * entry_size)) return -2;
+    const uint8_t* frames = r.here();
+
+    // v4 tracks are identified by the hash in each frame entry, in order of
+    // first appearance
+    std::vector<uint32_t> track_hashes;
+    std::unordered_map<uint32_t, uint32_t> track_of_hash;
+    if (version == 5) {
+        if (!r.seek((size_t)joint_hashes_offset + 12) || !r.has((size_t)track_count * 4)) return -2;
+        track_hashes.resize(track_count);
+        r.read(track_hashes.data(), (size_t)track_count * 4);
+    } else {
+        for (size_t e = 0; e < (size_t)frame_count * track_count; e++) {
+            uint32_t hash;
+            memcpy(&hash, frames + e * entry_size, 4);
+            if (track_of_hash.emplace(hash, (uint32_t)track_hashes.size()).second) track_hashes.push_back(hash);
+        }
+        // Only track_count * frame_count was checked against ANM_MAX_KEYS
+        if (track_hashes.size() > track_count) return -2;
+    }
+
+    ANM_DATA* anm = anm_alloc((uint32_t)track_hashes.size(), frame_count);
+    if (!anm) return -4;
+    anm->format = version == 5 ? ANM_FORMAT_V5 : ANM_FORMAT_V4;
+    anm->frame_count = frame_count;
+    anm->fps = 1.0f / frame_duration;
+    anm->duration = frame_count * frame_duration;
+    if (!track_hashes.empty()) memcpy(anm->joint_hashes, track_hashes.data(), track_hashes.size() * 4);
+
+    for (uint32_t f = 0; f < frame_count; f++) {
+        for (uint32_t t = 0; t < track_count; t++) {
+            const uint8_t* entry = frames + ((size_t)f * track_count + t) * entry_size;
+            uint32_t track = t;
+            if (version != 5) {
+                uint32_t hash;
+                memcpy(&hash, entry, 4);
+                track = track_of_hash[hash];
+                entry += 4;
+            }
+
+            uint16_t idx[3];    // translation, scale, rotation
+            memcpy(idx, entry, 6);
+            if (idx[0] >= vec_count || idx[1] >= vec_count || idx[2] >= quat_count) {
+                free(anm);
+                return -2;
+            }
+
+            size_t slot = (size_t)track * frame_count + f;
+            memcpy(anm->translations + slot * 3, vectors.data() + (size_t)idx[0] * 3, 12);
+            memcpy(anm->scales + slot * 3, vectors.data() + (size_t)idx[1] * 3, 12);
+            memcpy(anm->rotations + slot * 4, quats.data() + (size_t)idx[2] * 4, 16);
+            anm->key_flags[slot] = ANM_KEY_TRANSLATION | ANM_KEY_ROTATION | ANM_KEY_SCALE;
+        }
+    }
+
+    *out_anm = anm;
     return 0;
 }
 
-DLL_EXPORT void free_bytes(uint8_t* data) {
-    if (data) free(data);
+// Named tracks with a rotation and translation per frame; scale is always 1
+static int anm_parse_legacy(ByteReader& r, ANM_DATA** out_anm) {
+    uint32_t version, track_count, frame_count, fps;
+    if (!r.seek(8) || !r.u32(version) || !r.skip(4)) return -2;     // skl id
+    if (!r.u32(track_count) || !r.u32(frame_count) || !r.u32(fps)) return -2;
+    if (fps == 0) fps = 30;
+
+    const size_t track_size = 36 + (size_t)frame_count * 28;
+    if ((uint64_t)track_count * frame_count > ANM_MAX_KEYS || !r.has((size_t)track_count * track_size)) return -2;
+
+    ANM_DATA* anm = anm_alloc(track_count, frame_count);
+    if (!anm) return -4;
+    anm->format = ANM_FORMAT_LEGACY;
+    anm->version = version;
+    anm->frame_count = frame_count;
+    anm->fps = (float)fps;
+    anm->duration = (float)frame_count / fps;
+
+    for (uint32_t t = 0; t < track_count; t++) {
+        const uint8_t* track = r.here() + (size_t)t * track_size;
+        anm->joint_hashes[t] = elf_hash_lower((const char*)track, 32);
+
+        const uint8_t* frames = track + 36;     // 32 byte name, flags
+        for (uint32_t f = 0; f < frame_count; f++) {
+            size_t slot = (size_t)t * frame_count + f;
+            memcpy(anm->rotations + slot * 4, frames + (size_t)f * 28, 16);
+            memcpy(anm->translations + slot * 3, frames + (size_t)f * 28 + 16, 12);
+            anm->scales[slot * 3] = anm->scales[slot * 3 + 1] = anm->scales[slot * 3 + 2] = 1.0f;
+            anm->key_flags[slot] = ANM_KEY_TRANSLATION | ANM_KEY_ROTATION | ANM_KEY_SCALE;
+        }
+    }
+
+    *out_anm = anm;
+    return 0;
+}
+
+static int anm_parse(const uint8_t* src, size_t src_len, ANM_DATA** out_anm) {
+    StatsTimer timer(NATIVE_STAGE_PARSE);
+    ByteReader r = { src, src_len, 0 };
+
+    char magic[8];
+    uint32_t version;
+    if (!r.read(magic, 8) || !r.u32(version)) return -2;
+
+    int rc;
+    if (memcmp(magic, "r3d2canm", 8) == 0) {
+        rc = anm_parse_compressed(r, out_anm);
+    } else if (memcmp(magic, "r3d2anmd", 8) == 0 && (version == 5 || version == 4)) {
+        rc = anm_parse_palette(r, version, out_anm);
+    } else {
+        return anm_parse_legacy(r, out_anm);
+    }
+    if (rc == 0) (*out_anm)->version = version;
+    return rc;
+}
+
+/*
+ * Parse an in-memory ANM file into per-track key arrays
+ *
+ * Parameters:
+ *   src      - ANM file contents
+ *   src_len  - Size of src in bytes
+ *   out_anm  - Receives the parsed animation (free with free_bytes)
+ *
+ * Handles compressed (r3d2canm), v5, v4 and legacy files. Translations are
+ * in file units; the importer applies its own scale.
+ *
+ * Returns:
+ *   0 on success, negative on error:
+ *   -2: Invalid or truncated file
+ *   -4: Memory allocation failed
+ *   -5: Invalid arguments
+ */
+DLL_EXPORT int parse_anm_from_memory(const uint8_t* src, uint32_t src_len, ANM_DATA** out_anm) {
+    if (!src || !out_anm) return -5;
+    *out_anm = nullptr;
+    return anm_parse(src, src_len, out_anm);
+}
+
+/*
+ * Parse an ANM file into per-track key arrays
+ *
+ * Same as parse_anm_from_memory, reading the file through a mapping.
+ * Additionally returns -1 when the file can't be opened.
+ */
+DLL_EXPORT int parse_anm(const char* anm_path, ANM_DATA** out_anm) {
+    if (!anm_path || !out_anm) return -5;
+    *out_anm = nullptr;
+
+    MappedFile mapped;
+    if (!open_mapped(mapped, anm_path)) return -1;
+    return anm_parse(mapped.data(), mapped.size(), out_anm);
+}
+
+// ============================================================================
+// ANM Writing
+// ============================================================================
+
+static const uint32_t ANM_FORMAT_TOKEN = 0xBE0794D3;
+static const uint32_t ANM_V5_HEADER_SIZE = 76;
+static const size_t ANM_MAX_PALETTE = 65536;        // Frame entries index palettes with u16
+
+// Inverse of decompress_quat_scalar: normalize, drop the largest component
+// (flipping the sign so it's positive) and quantize the other three to 15 bits
+static uint64_t compress_quat(const float* q) {
+    float c[4] = {q[0], q[1], q[2], q[3]};
+    float len = sqrtf(c[0] * c[0] + c[1] * c[1] + c[2] * c[2] + c[3] * c[3]);
+    if (len > 0.0f) {
+        for (int i = 0; i < 4; i++) c[i] /= len;
+    } else {
+        c[0] = c[1] = c[2] = 0.0f;
+        c[3] = 1.0f;
+    }
+
+    uint32_t max_index = 0;
+    for (uint32_t i = 1; i < 4; i++) {
+        if (fabsf(c[i]) > fabsf(c[max_index])) max_index = i;
+    }
+    float sign = c[max_index] < 0.0f ? -1.0f : 1.0f;
+
+    uint64_t bits = (uint64_t)max_index << 45;
+    int shift = 30;
+    for (uint32_t i = 0; i < 4; i++) {
+        if (i == max_index) continue;
+        long v = lroundf((c[i] * sign + QUAT_ONE_DIV_SQRT2) / QUAT_SQRT2_DIV_32767);
+        if (v < 0) v = 0;
+        if (v > 32767) v = 32767;
+        bits |= (uint64_t)v << shift;
+        shift -= 15;
+    }
+    return bits;
+}
+
+// Vectors are deduplicated on values rounded to 1e-6 (as the Python writer
+// did); the palette keeps the first value seen for a key
+struct AnmVecKey {
+    int64_t v[3];
+
+    bool operator==(const AnmVecKey& o) const { return memcmp(v, o.v, sizeof(v)) == 0; }
+};
+
+struct AnmVecKeyHash {
+    size_t operator()(const AnmVecKey& k) const { return (size_t)xxhash64(k.v, sizeof(k.v)); }
+};
+
+class AnmVectorPalette {
+public:
+    // Palette index of v, or -1 once the palette is full
+    int32_t add(const float* v) {
+        AnmVecKey key;
+        for (int c = 0; c < 3; c++) key.v[c] = llround((double)v[c] * 1e6);
+        auto it = index_.find(key);
+        if (it != index_.end()) return (int32_t)it->second;
+        if (index_.size() >= ANM_MAX_PALETTE) return -1;
+        uint32_t idx = (uint32_t)index_.size();
+        index_.emplace(key, idx);
+        values_.insert(values_.end(), v, v + 3);
+        return (int32_t)idx;
+    }
+
+    const std::vector<float>& values() const { return values_; }
+
+private:
+    std::unordered_map<AnmVecKey, uint32_t, AnmVecKeyHash> index_;
+    std::vector<float> values_;
+};
+
+/*
+ * Write a v5 ANM (r3d2anmd) from dense per-track keys
+ *
+ * Parameters:
+ *   anm_path      - Output path (UTF-8)
+ *   track_count   - Number of tracks
+ *   frame_count   - Frames per track (at least 1)
+ *   fps           - Frames per second
+ *   joint_hashes  - track_count ELF hashes of the joint names
+ *   translations  - track_count * frame_count * 3 floats, [track][frame], file units
+ *   rotations     - track_count * frame_count * 4 floats (x, y, z, w), need not be normalized
+ *   scales        - track_count * frame_count * 3 floats
+ *
+ * Quaternions are stored as 48-bit smallest-three values and deduplicated on
+ * the packed bits; translations and scales share one vector palette.
+ *
+ * Returns:
+ *   0 on success, negative on error:
+ *   -1: Failed to write the file
+ *   -4: Memory allocation failed
+ *   -5: Invalid arguments (NULL buffers, non-finite keys, bad fps)
+ *   -7: More than 65536 distinct vectors or quaternions
+ */
+DLL_EXPORT int write_anm(const char* anm_path, uint32_t track_count, uint32_t frame_count, float fps,
+                         const uint32_t* joint_hashes, const float* translations,
+                         const float* rotations, const float* scales) {
+    if (!anm_path || frame_count == 0 || !(fps > 0.0f) || !std::isfinite(fps)) return -5;
+    if ((uint64_t)track_count * frame_count > ANM_MAX_KEYS) return -5;
+    if (track_count && (!joint_hashes || !translations || !rotations || !scales)) return -5;
+
+    const size_t key_count = (size_t)track_count * frame_count;
+    for (size_t i = 0; i < key_count * 3; i++) {
+        if (!std::isfinite(translations[i]) || !std::isfinite(scales[i])) return -5;
+    }
+    for (size_t i = 0; i < key_count * 4; i++) {
+        if (!std::isfinite(rotations[i])) return -5;
+    }
+
+    try {
+        // Compression is the expensive part and independent per key
+        std::vector<uint64_t> packed(key_count);
+        global_thread_pool().parallel_for(track_count, 0, [&](size_t t) {
+            for (size_t k = t * frame_count; k < (t + 1) * frame_count; k++) {
+                packed[k] = compress_quat(rotations + k * 4);
+            }
+        });
+
+        // Palettes and [frame][track] entries of (translation, scale, rotation)
+        AnmVectorPalette vectors;
+        std::vector<uint64_t> quats;
+        std::unordered_map<uint64_t, uint32_t> quat_index;
+        std::vector<uint16_t> entries(key_count * 3);
+
+        for (uint32_t f = 0; f < frame_count; f++) {
+            for (uint32_t t = 0; t < track_count; t++) {
+                size_t k = (size_t)t * frame_count + f;
+                int32_t ti = vectors.add(translations + k * 3);
+                int32_t si = vectors.add(scales + k * 3);
+                if (ti < 0 || si < 0) return -7;
+
+                auto it = quat_index.find(packed[k]);
+                uint32_t ri;
+                if (it != quat_index.end()) {
+                    ri = it->second;
+                } else {
+                    if (quats.size() >= ANM_MAX_PALETTE) return -7;
+                    ri = (uint32_t)quats.size();
+                    quat_index.emplace(packed[k], ri);
+                    quats.push_back(packed[k]);
+                }
+
+                uint16_t* entry = entries.data() + ((size_t)f * track_count + t) * 3;
+                entry[0] = (uint16_t)ti;
+                entry[1] = (uint16_t)si;
+                entry[2] = (uint16_t)ri;
+            }
+        }
+
+        // Offsets are relative to byte 12; sections follow the header in the
+        // order the readers derive palette sizes from
+        const std::vector<float>& vector_values = vectors.values();
+        const uint32_t vecs_offset = ANM_V5_HEADER_SIZE - 12;
+        const uint32_t quats_offset = vecs_offset + (uint32_t)vector_values.size() * 4;
+        const uint32_t hashes_offset = quats_offset + (uint32_t)quats.size() * 6;
+        const uint32_t frames_offset = hashes_offset + track_count * 4;
+        const uint32_t file_size = frames_offset + 12 + (uint32_t)entries.size() * 2;
+
+        ByteWriter w;
+        w.data.reserve(file_size);
+        w.write("r3d2anmd", 8);
+        w.u32(5);
+        w.u32(file_size);
+        w.u32(ANM_FORMAT_TOKEN);
+        w.u32(0);                   // Version
+        w.u32(0);                   // Flags
+        w.u32(track_count);
+        w.u32(frame_count);
+        w.f32(1.0f / fps);
+        w.i32((int32_t)hashes_offset);
+        w.i32(0);                   // Asset name offset
+        w.i32(0);                   // Time offset
+        w.i32((int32_t)vecs_offset);
+        w.i32((int32_t)quats_offset);
+        w.i32((int32_t)frames_offset);
+        w.zeros(ANM_V5_HEADER_SIZE - w.pos());
+
+        w.write(vector_values.data(), vector_values.size() * 4);
+        for (uint64_t bits : quats) w.write(&bits, 6);
+        w.write(joint_hashes, (size_t)track_count * 4);
+        w.write(entries.data(), entries.size() * 2);
+
+        return write_file(anm_path, w.data.data(), w.data.size()) ? 0 : -1;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
 }
 
 // ============================================================================
@@ -271,26 +1816,6 @@ static uint32_t get_hash_value(const ritobin::Value& val) {
     return 0;
 }
 
-// Find field by hash in an Embed
-static const ritobin::Field* find_field(const ritobin::Embed& embed, uint32_t hash) {
-    for (const auto& field : embed.items) {
-        if (field.key.hash() == hash) {
-            return &field;
-        }
-    }
-    return nullptr;
-}
-
-// Find field by hash in a Pointer
-static const ritobin::Field* find_field(const ritobin::Pointer& ptr, uint32_t hash) {
-    for (const auto& field : ptr.items) {
-        if (field.key.hash() == hash) {
-            return &field;
-        }
-    }
-    return nullptr;
-}
-
 // Parse BIN and extract texture mappings
 // Returns: "BASE=texture_path\nMaterialName=texture_path\n..."
 static std::string extract_textures(const ritobin::Bin& bin) {
@@ -313,93 +1838,87 @@ static std::string extract_textures(const ritobin::Bin& bin) {
         }
     }
 
+    // Materials are often linked from several overrides, so their index is kept
+    std::unordered_map<const ritobin::Embed*, FieldIndex> material_fields;
+
     // Traverse entries looking for skinMeshProperties
     for (const auto& pair : entries_map_val->items) {
         const auto* entry = std::get_if<ritobin::Embed>(&pair.value);
         if (!entry) continue;
 
-        for (const auto& field : entry->items) {
-            if (field.key.hash() != HASH_SKIN_MESH_PROPERTIES) continue;
+        const auto* smp_field = FieldIndex::scan(entry->items, HASH_SKIN_MESH_PROPERTIES);
+        if (!smp_field) continue;
 
-            // skinMeshProperties is an Embed
-            const auto* skin_mesh = std::get_if<ritobin::Embed>(&field.value);
-            if (!skin_mesh) continue;
+        // skinMeshProperties is an Embed
+        const auto* skin_mesh = std::get_if<ritobin::Embed>(&smp_field->value);
+        if (!skin_mesh) continue;
+        FieldIndex skin_fields(skin_mesh->items);
 
-            // Look for texture (default) and materialOverride
-            for (const auto& sub_field : skin_mesh->items) {
-                // Default texture
-                if (sub_field.key.hash() == HASH_TEXTURE) {
-                    std::string tex = get_string_value(sub_field.value);
-                    if (!tex.empty()) {
-                        results["BASE"] = tex;
-                    }
-                }
+        // Default texture
+        if (const auto* tex_field = skin_fields.find(HASH_TEXTURE)) {
+            std::string tex = get_string_value(tex_field->value);
+            if (!tex.empty()) {
+                results["BASE"] = tex;
+            }
+        }
 
-                // Material overrides (list of embeds)
-                if (sub_field.key.hash() == HASH_MATERIAL_OVERRIDE) {
-                    const auto* override_list = std::get_if<ritobin::List>(&sub_field.value);
-                    if (!override_list) continue;
+        // Material overrides (list of embeds)
+        const auto* mo_field = skin_fields.find(HASH_MATERIAL_OVERRIDE);
+        if (!mo_field) continue;
+        const auto* override_list = std::get_if<ritobin::List>(&mo_field->value);
+        if (!override_list) continue;
 
-                    for (const auto& override_elem : override_list->items) {
-                        const auto* override_embed = std::get_if<ritobin::Embed>(&override_elem.value);
-                        if (!override_embed) continue;
+        for (const auto& override_elem : override_list->items) {
+            const auto* override_embed = std::get_if<ritobin::Embed>(&override_elem.value);
+            if (!override_embed) continue;
+            FieldIndex override_fields(override_embed->items);
 
-                        std::string mat_name;
-                        std::string tex_path;
-                        uint32_t linked_mat_hash = 0;
+            std::string mat_name;
+            std::string tex_path;
+            uint32_t linked_mat_hash = 0;
 
-                        for (const auto& prop : override_embed->items) {
-                            if (prop.key.hash() == HASH_NAME) {
-                                mat_name = get_string_value(prop.value);
-                            }
-                            if (prop.key.hash() == HASH_TEXTURE) {
-                                tex_path = get_string_value(prop.value);
-                            }
-                            if (prop.key.hash() == HASH_MATERIAL_LINK) {
-                                linked_mat_hash = get_hash_value(prop.value);
-                            }
-                        }
+            if (const auto* name_field = override_fields.find(HASH_NAME)) {
+                mat_name = get_string_value(name_field->value);
+            }
+            if (const auto* tex_field = override_fields.find(HASH_TEXTURE)) {
+                tex_path = get_string_value(tex_field->value);
+            }
+            if (const auto* link_field = override_fields.find(HASH_MATERIAL_LINK)) {
+                linked_mat_hash = get_hash_value(link_field->value);
+            }
 
-                        // If no direct texture, try to follow material link
-                        if (tex_path.empty() && linked_mat_hash != 0) {
-                            auto mat_it = entries_map.find(linked_mat_hash);
-                            if (mat_it != entries_map.end()) {
-                                const auto* mat_entry = mat_it->second;
-
-                                // Look for Properties list
-                                const auto* props_field = find_field(*mat_entry, HASH_PROPERTIES_LIST);
-                                if (props_field) {
-                                    const auto* props_list = std::get_if<ritobin::List>(&props_field->value);
-                                    if (props_list) {
-                                        for (const auto& prop_elem : props_list->items) {
-                                            const auto* prop_embed = std::get_if<ritobin::Embed>(&prop_elem.value);
-                                            if (!prop_embed) continue;
-
-                                            std::string p_name, p_val;
-                                            for (const auto& pf : prop_embed->items) {
-                                                if (pf.key.hash() == HASH_PROP_NAME) {
-                                                    p_name = get_string_value(pf.value);
-                                                }
-                                                if (pf.key.hash() == HASH_PROP_VALUE) {
-                                                    p_val = get_string_value(pf.value);
-                                                }
-                                            }
-                                            if (p_name == "Diffuse_Texture" && !p_val.empty()) {
-                                                tex_path = p_val;
-                                                break;
-                                            }
-                                        }
-                                    }
-                                }
+            // If no direct texture, try to follow material link
+            if (tex_path.empty() && linked_mat_hash != 0) {
+                auto mat_it = entries_map.find(linked_mat_hash);
+                if (mat_it != entries_map.end()) {
+                    const auto* mat_entry = mat_it->second;
+                    const FieldIndex& mat_fields = material_fields.try_emplace(mat_entry, mat_entry->items).first->second;
+
+                    // Look for Properties list
+                    const auto* props_field = mat_fields.find(HASH_PROPERTIES_LIST);
+                    const auto* props_list = props_field ? std::get_if<ritobin::List>(&props_field->value) : nullptr;
+                    if (props_list) {
+                        for (const auto& prop_elem : props_list->items) {
+                            const auto* prop_embed = std::get_if<ritobin::Embed>(&prop_elem.value);
+                            if (!prop_embed) continue;
+
+                            // Sampler embeds hold a handful of fields, scanning is cheaper
+                            const auto* pn = FieldIndex::scan(prop_embed->items, HASH_PROP_NAME);
+                            if (!pn || get_string_value(pn->value) != "Diffuse_Texture") continue;
+                            const auto* pv = FieldIndex::scan(prop_embed->items, HASH_PROP_VALUE);
+                            std::string p_val = pv ? get_string_value(pv->value) : std::string();
+                            if (!p_val.empty()) {
+                                tex_path = p_val;
+                                break;
                             }
                         }
-
-                        if (!mat_name.empty() && !tex_path.empty()) {
-                            results[mat_name] = tex_path;
-                        }
                     }
                 }
             }
+
+            if (!mat_name.empty() && !tex_path.empty()) {
+                results[mat_name] = tex_path;
+            }
         }
     }
 
@@ -428,34 +1947,33 @@ static std::string extract_textures(const ritobin::Bin& bin) {
  * Output format: "MaterialName=texture_path\n..." (newline separated key=value pairs)
  */
 DLL_EXPORT int parse_bin_textures(const char* bin_path, uint8_t** out_data, uint32_t* out_size) {
-    // Read file
-    std::ifstream file(bin_path, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) return -1;
-
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<char> buffer(size);
-    if (!file.read(buffer.data(), size)) {
-        return -1;
-    }
-    file.close();
+    MappedFile mapped;
+    if (!open_mapped(mapped, bin_path)) return -1;
 
     // Parse BIN
     ritobin::Bin bin;
-    auto compat = ritobin::io::BinCompat::get("default");
-    std::string error = ritobin::io::read_binary(bin, buffer, compat);
-    if (!error.empty()) {
-        return -2;
+    {
+        StatsTimer timer(NATIVE_STAGE_PARSE);
+        auto compat = ritobin::io::BinCompat::get("default");
+        std::span<const char> data((const char*)mapped.data(), mapped.size());
+        std::string error = ritobin::io::read_binary(bin, data, compat);
+        if (!error.empty()) {
+            return -2;
+        }
     }
 
     // Extract textures
-    std::string result = extract_textures(bin);
+    std::string result;
+    {
+        StatsTimer timer(NATIVE_STAGE_LINK_RESOLVE);
+        result = extract_textures(bin);
+    }
 
     // Allocate output
     uint32_t result_size = (uint32_t)result.size();
     uint8_t* result_data = (uint8_t*)malloc(result_size + 1);
     if (!result_data) return -4;
+    stats_add(NATIVE_COUNTER_ALLOC_BYTES, result_size + 1);
 
     memcpy(result_data, result.c_str(), result_size + 1);
 
@@ -464,11 +1982,74 @@ DLL_EXPORT int parse_bin_textures(const char* bin_path, uint8_t** out_data, uint
     return 0;
 }
 
+// ============================================================================
+// Instrumentation
+// ============================================================================
+
+/*
+ * Read the per-stage timers and counters of this DLL
+ *
+ * Parameters:
+ *   out_stats - Receives the totals over all threads since the last
+ *               native_stats_reset (NATIVE_STATS in native_stats.h)
+ *
+ * Stages are file_read, parse, link_resolve, mip_reorder and decode; a
+ * stage's time is summed over threads, so parallel batches can report more
+ * than the wall time they took.
+ *
+ * Returns:
+ *   0 on success, -5 if out_stats is NULL
+ */
+DLL_EXPORT int native_stats_get(NATIVE_STATS* out_stats) {
+    if (!out_stats) return -5;
+    stats_snapshot(*out_stats);
+    return 0;
+}
+
+/*
+ * Zero every timer and counter
+ */
+DLL_EXPORT void native_stats_reset() {
+    stats_reset();
+}
+
+/*
+ * Start recording a Chrome trace of the timed stages
+ *
+ * Parameters:
+ *   events_per_thread - Events kept per thread, later ones are dropped and
+ *                       counted; 0 stops tracing
+ *
+ * Events of an earlier trace that wasn't dumped are discarded.
+ */
+DLL_EXPORT void native_trace_start(uint32_t events_per_thread) {
+    stats_trace_start(events_per_thread);
+}
+
+/*
+ * Stop tracing and write the recorded events as Chrome trace JSON
+ *
+ * Parameters:
+ *   json_path - Destination .json path (UTF-8), opens in chrome://tracing
+ *               or Perfetto
+ *
+ * Call when no other native work is running.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be written, -5 on invalid arguments
+ */
+DLL_EXPORT int native_trace_dump(const char* json_path) {
+    if (!json_path) return -5;
+    return stats_trace_dump(json_path, "lol_native") ? 0 : -1;
+}
+
 DLL_EXPORT const char* get_version() {
-    return "lol_native 1.0";
+    return "lol_native 1.13";
 }
 
+#ifdef _WIN32
 BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpReserved) {
     (void)hinstDLL; (void)lpReserved;
     return TRUE;
 }
+#endif
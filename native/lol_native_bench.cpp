@@ -0,0 +1,489 @@
+/*
+ * lol_native_bench - Throughput of the native DLLs over a corpus of game files
+ *
+ * Usage:
+ *   lol_native_bench <corpus_dir> [options]
+ *     --dll-dir DIR        Directory of the DLLs (default: the executable's)
+ *     --threads N          Workers of the parallel modes (default: one per core)
+ *     --iterations N       Timed passes per mode (default 3), after one warm-up pass
+ *     --only a,b,...       Benchmarks to run: tex, tex_legacy, bin, bin_lol_native,
+ *                          skn, scb, sco, anm (default: all with files in the corpus)
+ *     --stats              Print the native stage timers of each benchmark
+ *     --csv FILE           Write the results as CSV
+ *     --baseline FILE      Compare MB/s with the CSV of an earlier run
+ *     --max-regression P   With --baseline, exit with 2 when a result is more
+ *                          than P percent slower (default 10)
+ *
+ * Every benchmark runs the files of its extension single-threaded, spread
+ * over --threads threads calling the same export, and through the DLL's own
+ * batch export where it has one. The warm-up pass fills the OS file cache,
+ * so the numbers are parse throughput rather than disk speed. MB/s and
+ * files/s come from the median pass; latencies are per call over all passes
+ * (not available for batch exports).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <dlfcn.h>
+#endif
+
+#include "native_stats.h"
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// DLL Loading
+// ============================================================================
+
+#if defined(_WIN32)
+    #define LIB_SUFFIX ".dll"
+#elif defined(__APPLE__)
+    #define LIB_SUFFIX ".dylib"
+#else
+    #define LIB_SUFFIX ".so"
+#endif
+
+class Library {
+public:
+    bool open(const fs::path& path) {
+#ifdef _WIN32
+        handle_ = (void*)LoadLibraryW(path.c_str());
+#else
+        handle_ = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+        return handle_ != nullptr;
+    }
+
+    template <typename Fn>
+    Fn symbol(const char* name) const {
+        if (!handle_) return nullptr;
+#ifdef _WIN32
+        return (Fn)(void*)GetProcAddress((HMODULE)handle_, name);
+#else
+        return (Fn)dlsym(handle_, name);
+#endif
+    }
+
+    bool loaded() const { return handle_ != nullptr; }
+
+private:
+    void* handle_ = nullptr;        // Kept loaded until exit
+};
+
+static fs::path executable_dir(const char* argv0) {
+#ifdef _WIN32
+    wchar_t buffer[32768];
+    DWORD len = GetModuleFileNameW(nullptr, buffer, (DWORD)(sizeof(buffer) / sizeof(buffer[0])));
+    if (len > 0 && len < sizeof(buffer) / sizeof(buffer[0])) return fs::path(buffer).parent_path();
+#else
+    std::error_code ec;
+    fs::path self = fs::read_symlink("/proc/self/exe", ec);
+    if (!ec) return self.parent_path();
+#endif
+    return fs::absolute(argv0).parent_path();
+}
+
+// UTF-8 path for the DLL exports
+static std::string utf8_path(const fs::path& path) {
+    std::u8string s = path.u8string();
+    return std::string((const char*)s.data(), s.size());
+}
+
+typedef int (*FileToBytes)(const char*, uint8_t**, uint32_t*);
+typedef int (*FileToBlock)(const char*, void**);
+typedef int (*BatchToBytes)(const char* const*, uint32_t, uint8_t**, uint32_t*, int32_t*, uint32_t);
+typedef void (*FreeBytes)(uint8_t*);
+typedef void (*SetCapacity)(uint32_t);
+typedef int (*StatsGet)(NATIVE_STATS*);
+typedef void (*StatsReset)();
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+// One export over the files of one extension. Exactly one of to_bytes /
+// to_block is set; batch is optional.
+struct Benchmark {
+    const char* name;
+    const char* extension;
+    const Library* library;
+    FileToBytes to_bytes = nullptr;
+    FileToBlock to_block = nullptr;
+    BatchToBytes batch = nullptr;
+    FreeBytes free_result = nullptr;
+
+    bool available() const { return (to_bytes || to_block) && free_result; }
+
+    // Status code of one call; the result is freed right away
+    int run(const char* path) const {
+        if (to_bytes) {
+            uint8_t* data = nullptr;
+            uint32_t size = 0;
+            int rc = to_bytes(path, &data, &size);
+            if (rc == 0) free_result(data);
+            return rc;
+        }
+        void* block = nullptr;
+        int rc = to_block(path, &block);
+        if (rc == 0) free_result((uint8_t*)block);
+        return rc;
+    }
+};
+
+struct CorpusFile {
+    std::string path;
+    uint64_t size;
+};
+
+struct Result {
+    std::string benchmark;
+    std::string mode;
+    size_t files = 0;
+    uint64_t bytes = 0;
+    size_t failures = 0;
+    double wall_ms = 0;             // Median pass
+    std::vector<double> latencies_ms;
+};
+
+static double now_ms() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Nearest-rank percentile of sorted values, NAN when empty
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return NAN;
+    size_t rank = (size_t)std::ceil(p * sorted.size());
+    return sorted[rank ? rank - 1 : 0];
+}
+
+// One pass of every file, on `threads` threads, recording per-call latencies
+static double run_pass(const Benchmark& bench, const std::vector<CorpusFile>& files, unsigned threads,
+                       std::vector<double>* latencies, size_t& failures) {
+    std::vector<double> times(files.size());
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> failed{0};
+    auto worker = [&] {
+        size_t i;
+        while ((i = next.fetch_add(1)) < files.size()) {
+            double start = now_ms();
+            if (bench.run(files[i].path.c_str()) != 0) failed.fetch_add(1);
+            times[i] = now_ms() - start;
+        }
+    };
+
+    double start = now_ms();
+    if (threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++) pool.emplace_back(worker);
+        for (auto& t : pool) t.join();
+    }
+    double wall = now_ms() - start;
+
+    if (latencies) latencies->insert(latencies->end(), times.begin(), times.end());
+    failures = failed.load();
+    return wall;
+}
+
+// One pass through the batch export
+static double run_batch_pass(const Benchmark& bench, const std::vector<CorpusFile>& files, unsigned threads,
+                             size_t& failures) {
+    std::vector<const char*> paths(files.size());
+    for (size_t i = 0; i < files.size(); i++) paths[i] = files[i].path.c_str();
+    std::vector<uint8_t*> data(files.size());
+    std::vector<uint32_t> sizes(files.size());
+    std::vector<int32_t> results(files.size());
+
+    double start = now_ms();
+    int failed = bench.batch(paths.data(), (uint32_t)paths.size(), data.data(), sizes.data(), results.data(), threads);
+    double wall = now_ms() - start;
+
+    for (uint8_t* d : data) bench.free_result(d);
+    failures = failed < 0 ? files.size() : (size_t)failed;
+    return wall;
+}
+
+static double mb_per_s(const Result& r) {
+    return r.bytes / (1024.0 * 1024.0) / (r.wall_ms / 1000.0);
+}
+
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static void print_stats(const Library& library) {
+    StatsGet get = library.symbol<StatsGet>("native_stats_get");
+    NATIVE_STATS stats;
+    if (!get || get(&stats) != 0 || stats.stage_count != NATIVE_STAGE_COUNT) return;
+    for (uint32_t s = 0; s < NATIVE_STAGE_COUNT; s++) {
+        if (!stats.calls[s]) continue;
+        printf("      %-13s %10llu calls %12.2f ms\n", native_stage_name(s),
+               (unsigned long long)stats.calls[s], stats.ns[s] / 1e6);
+    }
+}
+
+static void reset_stats(const Library& library) {
+    if (StatsReset reset = library.symbol<StatsReset>("native_stats_reset")) reset();
+}
+
+static std::vector<Result> run_benchmark(const Benchmark& bench, const std::vector<CorpusFile>& files,
+                                         unsigned threads, unsigned iterations, bool show_stats) {
+    uint64_t bytes = 0;
+    for (const auto& f : files) bytes += f.size;
+
+    size_t warmup_failures;
+    run_pass(bench, files, 1, nullptr, warmup_failures);
+
+    struct Mode { const char* name; unsigned threads; bool batch; };
+    std::vector<Mode> modes = { { "single", 1, false }, { "threads", threads, false } };
+    if (bench.batch) modes.push_back({ "batch", threads, true });
+
+    std::vector<Result> results;
+    for (const Mode& mode : modes) {
+        Result r;
+        r.benchmark = bench.name;
+        r.mode = mode.name;
+        r.files = files.size();
+        r.bytes = bytes;
+
+        reset_stats(*bench.library);
+        std::vector<double> walls;
+        for (unsigned it = 0; it < iterations; it++) {
+            size_t failures;
+            walls.push_back(mode.batch ? run_batch_pass(bench, files, mode.threads, failures)
+                                       : run_pass(bench, files, mode.threads, &r.latencies_ms, failures));
+            r.failures = std::max(r.failures, failures);
+        }
+        r.wall_ms = median(walls);
+        std::sort(r.latencies_ms.begin(), r.latencies_ms.end());
+
+        printf("  %-16s %-8s %8.1f MB/s %9.1f files/s", r.benchmark.c_str(), r.mode.c_str(), mb_per_s(r),
+               r.files / (r.wall_ms / 1000.0));
+        if (!r.latencies_ms.empty()) {
+            printf("   p50 %8.3f ms   p99 %8.3f ms", percentile(r.latencies_ms, 0.50), percentile(r.latencies_ms, 0.99));
+        }
+        if (r.failures) printf("   (%zu failed)", r.failures);
+        printf("\n");
+        if (show_stats) print_stats(*bench.library);
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+// ============================================================================
+// CSV and Baseline
+// ============================================================================
+
+static const char* CSV_HEADER = "benchmark,mode,files,bytes,failures,wall_ms,mb_per_s,files_per_s,p50_ms,p99_ms";
+
+static bool write_csv(const char* path, const std::vector<Result>& results) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "%s\n", CSV_HEADER);
+    for (const Result& r : results) {
+        fprintf(f, "%s,%s,%zu,%llu,%zu,%.3f,%.3f,%.3f,%.4f,%.4f\n", r.benchmark.c_str(), r.mode.c_str(), r.files,
+                (unsigned long long)r.bytes, r.failures, r.wall_ms, mb_per_s(r), r.files / (r.wall_ms / 1000.0),
+                percentile(r.latencies_ms, 0.50), percentile(r.latencies_ms, 0.99));
+    }
+    return fclose(f) == 0;
+}
+
+// "benchmark/mode" -> MB/s of an earlier run
+static std::map<std::string, double> read_baseline(const char* path) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);         // Header
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream row(line);
+        std::string field;
+        while (std::getline(row, field, ',')) fields.push_back(field);
+        if (fields.size() >= 7) baseline[fields[0] + "/" + fields[1]] = atof(fields[6].c_str());
+    }
+    return baseline;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static void usage() {
+    fprintf(stderr,
+            "usage: lol_native_bench <corpus_dir> [--dll-dir DIR] [--threads N] [--iterations N]\n"
+            "                        [--only a,b,...] [--stats] [--csv FILE] [--baseline FILE]\n"
+            "                        [--max-regression PERCENT]\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    fs::path corpus = argv[1];
+    fs::path dll_dir = executable_dir(argv[0]);
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned iterations = 3;
+    std::vector<std::string> only;
+    bool show_stats = false;
+    const char* csv_path = nullptr;
+    const char* baseline_path = nullptr;
+    double max_regression = 10.0;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--dll-dir" && has_value) {
+            dll_dir = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--iterations" && has_value) {
+            iterations = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--only" && has_value) {
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) only.push_back(name);
+        } else if (arg == "--stats") {
+            show_stats = true;
+        } else if (arg == "--csv" && has_value) {
+            csv_path = argv[++i];
+        } else if (arg == "--baseline" && has_value) {
+            baseline_path = argv[++i];
+        } else if (arg == "--max-regression" && has_value) {
+            max_regression = atof(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    Library lol_native, bin_parser, tex_converter;
+    lol_native.open(dll_dir / ("lol_native" LIB_SUFFIX));
+    bin_parser.open(dll_dir / ("bin_parser" LIB_SUFFIX));
+    tex_converter.open(dll_dir / ("tex_converter" LIB_SUFFIX));
+    if (!lol_native.loaded() && !bin_parser.loaded() && !tex_converter.loaded()) {
+        fprintf(stderr, "No native libraries found in %s\n", utf8_path(dll_dir).c_str());
+        return 1;
+    }
+
+    // The BIN cache would turn every pass after the first into lookups
+    if (SetCapacity set_capacity = bin_parser.symbol<SetCapacity>("bin_cache_set_capacity")) set_capacity(0);
+
+    std::vector<Benchmark> benchmarks;
+    {
+        Benchmark b{ "tex", ".tex", &lol_native };
+        b.to_bytes = lol_native.symbol<FileToBytes>("tex_to_dds_bytes");
+        b.batch = lol_native.symbol<BatchToBytes>("tex_to_dds_batch");
+        b.free_result = lol_native.symbol<FreeBytes>("free_bytes");
+        benchmarks.push_back(b);
+    }
+    {
+        Benchmark b{ "tex_legacy", ".tex", &tex_converter };
+        b.to_bytes = tex_converter.symbol<FileToBytes>("tex_to_dds_bytes");
+        b.batch = tex_converter.symbol<BatchToBytes>("tex_to_dds_batch");
+        b.free_result = tex_converter.symbol<FreeBytes>("free_dds_bytes");
+        benchmarks.push_back(b);
+    }
+    {
+        Benchmark b{ "bin", ".bin", &bin_parser };
+        b.to_bytes = bin_parser.symbol<FileToBytes>("parse_bin_textures");
+        b.free_result = bin_parser.symbol<FreeBytes>("free_bin_result");
+        benchmarks.push_back(b);
+    }
+    {
+        Benchmark b{ "bin_lol_native", ".bin", &lol_native };
+        b.to_bytes = lol_native.symbol<FileToBytes>("parse_bin_textures");
+        b.free_result = lol_native.symbol<FreeBytes>("free_bytes");
+        benchmarks.push_back(b);
+    }
+    static const char* const MESH_FORMATS[][3] = {
+        { "skn", ".skn", "parse_skn" }, { "scb", ".scb", "parse_scb" },
+        { "sco", ".sco", "parse_sco" }, { "anm", ".anm", "parse_anm" },
+    };
+    for (const auto& format : MESH_FORMATS) {
+        Benchmark b{ format[0], format[1], &lol_native };
+        b.to_block = lol_native.symbol<FileToBlock>(format[2]);
+        b.free_result = lol_native.symbol<FreeBytes>("free_bytes");
+        benchmarks.push_back(b);
+    }
+
+    // Corpus files by lowercase extension
+    std::map<std::string, std::vector<CorpusFile>> corpus_files;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(corpus, fs::directory_options::skip_permission_denied, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        std::string ext = utf8_path(it->path().extension());
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)tolower(c); });
+        corpus_files[ext].push_back({ utf8_path(it->path()), (uint64_t)it->file_size(ec) });
+    }
+    if (ec) {
+        fprintf(stderr, "Can't read corpus %s: %s\n", utf8_path(corpus).c_str(), ec.message().c_str());
+        return 1;
+    }
+
+    printf("lol_native_bench: %u threads, %u iterations, libraries from %s\n", threads, iterations,
+           utf8_path(dll_dir).c_str());
+    std::vector<Result> results;
+    for (const Benchmark& bench : benchmarks) {
+        if (!only.empty() && std::find(only.begin(), only.end(), bench.name) == only.end()) continue;
+        const auto& files = corpus_files[bench.extension];
+        if (files.empty()) continue;
+        if (!bench.available()) {
+            printf("  %-16s not available in the loaded libraries\n", bench.name);
+            continue;
+        }
+        uint64_t bytes = 0;
+        for (const auto& f : files) bytes += f.size;
+        printf("%s: %zu files, %.1f MB\n", bench.name, files.size(), bytes / (1024.0 * 1024.0));
+        std::vector<Result> bench_results = run_benchmark(bench, files, threads, iterations, show_stats);
+        results.insert(results.end(), bench_results.begin(), bench_results.end());
+    }
+
+    if (csv_path && !write_csv(csv_path, results)) {
+        fprintf(stderr, "Can't write %s\n", csv_path);
+        return 1;
+    }
+
+    if (baseline_path) {
+        std::map<std::string, double> baseline = read_baseline(baseline_path);
+        int regressions = 0;
+        for (const Result& r : results) {
+            auto it = baseline.find(r.benchmark + "/" + r.mode);
+            if (it == baseline.end() || it->second <= 0) continue;
+            double change = (mb_per_s(r) / it->second - 1.0) * 100.0;
+            if (change < -max_regression) {
+                printf("REGRESSION %s/%s: %.1f MB/s vs %.1f MB/s (%.1f%%)\n", r.benchmark.c_str(), r.mode.c_str(),
+                       mb_per_s(r), it->second, change);
+                regressions++;
+            }
+        }
+        if (regressions) return 2;
+        printf("No result more than %.1f%% slower than %s\n", max_regression, baseline_path);
+    }
+    return 0;
+}
@@ -0,0 +1,1132 @@
+/*
+ * Mesh I/O - SKN, SCB and SCO parsing, SKN/SKL/SCB/SCO writing for the
+ * Blender addon
+ * Compiled into lol_native.dll alongside lol_native.cpp
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_reader.h"
+#include "binary_writer.h"
+#include "file_map.h"
+#include "native_stats.h"
+#include "platform.h"
+#include "thread_pool.h"
+#include "xxhash64.h"
+
+// ============================================================================
+// SKN Parsing
+// ============================================================================
+
+#define SKN_MAGIC 0x00112233
+
+#define SKN_VERTEX_BASIC    0   // position, influences, weights, normal, uv (52 bytes)
+#define SKN_VERTEX_COLOR    1   // + 4 byte color
+#define SKN_VERTEX_TANGENT  2   // + color + 16 byte tangent
+
+#pragma pack(push, 1)
+typedef struct {
+    char name[64];
+    uint32_t vertex_start;
+    uint32_t vertex_count;
+    uint32_t index_start;
+    uint32_t index_count;
+} SKN_SUBMESH;
+#pragma pack(pop)
+
+// Result of parse_skn: one malloc'd block holding this header followed by
+// every array it points to. Arrays not present in the file are NULL.
+typedef struct {
+    uint32_t major;
+    uint32_t minor;
+    uint32_t vertex_type;
+    uint32_t vertex_count;
+    uint32_t index_count;       // After dropping degenerate faces
+    uint32_t submesh_count;
+    float* positions;           // vertex_count * 3
+    float* normals;             // vertex_count * 3
+    float* uvs;                 // vertex_count * 2
+    uint8_t* bone_indices;      // vertex_count * 4, indices into the SKL influence list
+    float* weights;             // vertex_count * 4
+    uint8_t* colors;            // vertex_count * 4 as stored (BGRA), vertex_type >= 1
+    float* tangents;            // vertex_count * 4, vertex_type == 2
+    uint32_t* indices;          // index_count
+    SKN_SUBMESH* submeshes;     // submesh_count, index ranges refer to indices
+} SKN_MESH;
+
+static int skn_parse(const uint8_t* src, size_t src_len, SKN_MESH** out_mesh) {
+    StatsTimer timer(NATIVE_STAGE_PARSE);
+    ByteReader r = { src, src_len, 0 };
+
+    uint32_t magic;
+    uint16_t major, minor;
+    if (!r.u32(magic) || magic != SKN_MAGIC) return -2;
+    if (!r.u16(major) || !r.u16(minor)) return -2;
+
+    std::vector<SKN_SUBMESH> submeshes;
+    uint32_t index_count = 0, vertex_count = 0, vertex_size = 0, vertex_type = SKN_VERTEX_BASIC;
+
+    if (major == 0) {
+        if (!r.u32(index_count) || !r.u32(vertex_count)) return -2;
+        SKN_SUBMESH base = {};
+        strcpy(base.name, "Base");
+        base.vertex_count = vertex_count;
+        base.index_count = index_count;
+        submeshes.push_back(base);
+    } else {
+        uint32_t submesh_count;
+        if (!r.u32(submesh_count)) return -2;
+        if (!r.has((size_t)submesh_count * sizeof(SKN_SUBMESH))) return -2;
+        submeshes.resize(submesh_count);
+        for (auto& submesh : submeshes) {
+            r.read(&submesh, sizeof(SKN_SUBMESH));
+            submesh.name[63] = '\0';
+        }
+
+        if (major >= 4 && !r.skip(4)) return -2;   // flags
+        if (!r.u32(index_count) || !r.u32(vertex_count)) return -2;
+
+        if (major >= 4) {
+            if (!r.u32(vertex_size) || !r.u32(vertex_type)) return -2;
+            if (!r.skip(40)) return -2;             // AABB and bounding sphere
+        }
+    }
+
+    if (vertex_type > SKN_VERTEX_TANGENT) return -3;
+
+    uint32_t min_vertex_size = vertex_type == SKN_VERTEX_BASIC ? 52 : vertex_type == SKN_VERTEX_COLOR ? 56 : 72;
+    if (vertex_size < min_vertex_size) vertex_size = min_vertex_size;
+
+    const uint8_t* index_data = src + r.pos;
+    if (!r.skip((size_t)index_count * 2)) return -2;
+    const uint8_t* vertex_data = src + r.pos;
+    if (!r.has((size_t)vertex_count * vertex_size)) return -2;
+
+    const uint32_t face_count = index_count / 3;
+    const bool has_color = vertex_type >= SKN_VERTEX_COLOR;
+    const bool has_tangent = vertex_type == SKN_VERTEX_TANGENT;
+
+    BlockLayout layout;
+    size_t off_header = layout.add(sizeof(SKN_MESH));
+    size_t off_positions = layout.add((size_t)vertex_count * 3 * sizeof(float));
+    size_t off_normals = layout.add((size_t)vertex_count * 3 * sizeof(float));
+    size_t off_uvs = layout.add((size_t)vertex_count * 2 * sizeof(float));
+    size_t off_bones = layout.add((size_t)vertex_count * 4);
+    size_t off_weights = layout.add((size_t)vertex_count * 4 * sizeof(float));
+    size_t off_colors = has_color ? layout.add((size_t)vertex_count * 4) : 0;
+    size_t off_tangents = has_tangent ? layout.add((size_t)vertex_count * 4 * sizeof(float)) : 0;
+    size_t off_indices = layout.add((size_t)face_count * 3 * sizeof(uint32_t));
+    size_t off_submeshes = layout.add(submeshes.size() * sizeof(SKN_SUBMESH));
+
+    uint8_t* block = (uint8_t*)malloc(layout.size);
+    if (!block) return -4;
+    stats_add(NATIVE_COUNTER_ALLOC_BYTES, layout.size);
+
+    SKN_MESH* mesh = (SKN_MESH*)(block + off_header);
+    memset(mesh, 0, sizeof(SKN_MESH));
+    mesh->major = major;
+    mesh->minor = minor;
+    mesh->vertex_type = vertex_type;
+    mesh->vertex_count = vertex_count;
+    mesh->submesh_count = (uint32_t)submeshes.size();
+    mesh->positions = (float*)(block + off_positions);
+    mesh->normals = (float*)(block + off_normals);
+    mesh->uvs = (float*)(block + off_uvs);
+    mesh->bone_indices = block + off_bones;
+    mesh->weights = (float*)(block + off_weights);
+    mesh->colors = has_color ? block + off_colors : nullptr;
+    mesh->tangents = has_tangent ? (float*)(block + off_tangents) : nullptr;
+    mesh->indices = (uint32_t*)(block + off_indices);
+    mesh->submeshes = (SKN_SUBMESH*)(block + off_submeshes);
+
+    // Faces that reuse a vertex are dropped (Blender rejects them); kept[f]
+    // counts the faces kept before raw face f so submesh ranges can follow
+    std::vector<uint32_t> kept(face_count + 1);
+    uint32_t* indices = mesh->indices;
+    uint32_t faces_kept = 0;
+    for (uint32_t f = 0; f < face_count; f++) {
+        kept[f] = faces_kept;
+        uint16_t face[3];
+        memcpy(face, index_data + (size_t)f * 6, 6);
+        if (face[0] >= vertex_count || face[1] >= vertex_count || face[2] >= vertex_count) {
+            free(block);
+            return -2;
+        }
+        if (face[0] == face[1] || face[1] == face[2] || face[2] == face[0]) continue;
+        indices[faces_kept * 3] = face[0];
+        indices[faces_kept * 3 + 1] = face[1];
+        indices[faces_kept * 3 + 2] = face[2];
+        faces_kept++;
+    }
+    kept[face_count] = faces_kept;
+    mesh->index_count = faces_kept * 3;
+
+    for (size_t i = 0; i < submeshes.size(); i++) {
+        SKN_SUBMESH submesh = submeshes[i];
+        uint32_t first = submesh.index_start / 3;
+        uint32_t last = (uint32_t)(((uint64_t)submesh.index_start + submesh.index_count) / 3);
+        if (first > face_count) first = face_count;
+        if (last > face_count) last = face_count;
+        submesh.index_start = kept[first] * 3;
+        submesh.index_count = (kept[last] - kept[first]) * 3;
+        mesh->submeshes[i] = submesh;
+    }
+
+    for (uint32_t v = 0; v < vertex_count; v++) {
+        const uint8_t* vtx = vertex_data + (size_t)v * vertex_size;
+        memcpy(mesh->positions + (size_t)v * 3, vtx, 12);
+        memcpy(mesh->bone_indices + (size_t)v * 4, vtx + 12, 4);
+        memcpy(mesh->weights + (size_t)v * 4, vtx + 16, 16);
+        memcpy(mesh->normals + (size_t)v * 3, vtx + 32, 12);
+        memcpy(mesh->uvs + (size_t)v * 2, vtx + 44, 8);
+        if (has_color) memcpy(mesh->colors + (size_t)v * 4, vtx + 52, 4);
+        if (has_tangent) memcpy(mesh->tangents + (size_t)v * 4, vtx + 56, 16);
+    }
+
+    *out_mesh = mesh;
+    return 0;
+}
+
+/*
+ * Parse an in-memory SKN file into structure-of-arrays buffers
+ *
+ * Parameters:
+ *   src       - SKN file contents
+ *   src_len   - Size of src in bytes
+ *   out_mesh  - Receives the parsed mesh (free with free_bytes)
+ *
+ * Degenerate faces are removed like the Python reader does, and the submesh
+ * index ranges are adjusted to the remaining indices.
+ *
+ * Returns:
+ *   0 on success, negative on error:
+ *   -2: Invalid or truncated file
+ *   -3: Unsupported vertex type
+ *   -4: Memory allocation failed
+ *   -5: Invalid arguments
+ */
+DLL_EXPORT int parse_skn_from_memory(const uint8_t* src, uint32_t src_len, SKN_MESH** out_mesh) {
+    if (!src || !out_mesh) return -5;
+    *out_mesh = nullptr;
+    return skn_parse(src, src_len, out_mesh);
+}
+
+/*
+ * Parse an SKN file into structure-of-arrays buffers
+ *
+ * Same as parse_skn_from_memory, reading the file through a mapping.
+ * Additionally returns -1 when the file can't be opened.
+ */
+DLL_EXPORT int parse_skn(const char* skn_path, SKN_MESH** out_mesh) {
+    if (!skn_path || !out_mesh) return -5;
+    *out_mesh = nullptr;
+
+    MappedFile mapped;
+    if (!open_mapped(mapped, skn_path)) return -1;
+    return skn_parse(mapped.data(), mapped.size(), out_mesh);
+}
+
+// ============================================================================
+// SKN Writing
+// ============================================================================
+
+#define SKN_EXPORT_NO_TRANSFORM 0x1  // Keep Blender axes (no X mirror and Z-up to Y-up swap)
+
+#define SKN_MAX_VERTICES  65535      // Indices are 16-bit
+#define SKN_MAX_SUBMESHES 32
+
+// One Blender mesh as foreach_get arrays. Weights are CSR rows per vertex,
+// already limited to vertex groups that map to SKL bones.
+typedef struct {
+    uint32_t vertex_count;
+    const float* positions;             // vertex_count * 3, mesh space
+    const uint32_t* weight_offsets;     // vertex_count + 1, vertex v owns entries [offsets[v], offsets[v + 1])
+    const uint16_t* weight_bones;       // SKL bone index of each entry
+    const float* weight_values;         // Weight of each entry
+    uint32_t loop_count;
+    const int32_t* loop_vertices;       // loop_count
+    const float* loop_uvs;              // loop_count * 2, Blender UV orientation
+    uint32_t polygon_count;
+    const int32_t* polygon_loop_starts; // polygon_count
+    const int32_t* polygon_loop_totals; // polygon_count
+    const int32_t* polygon_materials;   // polygon_count
+    const float* polygon_normals;       // polygon_count * 3, mesh space
+    float matrix[16];                   // Mesh to armature space, row-major
+} SKN_EXPORT_MESH;
+
+typedef struct {
+    char name[64];
+    uint32_t mesh;                      // Index into the meshes array
+    int32_t material;                   // Only polygons with this material index, -1 for all
+    uint32_t vertex_count;              // Set by write_skn
+    uint32_t index_count;               // Set by write_skn
+} SKN_EXPORT_SUBMESH;
+
+#pragma pack(push, 1)
+struct SknVertex {
+    float position[3];
+    uint8_t bones[4];
+    float weights[4];
+    float normal[3];
+    float uv[2];
+};
+#pragma pack(pop)
+
+// Identity of an output vertex: everything but the UV bit for bit, the UV
+// rounded to 1e-6 so seam duplicates only appear where the UVs really differ
+struct SknVertexKey {
+    int64_t uv[2];
+    float position[3];
+    float normal[3];
+    float weights[4];
+    uint8_t bones[4];
+    uint8_t pad[4];
+
+    bool operator==(const SknVertexKey& o) const { return memcmp(this, &o, sizeof(*this)) == 0; }
+};
+
+struct SknVertexKeyHash {
+    size_t operator()(const SknVertexKey& k) const { return (size_t)xxhash64(&k, sizeof(k)); }
+};
+
+// Per-vertex data a submesh shares between all its corners
+struct SknVertexBase {
+    float position[3];
+    float normal[3];
+    uint8_t bones[4];
+    float weights[4];
+};
+
+static void transform_point(const float* m, const float* p, float* out) {
+    for (int r = 0; r < 3; r++) out[r] = m[r * 4] * p[0] + m[r * 4 + 1] * p[1] + m[r * 4 + 2] * p[2] + m[r * 4 + 3];
+}
+
+static void transform_direction(const float* m, const float* d, float* out) {
+    for (int r = 0; r < 3; r++) out[r] = m[r * 4] * d[0] + m[r * 4 + 1] * d[1] + m[r * 4 + 2] * d[2];
+}
+
+static void normalize3(float* v) {
+    float len = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (len > 0.0f) { v[0] /= len; v[1] /= len; v[2] /= len; }
+}
+
+// Four strongest influences, normalized; unweighted vertices get all weight
+// on the first. Equal weights keep their group order.
+static void limit_influences(const SKN_EXPORT_MESH& mesh, uint32_t v, uint8_t* bones, float* weights) {
+    uint16_t top_bones[4] = { 0, 0, 0, 0 };
+    float top_weights[4] = { 0, 0, 0, 0 };
+    uint32_t count = 0;
+    for (uint32_t e = mesh.weight_offsets[v]; e < mesh.weight_offsets[v + 1]; e++) {
+        float weight = mesh.weight_values[e];
+        uint32_t slot = count < 4 ? count : 4;
+        while (slot > 0 && weight > top_weights[slot - 1]) slot--;
+        if (slot >= 4) continue;
+        for (uint32_t j = (count < 4 ? count : 3); j > slot; j--) {
+            top_bones[j] = top_bones[j - 1];
+            top_weights[j] = top_weights[j - 1];
+        }
+        top_bones[slot] = mesh.weight_bones[e];
+        top_weights[slot] = weight;
+        if (count < 4) count++;
+    }
+
+    double sum = 0.0;
+    for (uint32_t j = 0; j < 4; j++) sum += top_weights[j];
+    for (uint32_t j = 0; j < 4; j++) {
+        bones[j] = (uint8_t)top_bones[j];
+        weights[j] = sum > 0 ? (float)(top_weights[j] / sum) : (j == 0 ? 1.0f : 0.0f);
+    }
+}
+
+static bool skn_mesh_valid(const SKN_EXPORT_MESH& mesh) {
+    if (!mesh.positions || !mesh.weight_offsets || !mesh.loop_vertices || !mesh.loop_uvs ||
+        !mesh.polygon_loop_starts || !mesh.polygon_loop_totals || !mesh.polygon_materials || !mesh.polygon_normals) {
+        return false;
+    }
+    uint32_t weight_count = mesh.weight_offsets[mesh.vertex_count];
+    if (weight_count && (!mesh.weight_bones || !mesh.weight_values)) return false;
+    for (uint32_t v = 0; v < mesh.vertex_count; v++) {
+        if (mesh.weight_offsets[v] > mesh.weight_offsets[v + 1]) return false;
+    }
+    for (uint32_t e = 0; e < weight_count; e++) {
+        if (mesh.weight_bones[e] > 0xff) return false;
+    }
+    for (uint32_t l = 0; l < mesh.loop_count; l++) {
+        if (mesh.loop_vertices[l] < 0 || (uint32_t)mesh.loop_vertices[l] >= mesh.vertex_count) return false;
+    }
+    for (uint32_t p = 0; p < mesh.polygon_count; p++) {
+        int64_t start = mesh.polygon_loop_starts[p], total = mesh.polygon_loop_totals[p];
+        if (start < 0 || total < 0 || start + total > (int64_t)mesh.loop_count) return false;
+    }
+    return true;
+}
+
+// Vertices and (local) indices of one submesh: corners are deduplicated by
+// SknVertexKey in first-seen order and polygons are fan-triangulated
+static void build_skn_submesh(const SKN_EXPORT_MESH& mesh, int32_t material, float scale, uint32_t flags,
+                              std::vector<SknVertex>& vertices, std::vector<uint32_t>& indices) {
+    auto selected = [&](uint32_t p) { return material < 0 || mesh.polygon_materials[p] == material; };
+
+    // Vertex normals average the normals of the polygons of this submesh
+    std::vector<float> normal_sums((size_t)mesh.vertex_count * 3, 0.0f);
+    std::vector<uint8_t> used(mesh.vertex_count, 0);
+    for (uint32_t p = 0; p < mesh.polygon_count; p++) {
+        if (!selected(p)) continue;
+        const float* n = mesh.polygon_normals + (size_t)p * 3;
+        for (int32_t l = 0; l < mesh.polygon_loop_totals[p]; l++) {
+            uint32_t v = (uint32_t)mesh.loop_vertices[mesh.polygon_loop_starts[p] + l];
+            float* sum = &normal_sums[(size_t)v * 3];
+            sum[0] += n[0]; sum[1] += n[1]; sum[2] += n[2];
+            used[v] = 1;
+        }
+    }
+
+    const bool mirror = (flags & SKN_EXPORT_NO_TRANSFORM) == 0;
+    std::vector<SknVertexBase> bases(mesh.vertex_count);
+    for (uint32_t v = 0; v < mesh.vertex_count; v++) {
+        if (!used[v]) continue;
+        SknVertexBase& base = bases[v];
+        float p[3], n[3];
+        transform_point(mesh.matrix, mesh.positions + (size_t)v * 3, p);
+        float* avg = &normal_sums[(size_t)v * 3];
+        normalize3(avg);
+        transform_direction(mesh.matrix, avg, n);
+        normalize3(n);
+
+        // Positions map Blender (x, y, z) to SKN (-x, z, -y); normals take the
+        // cofactor of that reflection, (x, -z, y)
+        if (mirror) {
+            base.position[0] = -p[0] * scale; base.position[1] = p[2] * scale; base.position[2] = -p[1] * scale;
+            base.normal[0] = n[0]; base.normal[1] = -n[2]; base.normal[2] = n[1];
+        } else {
+            for (int c = 0; c < 3; c++) { base.position[c] = p[c] * scale; base.normal[c] = n[c]; }
+        }
+        limit_influences(mesh, v, base.bones, base.weights);
+    }
+
+    std::unordered_map<SknVertexKey, uint32_t, SknVertexKeyHash> lookup;
+    std::vector<uint32_t> corners;
+    for (uint32_t p = 0; p < mesh.polygon_count; p++) {
+        if (!selected(p)) continue;
+        corners.clear();
+        for (int32_t l = 0; l < mesh.polygon_loop_totals[p]; l++) {
+            uint32_t loop = (uint32_t)(mesh.polygon_loop_starts[p] + l);
+            const SknVertexBase& base = bases[(uint32_t)mesh.loop_vertices[loop]];
+            const float* uv = mesh.loop_uvs + (size_t)loop * 2;
+
+            SknVertexKey key;
+            memset(&key, 0, sizeof(key));
+            key.uv[0] = llround((double)uv[0] * 1e6);
+            key.uv[1] = llround((double)uv[1] * 1e6);
+            memcpy(key.position, base.position, sizeof(key.position));
+            memcpy(key.normal, base.normal, sizeof(key.normal));
+            memcpy(key.weights, base.weights, sizeof(key.weights));
+            memcpy(key.bones, base.bones, sizeof(key.bones));
+
+            auto it = lookup.emplace(key, (uint32_t)vertices.size());
+            if (it.second) {
+                SknVertex vertex;
+                memcpy(vertex.position, base.position, sizeof(vertex.position));
+                memcpy(vertex.bones, base.bones, sizeof(vertex.bones));
+                memcpy(vertex.weights, base.weights, sizeof(vertex.weights));
+                memcpy(vertex.normal, base.normal, sizeof(vertex.normal));
+                vertex.uv[0] = uv[0];
+                vertex.uv[1] = 1.0f - uv[1];
+                vertices.push_back(vertex);
+            }
+            corners.push_back(it.first->second);
+        }
+        for (size_t i = 1; i + 1 < corners.size(); i++) {
+            indices.push_back(corners[0]);
+            indices.push_back(corners[i]);
+            indices.push_back(corners[i + 1]);
+        }
+    }
+}
+
+/*
+ * Write Blender meshes as an SKN file (version 1.1)
+ *
+ * Parameters:
+ *   skn_path       - Destination .skn path (UTF-8)
+ *   meshes         - mesh_count meshes as foreach_get arrays
+ *   mesh_count     - Number of meshes
+ *   submeshes      - submesh_count submeshes in file order; vertex_count and
+ *                    index_count are filled in (0 for submeshes without faces,
+ *                    which are left out of the file)
+ *   submesh_count  - Number of submeshes
+ *   scale          - Factor applied to positions
+ *   flags          - SKN_EXPORT_NO_TRANSFORM to keep Blender axes
+ *
+ * Vertices are deduplicated per submesh by position, normal, influences and
+ * UV, so every UV seam gets its own vertex. Each vertex keeps its four
+ * strongest influences, renormalized. Submeshes are built in parallel.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be written, -4 on allocation failure,
+ *   -5 on invalid arguments (including out of range indices), or
+ *   -7: more than 65535 vertices or 32 submeshes with faces (counts are still filled in)
+ *   -8: no faces to export
+ */
+DLL_EXPORT int write_skn(const char* skn_path, const SKN_EXPORT_MESH* meshes, uint32_t mesh_count,
+                         SKN_EXPORT_SUBMESH* submeshes, uint32_t submesh_count, float scale, uint32_t flags) {
+    if (!skn_path || (mesh_count && !meshes) || (submesh_count && !submeshes)) return -5;
+    for (uint32_t i = 0; i < mesh_count; i++) {
+        if (!skn_mesh_valid(meshes[i])) return -5;
+    }
+    for (uint32_t i = 0; i < submesh_count; i++) {
+        if (submeshes[i].mesh >= mesh_count) return -5;
+        submeshes[i].vertex_count = 0;
+        submeshes[i].index_count = 0;
+    }
+
+    struct Built {
+        std::vector<SknVertex> vertices;
+        std::vector<uint32_t> indices;
+    };
+    std::vector<Built> built;
+    try {
+        built.resize(submesh_count);
+        global_thread_pool().parallel_for(submesh_count, 0, [&](size_t i) {
+            build_skn_submesh(meshes[submeshes[i].mesh], submeshes[i].material, scale, flags,
+                              built[i].vertices, built[i].indices);
+        });
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+
+    uint64_t vertex_total = 0, index_total = 0;
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < submesh_count; i++) {
+        if (built[i].indices.empty()) continue;
+        submeshes[i].vertex_count = (uint32_t)built[i].vertices.size();
+        submeshes[i].index_count = (uint32_t)built[i].indices.size();
+        vertex_total += built[i].vertices.size();
+        index_total += built[i].indices.size();
+        written++;
+    }
+    if (written == 0) return -8;
+    if (vertex_total > SKN_MAX_VERTICES || written > SKN_MAX_SUBMESHES) return -7;
+
+    ByteWriter w;
+    try {
+        w.data.reserve(12 + (size_t)written * sizeof(SKN_SUBMESH) + 8 + index_total * 2 + vertex_total * sizeof(SknVertex));
+        w.u32(SKN_MAGIC);
+        w.u16(1);
+        w.u16(1);
+        w.u32(written);
+
+        uint32_t vertex_start = 0, index_start = 0;
+        for (uint32_t i = 0; i < submesh_count; i++) {
+            if (built[i].indices.empty()) continue;
+            SKN_SUBMESH header = {};
+            memcpy(header.name, submeshes[i].name, sizeof(header.name));
+            header.vertex_start = vertex_start;
+            header.vertex_count = submeshes[i].vertex_count;
+            header.index_start = index_start;
+            header.index_count = submeshes[i].index_count;
+            w.write(&header, sizeof(header));
+            vertex_start += header.vertex_count;
+            index_start += header.index_count;
+        }
+
+        w.u32((uint32_t)index_total);
+        w.u32((uint32_t)vertex_total);
+        uint32_t base = 0;
+        for (uint32_t i = 0; i < submesh_count; i++) {
+            for (uint32_t index : built[i].indices) w.u16((uint16_t)(base + index));
+            base += (uint32_t)built[i].vertices.size();
+        }
+        for (uint32_t i = 0; i < submesh_count; i++) {
+            if (!built[i].indices.empty()) w.write(built[i].vertices.data(), built[i].vertices.size() * sizeof(SknVertex));
+        }
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+
+    return write_file(skn_path, w.data.data(), w.data.size()) ? 0 : -1;
+}
+
+// ============================================================================
+// SKL Writing
+// ============================================================================
+
+#define SKL_MAGIC        0x22FD4FC3
+#define SKL_JOINT_SIZE   100
+#define SKL_JOINT_RADIUS 2.1f
+
+// ELF hash of the lowercased name, the SKL joint name hash
+static uint32_t skl_name_hash(const char* name) {
+    uint32_t h = 0;
+    for (const char* c = name; *c; c++) {
+        uint8_t ch = (uint8_t)*c;
+        if (ch >= 'A' && ch <= 'Z') ch = (uint8_t)(ch - 'A' + 'a');
+        h = (h << 4) + ch;
+        uint32_t t = h & 0xF0000000u;
+        if (t) h ^= t >> 24;
+        h &= ~t;
+    }
+    return h;
+}
+
+/*
+ * Write a skeleton as an SKL file (version 0)
+ *
+ * Parameters:
+ *   skl_path          - Destination .skl path (UTF-8)
+ *   joint_count       - Number of joints (at most 65535)
+ *   names             - joint_count joint names (ASCII)
+ *   parents           - joint_count parent joint indices, -1 for roots
+ *   local_trs         - joint_count * 10 floats: translation xyz, scale xyz,
+ *                       rotation quaternion xyzw, relative to the parent
+ *   inverse_bind_trs  - joint_count * 10 floats, inverse of the global bind
+ *                       transform in the same layout
+ *
+ * Every joint is its own influence, in joint order.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be written, -4 on allocation failure,
+ *   -5 on invalid arguments
+ */
+DLL_EXPORT int write_skl(const char* skl_path, uint32_t joint_count, const char* const* names,
+                         const int16_t* parents, const float* local_trs, const float* inverse_bind_trs) {
+    if (!skl_path || joint_count > 0xffff) return -5;
+    if (joint_count && (!names || !parents || !local_trs || !inverse_bind_trs)) return -5;
+    for (uint32_t i = 0; i < joint_count; i++) {
+        if (!names[i] || parents[i] < -1 || parents[i] >= (int32_t)joint_count) return -5;
+    }
+
+    const uint32_t joints_offset = 64;
+    const uint32_t joint_indices_offset = joints_offset + joint_count * SKL_JOINT_SIZE;
+    const uint32_t influences_offset = joint_indices_offset + joint_count * 8;
+    const uint32_t names_offset = influences_offset + joint_count * 2;
+
+    ByteWriter w;
+    try {
+        // Resource size counts everything up to the name table
+        w.u32(names_offset);
+        w.u32(SKL_MAGIC);
+        w.u32(0);
+        w.u16(0);
+        w.u16((uint16_t)joint_count);
+        w.u32(joint_count);
+        w.i32((int32_t)joints_offset);
+        w.i32((int32_t)joint_indices_offset);
+        w.i32((int32_t)influences_offset);
+        w.i32(0);
+        w.i32(0);
+        w.i32((int32_t)names_offset);
+        for (int i = 0; i < 5; i++) w.u32(0xFFFFFFFFu);
+
+        std::vector<uint32_t> name_offsets(joint_count);
+        uint32_t name_pos = names_offset;
+        for (uint32_t i = 0; i < joint_count; i++) {
+            name_offsets[i] = name_pos;
+            name_pos += (uint32_t)strlen(names[i]) + 1;
+        }
+
+        for (uint32_t i = 0; i < joint_count; i++) {
+            w.u16(0);
+            w.u16((uint16_t)i);
+            w.i16(parents[i]);
+            w.u16(0);
+            w.u32(skl_name_hash(names[i]));
+            w.f32(SKL_JOINT_RADIUS);
+            w.write(local_trs + (size_t)i * 10, 40);
+            w.write(inverse_bind_trs + (size_t)i * 10, 40);
+            w.i32((int32_t)(name_offsets[i] - (uint32_t)w.pos()));
+        }
+
+        for (uint32_t i = 0; i < joint_count; i++) {
+            w.u16((uint16_t)i);
+            w.u16(0);
+            w.u32(skl_name_hash(names[i]));
+        }
+        for (uint32_t i = 0; i < joint_count; i++) w.u16((uint16_t)i);
+        for (uint32_t i = 0; i < joint_count; i++) w.write(names[i], strlen(names[i]) + 1);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+
+    return write_file(skl_path, w.data.data(), w.data.size()) ? 0 : -1;
+}
+
+// ============================================================================
+// SCB / SCO Parsing
+// ============================================================================
+
+#define STATIC_MESH_SCB  1   // r3d2Mesh binary
+#define STATIC_MESH_SCO  2   // [ObjectBegin] text
+
+#define STATIC_MESH_HAS_PIVOT 0x1
+
+#define SCB_FACE_SIZE 100    // 3 indices, 64 byte material, u1 u2 u3 v1 v2 v3
+
+// Result of parse_scb / parse_sco: one malloc'd block holding this header
+// followed by the arrays. Positions and central / pivot points are in file
+// axes; UVs are per face corner as stored (V down).
+typedef struct {
+    uint32_t format;            // STATIC_MESH_*
+    uint32_t major;             // SCB version, 0 for SCO
+    uint32_t minor;
+    uint32_t flags;             // STATIC_MESH_HAS_PIVOT
+    uint32_t scb_flag;          // SCB header flag
+    uint32_t vertex_count;
+    uint32_t face_count;        // After dropping degenerate faces
+    float central[3];
+    float pivot[3];             // SCO PivotPoint, STATIC_MESH_HAS_PIVOT
+    char name[64];              // SCO Name=, empty for SCB or when missing
+    char material[64];          // Material of the first kept face, empty when missing
+    float* positions;           // vertex_count * 3
+    uint32_t* indices;          // face_count * 3
+    float* uvs;                 // face_count * 3 * 2
+} STATIC_MESH;
+
+static STATIC_MESH* alloc_static_mesh(uint32_t vertex_count, uint32_t face_count) {
+    BlockLayout layout;
+    size_t off_header = layout.add(sizeof(STATIC_MESH));
+    size_t off_positions = layout.add((size_t)vertex_count * 3 * sizeof(float));
+    size_t off_indices = layout.add((size_t)face_count * 3 * sizeof(uint32_t));
+    size_t off_uvs = layout.add((size_t)face_count * 6 * sizeof(float));
+
+    uint8_t* block = (uint8_t*)malloc(layout.size);
+    if (!block) return nullptr;
+    stats_add(NATIVE_COUNTER_ALLOC_BYTES, layout.size);
+
+    STATIC_MESH* mesh = (STATIC_MESH*)(block + off_header);
+    memset(mesh, 0, sizeof(STATIC_MESH));
+    mesh->vertex_count = vertex_count;
+    mesh->positions = (float*)(block + off_positions);
+    mesh->indices = (uint32_t*)(block + off_indices);
+    mesh->uvs = (float*)(block + off_uvs);
+    return mesh;
+}
+
+static void copy_name(char* dst, const char* src, size_t len) {
+    if (len > 63) len = 63;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+static int scb_parse(const uint8_t* src, size_t src_len, STATIC_MESH** out_mesh) {
+    ByteReader r = { src, src_len, 0 };
+
+    uint16_t major, minor;
+    if (!r.has(8) || memcmp(src, "r3d2Mesh", 8) != 0) return -2;
+    r.skip(8);
+    if (!r.u16(major) || !r.u16(minor)) return -2;
+    if (major != 2 && major != 3) return -3;
+    if (!r.skip(128)) return -2;                // Name
+
+    uint32_t vertex_count, face_count, scb_flag, vertex_type = 0;
+    if (!r.u32(vertex_count) || !r.u32(face_count) || !r.u32(scb_flag)) return -2;
+    if (!r.skip(24)) return -2;                 // Bounding box
+    if (major == 3 && minor == 2 && !r.u32(vertex_type)) return -2;
+
+    const uint8_t* vertex_data = r.here();
+    if (!r.skip((size_t)vertex_count * 12)) return -2;
+    if (vertex_type == 1 && !r.skip((size_t)vertex_count * 4)) return -2;   // Vertex colors
+    float central[3];
+    if (!r.read(central, 12)) return -2;
+    const uint8_t* face_data = r.here();
+    if (!r.has((size_t)face_count * SCB_FACE_SIZE)) return -2;
+
+    STATIC_MESH* mesh = alloc_static_mesh(vertex_count, face_count);
+    if (!mesh) return -4;
+    mesh->format = STATIC_MESH_SCB;
+    mesh->major = major;
+    mesh->minor = minor;
+    mesh->scb_flag = scb_flag;
+    memcpy(mesh->central, central, sizeof(central));
+    memcpy(mesh->positions, vertex_data, (size_t)vertex_count * 12);
+
+    uint32_t kept = 0;
+    for (uint32_t f = 0; f < face_count; f++) {
+        const uint8_t* face = face_data + (size_t)f * SCB_FACE_SIZE;
+        uint32_t idx[3];
+        float uv[6];
+        memcpy(idx, face, 12);
+        memcpy(uv, face + 76, 24);
+        if (idx[0] >= vertex_count || idx[1] >= vertex_count || idx[2] >= vertex_count) {
+            free(mesh);
+            return -2;
+        }
+        if (idx[0] == idx[1] || idx[1] == idx[2] || idx[2] == idx[0]) continue;
+        if (kept == 0) {
+            const char* name = (const char*)face + 12;
+            copy_name(mesh->material, name, strnlen(name, 64));
+        }
+
+        memcpy(mesh->indices + (size_t)kept * 3, idx, 12);
+        float* out = mesh->uvs + (size_t)kept * 6;
+        for (int c = 0; c < 3; c++) {
+            out[c * 2] = uv[c];
+            out[c * 2 + 1] = uv[3 + c];
+        }
+        kept++;
+    }
+    mesh->face_count = kept;
+
+    *out_mesh = mesh;
+    return 0;
+}
+
+static bool sco_point(TextReader line, float* out) {
+    return line.f32(out[0]) && line.f32(out[1]) && line.f32(out[2]);
+}
+
+static int sco_parse(const uint8_t* src, size_t src_len, STATIC_MESH** out_mesh) {
+    TextReader text = { (const char*)src, (const char*)src + src_len };
+    TextReader line;
+    if (!text.line(line) || !line.starts_with("[ObjectBegin]") || !line.empty()) return -2;
+
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    std::vector<float> uvs;
+    float central[3] = { 0, 0, 0 }, pivot[3] = { 0, 0, 0 };
+    bool has_pivot = false;
+    char name[64] = "", material[64] = "";
+
+    while (text.line(line)) {
+        if (line.starts_with("Name=")) {
+            // Up to the next '=' like str.split('=')[1]
+            const char* stop = (const char*)memchr(line.p, '=', (size_t)(line.end - line.p));
+            if (!stop) stop = line.end;
+            const char* begin = line.p;
+            while (begin < stop && TextReader::is_space(*begin)) begin++;
+            while (stop > begin && TextReader::is_space(stop[-1])) stop--;
+            copy_name(name, begin, (size_t)(stop - begin));
+        } else if (line.starts_with("CentralPoint=")) {
+            if (!sco_point(line, central)) return -2;
+        } else if (line.starts_with("PivotPoint=")) {
+            if (!sco_point(line, pivot)) return -2;
+            has_pivot = true;
+        } else if (line.starts_with("Verts=")) {
+            // Every vertex row takes at least 6 bytes and every face row 22,
+            // which bounds the counts before anything is reserved
+            uint32_t count;
+            if (!line.u32(count) || count > src_len / 6) return -2;
+            positions.resize((size_t)count * 3);
+            for (uint32_t v = 0; v < count; v++) {
+                TextReader row;
+                if (!text.line(row) || !sco_point(row, &positions[(size_t)v * 3])) return -2;
+            }
+        } else if (line.starts_with("Faces=")) {
+            uint32_t count;
+            if (!line.u32(count) || count > src_len / 22) return -2;
+            indices.reserve((size_t)count * 3);
+            uvs.reserve((size_t)count * 6);
+            for (uint32_t f = 0; f < count; f++) {
+                // 3 <i0> <i1> <i2> <material> <u1> <v1> <u2> <v2> <u3> <v3>
+                TextReader row;
+                if (!text.line(row)) return -2;
+                uint32_t corners, idx[3];
+                const char* mat_begin;
+                const char* mat_end;
+                float uv[6];
+                bool ok = row.u32(corners) && row.u32(idx[0]) && row.u32(idx[1]) && row.u32(idx[2]) &&
+                          row.token(mat_begin, mat_end);
+                for (int i = 0; ok && i < 6; i++) ok = row.f32(uv[i]);
+                if (!ok) continue;   // Short or malformed rows are skipped
+
+                if (idx[0] == idx[1] || idx[1] == idx[2] || idx[2] == idx[0]) continue;
+                if (indices.empty()) copy_name(material, mat_begin, (size_t)(mat_end - mat_begin));
+                indices.insert(indices.end(), idx, idx + 3);
+                uvs.insert(uvs.end(), uv, uv + 6);
+            }
+        }
+    }
+
+    const uint32_t vertex_count = (uint32_t)(positions.size() / 3);
+    for (uint32_t index : indices) {
+        if (index >= vertex_count) return -2;
+    }
+
+    const uint32_t face_count = (uint32_t)(indices.size() / 3);
+    STATIC_MESH* mesh = alloc_static_mesh(vertex_count, face_count);
+    if (!mesh) return -4;
+    mesh->format = STATIC_MESH_SCO;
+    mesh->flags = has_pivot ? STATIC_MESH_HAS_PIVOT : 0;
+    mesh->face_count = face_count;
+    memcpy(mesh->central, central, sizeof(central));
+    memcpy(mesh->pivot, pivot, sizeof(pivot));
+    memcpy(mesh->name, name, sizeof(name));
+    memcpy(mesh->material, material, sizeof(material));
+    if (vertex_count) memcpy(mesh->positions, positions.data(), positions.size() * sizeof(float));
+    if (face_count) {
+        memcpy(mesh->indices, indices.data(), indices.size() * sizeof(uint32_t));
+        memcpy(mesh->uvs, uvs.data(), uvs.size() * sizeof(float));
+    }
+
+    *out_mesh = mesh;
+    return 0;
+}
+
+typedef int (*StaticParser)(const uint8_t*, size_t, STATIC_MESH**);
+
+static int parse_static_file(const char* path, StaticParser parser, STATIC_MESH** out_mesh) {
+    if (!path || !out_mesh) return -5;
+    *out_mesh = nullptr;
+
+    MappedFile mapped;
+    if (!open_mapped(mapped, path)) return -1;
+    try {
+        StatsTimer timer(NATIVE_STAGE_PARSE);
+        return parser(mapped.data(), mapped.size(), out_mesh);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Parse an SCB static mesh into structure-of-arrays buffers
+ *
+ * Parameters:
+ *   scb_path  - Source .scb path (UTF-8)
+ *   out_mesh  - Receives the parsed mesh (free with free_bytes)
+ *
+ * Degenerate faces are removed like the Python reader does.
+ *
+ * Returns:
+ *   0 on success, negative on error:
+ *   -1: File can't be opened
+ *   -2: Invalid or truncated file (including out of range indices)
+ *   -3: Unsupported version
+ *   -4: Memory allocation failed
+ *   -5: Invalid arguments
+ */
+DLL_EXPORT int parse_scb(const char* scb_path, STATIC_MESH** out_mesh) {
+    return parse_static_file(scb_path, scb_parse, out_mesh);
+}
+
+/*
+ * Parse an SCO (text) static mesh into structure-of-arrays buffers
+ *
+ * Same contract as parse_scb. Numbers are tokenized in place over the
+ * mapped file; face rows with fewer than eleven fields are skipped like the
+ * Python reader does.
+ */
+DLL_EXPORT int parse_sco(const char* sco_path, STATIC_MESH** out_mesh) {
+    return parse_static_file(sco_path, sco_parse, out_mesh);
+}
+
+// ============================================================================
+// SCB / SCO Writing
+// ============================================================================
+
+#define STATIC_EXPORT_PIVOT 0x1      // Write a PivotPoint (SCO only)
+
+// One Blender mesh as foreach_get arrays plus the object placement
+typedef struct {
+    uint32_t vertex_count;
+    const float* positions;             // vertex_count * 3, mesh space
+    uint32_t loop_count;
+    const int32_t* loop_vertices;       // loop_count
+    const float* loop_uvs;              // loop_count * 2, Blender UV orientation
+    uint32_t polygon_count;
+    const int32_t* polygon_loop_starts; // polygon_count
+    const int32_t* polygon_loop_totals; // polygon_count
+    float matrix[16];                   // Mesh to world space, row-major
+    float central[3];                   // World space, the object origin
+    float pivot[3];                     // World space pivot bone head, STATIC_EXPORT_PIVOT
+    uint32_t flags;                     // STATIC_EXPORT_*
+    uint32_t scb_flag;                  // SCB header flag
+    float scale;                        // Factor applied to world positions
+    const char* name;                   // SCO Name= (UTF-8)
+    const char* material;               // Material written on every face
+} STATIC_EXPORT_MESH;
+
+static bool static_mesh_valid(const STATIC_EXPORT_MESH& mesh) {
+    if ((mesh.vertex_count && !mesh.positions) || (mesh.loop_count && (!mesh.loop_vertices || !mesh.loop_uvs)) ||
+        (mesh.polygon_count && (!mesh.polygon_loop_starts || !mesh.polygon_loop_totals)) || !mesh.material) {
+        return false;
+    }
+    for (uint32_t l = 0; l < mesh.loop_count; l++) {
+        if (mesh.loop_vertices[l] < 0 || (uint32_t)mesh.loop_vertices[l] >= mesh.vertex_count) return false;
+    }
+    for (uint32_t p = 0; p < mesh.polygon_count; p++) {
+        int64_t start = mesh.polygon_loop_starts[p], total = mesh.polygon_loop_totals[p];
+        if (start < 0 || total < 0 || start + total > (int64_t)mesh.loop_count) return false;
+    }
+    return true;
+}
+
+// Blender world (x, y, z) to file axes (-x, z, -y), scaled
+static void to_static_axes(const float* p, float scale, float* out) {
+    out[0] = -p[0] * scale;
+    out[1] = p[2] * scale;
+    out[2] = -p[1] * scale;
+}
+
+// Vertices in file axes and fan-triangulated faces with per-corner UVs
+// (u, 1 - v), in polygon order
+struct StaticBuilt {
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    std::vector<float> uvs;
+    float central[3];
+};
+
+static void build_static_mesh(const STATIC_EXPORT_MESH& mesh, StaticBuilt& out) {
+    out.positions.resize((size_t)mesh.vertex_count * 3);
+    global_thread_pool().parallel_for((mesh.vertex_count + 4095) / 4096, 0, [&](size_t chunk) {
+        uint32_t begin = (uint32_t)chunk * 4096;
+        uint32_t end = begin + 4096 < mesh.vertex_count ? begin + 4096 : mesh.vertex_count;
+        for (uint32_t v = begin; v < end; v++) {
+            float world[3];
+            transform_point(mesh.matrix, mesh.positions + (size_t)v * 3, world);
+            to_static_axes(world, mesh.scale, &out.positions[(size_t)v * 3]);
+        }
+    });
+    to_static_axes(mesh.central, mesh.scale, out.central);
+
+    for (uint32_t p = 0; p < mesh.polygon_count; p++) {
+        const int32_t start = mesh.polygon_loop_starts[p];
+        for (int32_t i = 1; i + 1 < mesh.polygon_loop_totals[p]; i++) {
+            const int32_t corners[3] = { start, start + i, start + i + 1 };
+            for (int32_t loop : corners) {
+                const float* uv = mesh.loop_uvs + (size_t)loop * 2;
+                out.indices.push_back((uint32_t)mesh.loop_vertices[loop]);
+                out.uvs.push_back(uv[0]);
+                out.uvs.push_back(1.0f - uv[1]);
+            }
+        }
+    }
+}
+
+/*
+ * Write a Blender mesh as an SCB file (version 3.2, no vertex colors)
+ *
+ * Parameters:
+ *   scb_path  - Destination .scb path (UTF-8)
+ *   mesh      - The mesh as foreach_get arrays
+ *
+ * Vertices are written as absolute world positions in file axes, the
+ * central point is the object origin and polygons are fan-triangulated with
+ * the material on every face (at most 64 bytes are kept).
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be written, -4 on allocation failure,
+ *   -5 on invalid arguments (including out of range indices)
+ */
+DLL_EXPORT int write_scb(const char* scb_path, const STATIC_EXPORT_MESH* mesh) {
+    if (!scb_path || !mesh || !static_mesh_valid(*mesh)) return -5;
+
+    ByteWriter w;
+    try {
+        StaticBuilt built;
+        build_static_mesh(*mesh, built);
+        const uint32_t face_count = (uint32_t)(built.indices.size() / 3);
+
+        w.data.reserve(176 + built.positions.size() * 4 + 12 + (size_t)face_count * SCB_FACE_SIZE);
+        w.write("r3d2Mesh", 8);
+        w.u16(3);
+        w.u16(2);
+        w.zeros(128);
+        w.u32(mesh->vertex_count);
+        w.u32(face_count);
+        w.u32(mesh->scb_flag);
+
+        float lo[3] = { 0, 0, 0 }, hi[3] = { 0, 0, 0 };
+        for (uint32_t v = 0; v < mesh->vertex_count; v++) {
+            const float* p = &built.positions[(size_t)v * 3];
+            for (int c = 0; c < 3; c++) {
+                if (v == 0 || p[c] < lo[c]) lo[c] = p[c];
+                if (v == 0 || p[c] > hi[c]) hi[c] = p[c];
+            }
+        }
+        w.write(lo, 12);
+        w.write(hi, 12);
+        w.u32(0);                               // Vertex type: no colors
+
+        w.write(built.positions.data(), built.positions.size() * sizeof(float));
+        w.write(built.central, 12);
+
+        char material[64] = {};
+        memcpy(material, mesh->material, strnlen(mesh->material, 64));
+        for (uint32_t f = 0; f < face_count; f++) {
+            const float* uv = &built.uvs[(size_t)f * 6];
+            w.write(&built.indices[(size_t)f * 3], 12);
+            w.write(material, 64);
+            for (int c = 0; c < 3; c++) w.f32(uv[c * 2]);
+            for (int c = 0; c < 3; c++) w.f32(uv[c * 2 + 1]);
+        }
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+
+    return write_file(scb_path, w.data.data(), w.data.size()) ? 0 : -1;
+}
+
+// snprintf into the buffer; the formats here never exceed the scratch size
+struct TextWriter {
+    std::vector<uint8_t>& data;
+
+    void put(const char* s) { data.insert(data.end(), (const uint8_t*)s, (const uint8_t*)s + strlen(s)); }
+    template <typename... Args>
+    void print(const char* format, Args... args) {
+        char scratch[256];
+        int n = snprintf(scratch, sizeof(scratch), format, args...);
+        if (n > 0) data.insert(data.end(), (const uint8_t*)scratch, (const uint8_t*)scratch + (n < 256 ? n : 255));
+    }
+};
+
+/*
+ * Write a Blender mesh as an SCO (text) file
+ *
+ * Same geometry as write_scb. The name is cut to 64 bytes; with
+ * STATIC_EXPORT_PIVOT a PivotPoint is written as the central point minus the
+ * pivot, both in file axes.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be written, -4 on allocation failure,
+ *   -5 on invalid arguments (including out of range indices)
+ */
+DLL_EXPORT int write_sco(const char* sco_path, const STATIC_EXPORT_MESH* mesh) {
+    if (!sco_path || !mesh || !mesh->name || !static_mesh_valid(*mesh)) return -5;
+
+    ByteWriter w;
+    try {
+        StaticBuilt built;
+        build_static_mesh(*mesh, built);
+        const uint32_t face_count = (uint32_t)(built.indices.size() / 3);
+
+        w.data.reserve(256 + (size_t)mesh->vertex_count * 40 + (size_t)face_count * 120);
+        TextWriter text = { w.data };
+        text.put("[ObjectBegin]\n");
+        text.print("Name= %.*s\n", (int)strnlen(mesh->name, 64), mesh->name);
+        text.print("CentralPoint= %.4f %.4f %.4f\n", built.central[0], built.central[1], built.central[2]);
+        if (mesh->flags & STATIC_EXPORT_PIVOT) {
+            float pivot[3];
+            to_static_axes(mesh->pivot, mesh->scale, pivot);
+            text.print("PivotPoint= %.4f %.4f %.4f\n", built.central[0] - pivot[0], built.central[1] - pivot[1],
+                       built.central[2] - pivot[2]);
+        }
+
+        text.print("Verts= %u\n", mesh->vertex_count);
+        for (uint32_t v = 0; v < mesh->vertex_count; v++) {
+            const float* p = &built.positions[(size_t)v * 3];
+            text.print("%.4f %.4f %.4f\n", p[0], p[1], p[2]);
+        }
+
+        text.print("Faces= %u\n", face_count);
+        for (uint32_t f = 0; f < face_count; f++) {
+            const uint32_t* idx = &built.indices[(size_t)f * 3];
+            const float* uv = &built.uvs[(size_t)f * 6];
+            text.print("3\t %5u %5u %5u\t", idx[0], idx[1], idx[2]);
+            text.print("%20.*s\t", 200, mesh->material);
+            text.print("%.12f %.12f %.12f %.12f %.12f %.12f\n", uv[0], uv[1], uv[2], uv[3], uv[4], uv[5]);
+        }
+        text.put("[ObjectEnd]");
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+
+    return write_file(sco_path, w.data.data(), w.data.size()) ? 0 : -1;
+}
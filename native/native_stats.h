@@ -0,0 +1,289 @@
+#ifndef NATIVE_STATS_H
+#define NATIVE_STATS_H
+
+/*
+ * Per-stage timers and counters for the native DLLs, with an optional
+ * Chrome trace (chrome://tracing, Perfetto) of the timed stages
+ *
+ * Every thread that records gets its own slot, claimed once from a fixed
+ * table with a compare-exchange and given back when the thread exits, so
+ * recording never takes a lock and only touches the thread's own cache
+ * lines. Slots keep their counts after their thread is gone; a snapshot
+ * sums all of them. Each DLL that includes this header has its own table.
+ *
+ * Slot memory comes from calloc: bin_parser routes operator new to parse
+ * arenas, which a slot must outlive.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "binary_writer.h"
+#include "file_map.h"
+
+// Timed stages (NATIVE_STATS.calls / .ns index)
+#define NATIVE_STAGE_FILE_READ     0    // Opening or reading files (pages of a mapping fault
+                                        // in later, in the stage that touches them)
+#define NATIVE_STAGE_PARSE         1    // Parsing file formats into trees or tables
+#define NATIVE_STAGE_LINK_RESOLVE  2    // Following BIN links and extracting results
+#define NATIVE_STAGE_MIP_REORDER   3    // Copying TEX mips into DDS order
+#define NATIVE_STAGE_DECODE        4    // Decoding pixels
+#define NATIVE_STAGE_COUNT         5
+
+// Counters (NATIVE_STATS.counters index)
+#define NATIVE_COUNTER_ALLOC_BYTES   0  // Bytes allocated for results handed to the caller
+#define NATIVE_COUNTER_READ_BYTES    1  // Bytes of files read or mapped
+#define NATIVE_COUNTER_CACHE_HITS    2
+#define NATIVE_COUNTER_CACHE_MISSES  3
+#define NATIVE_COUNTER_TRACE_DROPPED 4  // Trace events that didn't fit the buffers
+#define NATIVE_COUNTER_COUNT         5
+
+#define NATIVE_STATS_MAX_THREADS 256    // Threads beyond this record nothing
+
+typedef struct {
+    uint32_t stage_count;               // NATIVE_STAGE_COUNT
+    uint32_t counter_count;             // NATIVE_COUNTER_COUNT
+    uint32_t thread_count;              // Slots ever claimed (exited threads hand theirs on)
+    uint32_t reserved;
+    uint64_t calls[NATIVE_STAGE_COUNT];
+    uint64_t ns[NATIVE_STAGE_COUNT];    // Wall time per stage, summed over threads
+    uint64_t counters[NATIVE_COUNTER_COUNT];
+} NATIVE_STATS;
+
+inline const char* native_stage_name(uint32_t stage) {
+    static const char* const names[NATIVE_STAGE_COUNT] = {
+        "file_read", "parse", "link_resolve", "mip_reorder", "decode",
+    };
+    return stage < NATIVE_STAGE_COUNT ? names[stage] : "unknown";
+}
+
+inline uint64_t stats_now_ns() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct TraceEvent {
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint32_t stage;
+};
+
+// One thread's counts. Only the owning thread adds; snapshots and resets
+// from other threads see each value atomically.
+struct alignas(64) StatsSlot {
+    std::atomic<uint32_t> owned;
+    std::atomic<uint32_t> used;         // Ever recorded, for thread_count
+    std::atomic<uint64_t> calls[NATIVE_STAGE_COUNT];
+    std::atomic<uint64_t> ns[NATIVE_STAGE_COUNT];
+    std::atomic<uint64_t> counters[NATIVE_COUNTER_COUNT];
+
+    // Trace buffer, written by the owner and published through event_count
+    TraceEvent* events;
+    uint32_t event_capacity;
+    uint32_t trace_generation;
+    std::atomic<uint32_t> event_count;
+};
+
+struct StatsRegistry {
+    StatsSlot* slots;                   // NATIVE_STATS_MAX_THREADS, never freed
+    std::atomic<uint32_t> trace_generation{0};   // Bumped by every trace start, 0 = never traced
+    std::atomic<uint32_t> trace_capacity{0};     // Events per thread, 0 = not tracing
+    std::atomic<uint64_t> trace_origin_ns{0};
+};
+
+// The slots are never freed: pool threads may still record while the DLL
+// unloads, like the thread pool they belong to
+inline StatsRegistry& stats_registry() {
+    static StatsRegistry registry{ [] {
+        StatsSlot* slots = (StatsSlot*)calloc(NATIVE_STATS_MAX_THREADS, sizeof(StatsSlot));
+        if (slots) {
+            for (uint32_t i = 0; i < NATIVE_STATS_MAX_THREADS; i++) new (&slots[i]) StatsSlot();
+        }
+        return slots;
+    }() };
+    return registry;
+}
+
+// Claims a free slot for the calling thread and releases it at thread exit
+class StatsSlotOwner {
+public:
+    StatsSlotOwner() {
+        StatsRegistry& r = stats_registry();
+        if (!r.slots) return;
+        for (uint32_t i = 0; i < NATIVE_STATS_MAX_THREADS; i++) {
+            uint32_t expected = 0;
+            if (r.slots[i].owned.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+                slot_ = &r.slots[i];
+                slot_->used.store(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+    ~StatsSlotOwner() {
+        if (slot_) slot_->owned.store(0, std::memory_order_release);
+    }
+
+    StatsSlotOwner(const StatsSlotOwner&) = delete;
+    StatsSlotOwner& operator=(const StatsSlotOwner&) = delete;
+
+    StatsSlot* slot() const { return slot_; }
+
+private:
+    StatsSlot* slot_ = nullptr;
+};
+
+inline StatsSlot* stats_slot() {
+    static thread_local StatsSlotOwner owner;
+    return owner.slot();
+}
+
+inline void stats_add(uint32_t counter, uint64_t value) {
+    StatsSlot* slot = stats_slot();
+    if (slot) slot->counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+inline void stats_trace_event(StatsSlot* slot, uint32_t stage, uint64_t start_ns, uint64_t duration_ns) {
+    StatsRegistry& r = stats_registry();
+    uint32_t capacity = r.trace_capacity.load(std::memory_order_acquire);
+    if (!capacity) return;
+
+    // A new trace started since this thread last traced: start over, with
+    // a bigger buffer if needed
+    uint32_t generation = r.trace_generation.load(std::memory_order_acquire);
+    if (slot->trace_generation != generation) {
+        if (slot->event_capacity < capacity) {
+            TraceEvent* events = (TraceEvent*)malloc(sizeof(TraceEvent) * capacity);
+            if (!events) return;
+            free(slot->events);
+            slot->events = events;
+            slot->event_capacity = capacity;
+        }
+        slot->event_count.store(0, std::memory_order_relaxed);
+        slot->trace_generation = generation;
+    }
+
+    uint32_t count = slot->event_count.load(std::memory_order_relaxed);
+    if (count >= capacity) {
+        slot->counters[NATIVE_COUNTER_TRACE_DROPPED].fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    slot->events[count] = TraceEvent{ start_ns, duration_ns, stage };
+    slot->event_count.store(count + 1, std::memory_order_release);
+}
+
+// Times its scope as one call of a stage
+class StatsTimer {
+public:
+    explicit StatsTimer(uint32_t stage) : slot_(stats_slot()), stage_(stage), start_(slot_ ? stats_now_ns() : 0) {}
+    ~StatsTimer() {
+        if (!slot_) return;
+        uint64_t duration = stats_now_ns() - start_;
+        slot_->calls[stage_].fetch_add(1, std::memory_order_relaxed);
+        slot_->ns[stage_].fetch_add(duration, std::memory_order_relaxed);
+        stats_trace_event(slot_, stage_, start_, duration);
+    }
+
+    StatsTimer(const StatsTimer&) = delete;
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+private:
+    StatsSlot* slot_;
+    uint32_t stage_;
+    uint64_t start_;
+};
+
+// MappedFile::open, timed as a file read and counted in READ_BYTES
+inline bool open_mapped(MappedFile& mapped, const char* path) {
+    StatsTimer timer(NATIVE_STAGE_FILE_READ);
+    if (!mapped.open(path)) return false;
+    stats_add(NATIVE_COUNTER_READ_BYTES, mapped.size());
+    return true;
+}
+
+inline void stats_snapshot(NATIVE_STATS& out) {
+    out = NATIVE_STATS();
+    out.stage_count = NATIVE_STAGE_COUNT;
+    out.counter_count = NATIVE_COUNTER_COUNT;
+
+    StatsRegistry& r = stats_registry();
+    if (!r.slots) return;
+    for (uint32_t i = 0; i < NATIVE_STATS_MAX_THREADS; i++) {
+        const StatsSlot& slot = r.slots[i];
+        if (!slot.used.load(std::memory_order_relaxed)) continue;
+        out.thread_count++;
+        for (uint32_t s = 0; s < NATIVE_STAGE_COUNT; s++) {
+            out.calls[s] += slot.calls[s].load(std::memory_order_relaxed);
+            out.ns[s] += slot.ns[s].load(std::memory_order_relaxed);
+        }
+        for (uint32_t c = 0; c < NATIVE_COUNTER_COUNT; c++) {
+            out.counters[c] += slot.counters[c].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Counts recorded while this runs may land on either side of the reset
+inline void stats_reset() {
+    StatsRegistry& r = stats_registry();
+    if (!r.slots) return;
+    for (uint32_t i = 0; i < NATIVE_STATS_MAX_THREADS; i++) {
+        StatsSlot& slot = r.slots[i];
+        for (uint32_t s = 0; s < NATIVE_STAGE_COUNT; s++) {
+            slot.calls[s].store(0, std::memory_order_relaxed);
+            slot.ns[s].store(0, std::memory_order_relaxed);
+        }
+        for (uint32_t c = 0; c < NATIVE_COUNTER_COUNT; c++) {
+            slot.counters[c].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Starts a trace of up to events_per_thread events per thread (0 stops
+// tracing). Events recorded by an earlier trace are dropped.
+inline void stats_trace_start(uint32_t events_per_thread) {
+    StatsRegistry& r = stats_registry();
+    r.trace_capacity.store(0, std::memory_order_release);
+    if (!events_per_thread) return;
+    r.trace_origin_ns.store(stats_now_ns(), std::memory_order_relaxed);
+    r.trace_generation.fetch_add(1, std::memory_order_acq_rel);
+    r.trace_capacity.store(events_per_thread, std::memory_order_release);
+}
+
+// Stops tracing and writes the events of the current trace as Chrome trace
+// JSON ("X" events, microseconds since the trace started, one tid per slot).
+// Must not overlap a stats_trace_start, which lets threads reuse their buffers.
+inline bool stats_trace_dump(const char* path, const char* process_name) {
+    StatsRegistry& r = stats_registry();
+    r.trace_capacity.store(0, std::memory_order_release);
+    if (!r.slots) return false;
+
+    const uint32_t generation = r.trace_generation.load(std::memory_order_acquire);
+    const uint64_t origin = r.trace_origin_ns.load(std::memory_order_relaxed);
+
+    std::string json;
+    char line[256];
+    snprintf(line, sizeof(line), "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+             "\"args\":{\"name\":\"%s\"}}", process_name);
+    json += line;
+    for (uint32_t i = 0; i < NATIVE_STATS_MAX_THREADS; i++) {
+        const StatsSlot& slot = r.slots[i];
+        if (!generation || slot.trace_generation != generation) continue;
+        const uint32_t count = slot.event_count.load(std::memory_order_acquire);
+        for (uint32_t e = 0; e < count; e++) {
+            const TraceEvent& ev = slot.events[e];
+            snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"native\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%.3f,\"dur\":%.3f}", native_stage_name(ev.stage), i,
+                     ev.start_ns >= origin ? (ev.start_ns - origin) / 1000.0 : 0.0, ev.duration_ns / 1000.0);
+            json += line;
+        }
+    }
+    json += "\n]}\n";
+    return write_file(path, json.data(), json.size());
+}
+
+#endif // NATIVE_STATS_H
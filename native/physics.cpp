@@ -0,0 +1,651 @@
+/*
+ * Wiggle physics - native stepper for the wiggle bone solver (extras/physics.py)
+ * Compiled into lol_native.dll alongside lol_native.cpp
+ *
+ * Mirrors the tail solver of the Python frame handlers (move, constrain,
+ * collide and update_matrix) over flat per-bone arrays, and runs a whole
+ * schedule of frame changes in one call so WiggleBake can simulate a range
+ * from poses sampled up front instead of stepping through the handlers.
+ * Matrices are row-major 4x4 like mathutils, acting on column vectors.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "bvh.h"
+#include "platform.h"
+
+// ============================================================================
+// Scene Description
+// ============================================================================
+
+#define WIGGLE_BONE_CHAIN       0x1     // wiggle_chain: corrections are shared with the wiggle parent
+#define WIGGLE_BONE_CONNECTED   0x2     // The wiggle parent is the bone's own connected parent
+
+#define WIGGLE_STEP_RESET       0x1     // bpy.ops.wiggle.reset at this sample
+#define WIGGLE_STEP_HOLD        0x2     // The handlers returned early; the pose is unchanged
+
+// Per-bone float parameters, WIGGLE_PARAM_COUNT per bone
+#define WIGGLE_PARAM_MASS       0
+#define WIGGLE_PARAM_STIFF      1
+#define WIGGLE_PARAM_STRETCH    2
+#define WIGGLE_PARAM_DAMP       3
+#define WIGGLE_PARAM_GRAVITY    4
+#define WIGGLE_PARAM_LENGTH     5       // bone.length (rest, armature space)
+#define WIGGLE_PARAM_RADIUS     6
+#define WIGGLE_PARAM_FRICTION   7
+#define WIGGLE_PARAM_BOUNCE     8
+#define WIGGLE_PARAM_STICKY     9
+#define WIGGLE_PARAM_COUNT      10
+
+typedef struct {
+    uint32_t bone_count;
+    uint32_t sample_count;
+    uint32_t collider_count;
+    uint32_t iterations;            // scene.wiggle.iterations
+    float fps;
+    float gravity[3];               // scene.gravity
+
+    const int32_t* parents;         // bone_count: index of get_parent(b) in the bone list, or -1
+    const uint32_t* flags;          // bone_count: WIGGLE_BONE_*
+    const float* params;            // bone_count * WIGGLE_PARAM_COUNT
+    const uint32_t* collider_offsets;   // bone_count + 1: each bone's range in collider_indices
+    const uint32_t* collider_indices;   // Colliders tested per bone, in order
+
+    const float* object_matrices;   // sample_count * 16: armature matrix_world
+    const float* pose_matrices;     // sample_count * bone_count * 16: matrix_world @ b.matrix with wiggle bones at rest
+    const float* wind;              // sample_count * bone_count * 4: force xyz (dir * strength * wind / mass), wind_factor; or NULL
+    const float* collider_matrices; // sample_count * collider_count * 16: collider matrix_world
+    BVH* const* collider_bvhs;      // sample_count * collider_count: trees in collider local space (NULL: no mesh)
+} WIGGLE_SCENE;
+
+// One frame change; output >= 0 stores the keyed pose in that output slot
+typedef struct {
+    int32_t sample;
+    int32_t frames;                 // frames_elapsed; dt = frames / fps
+    uint32_t flags;                 // WIGGLE_STEP_*
+    int32_t output;
+} WIGGLE_STEP;
+
+// ============================================================================
+// Math
+// ============================================================================
+
+struct Vec3 {
+    float x, y, z;
+
+    Vec3 operator+(const Vec3& o) const { return {x + o.x, y + o.y, z + o.z}; }
+    Vec3 operator-(const Vec3& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    Vec3 operator*(float s) const { return {x * s, y * s, z * s}; }
+    Vec3 operator-() const { return {-x, -y, -z}; }
+    Vec3& operator+=(const Vec3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+    Vec3& operator-=(const Vec3& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    float dot(const Vec3& o) const { return x * o.x + y * o.y + z * o.z; }
+    Vec3 cross(const Vec3& o) const { return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x}; }
+    float length() const { return sqrtf(dot(*this)); }
+    // Like mathutils: a zero vector stays zero
+    Vec3 normalized() const {
+        float l = length();
+        return l > 0.0f ? *this * (1.0f / l) : Vec3{0.0f, 0.0f, 0.0f};
+    }
+};
+
+struct Mat4 {
+    float m[4][4];
+
+    static Mat4 load(const float* src) {
+        Mat4 r;
+        memcpy(r.m, src, sizeof(r.m));
+        return r;
+    }
+    Mat4 operator*(const Mat4& o) const {
+        Mat4 r;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                r.m[i][j] = m[i][0] * o.m[0][j] + m[i][1] * o.m[1][j] + m[i][2] * o.m[2][j] + m[i][3] * o.m[3][j];
+            }
+        }
+        return r;
+    }
+    Vec3 point(const Vec3& v) const {
+        return {m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + m[0][3],
+                m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + m[1][3],
+                m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3]};
+    }
+    Vec3 direction(const Vec3& v) const {
+        return {m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+                m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+                m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z};
+    }
+    Vec3 column(int c) const { return {m[0][c], m[1][c], m[2][c]}; }
+    Vec3 translation() const { return column(3); }
+
+    // Affine inverse (the bottom row is 0 0 0 1 for every matrix here)
+    Mat4 inverted() const {
+        Mat4 r = {};
+        float a = m[0][0], b = m[0][1], c = m[0][2];
+        float d = m[1][0], e = m[1][1], f = m[1][2];
+        float g = m[2][0], h = m[2][1], k = m[2][2];
+        float det = a * (e * k - f * h) - b * (d * k - f * g) + c * (d * h - e * g);
+        float inv = det != 0.0f ? 1.0f / det : 0.0f;
+        r.m[0][0] = (e * k - f * h) * inv;
+        r.m[0][1] = (c * h - b * k) * inv;
+        r.m[0][2] = (b * f - c * e) * inv;
+        r.m[1][0] = (f * g - d * k) * inv;
+        r.m[1][1] = (a * k - c * g) * inv;
+        r.m[1][2] = (c * d - a * f) * inv;
+        r.m[2][0] = (d * h - e * g) * inv;
+        r.m[2][1] = (b * g - a * h) * inv;
+        r.m[2][2] = (a * e - b * d) * inv;
+        Vec3 t = r.direction(translation());
+        r.m[0][3] = -t.x;
+        r.m[1][3] = -t.y;
+        r.m[2][3] = -t.z;
+        r.m[3][3] = 1.0f;
+        return r;
+    }
+};
+
+struct Quat {
+    float w, x, y, z;
+
+    Quat operator*(const Quat& o) const {
+        return {w * o.w - x * o.x - y * o.y - z * o.z,
+                w * o.x + x * o.w + y * o.z - z * o.y,
+                w * o.y - x * o.z + y * o.w + z * o.x,
+                w * o.z + x * o.y - y * o.x + z * o.w};
+    }
+    // Rows of the rotation matrix, as quat_to_mat3 (transposed to row-major)
+    void to_rows(float r[3][3]) const {
+        const float s = 1.41421356f;
+        float q0 = s * w, q1 = s * x, q2 = s * y, q3 = s * z;
+        float qda = q0 * q1, qdb = q0 * q2, qdc = q0 * q3;
+        float qaa = q1 * q1, qab = q1 * q2, qac = q1 * q3;
+        float qbb = q2 * q2, qbc = q2 * q3, qcc = q3 * q3;
+        r[0][0] = 1.0f - qbb - qcc;
+        r[1][0] = qdc + qab;
+        r[2][0] = -qdb + qac;
+        r[0][1] = -qdc + qab;
+        r[1][1] = 1.0f - qaa - qcc;
+        r[2][1] = qda + qbc;
+        r[0][2] = qdb + qac;
+        r[1][2] = -qda + qbc;
+        r[2][2] = 1.0f - qaa - qbb;
+    }
+};
+
+static Quat axis_angle_quat(const Vec3& axis, float angle) {
+    float s = sinf(angle * 0.5f);
+    return {cosf(angle * 0.5f), axis.x * s, axis.y * s, axis.z * s};
+}
+
+// Vector.to_track_quat('Y', 'Z'), following vec_to_quat
+static Quat track_quat_y_z(const Vec3& vec) {
+    float len = vec.length();
+    if (len == 0.0f) return {1.0f, 0.0f, 0.0f, 0.0f};
+
+    Vec3 nor = {vec.z, 0.0f, -vec.x};
+    if (fabsf(vec.x) + fabsf(vec.z) < 1e-4f) nor.z = 1.0f;
+    float co = vec.y / len;
+    co = co < -1.0f ? -1.0f : (co > 1.0f ? 1.0f : co);
+    Quat q = axis_angle_quat(nor.normalized(), acosf(co));
+
+    // Roll about the track axis so local Z stays as close to up as possible
+    float rows[3][3];
+    q.to_rows(rows);
+    float angle = 0.5f * atan2f(rows[0][2], rows[2][2]);
+    float si = sinf(angle) / len;
+    Quat roll = {cosf(angle), vec.x * si, vec.y * si, vec.z * si};
+    return roll * q;
+}
+
+// Rotation from a's direction to b's direction applied to v (Vector.rotation_difference)
+static Vec3 rotate_between(const Vec3& a, const Vec3& b, const Vec3& v) {
+    Vec3 na = a.normalized(), nb = b.normalized();
+    Vec3 axis = na.cross(nb);
+    float s = axis.length();
+    float c = na.dot(nb);
+    if (s <= 1.1920929e-7f) {
+        if (c > 0.0f) return v;
+        // Opposed: half turn about any perpendicular axis
+        axis = fabsf(na.x) < 0.9f ? Vec3{1.0f, 0.0f, 0.0f}.cross(na) : Vec3{0.0f, 1.0f, 0.0f}.cross(na);
+        axis = axis.normalized();
+        return axis * (2.0f * axis.dot(v)) - v;
+    }
+    axis = axis * (1.0f / s);
+    // Rodrigues
+    return v * c + axis.cross(v) * s + axis * (axis.dot(v) * (1.0f - c));
+}
+
+// Matrix.LocRotScale(t, rotation of m, size) as used by constrain
+static Mat4 loc_rot_scale(const Vec3& t, const Mat4& m, const Vec3& size) {
+    Mat4 r = {};
+    for (int c = 0; c < 3; c++) {
+        Vec3 axis = m.column(c).normalized();
+        float s = c == 0 ? size.x : (c == 1 ? size.y : size.z);
+        r.m[0][c] = axis.x * s;
+        r.m[1][c] = axis.y * s;
+        r.m[2][c] = axis.z * s;
+    }
+    r.m[0][3] = t.x;
+    r.m[1][3] = t.y;
+    r.m[2][3] = t.z;
+    r.m[3][3] = 1.0f;
+    return r;
+}
+
+static Vec3 column_lengths(const Mat4& m) {
+    return {m.column(0).length(), m.column(1).length(), m.column(2).length()};
+}
+
+// ============================================================================
+// Solver
+// ============================================================================
+
+struct WiggleSolver {
+    const WIGGLE_SCENE& scene;
+    uint32_t n;
+
+    std::vector<Vec3> position, position_last, velocity;
+    std::vector<Vec3> collision_point, collision_normal;
+    std::vector<int32_t> collision_ob;         // Collider index or -1
+    std::vector<Mat4> matrix;                  // b.wiggle.matrix
+    std::vector<Quat> basis_rotation;          // Local pose written by update_matrix(last=True)
+    std::vector<float> basis_scale;
+
+    // Current sample
+    const float* pose = nullptr;
+    Mat4 object_inverse = {};
+    uint32_t sample = 0;
+    float dt = 0.0f;
+
+    explicit WiggleSolver(const WIGGLE_SCENE& s)
+        : scene(s), n(s.bone_count), position(n), position_last(n), velocity(n), collision_point(n),
+          collision_normal(n), collision_ob(n, -1), matrix(n), basis_rotation(n, Quat{1.0f, 0.0f, 0.0f, 0.0f}),
+          basis_scale(n, 1.0f) {}
+
+    float param(uint32_t b, int p) const { return scene.params[(size_t)b * WIGGLE_PARAM_COUNT + p]; }
+    Mat4 rest(uint32_t b) const { return Mat4::load(pose + (size_t)b * 16); }
+
+    void set_sample(uint32_t s) {
+        sample = s;
+        pose = scene.pose_matrices + (size_t)s * n * 16;
+        object_inverse = Mat4::load(scene.object_matrices + (size_t)s * 16).inverted();
+    }
+
+    // p.wiggle.matrix @ relative_matrix(p.matrix, b.matrix), or the animated pose for roots
+    Mat4 frame_matrix(uint32_t b) const {
+        int32_t p = scene.parents[b];
+        if (p < 0) return rest(b);
+        return matrix[p] * (rest((uint32_t)p).inverted() * rest(b));
+    }
+
+    float length_world(uint32_t b) const { return rest(b).column(1).length() * param(b, WIGGLE_PARAM_LENGTH); }
+
+    void reset() {
+        for (uint32_t b = 0; b < n; b++) {
+            Mat4 r = rest(b);
+            position[b] = position_last[b] = r.point({0.0f, param(b, WIGGLE_PARAM_LENGTH), 0.0f});
+            velocity[b] = collision_normal[b] = {0.0f, 0.0f, 0.0f};
+            matrix[b] = r;
+            basis_rotation[b] = {1.0f, 0.0f, 0.0f, 0.0f};
+            basis_scale[b] = 1.0f;
+        }
+    }
+
+    void update_matrix(uint32_t b, bool last) {
+        Mat4 m2 = frame_matrix(b);
+        Vec3 vec = m2.inverted().point(position[b]);
+        Quat q = track_quat_y_z(vec);
+        float sy = vec.length() / param(b, WIGGLE_PARAM_LENGTH);
+
+        float rows[3][3];
+        q.to_rows(rows);
+        Mat4 rot_scale = {};
+        for (int r = 0; r < 3; r++) {
+            rot_scale.m[r][0] = rows[r][0];
+            rot_scale.m[r][1] = rows[r][1] * sy;
+            rot_scale.m[r][2] = rows[r][2];
+        }
+        rot_scale.m[3][3] = 1.0f;
+        matrix[b] = m2 * rot_scale;
+        if (last) {
+            basis_rotation[b] = q;
+            basis_scale[b] = sy;
+        }
+    }
+
+    void collide(uint32_t b) {
+        const float radius = param(b, WIGGLE_PARAM_RADIUS);
+        const float sticky = param(b, WIGGLE_PARAM_STICKY);
+        const float friction = param(b, WIGGLE_PARAM_FRICTION);
+        Vec3 pos = position[b];
+        int32_t co = collision_ob[b];
+        bool hit_any = false;
+
+        for (uint32_t k = scene.collider_offsets[b]; k < scene.collider_offsets[b + 1]; k++) {
+            uint32_t c = scene.collider_indices[k];
+            size_t slot = (size_t)sample * scene.collider_count + c;
+            const BVH* bvh = scene.collider_bvhs[slot];
+            if (!bvh) continue;
+
+            Mat4 cmw = Mat4::load(scene.collider_matrices + slot * 16);
+            Mat4 inv = cmw.inverted();
+            Vec3 local = inv.point(pos);
+            BVH_HIT hit;
+            bvh_closest_one(*bvh, &local.x, INFINITY, hit);
+            if (hit.primitive < 0) continue;
+
+            Vec3 n = loc_rot_scale({0.0f, 0.0f, 0.0f}, cmw, {1.0f, 1.0f, 1.0f})
+                         .direction({hit.normal[0], hit.normal[1], hit.normal[2]})
+                         .normalized();
+            Vec3 i = cmw.point({hit.point[0], hit.point[1], hit.point[2]});
+            Vec3 v = i - pos;
+            Vec3 vn = v.normalized();
+            float len = v.length();
+
+            if (n.dot(vn) > 0.01f || len < radius || (co >= 0 && len < radius + sticky)) {
+                Vec3 nv = n.dot(vn) > 0.0f ? vn : -vn;
+                pos = i + nv * radius;
+                if (co >= 0) {
+                    size_t prev = (size_t)sample * scene.collider_count + (uint32_t)co;
+                    Vec3 anchor = Mat4::load(scene.collider_matrices + prev * 16).point(collision_point[b]);
+                    pos = pos + (anchor - pos) * friction;
+                }
+                hit_any = true;
+                co = (int32_t)c;
+                collision_point[b] = inv.point(pos);
+                collision_normal[b] = nv;
+            }
+        }
+        if (!hit_any) co = -1;
+        position[b] = pos;
+        collision_ob[b] = co;
+    }
+
+    void move(uint32_t b) {
+        float damp = 1.0f - param(b, WIGGLE_PARAM_DAMP) * dt;
+        damp = damp < 0.0f ? 0.0f : (damp > 1.0f ? 1.0f : damp);
+        velocity[b] = velocity[b] * damp;
+
+        float g = param(b, WIGGLE_PARAM_GRAVITY);
+        Vec3 force = {scene.gravity[0] * g, scene.gravity[1] * g, scene.gravity[2] * g};
+        if (scene.wind) {
+            const float* w = scene.wind + ((size_t)sample * n + b) * 4;
+            Vec3 wind = {w[0], w[1], w[2]};
+            if (wind.dot(wind) > 0.0f) {
+                float fac = 1.0f - w[3] * fabsf(wind.normalized().dot((position[b] - matrix[b].translation()).normalized()));
+                force += wind * fac;
+            }
+        }
+        position[b] += velocity[b] + force * (dt * dt);
+        collide(b);
+        update_matrix(b, false);
+    }
+
+    Vec3 spring(const Vec3& target, const Vec3& pos, float stiff) const {
+        Vec3 s = target - pos;
+        Vec3 fs = s * (stiff / (float)scene.iterations) * (dt * dt);
+        return fs.length() > s.length() ? s : fs;
+    }
+
+    static float get_fac(float mass1, float mass2) { return mass1 == mass2 ? 0.5f : mass1 / (mass1 + mass2); }
+
+    // Moves the wiggle parent p so that the child's anchor point follows a correction of the chain
+    void swing_parent(uint32_t p, const Vec3& from, const Vec3& to) {
+        Vec3 origin = matrix[p].translation();
+        Vec3 v1 = from - origin, v2 = to - origin;
+        float l1 = v1.length();
+        if (l1 == 0.0f) return;
+        position[p] = origin + rotate_between(v1, v2, position[p] - origin) * (v2.length() / l1);
+    }
+
+    void constrain(uint32_t b, uint32_t i) {
+        const int32_t p = scene.parents[b];
+        const uint32_t flags = scene.flags[b];
+        const float length = param(b, WIGGLE_PARAM_LENGTH);
+        const bool chain = p >= 0 && (flags & WIGGLE_BONE_CHAIN);
+        bool update_p = false;
+
+        Mat4 mat = frame_matrix(b);
+        mat = loc_rot_scale(mat.translation(), mat, column_lengths(object_inverse * rest(b)));
+
+        // Spring towards the animated tail
+        Vec3 target = mat.point({0.0f, length, 0.0f});
+        Vec3 s = spring(target, position[b], param(b, WIGGLE_PARAM_STIFF));
+        if (chain) {
+            float fac = i == 0 ? param((uint32_t)p, WIGGLE_PARAM_STRETCH)
+                               : get_fac(param(b, WIGGLE_PARAM_MASS), param((uint32_t)p, WIGGLE_PARAM_MASS));
+            if (flags & WIGGLE_BONE_CONNECTED) {
+                position[p] -= s * fac;
+            } else {
+                Vec3 head = matrix[b].translation();
+                Vec3 tail = matrix[b].point({0.0f, length, 0.0f});
+                Vec3 mid = (head + tail) * 0.5f;
+                Vec3 moved = (head + tail - s * fac) * 0.5f;
+                swing_parent((uint32_t)p, mid, moved);
+            }
+            position[b] += s * (1.0f - fac);
+            update_p = true;
+        } else {
+            position[b] += s;
+        }
+
+        // Stretch back to the bone's length
+        Vec3 origin = mat.translation();
+        target = origin + (position[b] - origin).normalized() * length_world(b);
+        s = (target - position[b]) * (1.0f - param(b, WIGGLE_PARAM_STRETCH));
+        if (chain) {
+            float fac = i == 0 ? param((uint32_t)p, WIGGLE_PARAM_STRETCH)
+                               : get_fac(param(b, WIGGLE_PARAM_MASS), param((uint32_t)p, WIGGLE_PARAM_MASS));
+            if (flags & WIGGLE_BONE_CONNECTED) {
+                position[p] -= s * fac;
+            } else {
+                Vec3 head = matrix[b].translation();
+                swing_parent((uint32_t)p, head, head - s * fac);
+            }
+            position[b] += s * (1.0f - fac);
+            update_p = true;
+        } else {
+            position[b] += s;
+        }
+
+        if (update_p) {
+            collide((uint32_t)p);
+            update_matrix((uint32_t)p, false);
+        }
+        collide(b);
+        update_matrix(b, false);
+    }
+
+    void step(const WIGGLE_STEP& st) {
+        set_sample((uint32_t)st.sample);
+        if (st.flags & WIGGLE_STEP_RESET) {
+            reset();
+            return;
+        }
+        if (st.flags & WIGGLE_STEP_HOLD) return;
+
+        dt = (float)st.frames / scene.fps;
+        for (uint32_t b = 0; b < n; b++) collision_normal[b] = {0.0f, 0.0f, 0.0f};
+        for (uint32_t b = 0; b < n; b++) {
+            if (dt != 0.0f) {
+                move(b);
+            }
+        }
+        for (uint32_t it = 0; it < scene.iterations; it++) {
+            for (uint32_t b = 0; b < n; b++) {
+                if (dt != 0.0f) {
+                    constrain(b, scene.iterations - 1 - it);
+                } else {
+                    update_matrix(b, false);
+                }
+            }
+        }
+        for (uint32_t b = 0; b < n; b++) update_matrix(b, true);
+
+        if (st.frames) {
+            for (uint32_t b = 0; b < n; b++) {
+                Vec3 bounce = {0.0f, 0.0f, 0.0f};
+                Vec3 cn = collision_normal[b];
+                if (cn.dot(cn) > 0.0f) {
+                    Vec3 u = cn.normalized();
+                    bounce = u * (-velocity[b].dot(u) * param(b, WIGGLE_PARAM_BOUNCE));
+                }
+                velocity[b] = (position[b] - position_last[b]) * (1.0f / (float)st.frames) + bounce;
+                position_last[b] = position[b];
+            }
+        }
+    }
+};
+
+static int wiggle_check_scene(const WIGGLE_SCENE* scene) {
+    if (!scene->bone_count || !scene->sample_count || !scene->iterations || !(scene->fps > 0.0f)) return -5;
+    if (!scene->parents || !scene->flags || !scene->params || !scene->collider_offsets) return -5;
+    if (!scene->object_matrices || !scene->pose_matrices) return -5;
+
+    const uint32_t n = scene->bone_count;
+    for (uint32_t b = 0; b < n; b++) {
+        int32_t p = scene->parents[b];
+        if (p >= (int32_t)n || p == (int32_t)b || !(scene->params[(size_t)b * WIGGLE_PARAM_COUNT + WIGGLE_PARAM_LENGTH] > 0.0f)) return -5;
+        if (scene->collider_offsets[b] > scene->collider_offsets[b + 1]) return -5;
+    }
+    if (scene->collider_offsets[n]) {
+        if (!scene->collider_indices || !scene->collider_matrices || !scene->collider_bvhs) return -5;
+        for (uint32_t k = 0; k < scene->collider_offsets[n]; k++) {
+            if (scene->collider_indices[k] >= scene->collider_count) return -5;
+        }
+    }
+    return 0;
+}
+
+static int wiggle_check_steps(const WIGGLE_SCENE& scene, const WIGGLE_STEP* steps, uint32_t step_count,
+                              uint32_t output_count, const float* out_rotations, const float* out_scales) {
+    if (!steps || !step_count) return -5;
+    if (output_count && (!out_rotations || !out_scales)) return -5;
+    for (uint32_t s = 0; s < step_count; s++) {
+        if (steps[s].sample < 0 || (uint32_t)steps[s].sample >= scene.sample_count || steps[s].frames < 0) return -5;
+        if (steps[s].output >= (int32_t)output_count) return -5;
+    }
+    return 0;
+}
+
+static void wiggle_run_steps(WiggleSolver& solver, const WIGGLE_STEP* steps, uint32_t step_count,
+                             float* out_rotations, float* out_scales) {
+    const uint32_t n = solver.n;
+    for (uint32_t s = 0; s < step_count; s++) {
+        solver.step(steps[s]);
+        if (steps[s].output < 0) continue;
+        size_t base = (size_t)steps[s].output * n;
+        for (uint32_t b = 0; b < n; b++) {
+            const Quat& q = solver.basis_rotation[b];
+            float* dst = out_rotations + (base + b) * 4;
+            dst[0] = q.w;
+            dst[1] = q.x;
+            dst[2] = q.y;
+            dst[3] = q.z;
+            out_scales[base + b] = solver.basis_scale[b];
+        }
+    }
+}
+
+/*
+ * Simulate a schedule of frame changes for one armature's wiggle bones
+ *
+ * Parameters:
+ *   scene          - Bones, parameters, sampled poses and colliders
+ *   steps          - step_count frame changes, applied in order; the first must reset
+ *   step_count     - Number of steps
+ *   output_count   - Number of output slots referenced by steps
+ *   out_rotations  - Receives output_count * bone_count quaternions (w, x, y, z):
+ *                    each bone's rotation_quaternion after the step
+ *   out_scales     - Receives output_count * bone_count Y scales (X and Z stay 1)
+ *
+ * Kept as the one-call form of wiggle_solver_create / _run / _free, for
+ * callers that can hold every sample's poses and collider trees at once;
+ * the add-on's bake uses the solver so it can free them as it goes.
+ *
+ * Returns:
+ *   0 on success, -4 if out of memory, -5 on invalid arguments
+ */
+DLL_EXPORT int wiggle_simulate(const WIGGLE_SCENE* scene, const WIGGLE_STEP* steps, uint32_t step_count,
+                               uint32_t output_count, float* out_rotations, float* out_scales) {
+    if (!scene || wiggle_check_scene(scene) != 0) return -5;
+    if (wiggle_check_steps(*scene, steps, step_count, output_count, out_rotations, out_scales) != 0) return -5;
+    if (!(steps[0].flags & WIGGLE_STEP_RESET)) return -5;
+
+    try {
+        WiggleSolver solver(*scene);
+        for (size_t o = 0; o < (size_t)output_count * scene->bone_count; o++) {
+            out_rotations[o * 4] = 1.0f;
+            out_rotations[o * 4 + 1] = out_rotations[o * 4 + 2] = out_rotations[o * 4 + 3] = 0.0f;
+            out_scales[o] = 1.0f;
+        }
+        wiggle_run_steps(solver, steps, step_count, out_rotations, out_scales);
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+// Solver state carried between wiggle_solver_run calls. The scene is copied;
+// the arrays it points to stay the caller's.
+struct WIGGLE_SOLVER {
+    WIGGLE_SCENE scene;
+    WiggleSolver solver;
+    bool started = false;
+
+    explicit WIGGLE_SOLVER(const WIGGLE_SCENE& s) : scene(s), solver(scene) {}
+};
+
+/*
+ * Create a solver that runs a schedule in several calls
+ *
+ * Same scene as wiggle_simulate. Samples are only read by the steps that
+ * use them, so the caller may fill a sample's poses and collider trees just
+ * before the wiggle_solver_run call that reaches it, and free the trees once
+ * no later step uses that sample.
+ *
+ * Returns:
+ *   0 on success, -4 if out of memory, -5 on invalid arguments
+ */
+DLL_EXPORT int wiggle_solver_create(const WIGGLE_SCENE* scene, WIGGLE_SOLVER** out_solver) {
+    if (!out_solver) return -5;
+    *out_solver = nullptr;
+    if (!scene || wiggle_check_scene(scene) != 0) return -5;
+
+    try {
+        *out_solver = new WIGGLE_SOLVER(*scene);
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Apply the next steps of a schedule
+ *
+ * Same parameters as wiggle_simulate, continuing from the solver's previous
+ * call; the first step of the first call must reset. Output slots that no
+ * step writes are left unchanged.
+ *
+ * Returns:
+ *   0 on success, -5 on invalid arguments
+ */
+DLL_EXPORT int wiggle_solver_run(WIGGLE_SOLVER* solver, const WIGGLE_STEP* steps, uint32_t step_count,
+                                 uint32_t output_count, float* out_rotations, float* out_scales) {
+    if (!solver) return -5;
+    if (wiggle_check_steps(solver->scene, steps, step_count, output_count, out_rotations, out_scales) != 0) return -5;
+    if (!solver->started && !(steps[0].flags & WIGGLE_STEP_RESET)) return -5;
+
+    solver->started = true;
+    wiggle_run_steps(solver->solver, steps, step_count, out_rotations, out_scales);
+    return 0;
+}
+
+DLL_EXPORT void wiggle_solver_free(WIGGLE_SOLVER* solver) {
+    delete solver;
+}
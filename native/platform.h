@@ -0,0 +1,160 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+/*
+ * What differs between the Windows (.dll) and Linux / macOS (.so / .dylib)
+ * builds of the native libraries: export declarations, opening UTF-8 paths
+ * with stdio and, for the C sources, threads and atomic counters. C++
+ * sources map files with file_map.h and use std::thread (thread_pool.h).
+ *
+ * Usable from C and C++.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+    #define PLATFORM_EXTERN_C extern "C"
+#else
+    #define PLATFORM_EXTERN_C
+#endif
+
+// Exported with an unmangled name; the same C ABI on every platform
+#ifdef _WIN32
+    #ifdef BUILD_DLL
+        #define DLL_EXPORT PLATFORM_EXTERN_C __declspec(dllexport)
+    #else
+        #define DLL_EXPORT PLATFORM_EXTERN_C __declspec(dllimport)
+    #endif
+#else
+    #define DLL_EXPORT PLATFORM_EXTERN_C __attribute__((visibility("default")))
+#endif
+
+// fopen for a UTF-8 path (Windows fopen takes the ANSI code page), NULL on failure
+static inline FILE* fopen_utf8(const char* path, const char* mode) {
+#ifdef _WIN32
+    wchar_t wpath[MAX_PATH * 4];
+    wchar_t wmode[8];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, MAX_PATH * 4) == 0) return NULL;
+    if (MultiByteToWideChar(CP_UTF8, 0, mode, -1, wmode, 8) == 0) return NULL;
+    return _wfopen(wpath, wmode);
+#else
+    return fopen(path, mode);
+#endif
+}
+
+static inline uint32_t platform_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1;
+#endif
+}
+
+static inline uint32_t platform_process_id(void) {
+#ifdef _WIN32
+    return (uint32_t)GetCurrentProcessId();
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+#ifndef _WIN32
+// Modification time of a stat result in nanoseconds (macOS names the field
+// st_mtimespec)
+static inline uint64_t platform_stat_mtime_ns(const struct stat* st) {
+#ifdef __APPLE__
+    return (uint64_t)st->st_mtimespec.tv_sec * 1000000000ull + (uint64_t)st->st_mtimespec.tv_nsec;
+#else
+    return (uint64_t)st->st_mtim.tv_sec * 1000000000ull + (uint64_t)st->st_mtim.tv_nsec;
+#endif
+}
+#endif
+
+// Index of the highest set bit of a non-zero x
+static inline uint32_t platform_bit_scan_reverse(uint32_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, x);
+    return (uint32_t)index;
+#else
+    return 31u - (uint32_t)__builtin_clz(x);
+#endif
+}
+
+// ============================================================================
+// Threads and atomics for the C sources
+// ============================================================================
+
+// Thread functions are declared with PLATFORM_THREAD_PROC(name, arg) and
+// return 0
+#ifdef _WIN32
+    typedef HANDLE platform_thread;
+    #define PLATFORM_THREAD_PROC(name, arg) DWORD WINAPI name(LPVOID arg)
+    typedef LPTHREAD_START_ROUTINE platform_thread_proc;
+#else
+    typedef pthread_t platform_thread;
+    #define PLATFORM_THREAD_PROC(name, arg) void* name(void* arg)
+    typedef void* (*platform_thread_proc)(void*);
+#endif
+
+// Returns 0 if the thread couldn't be started
+static inline int platform_thread_start(platform_thread* thread, platform_thread_proc proc, void* arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, proc, arg, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, proc, arg) == 0;
+#endif
+}
+
+static inline void platform_thread_join(platform_thread thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// Mutex usable as a static: static platform_mutex m = PLATFORM_MUTEX_INIT;
+#ifdef _WIN32
+    typedef SRWLOCK platform_mutex;
+    #define PLATFORM_MUTEX_INIT SRWLOCK_INIT
+    static inline void platform_mutex_lock(platform_mutex* m) { AcquireSRWLockExclusive(m); }
+    static inline void platform_mutex_unlock(platform_mutex* m) { ReleaseSRWLockExclusive(m); }
+#else
+    typedef pthread_mutex_t platform_mutex;
+    #define PLATFORM_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+    static inline void platform_mutex_lock(platform_mutex* m) { pthread_mutex_lock(m); }
+    static inline void platform_mutex_unlock(platform_mutex* m) { pthread_mutex_unlock(m); }
+#endif
+
+// Atomically adds 1 to *value and returns the new value
+static inline long platform_atomic_increment(volatile long* value) {
+#ifdef _WIN32
+    return InterlockedIncrement(value);
+#else
+    return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+#endif // PLATFORM_H
@@ -1,64 +1,165 @@
 /*
  * Ritoddstex DLL - Fast TEX to DDS conversion for Blender addon
  * Exports functions callable from Python via ctypes
+ * The conversion itself is in tex_dds.c, which lol_native.dll shares
  */
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
+// stat times, utimensat, realpath etc. also under a strict -std=c11
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+    #define _XOPEN_SOURCE 700
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
-#include "dds.h"
-#include "tex.h"
+#include "platform.h"
+#include "tex_dds.h"
+#include "xxhash64.h"
+
+#ifdef _WIN32
+    #include <wctype.h>
+#else
+    #include <dirent.h>
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <limits.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <time.h>
+#endif
 
-// DLL export macro
-#ifdef BUILD_DLL
-    #define DLL_EXPORT __declspec(dllexport)
+// Read-only view of a whole file
+typedef struct {
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
 #else
-    #define DLL_EXPORT __declspec(dllimport)
+    int fd;
 #endif
+    const uint8_t* data;
+    uint64_t size;
+} TEX_MAPPING;
+
+#ifdef _WIN32
+static int map_tex_file(const char* tex_path, TEX_MAPPING* map) {
+    WCHAR wpath[MAX_PATH * 4];
+    LARGE_INTEGER file_size;
 
-// Helper: max macro
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
+    map->file = INVALID_HANDLE_VALUE;
+    map->mapping = NULL;
+    map->data = NULL;
+    map->size = 0;
+
+    if (MultiByteToWideChar(CP_UTF8, 0, tex_path, -1, wpath, MAX_PATH * 4) == 0) {
+        return 0;
+    }
 
-// Helper: count leading zeros (replacement for __builtin_clz)
-static inline uint32_t clz32(uint32_t x) {
-    unsigned long index;
-    if (_BitScanReverse(&index, x)) {
-        return 31 - index;
+    map->file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) {
+        return 0;
     }
-    return 32;
+
+    if (!GetFileSizeEx(map->file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(map->file);
+        map->file = INVALID_HANDLE_VALUE;
+        return 0;
+    }
+
+    map->mapping = CreateFileMappingW(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (map->mapping) {
+        map->data = (const uint8_t*)MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!map->data) {
+        if (map->mapping) CloseHandle(map->mapping);
+        CloseHandle(map->file);
+        map->mapping = NULL;
+        map->file = INVALID_HANDLE_VALUE;
+        return 0;
+    }
+
+    map->size = (uint64_t)file_size.QuadPart;
+    return 1;
 }
 
-// Helper: calculate mipmap count
-static inline uint32_t calc_mipmap_count(uint32_t width, uint32_t height) {
-    uint32_t max_dim = MAX(width, height);
-    return 32 - clz32(max_dim);
+static void unmap_tex_file(TEX_MAPPING* map) {
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->mapping) CloseHandle(map->mapping);
+    if (map->file != INVALID_HANDLE_VALUE) CloseHandle(map->file);
+    map->data = NULL;
+    map->mapping = NULL;
+    map->file = INVALID_HANDLE_VALUE;
 }
+#else
+static int map_tex_file(const char* tex_path, TEX_MAPPING* map) {
+    struct stat st;
+    void* data;
 
-// Get bytes per block for format
-static int get_bytes_per_block(uint8_t format) {
-    switch (format) {
-        case TEX_FORMAT_DXT1:  return 8;
-        case TEX_FORMAT_DXT5:  return 16;
-        case TEX_FORMAT_BGRA8: return 4;
-        case TEX_FORMAT_RGBA16: return 8;
-        default: return 0;
+    map->data = NULL;
+    map->size = 0;
+
+    map->fd = open(tex_path, O_RDONLY);
+    if (map->fd < 0) {
+        return 0;
+    }
+
+    if (fstat(map->fd, &st) != 0 || st.st_size <= 0) {
+        close(map->fd);
+        map->fd = -1;
+        return 0;
+    }
+
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, map->fd, 0);
+    if (data == MAP_FAILED) {
+        close(map->fd);
+        map->fd = -1;
+        return 0;
     }
+
+    map->data = (const uint8_t*)data;
+    map->size = (uint64_t)st.st_size;
+    return 1;
 }
 
-// Get block size for format
-static int get_block_size(uint8_t format) {
-    switch (format) {
-        case TEX_FORMAT_DXT1:
-        case TEX_FORMAT_DXT5:
-            return 4;
-        case TEX_FORMAT_BGRA8:
-        case TEX_FORMAT_RGBA16:
-            return 1;
-        default: return 1;
+static void unmap_tex_file(TEX_MAPPING* map) {
+    if (map->data) munmap((void*)map->data, (size_t)map->size);
+    if (map->fd >= 0) close(map->fd);
+    map->data = NULL;
+    map->size = 0;
+    map->fd = -1;
+}
+#endif
+
+/*
+ * Convert tex_path into out_buf when given (capacity bytes), otherwise into
+ * a malloc'd buffer returned through out_alloc.
+ *
+ * The file is memory-mapped and its mips are reordered straight from the
+ * mapping into the single output buffer. Files that can't be mapped are
+ * read with stdio, one mip at a time, into the same buffer.
+ */
+static int tex_convert_file(const char* tex_path, uint8_t* out_buf, uint32_t capacity,
+                            uint8_t** out_alloc, uint32_t* out_size) {
+    TEX_MAPPING map;
+    FILE* tex_file;
+    TEX_HEADER tex_header;
+    uint64_t file_size;
+    int rc;
+
+    if (map_tex_file(tex_path, &map)) {
+        rc = tex_dds_convert(map.data, map.size, out_buf, capacity, out_alloc, out_size);
+        unmap_tex_file(&map);
+        return rc;
     }
+
+    rc = tex_open_stdio(tex_path, &tex_file, &tex_header, &file_size);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = tex_dds_convert_stdio(tex_file, &tex_header, file_size, out_buf, capacity, out_alloc, out_size);
+    fclose(tex_file);
+    return rc;
 }
 
 /*
@@ -77,166 +178,740 @@ static int get_block_size(uint8_t format) {
  *   -4: Memory allocation failed
  */
 DLL_EXPORT int tex_to_dds_bytes(const char* tex_path, uint8_t** out_data, uint32_t* out_size) {
-    FILE* tex_file = fopen(tex_path, "rb");
-    if (!tex_file) {
-        return -1; // Failed to open
+    return tex_convert_file(tex_path, NULL, 0, out_data, out_size);
+}
+
+/*
+ * Get the size of the DDS data tex_to_dds_into will write for a TEX file.
+ * Only the TEX header is read.
+ *
+ * Returns:
+ *   0 on success, or the tex_to_dds_bytes error codes -1, -2, -3
+ */
+DLL_EXPORT int tex_to_dds_query(const char* tex_path, uint32_t* out_size) {
+    return tex_dds_query(tex_path, out_size);
+}
+
+/*
+ * Convert TEX file to DDS bytes in a caller-supplied buffer
+ *
+ * Parameters:
+ *   tex_path  - Path to the .tex file (UTF-8)
+ *   out_buf   - Destination buffer, sized with tex_to_dds_query
+ *   capacity  - Size of out_buf in bytes
+ *   out_size  - Optional, receives the DDS size (also set when out_buf is too small)
+ *
+ * Returns:
+ *   0 on success, the tex_to_dds_bytes error codes, or
+ *   -6: out_buf is smaller than the DDS data
+ */
+DLL_EXPORT int tex_to_dds_into(const char* tex_path, uint8_t* out_buf, uint32_t capacity, uint32_t* out_size) {
+    if (!out_buf) {
+        return -6;
     }
+    return tex_convert_file(tex_path, out_buf, capacity, NULL, out_size);
+}
+
+/*
+ * Convert an in-memory TEX file to DDS bytes
+ *
+ * Parameters:
+ *   src       - TEX file contents
+ *   src_len   - Size of src in bytes
+ *   out_data  - Pointer to receive allocated DDS data (caller must free with free_dds_bytes)
+ *   out_size  - Pointer to receive size of DDS data
+ *
+ * Returns:
+ *   0 on success, or the tex_to_dds_bytes error codes -2, -3, -4
+ */
+DLL_EXPORT int tex_to_dds_from_memory(const uint8_t* src, uint32_t src_len, uint8_t** out_data, uint32_t* out_size) {
+    return tex_dds_convert(src, src_len, NULL, 0, out_data, out_size);
+}
 
-    // Get file size
-    fseek(tex_file, 0, SEEK_END);
-    uint32_t file_size = (uint32_t)ftell(tex_file);
-    rewind(tex_file);
+// Upper bound on batch worker threads (MAXIMUM_WAIT_OBJECTS on Windows)
+#define TEX_BATCH_MAX_THREADS 64
 
-    // Read and validate TEX header
-    TEX_HEADER tex_header;
-    if (file_size < sizeof(TEX_HEADER) ||
-        fread(&tex_header, sizeof(TEX_HEADER), 1, tex_file) != 1 ||
-        memcmp(tex_header.magic, TEX_MAGIC, 3) != 0) {
-        fclose(tex_file);
-        return -2; // Invalid TEX
+// Shared state for one tex_to_dds_batch call
+typedef struct {
+    const char* const* tex_paths;
+    uint8_t** out_data;
+    uint32_t* out_sizes;
+    int32_t* results;
+    long count;
+    volatile long next;
+    volatile long failed;
+} TEX_BATCH;
+
+// Worker: pulls the next unconverted index until the batch is drained
+static PLATFORM_THREAD_PROC(tex_batch_worker, param) {
+    TEX_BATCH* batch = (TEX_BATCH*)param;
+    long i;
+
+    while ((i = platform_atomic_increment(&batch->next) - 1) < batch->count) {
+        int rc = -1;
+        batch->out_data[i] = NULL;
+        batch->out_sizes[i] = 0;
+        if (batch->tex_paths[i]) {
+            rc = tex_to_dds_bytes(batch->tex_paths[i], &batch->out_data[i], &batch->out_sizes[i]);
+        }
+        batch->results[i] = rc;
+        if (rc != 0) {
+            platform_atomic_increment(&batch->failed);
+        }
     }
+    return 0;
+}
 
-    // Setup DDS pixel format
-    DDS_PIXELFORMAT ddspf = {0};
-    ddspf.dwSize = sizeof(DDS_PIXELFORMAT);
+/*
+ * Convert many TEX files to DDS bytes in parallel
+ *
+ * Parameters:
+ *   tex_paths   - Array of count paths to .tex files (UTF-8)
+ *   count       - Number of paths
+ *   out_data    - Array of count pointers receiving DDS data (free each with free_dds_bytes)
+ *   out_sizes   - Array of count sizes of the DDS data
+ *   results     - Array of count per-file status codes (same codes as tex_to_dds_bytes)
+ *   max_threads - Upper bound on worker threads, 0 = one per core
+ *
+ * Returns:
+ *   Number of files that failed to convert, or -5 on invalid arguments.
+ *   Failed entries have out_data[i] = NULL and out_sizes[i] = 0.
+ */
+DLL_EXPORT int tex_to_dds_batch(const char* const* tex_paths, uint32_t count,
+                                uint8_t** out_data, uint32_t* out_sizes,
+                                int32_t* results, uint32_t max_threads) {
+    platform_thread threads[TEX_BATCH_MAX_THREADS];
+    TEX_BATCH batch;
+    uint32_t thread_count;
+    uint32_t started = 0;
+    uint32_t i;
 
-    const char* fourcc = NULL;
-    int need_dx10 = 0;
+    if (count == 0) {
+        return 0;
+    }
+    if (!tex_paths || !out_data || !out_sizes || !results || count > 0x7fffffff) {
+        return -5;
+    }
 
-    switch (tex_header.tex_format) {
-        case TEX_FORMAT_DXT1:
-            fourcc = "DXT1";
-            ddspf.dwFlags = DDS_FOURCC;
-            break;
-        case TEX_FORMAT_DXT5:
-            fourcc = "DXT5";
-            ddspf.dwFlags = DDS_FOURCC;
-            break;
-        case TEX_FORMAT_BGRA8:
-            ddspf.dwFlags = DDS_RGBA;
-            ddspf.dwRGBBitCount = 32;
-            ddspf.dwBBitMask = 0x000000ff;
-            ddspf.dwGBitMask = 0x0000ff00;
-            ddspf.dwRBitMask = 0x00ff0000;
-            ddspf.dwABitMask = 0xff000000;
-            break;
-        case TEX_FORMAT_RGBA16:
-            // DX10 extended format - simplified handling
-            fourcc = "DX10";
-            ddspf.dwFlags = DDS_FOURCC;
-            need_dx10 = 1;
+    batch.tex_paths = tex_paths;
+    batch.out_data = out_data;
+    batch.out_sizes = out_sizes;
+    batch.results = results;
+    batch.count = (long)count;
+    batch.next = 0;
+    batch.failed = 0;
+
+    if (max_threads == 0) {
+        max_threads = platform_cpu_count();
+    }
+    thread_count = max_threads;
+    if (thread_count > count) thread_count = count;
+    if (thread_count > TEX_BATCH_MAX_THREADS) thread_count = TEX_BATCH_MAX_THREADS;
+
+    // The calling thread is one of the workers
+    for (i = 1; i < thread_count; i++) {
+        if (!platform_thread_start(&threads[started], tex_batch_worker, &batch)) {
             break;
-        default:
-            fclose(tex_file);
-            return -3; // Unsupported format
-    }
-
-    if (fourcc) {
-        memcpy(ddspf.dwFourCC, fourcc, 4);
-    }
-
-    // Setup DDS header
-    DDS_HEADER dds_header = {0};
-    dds_header.dwSize = sizeof(DDS_HEADER);
-    dds_header.dwFlags = DDS_HEADER_FLAGS_TEXTURE;
-    dds_header.dwHeight = tex_header.image_height;
-    dds_header.dwWidth = tex_header.image_width;
-    dds_header.ddspf = ddspf;
-    dds_header.dwCaps = DDS_SURFACE_FLAGS_TEXTURE;
-
-    uint32_t mipmap_count = 0;
-    if (tex_header.has_mipmaps) {
-        dds_header.dwFlags |= DDS_HEADER_FLAGS_MIPMAP;
-        dds_header.dwCaps |= DDS_SURFACE_FLAGS_MIPMAP;
-        mipmap_count = calc_mipmap_count(tex_header.image_width, tex_header.image_height);
-        dds_header.dwMipMapCount = mipmap_count;
-    }
-
-    // Calculate output size
-    uint32_t tex_data_size = file_size - sizeof(TEX_HEADER);
-    uint32_t header_size = 4 + sizeof(DDS_HEADER); // "DDS " + header
-    if (need_dx10) {
-        header_size += 20; // DX10 extended header
-    }
-    uint32_t total_size = header_size + tex_data_size;
-
-    // Allocate output buffer
-    uint8_t* dds_data = (uint8_t*)malloc(total_size);
-    if (!dds_data) {
-        fclose(tex_file);
-        return -4; // Alloc failed
-    }
-
-    // Write DDS magic
-    uint8_t* ptr = dds_data;
-    memcpy(ptr, DDS_MAGIC, 4);
-    ptr += 4;
-
-    // Write DDS header
-    memcpy(ptr, &dds_header, sizeof(DDS_HEADER));
-    ptr += sizeof(DDS_HEADER);
-
-    // Write DX10 header if needed
-    if (need_dx10) {
-        uint8_t dx10_header[20] = {0};
-        // dxgiFormat = DXGI_FORMAT_R16G16B16A16_SNORM (0x0d)
-        dx10_header[0] = 0x0d;
-        // resourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D (3)
-        dx10_header[4] = 0x03;
-        // arraySize = 1
-        dx10_header[12] = 0x01;
-        // miscFlags2 = DDS_ALPHA_MODE_STRAIGHT (1)
-        dx10_header[16] = 0x01;
-        memcpy(ptr, dx10_header, 20);
-        ptr += 20;
-    }
-
-    // Read TEX data
-    uint8_t* tex_data = (uint8_t*)malloc(tex_data_size);
-    if (!tex_data) {
-        free(dds_data);
-        fclose(tex_file);
-        return -4;
+        }
+        started++;
     }
 
-    if (fread(tex_data, 1, tex_data_size, tex_file) != tex_data_size) {
-        free(tex_data);
-        free(dds_data);
-        fclose(tex_file);
-        return -2;
+    tex_batch_worker(&batch);
+
+    for (i = 0; i < started; i++) {
+        platform_thread_join(threads[i]);
     }
-    fclose(tex_file);
 
-    // Handle mipmaps (TEX stores in reverse order compared to DDS)
-    if (tex_header.has_mipmaps && mipmap_count > 0) {
-        uint32_t block_size = get_block_size(tex_header.tex_format);
-        uint32_t bytes_per_block = get_bytes_per_block(tex_header.tex_format);
-        int32_t current_offset = tex_data_size;
-
-        for (uint32_t i = 0; i < mipmap_count; i++) {
-            uint32_t mip_width = MAX(tex_header.image_width >> i, 1);
-            uint32_t mip_height = MAX(tex_header.image_height >> i, 1);
-            uint32_t block_width = (mip_width + block_size - 1) / block_size;
-            uint32_t block_height = (mip_height + block_size - 1) / block_size;
-            uint32_t mip_size = bytes_per_block * block_width * block_height;
-
-            current_offset -= mip_size;
-            if (current_offset < 0) {
-                break;
+    return (int)batch.failed;
+}
+
+// Persistent DDS cache: one <key>.dds file per converted TEX in a cache
+// directory, key = XXH64 of the canonical path, TEX header, file size and
+// mtime. Entry files are written through a mapping to a temp file named
+// after the process and renamed into place, so several processes can share
+// a directory; the index here only drives the LRU cap.
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;          // Converted and stored
+    uint64_t evictions;
+    uint64_t bytes;           // Size of the entries known to this process
+    uint64_t max_bytes;
+    uint32_t entries;
+    uint32_t reserved;
+} TEX_CACHE_STATS;
+
+typedef struct {
+    uint64_t key;
+    uint64_t size;
+    uint64_t last_use;        // File time of the last hit or write
+} TEX_CACHE_ENTRY;
+
+static platform_mutex g_cache_lock = PLATFORM_MUTEX_INIT;
+static char* g_cache_dir = NULL;      // UTF-8, ends with a separator; NULL while closed
+static TEX_CACHE_ENTRY* g_cache_entries = NULL;
+static uint32_t g_cache_count = 0;
+static uint32_t g_cache_capacity = 0;
+static TEX_CACHE_STATS g_cache_stats;
+static volatile long g_cache_temp_id = 0;
+
+// Part of every key; bumping it orphans the entries of older builds, which
+// the LRU cap then deletes
+#define TEX_CACHE_KEY_VERSION 2
+
+// Temp files this much older than their last write are left over from a crash
+#define TEX_CACHE_STALE_TEMP_SECONDS 600
+
+// Longest path of an entry file, in UTF-8 bytes
+#ifdef _WIN32
+    #define TEX_CACHE_PATH_MAX (MAX_PATH * 4)
+#else
+    #define TEX_CACHE_PATH_MAX PATH_MAX
+#endif
+
+// Writable mapping of a new file of a fixed size; fails if path exists
+typedef struct {
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+    uint8_t* data;
+    uint64_t size;
+} TEX_OUTPUT_MAPPING;
+
+#ifdef _WIN32
+static int widen_path(const char* path, WCHAR* out) {
+    return MultiByteToWideChar(CP_UTF8, 0, path, -1, out, MAX_PATH * 4) != 0;
+}
+
+// File times: 100 ns ticks
+#define CACHE_TICKS_PER_SECOND 10000000ull
+
+static uint64_t cache_now(void) {
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    return ((uint64_t)now.dwHighDateTime << 32) | now.dwLowDateTime;
+}
+
+// Size and last write time of a regular file
+static int file_stat(const char* path, uint64_t* size, uint64_t* mtime) {
+    WCHAR wpath[MAX_PATH * 4];
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!widen_path(path, wpath) || !GetFileAttributesExW(wpath, GetFileExInfoStandard, &attr) ||
+        (attr.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        return 0;
+    }
+    *size = ((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+    *mtime = ((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    return 1;
+}
+
+// Set the last write time of path to now; fails if it doesn't exist
+static int file_touch(const char* path, uint64_t now) {
+    WCHAR wpath[MAX_PATH * 4];
+    FILETIME time;
+    HANDLE file;
+    int ok;
+    if (!widen_path(path, wpath)) return 0;
+    file = CreateFileW(wpath, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                       NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    time.dwLowDateTime = (DWORD)now;
+    time.dwHighDateTime = (DWORD)(now >> 32);
+    ok = SetFileTime(file, NULL, NULL, &time) != 0;
+    CloseHandle(file);
+    return ok;
+}
+
+// Also succeeds if path is already gone; fails while another handle has it open
+static int file_delete(const char* path) {
+    WCHAR wpath[MAX_PATH * 4];
+    if (!widen_path(path, wpath)) return 0;
+    return DeleteFileW(wpath) || GetLastError() == ERROR_FILE_NOT_FOUND;
+}
+
+static int file_replace(const char* from, const char* to) {
+    WCHAR wfrom[MAX_PATH * 4];
+    WCHAR wto[MAX_PATH * 4];
+    return widen_path(from, wfrom) && widen_path(to, wto) &&
+           MoveFileExW(wfrom, wto, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+static int dir_create(const char* path) {
+    WCHAR wpath[MAX_PATH * 4];
+    if (!widen_path(path, wpath)) return 0;
+    return CreateDirectoryW(wpath, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+// Absolute path of path into out (TEX_CACHE_PATH_MAX bytes), lowercased as
+// NTFS paths are case-insensitive
+static int file_canonical_path(const char* path, char* out) {
+    WCHAR wpath[MAX_PATH * 4];
+    WCHAR full[MAX_PATH * 4];
+    DWORD len, i;
+    if (!widen_path(path, wpath)) return 0;
+    len = GetFullPathNameW(wpath, MAX_PATH * 4, full, NULL);
+    if (len == 0 || len >= MAX_PATH * 4) return 0;
+    for (i = 0; i < len; i++) full[i] = (WCHAR)towlower(full[i]);
+    return WideCharToMultiByte(CP_UTF8, 0, full, -1, out, TEX_CACHE_PATH_MAX, NULL, NULL) != 0;
+}
+
+static int create_output_mapping(const char* path, uint64_t size, TEX_OUTPUT_MAPPING* map) {
+    WCHAR wpath[MAX_PATH * 4];
+    map->data = NULL;
+    map->size = size;
+    map->mapping = NULL;
+    map->file = INVALID_HANDLE_VALUE;
+    if (!widen_path(path, wpath)) return 0;
+
+    map->file = CreateFileW(wpath, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) return 0;
+    // Growing the mapping sets the file size
+    map->mapping = CreateFileMappingW(map->file, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+    if (map->mapping) {
+        map->data = (uint8_t*)MapViewOfFile(map->mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)size);
+    }
+    if (!map->data) {
+        if (map->mapping) CloseHandle(map->mapping);
+        CloseHandle(map->file);
+        map->mapping = NULL;
+        map->file = INVALID_HANDLE_VALUE;
+        return 0;
+    }
+    return 1;
+}
+
+static void close_output_mapping(TEX_OUTPUT_MAPPING* map) {
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->mapping) CloseHandle(map->mapping);
+    if (map->file != INVALID_HANDLE_VALUE) CloseHandle(map->file);
+    map->data = NULL;
+    map->mapping = NULL;
+    map->file = INVALID_HANDLE_VALUE;
+}
+#else
+#define CACHE_TICKS_PER_SECOND 1000000000ull
+
+static uint64_t cache_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static int file_stat(const char* path, uint64_t* size, uint64_t* mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return 0;
+    *size = (uint64_t)st.st_size;
+    *mtime = platform_stat_mtime_ns(&st);
+    return 1;
+}
+
+static int file_touch(const char* path, uint64_t now) {
+    struct timespec times[2];
+    times[0].tv_sec = (time_t)(now / 1000000000ull);
+    times[0].tv_nsec = (long)(now % 1000000000ull);
+    times[1] = times[0];
+    return utimensat(AT_FDCWD, path, times, 0) == 0;
+}
+
+static int file_delete(const char* path) {
+    return unlink(path) == 0 || errno == ENOENT;
+}
+
+static int file_replace(const char* from, const char* to) {
+    return rename(from, to) == 0;
+}
+
+static int dir_create(const char* path) {
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+// Absolute path of path, symlinks resolved, into out (TEX_CACHE_PATH_MAX bytes)
+static int file_canonical_path(const char* path, char* out) {
+    return realpath(path, out) != NULL;
+}
+
+static int create_output_mapping(const char* path, uint64_t size, TEX_OUTPUT_MAPPING* map) {
+    void* data;
+    map->data = NULL;
+    map->size = size;
+
+    map->fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (map->fd < 0) return 0;
+    if (ftruncate(map->fd, (off_t)size) != 0) {
+        close(map->fd);
+        map->fd = -1;
+        return 0;
+    }
+    data = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0);
+    if (data == MAP_FAILED) {
+        close(map->fd);
+        map->fd = -1;
+        return 0;
+    }
+    map->data = (uint8_t*)data;
+    return 1;
+}
+
+static void close_output_mapping(TEX_OUTPUT_MAPPING* map) {
+    if (map->data) munmap(map->data, (size_t)map->size);
+    if (map->fd >= 0) close(map->fd);
+    map->data = NULL;
+    map->fd = -1;
+}
+#endif
+
+// "<16 hex digits>.dds" -> key
+static int parse_entry_name(const char* name, uint64_t* key) {
+    uint64_t value = 0;
+    int i;
+    for (i = 0; i < 16; i++) {
+        char c = name[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') digit = (uint32_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = (uint32_t)(c - 'a' + 10);
+        else return 0;
+        value = (value << 4) | digit;
+    }
+    if (strcmp(name + 16, ".dds") != 0) return 0;
+    *key = value;
+    return 1;
+}
+
+// "<16 hex digits>.<pid>.<n>.tmp", an entry being written
+static int is_temp_name(const char* name) {
+    size_t len = strlen(name);
+    uint64_t key;
+    char entry[21];
+    if (len < 21 || name[16] != '.' || strcmp(name + len - 4, ".tmp") != 0) return 0;
+    memcpy(entry, name, 16);
+    memcpy(entry + 16, ".dds", 5);
+    return parse_entry_name(entry, &key);
+}
+
+// g_cache_dir + key + suffix into out (TEX_CACHE_PATH_MAX bytes)
+static void cache_entry_path(uint64_t key, const char* suffix, char* out) {
+    snprintf(out, TEX_CACHE_PATH_MAX, "%s%016llx%s", g_cache_dir, (unsigned long long)key, suffix);
+}
+
+// Remove entry i from the index (not the file); g_cache_lock held
+static void cache_forget(uint32_t i) {
+    g_cache_stats.bytes -= g_cache_entries[i].size;
+    g_cache_entries[i] = g_cache_entries[--g_cache_count];
+}
+
+static int cache_find(uint64_t key) {
+    uint32_t i;
+    for (i = 0; i < g_cache_count; i++) {
+        if (g_cache_entries[i].key == key) return (int)i;
+    }
+    return -1;
+}
+
+// Add or refresh an entry, then evict least recently used entries past the
+// cap (never the one just used); g_cache_lock held
+static void cache_note(uint64_t key, uint64_t size, uint64_t now) {
+    char path[TEX_CACHE_PATH_MAX];
+    uint32_t attempts;
+    int i = cache_find(key);
+
+    if (i >= 0) {
+        g_cache_stats.bytes += size - g_cache_entries[i].size;
+        g_cache_entries[i].size = size;
+        g_cache_entries[i].last_use = now;
+    } else {
+        if (g_cache_count == g_cache_capacity) {
+            uint32_t capacity = g_cache_capacity ? g_cache_capacity * 2 : 256;
+            TEX_CACHE_ENTRY* grown = (TEX_CACHE_ENTRY*)realloc(g_cache_entries, capacity * sizeof(TEX_CACHE_ENTRY));
+            if (!grown) return;
+            g_cache_entries = grown;
+            g_cache_capacity = capacity;
+        }
+        g_cache_entries[g_cache_count].key = key;
+        g_cache_entries[g_cache_count].size = size;
+        g_cache_entries[g_cache_count].last_use = now;
+        g_cache_count++;
+        g_cache_stats.bytes += size;
+    }
+
+    // An entry another process still has open can't be deleted yet; it
+    // stays indexed as just used. One attempt per entry bounds the loop.
+    attempts = g_cache_count;
+    while (g_cache_stats.bytes > g_cache_stats.max_bytes && g_cache_count > 1 && attempts-- > 0) {
+        uint32_t oldest = g_cache_count;
+        uint32_t j;
+        for (j = 0; j < g_cache_count; j++) {
+            if (g_cache_entries[j].key == key) continue;
+            if (oldest == g_cache_count || g_cache_entries[j].last_use < g_cache_entries[oldest].last_use) {
+                oldest = j;
             }
-            memcpy(ptr, tex_data + current_offset, mip_size);
-            ptr += mip_size;
         }
-    } else {
-        // No mipmaps - straight copy
-        memcpy(ptr, tex_data, tex_data_size);
+        cache_entry_path(g_cache_entries[oldest].key, ".dds", path);
+        if (!file_delete(path)) {
+            g_cache_entries[oldest].last_use = now;
+            continue;
+        }
+        cache_forget(oldest);
+        g_cache_stats.evictions++;
     }
+}
 
-    free(tex_data);
+// Index the entries already in g_cache_dir and delete temp files a crash
+// left behind; g_cache_lock held
+static void cache_scan(void) {
+    char path[TEX_CACHE_PATH_MAX];
+    uint64_t key, size, mtime;
+    uint64_t stale_before = cache_now() - TEX_CACHE_STALE_TEMP_SECONDS * CACHE_TICKS_PER_SECOND;
+#ifdef _WIN32
+    WCHAR wpattern[MAX_PATH * 4];
+    WIN32_FIND_DATAW found;
+    HANDLE find;
+    char name[64];
 
-    *out_data = dds_data;
-    *out_size = total_size;
-    return 0; // Success
+    snprintf(path, sizeof(path), "%s*", g_cache_dir);
+    if (!widen_path(path, wpattern)) return;
+    find = FindFirstFileExW(wpattern, FindExInfoBasic, &found, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (find == INVALID_HANDLE_VALUE) return;
+    do {
+        if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+        if (WideCharToMultiByte(CP_UTF8, 0, found.cFileName, -1, name, sizeof(name), NULL, NULL) == 0) continue;
+        mtime = ((uint64_t)found.ftLastWriteTime.dwHighDateTime << 32) | found.ftLastWriteTime.dwLowDateTime;
+        if (is_temp_name(name)) {
+            if (mtime < stale_before) {
+                snprintf(path, sizeof(path), "%s%s", g_cache_dir, name);
+                file_delete(path);
+            }
+            continue;
+        }
+        if (!parse_entry_name(name, &key)) continue;
+        size = ((uint64_t)found.nFileSizeHigh << 32) | found.nFileSizeLow;
+        cache_note(key, size, mtime);
+    } while (FindNextFileW(find, &found));
+    FindClose(find);
+#else
+    DIR* dir = opendir(g_cache_dir);
+    struct dirent* item;
+    if (!dir) return;
+    while ((item = readdir(dir)) != NULL) {
+        int temp = is_temp_name(item->d_name);
+        if (!temp && !parse_entry_name(item->d_name, &key)) continue;
+        snprintf(path, sizeof(path), "%s%s", g_cache_dir, item->d_name);
+        if (!file_stat(path, &size, &mtime)) continue;
+        if (temp) {
+            if (mtime < stale_before) file_delete(path);
+            continue;
+        }
+        cache_note(key, size, mtime);
+    }
+    closedir(dir);
+#endif
+}
+
+/*
+ * Keep converted DDS files in a directory across sessions
+ *
+ * Parameters:
+ *   cache_dir  - Directory for the entries (UTF-8), created if its parent exists
+ *   max_bytes  - Size cap; past it the least recently used entries are deleted
+ *
+ * Replaces a cache opened earlier. Entries found in cache_dir count towards
+ * the cap, so it applies from the first conversion. Temp files of entries
+ * whose writer died are deleted once they are TEX_CACHE_STALE_TEMP_SECONDS old.
+ *
+ * Returns:
+ *   0 on success, -1 if the directory can't be created, -4 if allocation failed,
+ *   -5 on invalid arguments
+ */
+DLL_EXPORT int tex_cache_open(const char* cache_dir, uint64_t max_bytes) {
+    size_t len;
+    char* dir;
+
+    if (!cache_dir || !cache_dir[0] || max_bytes == 0) {
+        return -5;
+    }
+    if (!dir_create(cache_dir)) {
+        return -1;
+    }
+
+    len = strlen(cache_dir);
+    if (len + 64 >= TEX_CACHE_PATH_MAX) {
+        return -5;
+    }
+    dir = (char*)malloc(len + 2);
+    if (!dir) {
+        return -4;
+    }
+    memcpy(dir, cache_dir, len + 1);
+    if (dir[len - 1] != '/' && dir[len - 1] != '\\') {
+#ifdef _WIN32
+        dir[len] = '\\';
+#else
+        dir[len] = '/';
+#endif
+        dir[len + 1] = '\0';
+    }
+
+    platform_mutex_lock(&g_cache_lock);
+    free(g_cache_dir);
+    g_cache_dir = dir;
+    g_cache_count = 0;
+    memset(&g_cache_stats, 0, sizeof(g_cache_stats));
+    g_cache_stats.max_bytes = max_bytes;
+    cache_scan();
+    platform_mutex_unlock(&g_cache_lock);
+    return 0;
+}
+
+/*
+ * Stop using the DDS cache; its files stay on disk
+ */
+DLL_EXPORT void tex_cache_close(void) {
+    platform_mutex_lock(&g_cache_lock);
+    free(g_cache_dir);
+    free(g_cache_entries);
+    g_cache_dir = NULL;
+    g_cache_entries = NULL;
+    g_cache_count = 0;
+    g_cache_capacity = 0;
+    platform_mutex_unlock(&g_cache_lock);
+}
+
+/*
+ * Path of a DDS file holding the conversion of a TEX file, from the cache
+ *
+ * Parameters:
+ *   tex_path  - Path to the .tex file (UTF-8)
+ *   out_path  - Receives the NUL-terminated path of the DDS file (UTF-8)
+ *   capacity  - Size of out_path in bytes
+ *
+ * On a miss the TEX file is converted straight into a new mapped entry
+ * file. The file can be deleted by eviction once other conversions follow,
+ * so load it before converting more.
+ *
+ * Returns:
+ *   0 if the entry was already cached, 1 if it was converted and stored,
+ *   the tex_to_dds_bytes error codes (-1 also when the entry can't be
+ *   written), -5 on invalid arguments or without tex_cache_open,
+ *   -6 if out_path is too small
+ */
+DLL_EXPORT int tex_cache_dds_path(const char* tex_path, char* out_path, uint32_t capacity) {
+    FILE* tex_file;
+    TEX_HEADER tex_header;
+    DDS_LAYOUT layout;
+    TEX_OUTPUT_MAPPING out;
+    char final_path[TEX_CACHE_PATH_MAX];
+    char temp_path[TEX_CACHE_PATH_MAX];
+    char temp_suffix[32];
+    char canonical_path[TEX_CACHE_PATH_MAX];
+    struct {
+        uint32_t version;
+        TEX_HEADER header;
+        uint64_t size;
+        uint64_t mtime;
+    } stamp;
+    uint64_t file_size, key, now;
+    uint32_t written = 0;
+    int rc, i;
+
+    if (!tex_path || !out_path) {
+        return -5;
+    }
+
+    // Key: the file's canonical path, TEX header, size and mtime. Same-sized
+    // textures written in one burst (WAD extraction, copies keeping
+    // timestamps) differ only by path.
+    rc = tex_open_stdio(tex_path, &tex_file, &tex_header, &file_size);
+    if (rc != 0) {
+        return rc;
+    }
+    fclose(tex_file);
+    rc = tex_build_layout(&tex_header, file_size, &layout);
+    if (rc != 0) {
+        return rc;
+    }
+    memset(&stamp, 0, sizeof(stamp));
+    stamp.version = TEX_CACHE_KEY_VERSION;
+    stamp.header = tex_header;
+    if (!file_stat(tex_path, &stamp.size, &stamp.mtime) || !file_canonical_path(tex_path, canonical_path)) {
+        return -1;
+    }
+    key = xxhash64_seeded(canonical_path, strlen(canonical_path), xxhash64(&stamp, sizeof(stamp)));
+
+    platform_mutex_lock(&g_cache_lock);
+    if (!g_cache_dir) {
+        platform_mutex_unlock(&g_cache_lock);
+        return -5;
+    }
+    cache_entry_path(key, ".dds", final_path);
+    // Unique across the processes sharing the directory
+    snprintf(temp_suffix, sizeof(temp_suffix), ".%lu.%ld.tmp", (unsigned long)platform_process_id(),
+             platform_atomic_increment(&g_cache_temp_id));
+    cache_entry_path(key, temp_suffix, temp_path);
+    if (strlen(final_path) >= capacity) {
+        platform_mutex_unlock(&g_cache_lock);
+        return -6;
+    }
+
+    // Touching doubles as the existence check, entries may come from another process
+    now = cache_now();
+    if (file_touch(final_path, now)) {
+        cache_note(key, layout.total_size, now);
+        g_cache_stats.hits++;
+        platform_mutex_unlock(&g_cache_lock);
+        memcpy(out_path, final_path, strlen(final_path) + 1);
+        return 0;
+    }
+    i = cache_find(key);
+    if (i >= 0) {
+        cache_forget((uint32_t)i);
+    }
+    platform_mutex_unlock(&g_cache_lock);
+
+    if (!create_output_mapping(temp_path, layout.total_size, &out)) {
+        return -1;
+    }
+    rc = tex_convert_file(tex_path, out.data, layout.total_size, NULL, &written);
+    close_output_mapping(&out);
+    if (rc == 0 && written != layout.total_size) {
+        rc = -2; // Changed while converting
+    }
+    if (rc != 0 || !file_replace(temp_path, final_path)) {
+        file_delete(temp_path);
+        return rc != 0 ? rc : -1;
+    }
+
+    platform_mutex_lock(&g_cache_lock);
+    if (g_cache_dir) {
+        cache_note(key, layout.total_size, cache_now());
+        g_cache_stats.misses++;
+    }
+    platform_mutex_unlock(&g_cache_lock);
+
+    memcpy(out_path, final_path, strlen(final_path) + 1);
+    return 1;
+}
+
+/*
+ * Counters of the DDS cache since tex_cache_open
+ *
+ * Returns:
+ *   0 on success, -5 on invalid arguments or without tex_cache_open
+ */
+DLL_EXPORT int tex_cache_get_stats(TEX_CACHE_STATS* out_stats) {
+    int rc = -5;
+    if (!out_stats) {
+        return -5;
+    }
+    platform_mutex_lock(&g_cache_lock);
+    if (g_cache_dir) {
+        *out_stats = g_cache_stats;
+        out_stats->entries = g_cache_count;
+        rc = 0;
+    }
+    platform_mutex_unlock(&g_cache_lock);
+    return rc;
 }
 
 /*
@@ -252,9 +927,10 @@ DLL_EXPORT void free_dds_bytes(uint8_t* data) {
  * Get version string
  */
 DLL_EXPORT const char* get_version(void) {
-    return "ritoddstex_dll 1.0";
+    return "ritoddstex_dll 1.3";
 }
 
+#ifdef _WIN32
 // DLL entry point
 BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpReserved) {
     (void)hinstDLL;
@@ -268,3 +944,4 @@ BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpReserved) {
     }
     return TRUE;
 }
+#endif
@@ -0,0 +1,622 @@
+/*
+ * Skinning - voxel heat diffusion weights and weight smoothing for the
+ * Blender addon
+ * Compiled into lol_native.dll alongside lol_native.cpp
+ *
+ * The mesh is voxelized into a dense grid (surface shell plus the enclosed
+ * interior), every bone claims the voxels its segment passes through, and
+ * one heat field per bone is relaxed over the voxel volume with the bone's
+ * voxels held at 1 and every other bone's voxels at 0. Heat can't cross
+ * empty space, so a hand doesn't pull weight from a thigh it merely sits
+ * close to. Vertices sample the fields trilinearly.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "platform.h"
+#include "thread_pool.h"
+
+// ============================================================================
+// Voxel Heat Weights
+// ============================================================================
+
+#define VOXEL_MIN_RESOLUTION    4
+#define VOXEL_MAX_RESOLUTION    256
+#define VOXEL_PAD               2       // Empty cells around the mesh, so the outside is connected
+#define VOXEL_MAX_INFLUENCES    4
+
+static const float VOXEL_SOR_OMEGA = 1.7f;
+static const float VOXEL_CONVERGED = 1e-5f;
+
+// Dense grid over the mesh bounds; cell (x, y, z) covers
+// origin + [x, x + 1) * size on each axis
+struct VoxelGrid {
+    float origin[3];
+    float size;
+    int32_t dims[3];
+
+    size_t cell_count() const { return (size_t)dims[0] * dims[1] * dims[2]; }
+    size_t index(int32_t x, int32_t y, int32_t z) const {
+        return ((size_t)z * dims[1] + y) * dims[0] + x;
+    }
+    int32_t coord(const float* p, int axis) const {
+        int32_t c = (int32_t)floorf((p[axis] - origin[axis]) / size);
+        return c < 0 ? 0 : (c >= dims[axis] ? dims[axis] - 1 : c);
+    }
+    void center(int32_t x, int32_t y, int32_t z, float* out) const {
+        out[0] = origin[0] + (x + 0.5f) * size;
+        out[1] = origin[1] + (y + 0.5f) * size;
+        out[2] = origin[2] + (z + 0.5f) * size;
+    }
+};
+
+// In-volume cells in a compact array; neighbors outside the volume are -1
+struct VoxelDomain {
+    std::vector<int32_t> cells;         // Grid index of each domain cell
+    std::vector<int32_t> neighbors;     // 6 per domain cell: -x, +x, -y, +y, -z, +z
+    std::vector<float> centers;         // 3 per domain cell
+};
+
+static float segment_distance_sq(const float* p, const float* head, const float* tail) {
+    float d[3], v[3];
+    float len_sq = 0.0f, t = 0.0f;
+    for (int c = 0; c < 3; c++) {
+        d[c] = tail[c] - head[c];
+        v[c] = p[c] - head[c];
+        len_sq += d[c] * d[c];
+        t += v[c] * d[c];
+    }
+    t = len_sq > 0.0f ? t / len_sq : 0.0f;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    float dist_sq = 0.0f;
+    for (int c = 0; c < 3; c++) {
+        float e = v[c] - d[c] * t;
+        dist_sq += e * e;
+    }
+    return dist_sq;
+}
+
+static void mark_point(const VoxelGrid& grid, const float* p, std::vector<uint8_t>& surface) {
+    surface[grid.index(grid.coord(p, 0), grid.coord(p, 1), grid.coord(p, 2))] = 1;
+}
+
+// Marks every cell a triangle touches by sampling it at half the cell size
+static void mark_triangle(const VoxelGrid& grid, const float* a, const float* b, const float* c,
+                          std::vector<uint8_t>& surface) {
+    float longest = 0.0f;
+    const float* edges[3][2] = {{a, b}, {b, c}, {c, a}};
+    for (auto& e : edges) {
+        float len_sq = 0.0f;
+        for (int k = 0; k < 3; k++) len_sq += (e[1][k] - e[0][k]) * (e[1][k] - e[0][k]);
+        if (len_sq > longest) longest = len_sq;
+    }
+    int32_t steps = (int32_t)ceilf(sqrtf(longest) / (grid.size * 0.5f));
+    if (steps < 1) steps = 1;
+
+    for (int32_t i = 0; i <= steps; i++) {
+        for (int32_t j = 0; i + j <= steps; j++) {
+            float u = (float)i / steps, v = (float)j / steps, w = 1.0f - u - v;
+            float p[3];
+            for (int k = 0; k < 3; k++) p[k] = a[k] * w + b[k] * u + c[k] * v;
+            mark_point(grid, p, surface);
+        }
+    }
+}
+
+// Surface cells plus everything the outside can't reach through 6-connected
+// empty cells. Open meshes leak, which leaves just the shell.
+static void build_domain(const VoxelGrid& grid, const std::vector<uint8_t>& surface, VoxelDomain& domain) {
+    const size_t count = grid.cell_count();
+    std::vector<uint8_t> outside(count, 0);
+    std::vector<int32_t> stack;
+    stack.push_back(0);     // Corner cell, empty thanks to the padding
+    outside[0] = 1;
+
+    const int32_t dx = 1, dy = grid.dims[0], dz = grid.dims[0] * grid.dims[1];
+    while (!stack.empty()) {
+        int32_t i = stack.back();
+        stack.pop_back();
+        int32_t x = i % grid.dims[0], y = (i / grid.dims[0]) % grid.dims[1], z = i / dz;
+        const int32_t next[6] = {
+            x > 0 ? i - dx : -1, x + 1 < grid.dims[0] ? i + dx : -1,
+            y > 0 ? i - dy : -1, y + 1 < grid.dims[1] ? i + dy : -1,
+            z > 0 ? i - dz : -1, z + 1 < grid.dims[2] ? i + dz : -1,
+        };
+        for (int32_t n : next) {
+            if (n >= 0 && !outside[n] && !surface[n]) {
+                outside[n] = 1;
+                stack.push_back(n);
+            }
+        }
+    }
+
+    std::vector<int32_t> domain_of_cell(count, -1);
+    for (size_t i = 0; i < count; i++) {
+        if (!outside[i]) {
+            domain_of_cell[i] = (int32_t)domain.cells.size();
+            domain.cells.push_back((int32_t)i);
+        }
+    }
+
+    domain.neighbors.resize(domain.cells.size() * 6);
+    domain.centers.resize(domain.cells.size() * 3);
+    for (size_t d = 0; d < domain.cells.size(); d++) {
+        int32_t i = domain.cells[d];
+        int32_t x = i % grid.dims[0], y = (i / grid.dims[0]) % grid.dims[1], z = i / dz;
+        const int32_t next[6] = {
+            x > 0 ? i - dx : -1, x + 1 < grid.dims[0] ? i + dx : -1,
+            y > 0 ? i - dy : -1, y + 1 < grid.dims[1] ? i + dy : -1,
+            z > 0 ? i - dz : -1, z + 1 < grid.dims[2] ? i + dz : -1,
+        };
+        for (int k = 0; k < 6; k++) domain.neighbors[d * 6 + k] = next[k] >= 0 ? domain_of_cell[next[k]] : -1;
+        grid.center(x, y, z, &domain.centers[d * 3]);
+    }
+}
+
+/*
+ * Compute skinning weights by voxel heat diffusion
+ *
+ * Parameters:
+ *   positions       - vertex_count * 3 floats, same space as the bones
+ *   vertex_count    - Number of vertices
+ *   triangles       - triangle_count * 3 vertex indices (may be NULL when triangle_count is 0)
+ *   triangle_count  - Number of triangles
+ *   bone_segments   - bone_count * 6 floats: head xyz, tail xyz
+ *   bone_count      - Number of bones
+ *   resolution      - Voxels along the longest side of the mesh bounds (4-256)
+ *   iterations      - Relaxation sweeps per bone (stops early once converged; 0 keeps the
+ *                     inverse-distance seed)
+ *   falloff_power   - Heat is raised to this power before normalizing (1 keeps it as diffused)
+ *   max_influences  - Influences kept per vertex (1-4)
+ *   out_bones       - Receives vertex_count * 4 bone indices, -1 for unused slots
+ *   out_weights     - Receives vertex_count * 4 weights, normalized per vertex
+ *
+ * Returns:
+ *   0 on success, negative on error:
+ *   -4: Memory allocation failed
+ *   -5: Invalid arguments (NULL buffers, out of range indices or parameters)
+ */
+DLL_EXPORT int voxel_heat_weights(const float* positions, uint32_t vertex_count,
+                                  const int32_t* triangles, uint32_t triangle_count,
+                                  const float* bone_segments, uint32_t bone_count,
+                                  uint32_t resolution, uint32_t iterations, float falloff_power,
+                                  uint32_t max_influences, int32_t* out_bones, float* out_weights) {
+    if (!positions || !bone_segments || !out_bones || !out_weights) return -5;
+    if (vertex_count == 0 || bone_count == 0 || (triangle_count && !triangles)) return -5;
+    if (resolution < VOXEL_MIN_RESOLUTION || resolution > VOXEL_MAX_RESOLUTION) return -5;
+    if (max_influences < 1 || max_influences > VOXEL_MAX_INFLUENCES || !(falloff_power > 0.0f)) return -5;
+    for (size_t i = 0; i < (size_t)triangle_count * 3; i++) {
+        if (triangles[i] < 0 || (uint32_t)triangles[i] >= vertex_count) return -5;
+    }
+
+    try {
+        // Grid over the mesh bounds
+        float lo[3], hi[3];
+        for (int c = 0; c < 3; c++) lo[c] = hi[c] = positions[c];
+        for (size_t v = 0; v < vertex_count; v++) {
+            for (int c = 0; c < 3; c++) {
+                float p = positions[v * 3 + c];
+                if (!std::isfinite(p)) return -5;
+                lo[c] = p < lo[c] ? p : lo[c];
+                hi[c] = p > hi[c] ? p : hi[c];
+            }
+        }
+        float extent = 0.0f;
+        for (int c = 0; c < 3; c++) extent = hi[c] - lo[c] > extent ? hi[c] - lo[c] : extent;
+
+        VoxelGrid grid;
+        grid.size = extent > 0.0f ? extent / resolution : 1.0f;
+        for (int c = 0; c < 3; c++) {
+            grid.origin[c] = lo[c] - VOXEL_PAD * grid.size;
+            grid.dims[c] = (int32_t)ceilf((hi[c] - lo[c]) / grid.size) + 1 + 2 * VOXEL_PAD;
+        }
+
+        std::vector<uint8_t> surface(grid.cell_count(), 0);
+        for (size_t v = 0; v < vertex_count; v++) mark_point(grid, positions + v * 3, surface);
+        for (size_t t = 0; t < triangle_count; t++) {
+            const int32_t* tri = triangles + t * 3;
+            mark_triangle(grid, positions + (size_t)tri[0] * 3, positions + (size_t)tri[1] * 3,
+                          positions + (size_t)tri[2] * 3, surface);
+        }
+
+        VoxelDomain domain;
+        build_domain(grid, surface, domain);
+        const size_t cell_count = domain.cells.size();
+
+        // Each cell goes to its nearest bone if a segment passes through it;
+        // a bone that passes through none (outside the mesh) takes the cell
+        // closest to it so it still gets a source. The inverse-square distance
+        // sums seed the fields, so the sweeps only have to correct for the
+        // shape of the volume.
+        const float claim_sq = grid.size * grid.size * 0.75f;     // Half the cell diagonal
+        const float min_dist_sq = grid.size * grid.size * 0.25f;
+        std::vector<int32_t> owner(cell_count, -1);
+        std::vector<float> inverse_sum(cell_count);
+        global_thread_pool().parallel_for((cell_count + 4095) / 4096, 0, [&](size_t chunk) {
+            size_t end = (chunk + 1) * 4096 < cell_count ? (chunk + 1) * 4096 : cell_count;
+            for (size_t d = chunk * 4096; d < end; d++) {
+                float best = claim_sq;
+                float sum = 0.0f;
+                for (uint32_t b = 0; b < bone_count; b++) {
+                    float dist_sq = segment_distance_sq(&domain.centers[d * 3], bone_segments + b * 6,
+                                                        bone_segments + b * 6 + 3);
+                    sum += 1.0f / (dist_sq > min_dist_sq ? dist_sq : min_dist_sq);
+                    if (dist_sq <= best) {
+                        best = dist_sq;
+                        owner[d] = (int32_t)b;
+                    }
+                }
+                inverse_sum[d] = sum;
+            }
+        });
+
+        std::vector<uint8_t> has_source(bone_count, 0);
+        for (int32_t b : owner) {
+            if (b >= 0) has_source[b] = 1;
+        }
+        for (uint32_t b = 0; b < bone_count; b++) {
+            if (has_source[b]) continue;
+            int32_t nearest = -1;
+            float best = INFINITY;
+            for (size_t d = 0; d < cell_count; d++) {
+                if (owner[d] >= 0) continue;
+                float dist_sq = segment_distance_sq(&domain.centers[d * 3], bone_segments + b * 6,
+                                                    bone_segments + b * 6 + 3);
+                if (dist_sq < best) {
+                    best = dist_sq;
+                    nearest = (int32_t)d;
+                }
+            }
+            if (nearest >= 0) owner[nearest] = (int32_t)b;
+        }
+
+        // Trilinear stencil of every vertex over cell centers; corners outside
+        // the volume drop out and the rest are renormalized
+        std::vector<int32_t> domain_of_cell(grid.cell_count(), -1);
+        for (size_t d = 0; d < cell_count; d++) domain_of_cell[domain.cells[d]] = (int32_t)d;
+
+        std::vector<int32_t> stencil_cells((size_t)vertex_count * 8);
+        std::vector<float> stencil_weights((size_t)vertex_count * 8);
+        global_thread_pool().parallel_for(vertex_count, 0, [&](size_t v) {
+            const float* p = positions + v * 3;
+            int32_t base[3];
+            float frac[3];
+            for (int c = 0; c < 3; c++) {
+                float g = (p[c] - grid.origin[c]) / grid.size - 0.5f;
+                base[c] = (int32_t)floorf(g);
+                frac[c] = g - base[c];
+            }
+            float total = 0.0f;
+            for (int k = 0; k < 8; k++) {
+                int32_t x = base[0] + (k & 1), y = base[1] + ((k >> 1) & 1), z = base[2] + (k >> 2);
+                float w = ((k & 1) ? frac[0] : 1.0f - frac[0]) * (((k >> 1) & 1) ? frac[1] : 1.0f - frac[1]) *
+                          ((k >> 2) ? frac[2] : 1.0f - frac[2]);
+                int32_t d = -1;
+                if (x >= 0 && y >= 0 && z >= 0 && x < grid.dims[0] && y < grid.dims[1] && z < grid.dims[2]) {
+                    d = domain_of_cell[grid.index(x, y, z)];
+                }
+                stencil_cells[v * 8 + k] = d;
+                stencil_weights[v * 8 + k] = d >= 0 ? w : 0.0f;
+                total += stencil_weights[v * 8 + k];
+            }
+            if (total > 0.0f) {
+                for (int k = 0; k < 8; k++) stencil_weights[v * 8 + k] /= total;
+            } else {
+                // Vertex exactly on a cell boundary: its own cell is always in the volume
+                stencil_cells[v * 8] = domain_of_cell[grid.index(grid.coord(p, 0), grid.coord(p, 1), grid.coord(p, 2))];
+                stencil_weights[v * 8] = 1.0f;
+            }
+        });
+        domain_of_cell.clear();
+        domain_of_cell.shrink_to_fit();
+
+        // One heat field per bone, relaxed with in-place Gauss-Seidel + SOR.
+        // Insulated boundary: free cells average only their in-volume neighbors.
+        std::vector<float> heat((size_t)bone_count * vertex_count);
+        global_thread_pool().parallel_for(bone_count, 0, [&](size_t b) {
+            const float* head = bone_segments + b * 6;
+            std::vector<float> field(cell_count);
+            for (size_t d = 0; d < cell_count; d++) {
+                if (owner[d] >= 0) {
+                    field[d] = owner[d] == (int32_t)b ? 1.0f : 0.0f;
+                } else {
+                    float dist_sq = segment_distance_sq(&domain.centers[d * 3], head, head + 3);
+                    field[d] = 1.0f / (dist_sq > min_dist_sq ? dist_sq : min_dist_sq) / inverse_sum[d];
+                }
+            }
+
+            for (uint32_t it = 0; it < iterations; it++) {
+                float max_change = 0.0f;
+                for (size_t d = 0; d < cell_count; d++) {
+                    if (owner[d] >= 0) continue;
+                    const int32_t* n = &domain.neighbors[d * 6];
+                    float sum = 0.0f;
+                    int count = 0;
+                    for (int k = 0; k < 6; k++) {
+                        if (n[k] >= 0) {
+                            sum += field[n[k]];
+                            count++;
+                        }
+                    }
+                    if (!count) continue;
+                    float change = VOXEL_SOR_OMEGA * (sum / count - field[d]);
+                    float value = field[d] + change;
+                    field[d] = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+                    change = fabsf(change);
+                    if (change > max_change) max_change = change;
+                }
+                if (max_change < VOXEL_CONVERGED) break;
+            }
+
+            float* out = &heat[b * vertex_count];
+            for (size_t v = 0; v < vertex_count; v++) {
+                float h = 0.0f;
+                for (int k = 0; k < 8; k++) {
+                    int32_t d = stencil_cells[v * 8 + k];
+                    if (d >= 0) h += field[d] * stencil_weights[v * 8 + k];
+                }
+                out[v] = h;
+            }
+        });
+
+        // Strongest max_influences bones per vertex, sharpened and normalized
+        global_thread_pool().parallel_for((vertex_count + 1023) / 1024, 0, [&](size_t chunk) {
+            size_t end = (chunk + 1) * 1024 < vertex_count ? (chunk + 1) * 1024 : vertex_count;
+            for (size_t v = chunk * 1024; v < end; v++) {
+                int32_t bones[VOXEL_MAX_INFLUENCES] = {-1, -1, -1, -1};
+                float values[VOXEL_MAX_INFLUENCES] = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (uint32_t b = 0; b < bone_count; b++) {
+                    float h = heat[(size_t)b * vertex_count + v];
+                    if (!(h > 1e-6f) || h <= values[max_influences - 1]) continue;
+                    uint32_t slot = max_influences - 1;
+                    while (slot > 0 && h > values[slot - 1]) {
+                        values[slot] = values[slot - 1];
+                        bones[slot] = bones[slot - 1];
+                        slot--;
+                    }
+                    values[slot] = h;
+                    bones[slot] = (int32_t)b;
+                }
+
+                float total = 0.0f;
+                for (uint32_t k = 0; k < max_influences; k++) {
+                    if (bones[k] >= 0) {
+                        values[k] = powf(values[k], falloff_power);
+                        total += values[k];
+                    }
+                }
+                for (uint32_t k = 0; k < VOXEL_MAX_INFLUENCES; k++) {
+                    bool used = k < max_influences && bones[k] >= 0 && total > 0.0f;
+                    out_bones[v * 4 + k] = used ? bones[k] : -1;
+                    out_weights[v * 4 + k] = used ? values[k] / total : 0.0f;
+                }
+            }
+        });
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+// ============================================================================
+// Weight Smoothing
+// ============================================================================
+
+#define SMOOTH_WEIGHTS_NO_GROW  0x1     // Only smooth weights that are already non-zero, from non-zero neighbors,
+                                        // and drop those at or below min_weight after every iteration
+#define SMOOTH_MAX_INFLUENCES   8
+
+// Vertex adjacency in compressed sparse row form: the neighbors of vertex v
+// are neighbors[offsets[v] .. offsets[v + 1])
+struct MESH_ADJACENCY {
+    uint32_t vertex_count;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbors;
+};
+
+/*
+ * Build vertex adjacency from an edge list
+ *
+ * Parameters:
+ *   edges         - edge_count * 2 vertex indices (Blender mesh.edges 'vertices')
+ *   edge_count    - Number of edges
+ *   vertex_count  - Number of vertices
+ *   out_adjacency - Receives the adjacency (free with mesh_adjacency_free)
+ *
+ * Duplicate edges and self loops are dropped.
+ *
+ * Returns:
+ *   0 on success, -4 if out of memory, -5 on invalid arguments or out of range indices
+ */
+DLL_EXPORT int mesh_adjacency_build(const int32_t* edges, uint32_t edge_count, uint32_t vertex_count,
+                                    MESH_ADJACENCY** out_adjacency) {
+    if (!out_adjacency || (edge_count && !edges)) return -5;
+    *out_adjacency = nullptr;
+    for (size_t i = 0; i < (size_t)edge_count * 2; i++) {
+        if (edges[i] < 0 || (uint32_t)edges[i] >= vertex_count) return -5;
+    }
+
+    MESH_ADJACENCY* adjacency = nullptr;
+    try {
+        adjacency = new MESH_ADJACENCY();
+        adjacency->vertex_count = vertex_count;
+        adjacency->offsets.assign((size_t)vertex_count + 1, 0);
+
+        // Count, prefix sum, scatter
+        for (size_t e = 0; e < edge_count; e++) {
+            uint32_t a = (uint32_t)edges[e * 2], b = (uint32_t)edges[e * 2 + 1];
+            if (a == b) continue;
+            adjacency->offsets[a + 1]++;
+            adjacency->offsets[b + 1]++;
+        }
+        for (size_t v = 0; v < vertex_count; v++) adjacency->offsets[v + 1] += adjacency->offsets[v];
+
+        std::vector<uint32_t> cursor(adjacency->offsets.begin(), adjacency->offsets.end() - 1);
+        adjacency->neighbors.resize(adjacency->offsets[vertex_count]);
+        for (size_t e = 0; e < edge_count; e++) {
+            uint32_t a = (uint32_t)edges[e * 2], b = (uint32_t)edges[e * 2 + 1];
+            if (a == b) continue;
+            adjacency->neighbors[cursor[a]++] = b;
+            adjacency->neighbors[cursor[b]++] = a;
+        }
+
+        // Sort each row and squeeze out duplicates in place
+        uint32_t write = 0;
+        for (size_t v = 0; v < vertex_count; v++) {
+            uint32_t begin = adjacency->offsets[v], end = adjacency->offsets[v + 1];
+            uint32_t* row = adjacency->neighbors.data();
+            std::sort(row + begin, row + end);
+            adjacency->offsets[v] = write;
+            for (uint32_t i = begin; i < end; i++) {
+                if (i == begin || row[i] != row[i - 1]) row[write++] = row[i];
+            }
+        }
+        adjacency->offsets[vertex_count] = write;
+        adjacency->neighbors.resize(write);
+        adjacency->neighbors.shrink_to_fit();
+
+        *out_adjacency = adjacency;
+        return 0;
+    } catch (const std::bad_alloc&) {
+        delete adjacency;
+        return -4;
+    }
+}
+
+DLL_EXPORT void mesh_adjacency_free(MESH_ADJACENCY* adjacency) {
+    delete adjacency;
+}
+
+// Keeps the max_influences largest weights of a row (ties keep the lower
+// bone), drops those below min_weight and renormalizes what's left
+static void limit_weight_row(float* row, uint32_t bone_count, uint32_t max_influences, float min_weight) {
+    uint32_t keep[SMOOTH_MAX_INFLUENCES];
+    uint32_t kept = 0;
+
+    for (uint32_t b = 0; b < bone_count; b++) {
+        float w = row[b];
+        if (!(w >= min_weight) || !(w > 0.0f)) continue;
+        if (kept == max_influences && w <= row[keep[kept - 1]]) continue;
+        uint32_t slot = kept < max_influences ? kept++ : kept - 1;
+        while (slot > 0 && w > row[keep[slot - 1]]) {
+            keep[slot] = keep[slot - 1];
+            slot--;
+        }
+        keep[slot] = b;
+    }
+
+    float total = 0.0f;
+    for (uint32_t k = 0; k < kept; k++) total += row[keep[k]];
+    float kept_values[SMOOTH_MAX_INFLUENCES];
+    for (uint32_t k = 0; k < kept; k++) kept_values[k] = row[keep[k]] / total;
+    memset(row, 0, (size_t)bone_count * sizeof(float));
+    for (uint32_t k = 0; k < kept; k++) row[keep[k]] = kept_values[k];
+}
+
+// Zeroes the weights of a row at or below min_weight, so they stop feeding
+// their neighbors in the next NO_GROW iteration
+static void drop_small_weights(float* row, uint32_t bone_count, float min_weight) {
+    for (uint32_t b = 0; b < bone_count; b++) {
+        if (!(row[b] > min_weight)) row[b] = 0.0f;
+    }
+}
+
+/*
+ * Laplacian smoothing of a dense weight matrix
+ *
+ * Parameters:
+ *   adjacency       - Vertex adjacency from mesh_adjacency_build
+ *   weights         - vertex_count * bone_count floats, [vertex][bone]; smoothed in place
+ *   bone_count      - Columns of the matrix
+ *   iterations      - Jacobi iterations: w = w * (1 - strength) + mean(neighbor w) * strength
+ *   strength        - 0..1
+ *   max_influences  - After smoothing, keep this many weights per vertex and renormalize
+ *                     (0: leave the rows as smoothed, 1-8 otherwise)
+ *   min_weight      - Weights below this are zeroed by the limit step; with
+ *                     SMOOTH_WEIGHTS_NO_GROW, weights at or below it are also
+ *                     zeroed after every iteration
+ *   flags           - SMOOTH_WEIGHTS_*
+ *
+ * Vertices without neighbors keep their weights.
+ *
+ * Returns:
+ *   0 on success, -4 if out of memory, -5 on invalid arguments
+ */
+DLL_EXPORT int smooth_weights(const MESH_ADJACENCY* adjacency, float* weights, uint32_t bone_count,
+                              uint32_t iterations, float strength, uint32_t max_influences,
+                              float min_weight, uint32_t flags) {
+    if (!adjacency || !weights || bone_count == 0) return -5;
+    if (!(strength >= 0.0f && strength <= 1.0f) || max_influences > SMOOTH_MAX_INFLUENCES) return -5;
+
+    const size_t vertex_count = adjacency->vertex_count;
+    const size_t chunk_size = 1024;
+    const size_t chunks = (vertex_count + chunk_size - 1) / chunk_size;
+    const bool no_grow = (flags & SMOOTH_WEIGHTS_NO_GROW) != 0;
+
+    try {
+        std::vector<float> scratch(iterations ? vertex_count * bone_count : 0);
+        float* src = weights;
+        float* dst = scratch.data();
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            global_thread_pool().parallel_for(chunks, 0, [&](size_t chunk) {
+                std::vector<float> sum(bone_count);
+                std::vector<uint32_t> count(no_grow ? bone_count : 0);
+                size_t end = (chunk + 1) * chunk_size < vertex_count ? (chunk + 1) * chunk_size : vertex_count;
+
+                for (size_t v = chunk * chunk_size; v < end; v++) {
+                    const float* row = src + v * bone_count;
+                    float* out = dst + v * bone_count;
+                    uint32_t begin = adjacency->offsets[v], stop = adjacency->offsets[v + 1];
+                    if (begin == stop) {
+                        memcpy(out, row, bone_count * sizeof(float));
+                        if (no_grow) drop_small_weights(out, bone_count, min_weight);
+                        continue;
+                    }
+
+                    std::fill(sum.begin(), sum.end(), 0.0f);
+                    if (no_grow) std::fill(count.begin(), count.end(), 0u);
+                    for (uint32_t i = begin; i < stop; i++) {
+                        const float* n = src + (size_t)adjacency->neighbors[i] * bone_count;
+                        for (uint32_t b = 0; b < bone_count; b++) {
+                            sum[b] += n[b];
+                            if (no_grow) count[b] += n[b] != 0.0f;
+                        }
+                    }
+
+                    const float inv_count = 1.0f / (stop - begin);
+                    for (uint32_t b = 0; b < bone_count; b++) {
+                        if (no_grow) {
+                            out[b] = row[b] != 0.0f && count[b]
+                                ? row[b] * (1.0f - strength) + sum[b] / count[b] * strength
+                                : row[b];
+                        } else {
+                            out[b] = row[b] * (1.0f - strength) + sum[b] * inv_count * strength;
+                        }
+                    }
+                    if (no_grow) drop_small_weights(out, bone_count, min_weight);
+                }
+            });
+            std::swap(src, dst);
+        }
+
+        // Fused with the copy back when the result ended up in scratch
+        global_thread_pool().parallel_for(chunks, 0, [&](size_t chunk) {
+            size_t end = (chunk + 1) * chunk_size < vertex_count ? (chunk + 1) * chunk_size : vertex_count;
+            for (size_t v = chunk * chunk_size; v < end; v++) {
+                float* row = weights + v * bone_count;
+                if (src != weights) memcpy(row, src + v * bone_count, bone_count * sizeof(float));
+                if (max_influences) limit_weight_row(row, bone_count, max_influences, min_weight);
+            }
+        });
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
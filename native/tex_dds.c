@@ -0,0 +1,346 @@
+/*
+ * TEX to DDS conversion core (from ritoddstex)
+ * Compiled into tex_converter.dll (ritoddstex_dll.c) and lol_native.dll
+ * (lol_native.cpp); see tex_dds.h
+ */
+
+// platform.h's stat helpers also under a strict -std=c11
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+    #define _XOPEN_SOURCE 700
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "platform.h"
+#include "tex_dds.h"
+
+// Helper: max macro
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+// Helper: count leading zeros
+static inline uint32_t clz32(uint32_t x) {
+    if (x) {
+        return 31 - platform_bit_scan_reverse(x);
+    }
+    return 32;
+}
+
+// Helper: calculate mipmap count
+static inline uint32_t calc_mipmap_count(uint32_t width, uint32_t height) {
+    uint32_t max_dim = MAX(width, height);
+    return 32 - clz32(max_dim);
+}
+
+// Get bytes per block for format
+static int get_bytes_per_block(uint8_t format) {
+    switch (format) {
+        case TEX_FORMAT_DXT1:  return 8;
+        case TEX_FORMAT_DXT5:  return 16;
+        case TEX_FORMAT_BGRA8: return 4;
+        case TEX_FORMAT_RGBA16: return 8;
+        default: return 0;
+    }
+}
+
+// Get block size for format
+static int get_block_size(uint8_t format) {
+    switch (format) {
+        case TEX_FORMAT_DXT1:
+        case TEX_FORMAT_DXT5:
+            return 4;
+        case TEX_FORMAT_BGRA8:
+        case TEX_FORMAT_RGBA16:
+            return 1;
+        default: return 1;
+    }
+}
+
+// Validate a TEX header and compute the DDS header/sizes for it
+int tex_build_layout(const TEX_HEADER* tex_header, uint64_t file_size, DDS_LAYOUT* layout) {
+    DDS_PIXELFORMAT ddspf = {0};
+    DDS_HEADER dds_header = {0};
+    const char* fourcc = NULL;
+    int need_dx10 = 0;
+    uint32_t mipmap_count = 0;
+
+    if (file_size < sizeof(TEX_HEADER) || file_size > 0xffffffffu ||
+        memcmp(tex_header->magic, TEX_MAGIC, 3) != 0) {
+        return -2; // Invalid TEX
+    }
+
+    // Setup DDS pixel format
+    ddspf.dwSize = sizeof(DDS_PIXELFORMAT);
+
+    switch (tex_header->tex_format) {
+        case TEX_FORMAT_DXT1:
+            fourcc = "DXT1";
+            ddspf.dwFlags = DDS_FOURCC;
+            break;
+        case TEX_FORMAT_DXT5:
+            fourcc = "DXT5";
+            ddspf.dwFlags = DDS_FOURCC;
+            break;
+        case TEX_FORMAT_BGRA8:
+            ddspf.dwFlags = DDS_RGBA;
+            ddspf.dwRGBBitCount = 32;
+            ddspf.dwBBitMask = 0x000000ff;
+            ddspf.dwGBitMask = 0x0000ff00;
+            ddspf.dwRBitMask = 0x00ff0000;
+            ddspf.dwABitMask = 0xff000000;
+            break;
+        case TEX_FORMAT_RGBA16:
+            // DX10 extended format - simplified handling
+            fourcc = "DX10";
+            ddspf.dwFlags = DDS_FOURCC;
+            need_dx10 = 1;
+            break;
+        default:
+            return -3; // Unsupported format
+    }
+
+    if (fourcc) {
+        memcpy(ddspf.dwFourCC, fourcc, 4);
+    }
+
+    // Setup DDS header
+    dds_header.dwSize = sizeof(DDS_HEADER);
+    dds_header.dwFlags = DDS_HEADER_FLAGS_TEXTURE;
+    dds_header.dwHeight = tex_header->image_height;
+    dds_header.dwWidth = tex_header->image_width;
+    dds_header.ddspf = ddspf;
+    dds_header.dwCaps = DDS_SURFACE_FLAGS_TEXTURE;
+
+    if (tex_header->has_mipmaps) {
+        dds_header.dwFlags |= DDS_HEADER_FLAGS_MIPMAP;
+        dds_header.dwCaps |= DDS_SURFACE_FLAGS_MIPMAP;
+        mipmap_count = calc_mipmap_count(tex_header->image_width, tex_header->image_height);
+        dds_header.dwMipMapCount = mipmap_count;
+    }
+
+    // Calculate output size
+    layout->tex = *tex_header;
+    layout->dds = dds_header;
+    layout->need_dx10 = need_dx10;
+    layout->mipmap_count = mipmap_count;
+    layout->data_size = (uint32_t)(file_size - sizeof(TEX_HEADER));
+    layout->header_size = 4 + sizeof(DDS_HEADER); // "DDS " + header
+    if (need_dx10) {
+        layout->header_size += 20; // DX10 extended header
+    }
+    layout->total_size = layout->header_size + layout->data_size;
+    return 0;
+}
+
+// Size in bytes of mip level i
+uint32_t tex_mip_size(const TEX_HEADER* tex_header, uint32_t i) {
+    uint32_t block_size = get_block_size(tex_header->tex_format);
+    uint32_t bytes_per_block = get_bytes_per_block(tex_header->tex_format);
+    uint32_t mip_width = MAX(tex_header->image_width >> i, 1);
+    uint32_t mip_height = MAX(tex_header->image_height >> i, 1);
+    uint32_t block_width = (mip_width + block_size - 1) / block_size;
+    uint32_t block_height = (mip_height + block_size - 1) / block_size;
+    return bytes_per_block * block_width * block_height;
+}
+
+// Write "DDS " + header (+ DX10 header), returns pointer past it
+static uint8_t* write_dds_header(const DDS_LAYOUT* layout, uint8_t* ptr) {
+    // Write DDS magic
+    memcpy(ptr, DDS_MAGIC, 4);
+    ptr += 4;
+
+    // Write DDS header
+    memcpy(ptr, &layout->dds, sizeof(DDS_HEADER));
+    ptr += sizeof(DDS_HEADER);
+
+    // Write DX10 header if needed
+    if (layout->need_dx10) {
+        uint8_t dx10_header[20] = {0};
+        // dxgiFormat = DXGI_FORMAT_R16G16B16A16_SNORM (0x0d)
+        dx10_header[0] = 0x0d;
+        // resourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D (3)
+        dx10_header[4] = 0x03;
+        // arraySize = 1
+        dx10_header[12] = 0x01;
+        // miscFlags2 = DDS_ALPHA_MODE_STRAIGHT (1)
+        dx10_header[16] = 0x01;
+        memcpy(ptr, dx10_header, 20);
+        ptr += 20;
+    }
+    return ptr;
+}
+
+// Copy the TEX payload into DDS order (TEX stores mips in reverse order
+// compared to DDS). Bytes not covered by a complete mip chain are zeroed.
+static void write_dds_mips(const DDS_LAYOUT* layout, const uint8_t* tex_data, uint8_t* ptr) {
+    uint8_t* end = ptr + layout->data_size;
+    int64_t current_offset = layout->data_size;
+    uint32_t i;
+
+    if (!layout->tex.has_mipmaps || layout->mipmap_count == 0) {
+        // No mipmaps - straight copy
+        memcpy(ptr, tex_data, layout->data_size);
+        return;
+    }
+
+    for (i = 0; i < layout->mipmap_count; i++) {
+        uint32_t mip_size = tex_mip_size(&layout->tex, i);
+        current_offset -= mip_size;
+        if (current_offset < 0) {
+            break;
+        }
+        memcpy(ptr, tex_data + current_offset, mip_size);
+        ptr += mip_size;
+    }
+    if (ptr < end) {
+        memset(ptr, 0, end - ptr);
+    }
+}
+
+// Fallback for files that can't be mapped: stream each mip straight into
+// the output buffer instead of staging the whole payload
+static int tex_read_mips_stdio(FILE* tex_file, const DDS_LAYOUT* layout, uint8_t* ptr) {
+    uint8_t* end = ptr + layout->data_size;
+    int64_t current_offset = layout->data_size;
+    uint32_t i;
+
+    if (!layout->tex.has_mipmaps || layout->mipmap_count == 0) {
+        return fread(ptr, 1, layout->data_size, tex_file) == layout->data_size ? 0 : -2;
+    }
+
+    for (i = 0; i < layout->mipmap_count; i++) {
+        uint32_t mip_size = tex_mip_size(&layout->tex, i);
+        current_offset -= mip_size;
+        if (current_offset < 0) {
+            break;
+        }
+        if (fseek(tex_file, (long)(sizeof(TEX_HEADER) + current_offset), SEEK_SET) != 0 ||
+            fread(ptr, 1, mip_size, tex_file) != mip_size) {
+            return -2;
+        }
+        ptr += mip_size;
+    }
+    if (ptr < end) {
+        memset(ptr, 0, end - ptr);
+    }
+    return 0;
+}
+
+// Open tex_path with stdio and read its TEX header
+int tex_open_stdio(const char* tex_path, FILE** out_file, TEX_HEADER* tex_header, uint64_t* file_size) {
+    long size;
+    FILE* tex_file = fopen_utf8(tex_path, "rb");
+    if (!tex_file) {
+        return -1; // Failed to open
+    }
+
+    // Get file size
+    fseek(tex_file, 0, SEEK_END);
+    size = ftell(tex_file);
+    rewind(tex_file);
+
+    // Read TEX header
+    if (size < (long)sizeof(TEX_HEADER) ||
+        fread(tex_header, sizeof(TEX_HEADER), 1, tex_file) != 1) {
+        fclose(tex_file);
+        return -2; // Invalid TEX
+    }
+
+    *out_file = tex_file;
+    *file_size = (uint64_t)size;
+    return 0;
+}
+
+int tex_dds_convert(const uint8_t* src, uint64_t src_len, uint8_t* out_buf, uint32_t capacity,
+                    uint8_t** out_alloc, uint32_t* out_size) {
+    TEX_HEADER tex_header;
+    DDS_LAYOUT layout;
+    uint8_t* dds_data;
+    uint8_t* ptr;
+    int rc;
+
+    if (!src || src_len < sizeof(TEX_HEADER)) {
+        return -2; // Invalid TEX
+    }
+    memcpy(&tex_header, src, sizeof(TEX_HEADER));
+
+    rc = tex_build_layout(&tex_header, src_len, &layout);
+    if (rc == 0 && out_buf && capacity < layout.total_size) {
+        rc = -6; // Buffer too small
+    }
+    if (out_size && (rc == 0 || rc == -6)) {
+        *out_size = layout.total_size;
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    // Allocate output buffer unless the caller supplied one
+    dds_data = out_buf ? out_buf : (uint8_t*)malloc(layout.total_size);
+    if (!dds_data) {
+        return -4; // Alloc failed
+    }
+
+    ptr = write_dds_header(&layout, dds_data);
+    write_dds_mips(&layout, src + sizeof(TEX_HEADER), ptr);
+    if (out_alloc) {
+        *out_alloc = dds_data;
+    }
+    return 0;
+}
+
+int tex_dds_convert_stdio(FILE* tex_file, const TEX_HEADER* tex_header, uint64_t file_size,
+                          uint8_t* out_buf, uint32_t capacity, uint8_t** out_alloc, uint32_t* out_size) {
+    DDS_LAYOUT layout;
+    uint8_t* dds_data;
+    uint8_t* ptr;
+    int rc;
+
+    rc = tex_build_layout(tex_header, file_size, &layout);
+    if (rc == 0 && out_buf && capacity < layout.total_size) {
+        rc = -6; // Buffer too small
+    }
+    if (out_size && (rc == 0 || rc == -6)) {
+        *out_size = layout.total_size;
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    dds_data = out_buf ? out_buf : (uint8_t*)malloc(layout.total_size);
+    if (!dds_data) {
+        return -4; // Alloc failed
+    }
+
+    ptr = write_dds_header(&layout, dds_data);
+    rc = tex_read_mips_stdio(tex_file, &layout, ptr);
+    if (rc != 0) {
+        if (!out_buf) free(dds_data);
+    } else if (out_alloc) {
+        *out_alloc = dds_data;
+    }
+    return rc;
+}
+
+int tex_dds_query(const char* tex_path, uint32_t* out_size) {
+    FILE* tex_file;
+    TEX_HEADER tex_header;
+    DDS_LAYOUT layout;
+    uint64_t file_size;
+    int rc;
+
+    rc = tex_open_stdio(tex_path, &tex_file, &tex_header, &file_size);
+    if (rc != 0) {
+        return rc;
+    }
+    fclose(tex_file);
+
+    rc = tex_build_layout(&tex_header, file_size, &layout);
+    if (rc != 0) {
+        return rc;
+    }
+
+    *out_size = layout.total_size;
+    return 0;
+}
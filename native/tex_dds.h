@@ -0,0 +1,70 @@
+#ifndef TEX_DDS_H
+#define TEX_DDS_H
+
+/*
+ * TEX to DDS conversion core (from ritoddstex), compiled into both
+ * tex_converter.dll and lol_native.dll. Each library wraps it in its own
+ * tex_to_dds_* exports and brings its own file access.
+ *
+ * Error codes are those of the exports:
+ *   -1: Failed to open file
+ *   -2: Invalid TEX file
+ *   -3: Unsupported format
+ *   -4: Memory allocation failed
+ *   -6: Output buffer smaller than the DDS data
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "dds.h"
+#include "tex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Everything needed to turn a TEX payload into a DDS file
+typedef struct {
+    TEX_HEADER tex;
+    DDS_HEADER dds;
+    int need_dx10;
+    uint32_t mipmap_count;
+    uint32_t header_size;   // "DDS " + DDS_HEADER (+ DX10 header)
+    uint32_t data_size;     // TEX payload after TEX_HEADER
+    uint32_t total_size;
+} DDS_LAYOUT;
+
+// Validate a TEX header and compute the DDS header/sizes for it
+int tex_build_layout(const TEX_HEADER* tex_header, uint64_t file_size, DDS_LAYOUT* layout);
+
+// Size in bytes of mip level i
+uint32_t tex_mip_size(const TEX_HEADER* tex_header, uint32_t i);
+
+// Open tex_path with stdio and read its TEX header
+int tex_open_stdio(const char* tex_path, FILE** out_file, TEX_HEADER* tex_header, uint64_t* file_size);
+
+/*
+ * Convert the TEX file contents src into out_buf when given (capacity
+ * bytes), otherwise into a malloc'd buffer returned through out_alloc.
+ * out_size, when given, receives the DDS size on success and on -6.
+ */
+int tex_dds_convert(const uint8_t* src, uint64_t src_len, uint8_t* out_buf, uint32_t capacity,
+                    uint8_t** out_alloc, uint32_t* out_size);
+
+/*
+ * Same as tex_dds_convert for a file opened with tex_open_stdio, for files
+ * that can't be mapped: each mip is read straight into the output buffer
+ * instead of staging the whole payload.
+ */
+int tex_dds_convert_stdio(FILE* tex_file, const TEX_HEADER* tex_header, uint64_t file_size,
+                          uint8_t* out_buf, uint32_t capacity, uint8_t** out_alloc, uint32_t* out_size);
+
+// DDS size tex_dds_convert produces for a TEX file; only its header is read
+int tex_dds_query(const char* tex_path, uint32_t* out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEX_DDS_H
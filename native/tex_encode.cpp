@@ -0,0 +1,624 @@
+/*
+ * TEX Encoding - RGBA8 pixels to TEX (BC1/BC3/BGRA8) for the Blender addon
+ * Compiled into lol_native.dll alongside lol_native.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "platform.h"
+#include "tex.h"
+#include "thread_pool.h"
+
+// ============================================================================
+// TEX Layout
+// ============================================================================
+
+#define TEX_ENCODE_FLIP_Y   0x1   // Input rows are bottom-up (Blender image order)
+#define TEX_ENCODE_MIPMAPS  0x2   // Generate and store the full mip chain
+#define TEX_ENCODE_KAISER   0x4   // Kaiser-windowed sinc mip filter instead of a 2x2 box
+#define TEX_ENCODE_SRGB     0x8   // Filter color channels in linear light (input is sRGB)
+
+static uint32_t mip_count_for(uint32_t width, uint32_t height) {
+    uint32_t max_dim = width > height ? width : height;
+    uint32_t count = 0;
+    while (max_dim > 0) { count++; max_dim >>= 1; }
+    return count;
+}
+
+// Size in bytes of one level, as tex_mip_size computes it when decoding
+static size_t encoded_level_size(uint8_t format, uint32_t width, uint32_t height) {
+    if (format == TEX_FORMAT_BGRA8) return (size_t)width * height * 4;
+    size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+    return blocks * (format == TEX_FORMAT_DXT1 ? 8 : 16);
+}
+
+// ============================================================================
+// Mip Generation
+// ============================================================================
+
+struct EncodeLevel {
+    uint32_t width;
+    uint32_t height;
+    const uint8_t* pixels;          // RGBA8, top-down
+    std::vector<uint8_t> storage;   // Owns pixels unless it is the caller's level 0
+};
+
+// Source texels and weights of every output texel along one axis
+struct FilterTaps {
+    uint32_t taps = 0;              // Per output texel
+    std::vector<uint32_t> index;    // Clamped source texel
+    std::vector<float> weight;      // Normalized to sum 1
+};
+
+static const float KAISER_RADIUS = 3.0f;    // In output texels
+static const float KAISER_ALPHA = 4.0f;
+static const double PI = 3.14159265358979323846;
+
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+static float kaiser_weight(float t) {
+    float r = t / KAISER_RADIUS;
+    if (r <= -1.0f || r >= 1.0f) return 0.0f;
+    float sinc = t == 0.0f ? 1.0f : (float)(sin(PI * t) / (PI * t));
+    double window = bessel_i0(KAISER_ALPHA * sqrt(1.0 - (double)r * r)) / bessel_i0(KAISER_ALPHA);
+    return sinc * (float)window;
+}
+
+static void build_taps(uint32_t src, uint32_t dst, bool kaiser, FilterTaps& out) {
+    if (src == dst) {
+        out.taps = 1;
+        out.index.resize(dst);
+        out.weight.assign(dst, 1.0f);
+        for (uint32_t x = 0; x < dst; x++) out.index[x] = x;
+        return;
+    }
+
+    if (!kaiser) {
+        out.taps = 2;
+        out.index.resize((size_t)dst * 2);
+        out.weight.assign((size_t)dst * 2, 0.5f);
+        for (uint32_t x = 0; x < dst; x++) {
+            out.index[x * 2] = x * 2;
+            out.index[x * 2 + 1] = x * 2 + 1 < src ? x * 2 + 1 : src - 1;
+        }
+        return;
+    }
+
+    float scale = (float)src / (float)dst;
+    out.taps = (uint32_t)ceil(KAISER_RADIUS * scale * 2.0f) + 1;
+    out.index.resize((size_t)dst * out.taps);
+    out.weight.resize((size_t)dst * out.taps);
+    for (uint32_t x = 0; x < dst; x++) {
+        float center = ((float)x + 0.5f) * scale;
+        int first = (int)floor(center - KAISER_RADIUS * scale);
+        float sum = 0.0f;
+        for (uint32_t k = 0; k < out.taps; k++) {
+            int i = first + (int)k;
+            float w = kaiser_weight(((float)i + 0.5f - center) / scale);
+            int clamped = i < 0 ? 0 : (i >= (int)src ? (int)src - 1 : i);
+            out.index[(size_t)x * out.taps + k] = (uint32_t)clamped;
+            out.weight[(size_t)x * out.taps + k] = w;
+            sum += w;
+        }
+        for (uint32_t k = 0; k < out.taps; k++) out.weight[(size_t)x * out.taps + k] /= sum;
+    }
+}
+
+// sRGB <-> linear conversion for the filter, built once on first use
+struct SrgbTables {
+    float to_linear[256];
+    uint8_t to_srgb[4097];      // Indexed by linear * 4096
+};
+
+static const SrgbTables& srgb_tables() {
+    static const SrgbTables tables = [] {
+        SrgbTables t;
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            t.to_linear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i <= 4096; i++) {
+            float l = i / 4096.0f;
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+            t.to_srgb[i] = (uint8_t)(c * 255.0f + 0.5f);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+static const uint32_t MIP_ROWS_PER_TASK = 16;
+
+// Next level of src through separable taps; rows are split across the pool
+static void downsample_level(const EncodeLevel& src, bool kaiser, bool srgb, EncodeLevel& dst) {
+    dst.width = src.width > 1 ? src.width >> 1 : 1;
+    dst.height = src.height > 1 ? src.height >> 1 : 1;
+    dst.storage.resize((size_t)dst.width * dst.height * 4);
+    dst.pixels = dst.storage.data();
+
+    FilterTaps tx, ty;
+    build_taps(src.width, dst.width, kaiser, tx);
+    build_taps(src.height, dst.height, kaiser, ty);
+
+    float unorm[256];
+    for (int i = 0; i < 256; i++) unorm[i] = i / 255.0f;
+    const SrgbTables& tables = srgb_tables();
+    const float* color_in = srgb ? tables.to_linear : unorm;
+
+    // Each task filters the source rows its output rows cover horizontally
+    // once, then combines them vertically
+    uint32_t tasks = (dst.height + MIP_ROWS_PER_TASK - 1) / MIP_ROWS_PER_TASK;
+    global_thread_pool().parallel_for(tasks, 0, [&](size_t task) {
+        uint32_t y_begin = (uint32_t)task * MIP_ROWS_PER_TASK;
+        uint32_t y_end = y_begin + MIP_ROWS_PER_TASK;
+        if (y_end > dst.height) y_end = dst.height;
+
+        uint32_t first = UINT32_MAX, last = 0;
+        for (size_t k = (size_t)y_begin * ty.taps; k < (size_t)y_end * ty.taps; k++) {
+            first = ty.index[k] < first ? ty.index[k] : first;
+            last = ty.index[k] > last ? ty.index[k] : last;
+        }
+
+        size_t row_values = (size_t)dst.width * 4;
+        std::vector<float> filtered((size_t)(last - first + 1) * row_values);
+        for (uint32_t sy = first; sy <= last; sy++) {
+            const uint8_t* src_row = src.pixels + (size_t)sy * src.width * 4;
+            float* acc = &filtered[(size_t)(sy - first) * row_values];
+            for (uint32_t x = 0; x < dst.width; x++, acc += 4) {
+                float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+                for (uint32_t kx = 0; kx < tx.taps; kx++) {
+                    float w = tx.weight[(size_t)x * tx.taps + kx];
+                    const uint8_t* s = src_row + (size_t)tx.index[(size_t)x * tx.taps + kx] * 4;
+                    r += w * color_in[s[0]];
+                    g += w * color_in[s[1]];
+                    b += w * color_in[s[2]];
+                    a += w * unorm[s[3]];
+                }
+                acc[0] = r; acc[1] = g; acc[2] = b; acc[3] = a;
+            }
+        }
+
+        std::vector<float> row(row_values);
+        for (uint32_t y = y_begin; y < y_end; y++) {
+            std::fill(row.begin(), row.end(), 0.0f);
+            for (uint32_t ky = 0; ky < ty.taps; ky++) {
+                float wy = ty.weight[(size_t)y * ty.taps + ky];
+                if (wy == 0.0f) continue;
+                const float* h = &filtered[(size_t)(ty.index[(size_t)y * ty.taps + ky] - first) * row_values];
+                for (size_t i = 0; i < row_values; i++) row[i] += wy * h[i];
+            }
+
+            // Kaiser lobes can overshoot, so every channel is clamped
+            uint8_t* out = dst.storage.data() + (size_t)y * dst.width * 4;
+            for (uint32_t i = 0; i < dst.width * 4; i++) {
+                float v = row[i];
+                v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+                if (srgb && (i & 3) != 3) {
+                    out[i] = tables.to_srgb[(int)(v * 4096.0f + 0.5f)];
+                } else {
+                    out[i] = (uint8_t)(v * 255.0f + 0.5f);
+                }
+            }
+        }
+    });
+}
+
+// ============================================================================
+// BC1/BC3 Block Compression
+// ============================================================================
+
+// 4x4 texels starting at (bx, by); edge blocks repeat the last row/column
+static void load_block(const EncodeLevel& level, uint32_t bx, uint32_t by, uint8_t block[16][4]) {
+    for (uint32_t y = 0; y < 4; y++) {
+        uint32_t sy = by + y < level.height ? by + y : level.height - 1;
+        for (uint32_t x = 0; x < 4; x++) {
+            uint32_t sx = bx + x < level.width ? bx + x : level.width - 1;
+            memcpy(block[y * 4 + x], level.pixels + ((size_t)sy * level.width + sx) * 4, 4);
+        }
+    }
+}
+
+static inline uint16_t pack_rgb565(const float* c) {
+    int r = (int)(c[0] * (31.0f / 255.0f) + 0.5f);
+    int g = (int)(c[1] * (63.0f / 255.0f) + 0.5f);
+    int b = (int)(c[2] * (31.0f / 255.0f) + 0.5f);
+    r = r < 0 ? 0 : (r > 31 ? 31 : r);
+    g = g < 0 ? 0 : (g > 63 ? 63 : g);
+    b = b < 0 ? 0 : (b > 31 ? 31 : b);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static inline void unpack_rgb565(uint16_t c, int* out) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// Palette exactly as the decoder expands it
+static void color_palette(uint16_t c0, uint16_t c1, bool four_color, int palette[4][3]) {
+    unpack_rgb565(c0, palette[0]);
+    unpack_rgb565(c1, palette[1]);
+    for (int ch = 0; ch < 3; ch++) {
+        if (four_color) {
+            palette[2][ch] = (2 * palette[0][ch] + palette[1][ch]) / 3;
+            palette[3][ch] = (palette[0][ch] + 2 * palette[1][ch]) / 3;
+        } else {
+            palette[2][ch] = (palette[0][ch] + palette[1][ch]) / 2;
+            palette[3][ch] = 0;
+        }
+    }
+}
+
+// Nearest palette entry for each used texel; returns the squared error
+static uint32_t assign_colors(const uint8_t block[16][4], const bool used[16], const int palette[4][3],
+                              int entries, uint8_t indices[16]) {
+    uint32_t total = 0;
+    for (int i = 0; i < 16; i++) {
+        if (!used[i]) continue;
+        uint32_t best = UINT32_MAX;
+        for (int e = 0; e < entries; e++) {
+            int dr = block[i][0] - palette[e][0];
+            int dg = block[i][1] - palette[e][1];
+            int db = block[i][2] - palette[e][2];
+            uint32_t d = (uint32_t)(dr * dr + dg * dg + db * db);
+            if (d < best) { best = d; indices[i] = (uint8_t)e; }
+        }
+        total += best;
+    }
+    return total;
+}
+
+// Endpoints minimizing the error for fixed indices; false if degenerate
+static bool refit_endpoints(const uint8_t block[16][4], const bool used[16], const uint8_t indices[16],
+                            bool four_color, float e0[3], float e1[3]) {
+    static const float weight4[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    static const float weight3[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+    const float* weight = four_color ? weight4 : weight3;
+
+    float aa = 0, ab = 0, bb = 0, ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        if (!used[i]) continue;
+        float a = weight[indices[i]], b = 1.0f - a;
+        aa += a * a; ab += a * b; bb += b * b;
+        for (int ch = 0; ch < 3; ch++) {
+            ax[ch] += a * block[i][ch];
+            bx[ch] += b * block[i][ch];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (fabsf(det) < 1e-6f) return false;
+
+    for (int ch = 0; ch < 3; ch++) {
+        e0[ch] = (ax[ch] * bb - bx[ch] * ab) / det;
+        e1[ch] = (bx[ch] * aa - ax[ch] * ab) / det;
+        e0[ch] = e0[ch] < 0 ? 0 : (e0[ch] > 255 ? 255 : e0[ch]);
+        e1[ch] = e1[ch] < 0 ? 0 : (e1[ch] > 255 ? 255 : e1[ch]);
+    }
+    return true;
+}
+
+// Initial endpoints: extremes of the used texels along their principal axis
+static void principal_endpoints(const uint8_t block[16][4], const bool used[16], float e0[3], float e1[3]) {
+    float mean[3] = { 0, 0, 0 };
+    int n = 0;
+    for (int i = 0; i < 16; i++) {
+        if (!used[i]) continue;
+        for (int ch = 0; ch < 3; ch++) mean[ch] += block[i][ch];
+        n++;
+    }
+    for (int ch = 0; ch < 3; ch++) mean[ch] /= (float)n;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };   // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++) {
+        if (!used[i]) continue;
+        float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iter = 0; iter < 8; iter++) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float len = fmaxf(fabsf(x), fmaxf(fabsf(y), fabsf(z)));
+        if (len < 1e-6f) break;
+        axis[0] = x / len; axis[1] = y / len; axis[2] = z / len;
+    }
+
+    float lo = 1e30f, hi = -1e30f;
+    int lo_i = 0, hi_i = 0;
+    for (int i = 0; i < 16; i++) {
+        if (!used[i]) continue;
+        float d = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+        if (d < lo) { lo = d; lo_i = i; }
+        if (d > hi) { hi = d; hi_i = i; }
+    }
+    for (int ch = 0; ch < 3; ch++) {
+        e0[ch] = block[hi_i][ch];
+        e1[ch] = block[lo_i][ch];
+    }
+}
+
+static void write_color_block(uint16_t c0, uint16_t c1, const uint8_t indices[16], uint8_t* out) {
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint32_t)indices[i] << (2 * i);
+    out[0] = (uint8_t)c0; out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)c1; out[3] = (uint8_t)(c1 >> 8);
+    memcpy(out + 4, &bits, 4);
+}
+
+static const int COLOR_REFINE_STEPS = 2;
+
+// BC1 color block (8 bytes). With punch_through, texels with alpha < 128
+// become transparent through the three-color mode; BC3 passes false since
+// its color block is always decoded in four-color mode.
+static void encode_color_block(const uint8_t block[16][4], bool punch_through, uint8_t* out) {
+    bool used[16];
+    int opaque = 0;
+    for (int i = 0; i < 16; i++) {
+        used[i] = !punch_through || block[i][3] >= 128;
+        opaque += used[i];
+    }
+    bool four_color = opaque == 16;
+
+    uint8_t indices[16];
+    if (opaque == 0) {
+        memset(indices, 3, sizeof(indices));
+        write_color_block(0, 0, indices, out);
+        return;
+    }
+
+    float e0[3], e1[3];
+    principal_endpoints(block, used, e0, e1);
+
+    uint16_t best_c0 = 0, best_c1 = 0;
+    uint8_t best_indices[16] = {};
+    uint32_t best_error = UINT32_MAX;
+    for (int step = 0; step <= COLOR_REFINE_STEPS; step++) {
+        uint16_t c0 = pack_rgb565(e0), c1 = pack_rgb565(e1);
+        int palette[4][3];
+        color_palette(c0, c1, four_color, palette);
+        uint32_t error = assign_colors(block, used, palette, four_color ? 4 : 3, indices);
+        if (error < best_error) {
+            best_error = error;
+            best_c0 = c0;
+            best_c1 = c1;
+            memcpy(best_indices, indices, sizeof(indices));
+        }
+        if (error == 0 || step == COLOR_REFINE_STEPS) break;
+        if (!refit_endpoints(block, used, indices, four_color, e0, e1)) break;
+    }
+
+    // The endpoint order selects the mode: c0 > c1 four colors, else three
+    static const uint8_t swap_four[4] = { 1, 0, 3, 2 };
+    static const uint8_t swap_three[4] = { 1, 0, 2, 3 };
+    if (four_color) {
+        if (best_c0 == best_c1) {
+            memset(best_indices, 0, sizeof(best_indices));
+        } else if (best_c0 < best_c1) {
+            std::swap(best_c0, best_c1);
+            for (int i = 0; i < 16; i++) best_indices[i] = swap_four[best_indices[i]];
+        }
+    } else {
+        if (best_c0 > best_c1) {
+            std::swap(best_c0, best_c1);
+            for (int i = 0; i < 16; i++) best_indices[i] = swap_three[best_indices[i]];
+        }
+        for (int i = 0; i < 16; i++) {
+            if (!used[i]) best_indices[i] = 3;
+        }
+    }
+    write_color_block(best_c0, best_c1, best_indices, out);
+}
+
+// Alpha palette exactly as the decoder expands it
+static void alpha_palette(int a0, int a1, int palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    } else {
+        for (int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+static uint32_t assign_alpha(const uint8_t block[16][4], const int palette[8], uint8_t indices[16]) {
+    uint32_t total = 0;
+    for (int i = 0; i < 16; i++) {
+        uint32_t best = UINT32_MAX;
+        for (int e = 0; e < 8; e++) {
+            int d = block[i][3] - palette[e];
+            if ((uint32_t)(d * d) < best) { best = (uint32_t)(d * d); indices[i] = (uint8_t)e; }
+        }
+        total += best;
+    }
+    return total;
+}
+
+// BC3 alpha block (8 bytes): the eight-value mode over the alpha range, or
+// the six-value mode with explicit 0 and 255 when that fits better
+static void encode_alpha_block(const uint8_t block[16][4], uint8_t* out) {
+    int lo = 255, hi = 0, inner_lo = 255, inner_hi = 0;
+    for (int i = 0; i < 16; i++) {
+        int a = block[i][3];
+        lo = a < lo ? a : lo;
+        hi = a > hi ? a : hi;
+        if (a != 0 && a != 255) {
+            inner_lo = a < inner_lo ? a : inner_lo;
+            inner_hi = a > inner_hi ? a : inner_hi;
+        }
+    }
+
+    int a0 = hi, a1 = lo;
+    int palette[8];
+    uint8_t indices[16];
+    alpha_palette(a0, a1, palette);
+    uint32_t error = assign_alpha(block, palette, indices);
+
+    if (error > 0 && (lo == 0 || hi == 255)) {
+        int b0 = inner_lo <= inner_hi ? inner_lo : 0;
+        int b1 = inner_lo <= inner_hi ? inner_hi : 0;
+        int six[8];
+        uint8_t six_indices[16];
+        alpha_palette(b0, b1, six);
+        uint32_t six_error = assign_alpha(block, six, six_indices);
+        if (six_error < error) {
+            a0 = b0;
+            a1 = b1;
+            memcpy(indices, six_indices, sizeof(indices));
+        }
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint64_t)indices[i] << (3 * i);
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    for (int i = 0; i < 6; i++) out[2 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+// One row of 4x4 blocks (or of texels for BGRA8) of a level
+static void encode_block_row(const EncodeLevel& level, uint8_t format, uint32_t row, uint8_t* out) {
+    if (format == TEX_FORMAT_BGRA8) {
+        const uint8_t* src = level.pixels + (size_t)row * level.width * 4;
+        for (uint32_t x = 0; x < level.width; x++, src += 4, out += 4) {
+            out[0] = src[2];
+            out[1] = src[1];
+            out[2] = src[0];
+            out[3] = src[3];
+        }
+        return;
+    }
+
+    uint32_t blocks_x = (level.width + 3) / 4;
+    uint8_t block[16][4];
+    for (uint32_t bx = 0; bx < blocks_x; bx++) {
+        load_block(level, bx * 4, row * 4, block);
+        if (format == TEX_FORMAT_DXT1) {
+            encode_color_block(block, true, out);
+            out += 8;
+        } else {
+            encode_alpha_block(block, out);
+            encode_color_block(block, false, out + 8);
+            out += 16;
+        }
+    }
+}
+
+/*
+ * Encode RGBA8 pixels as a TEX file
+ *
+ * Parameters:
+ *   pixels    - width * height RGBA8 texels, top row first unless TEX_ENCODE_FLIP_Y
+ *   width     - Image width (1-65535)
+ *   height    - Image height (1-65535)
+ *   format    - TEX_FORMAT_DXT1 (BC1, alpha < 128 becomes transparent),
+ *               TEX_FORMAT_DXT5 (BC3) or TEX_FORMAT_BGRA8
+ *   flags     - TEX_ENCODE_* flags
+ *   out_data  - Receives the TEX file (free with free_bytes)
+ *   out_size  - Receives the size of the TEX file
+ *
+ * With TEX_ENCODE_MIPMAPS every level down to 1x1 is filtered from the one
+ * above it (2x2 box, or a Kaiser-windowed sinc with TEX_ENCODE_KAISER) and
+ * the levels are stored smallest first, the order tex_to_dds_bytes reverses.
+ * Blocks of all levels are compressed in parallel.
+ *
+ * Returns:
+ *   0 on success, -3 for an unsupported format, -4 on allocation failure,
+ *   -5 on invalid arguments
+ */
+DLL_EXPORT int rgba_to_tex(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t format,
+                           uint32_t flags, uint8_t** out_data, uint32_t* out_size) {
+    if (!pixels || !out_data || !out_size || width == 0 || height == 0 || width > 0xffff || height > 0xffff) {
+        return -5;
+    }
+    *out_data = nullptr;
+    *out_size = 0;
+    if (format != TEX_FORMAT_DXT1 && format != TEX_FORMAT_DXT5 && format != TEX_FORMAT_BGRA8) return -3;
+
+    bool mipmaps = (flags & TEX_ENCODE_MIPMAPS) != 0;
+    uint32_t level_count = mipmaps ? mip_count_for(width, height) : 1;
+    std::vector<EncodeLevel> levels(level_count);
+
+    try {
+        levels[0].width = width;
+        levels[0].height = height;
+        levels[0].pixels = pixels;
+        if (flags & TEX_ENCODE_FLIP_Y) {
+            size_t stride = (size_t)width * 4;
+            levels[0].storage.resize(stride * height);
+            for (uint32_t y = 0; y < height; y++) {
+                memcpy(levels[0].storage.data() + (size_t)y * stride, pixels + (size_t)(height - 1 - y) * stride, stride);
+            }
+            levels[0].pixels = levels[0].storage.data();
+        }
+        for (uint32_t i = 1; i < level_count; i++) {
+            downsample_level(levels[i - 1], (flags & TEX_ENCODE_KAISER) != 0, (flags & TEX_ENCODE_SRGB) != 0, levels[i]);
+        }
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+
+    // Smallest level first: level i starts after every smaller one
+    std::vector<size_t> offsets(level_count);
+    size_t total = sizeof(TEX_HEADER);
+    for (uint32_t i = level_count; i-- > 0;) {
+        offsets[i] = total;
+        total += encoded_level_size((uint8_t)format, levels[i].width, levels[i].height);
+    }
+    if (total > 0xffffffffu) return -5;
+
+    uint8_t* tex = (uint8_t*)malloc(total);
+    if (!tex) return -4;
+
+    TEX_HEADER header = {};
+    memcpy(header.magic, TEX_MAGIC, 4);
+    header.image_width = (uint16_t)width;
+    header.image_height = (uint16_t)height;
+    header.unk1 = 1;
+    header.tex_format = (uint8_t)format;
+    header.has_mipmaps = mipmaps ? 1 : 0;
+    memcpy(tex, &header, sizeof(header));
+
+    try {
+        // One task per block row of every level
+        struct RowTask { uint32_t level; uint32_t row; };
+        std::vector<RowTask> tasks;
+        uint32_t rows_per_block = format == TEX_FORMAT_BGRA8 ? 1 : 4;
+        for (uint32_t i = 0; i < level_count; i++) {
+            uint32_t rows = (levels[i].height + rows_per_block - 1) / rows_per_block;
+            for (uint32_t r = 0; r < rows; r++) tasks.push_back(RowTask{ i, r });
+        }
+
+        global_thread_pool().parallel_for(tasks.size(), 0, [&](size_t t) {
+            const EncodeLevel& level = levels[tasks[t].level];
+            size_t row_bytes = encoded_level_size((uint8_t)format, level.width, rows_per_block);
+            encode_block_row(level, (uint8_t)format, tasks[t].row, tex + offsets[tasks[t].level] + tasks[t].row * row_bytes);
+        });
+    } catch (const std::bad_alloc&) {
+        free(tex);
+        return -4;
+    }
+
+    *out_data = tex;
+    *out_size = (uint32_t)total;
+    return 0;
+}
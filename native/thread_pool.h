@@ -0,0 +1,164 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/*
+ * Fixed-size worker pool shared by the batch exports of the native DLLs
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned thread_count) {
+        if (thread_count == 0) thread_count = 1;
+        workers_.reserve(thread_count);
+        for (unsigned i = 0; i < thread_count; i++) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers_.size(); }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    // Runs fn(i) for every i in [0, count) on at most max_workers threads
+    // (0 = whole pool) and blocks until all of them returned. The calling
+    // thread takes part in the loop, and helpers that were not picked up by
+    // the time it finishes are skipped, so this is safe to call from a worker.
+    // If fn throws, no further indices are handed out and the first exception
+    // is rethrown here once every thread has left the loop.
+    template <class Fn>
+    void parallel_for(size_t count, unsigned max_workers, Fn&& fn) {
+        if (count == 0) return;
+
+        unsigned workers = max_workers ? max_workers : size() + 1;
+        if (workers > size() + 1) workers = size() + 1;
+        if (workers > count) workers = (unsigned)count;
+
+        if (workers <= 1) {
+            for (size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+
+        // Helpers may be dequeued after this call returned, so the state they
+        // touch lives on the heap; fn is only used while active > 0.
+        struct Shared {
+            std::atomic<size_t> next{0};
+            std::mutex mutex;
+            std::condition_variable cv;
+            unsigned active = 0;
+            bool closed = false;
+            std::exception_ptr error;
+        };
+        auto shared = std::make_shared<Shared>();
+        auto run = [count, &fn](Shared& st) {
+            size_t i;
+            try {
+                while ((i = st.next.fetch_add(1)) < count) fn(i);
+            } catch (...) {
+                st.next.store(count);
+                std::lock_guard<std::mutex> lock(st.mutex);
+                if (!st.error) st.error = std::current_exception();
+            }
+        };
+
+        auto close_and_wait = [&shared] {
+            std::unique_lock<std::mutex> lock(shared->mutex);
+            shared->closed = true;
+            shared->cv.wait(lock, [&] { return shared->active == 0; });
+        };
+
+        // Helpers reference run and fn on this frame, so a failed submit must
+        // not unwind before the ones already queued are closed out.
+        try {
+            for (unsigned w = 0; w + 1 < workers; w++) {
+                submit([shared, &run] {
+                    {
+                        std::lock_guard<std::mutex> lock(shared->mutex);
+                        if (shared->closed) return;
+                        shared->active++;
+                    }
+                    run(*shared);
+                    std::lock_guard<std::mutex> lock(shared->mutex);
+                    if (--shared->active == 0) shared->cv.notify_all();
+                });
+            }
+        } catch (...) {
+            shared->next.store(count);
+            close_and_wait();
+            throw;
+        }
+
+        run(*shared);
+
+        close_and_wait();
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        if (shared->error) {
+            lock.unlock();
+            std::rethrow_exception(shared->error);
+        }
+    }
+
+private:
+    void worker_loop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (stopping_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+// Process-wide pool sized to the machine. It is intentionally never destroyed:
+// joining threads from DllMain(DLL_PROCESS_DETACH) deadlocks on the loader lock.
+inline ThreadPool& global_thread_pool() {
+    static ThreadPool* pool = [] {
+        unsigned n = std::thread::hardware_concurrency();
+        return new ThreadPool(n > 1 ? n - 1 : 1);
+    }();
+    return *pool;
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,407 @@
+/*
+ * WAD Reader - reads assets straight out of .wad.client archives
+ * Compiled into lol_native.dll alongside lol_native.cpp (links zstd and zlib)
+ *
+ * The archive is memory-mapped and its TOC sorted by path hash; entries are
+ * decompressed on demand and can be fed to the TEX and BIN pipelines
+ * without extracting anything to disk.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+#include <zstd.h>
+
+#include "binary_reader.h"
+#include "file_map.h"
+#include "native_stats.h"
+#include "platform.h"
+#include "xxhash64.h"
+
+// Defined in lol_native.cpp
+DLL_EXPORT int tex_to_dds_from_memory(const uint8_t* src, uint32_t src_len, uint8_t** out_data, uint32_t* out_size);
+
+// ============================================================================
+// WAD Archive
+// ============================================================================
+
+#define WAD_ENTRY_RAW           0
+#define WAD_ENTRY_GZIP          1
+#define WAD_ENTRY_SATELLITE     2   // Redirect to another file, not supported
+#define WAD_ENTRY_ZSTD          3
+#define WAD_ENTRY_ZSTD_CHUNKED  4   // Concatenated subchunks, described by the .subchunktoc entry
+
+typedef struct {
+    uint64_t path_hash;         // xxhash64 of the lowercase path
+    uint32_t offset;
+    uint32_t compressed_size;
+    uint32_t size;
+    uint8_t type;               // WAD_ENTRY_*
+    uint8_t subchunk_count;
+    uint16_t first_subchunk;
+} WAD_ENTRY;
+
+struct WadSubchunk {
+    uint32_t compressed_size;
+    uint32_t size;
+};
+
+struct WAD_ARCHIVE {
+    MappedFile file;
+    uint32_t major = 0;
+    uint32_t minor = 0;
+    std::vector<WAD_ENTRY> entries;         // Sorted by path_hash
+    std::vector<WadSubchunk> subchunks;
+
+    const WAD_ENTRY* find(uint64_t hash) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), hash,
+                                   [](const WAD_ENTRY& e, uint64_t h) { return e.path_hash < h; });
+        return it != entries.end() && it->path_hash == hash ? &*it : nullptr;
+    }
+};
+
+static uint64_t hash_path(const char* path) {
+    std::string lower = path;
+    for (auto& c : lower) {
+        if (c == '\\') c = '/';
+        else if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return xxhash64(lower.data(), lower.size());
+}
+
+static int wad_read_toc(WAD_ARCHIVE& wad) {
+    ByteReader r = { wad.file.data(), wad.file.size(), 0 };
+
+    uint8_t magic[2], major, minor;
+    if (!r.read(magic, 2) || magic[0] != 'R' || magic[1] != 'W') return -2;
+    if (!r.read(&major, 1) || !r.read(&minor, 1)) return -2;
+    wad.major = major;
+    wad.minor = minor;
+
+    uint32_t entry_count;
+    size_t entry_size;
+    if (major == 1 || major == 2) {
+        uint16_t toc_offset, toc_entry_size;
+        if (major == 2) {
+            uint8_t ecdsa_length;
+            if (!r.read(&ecdsa_length, 1) || !r.skip(83 + 8)) return -2;   // signature, checksum
+        }
+        if (!r.u16(toc_offset) || !r.u16(toc_entry_size) || !r.u32(entry_count)) return -2;
+        if (!r.seek(toc_offset)) return -2;
+        entry_size = toc_entry_size;
+        if (entry_size < 24) return -2;
+    } else if (major == 3) {
+        if (!r.skip(256 + 8) || !r.u32(entry_count)) return -2;            // signature, checksum
+        entry_size = 32;
+    } else {
+        return -3;
+    }
+    if (!r.has((size_t)entry_count * entry_size)) return -2;
+
+    wad.entries.resize(entry_count);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        const uint8_t* src = r.here() + (size_t)i * entry_size;
+        WAD_ENTRY& entry = wad.entries[i];
+        memcpy(&entry.path_hash, src, 8);
+        memcpy(&entry.offset, src + 8, 4);
+        memcpy(&entry.compressed_size, src + 12, 4);
+        memcpy(&entry.size, src + 16, 4);
+        // v3 packs the subchunk count into the high nibble of the type
+        entry.type = major >= 3 ? (src[20] & 0x0f) : src[20];
+        entry.subchunk_count = major >= 3 ? (uint8_t)(src[20] >> 4) : 0;
+        if (major >= 3) memcpy(&entry.first_subchunk, src + 22, 2);
+        else entry.first_subchunk = 0;
+    }
+
+    std::sort(wad.entries.begin(), wad.entries.end(),
+              [](const WAD_ENTRY& a, const WAD_ENTRY& b) { return a.path_hash < b.path_hash; });
+    return 0;
+}
+
+// zstd contexts are reused per thread, creating one costs more than a small frame
+static ZSTD_DCtx* thread_dctx() {
+    struct Holder {
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        ~Holder() { ZSTD_freeDCtx(dctx); }
+    };
+    static thread_local Holder holder;
+    return holder.dctx;
+}
+
+static bool inflate_gzip(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_len) {
+    z_stream stream = {};
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) return false;
+    stream.next_in = (Bytef*)src;
+    stream.avail_in = (uInt)src_len;
+    stream.next_out = dst;
+    stream.avail_out = (uInt)dst_len;
+    int rc = inflate(&stream, Z_FINISH);
+    bool ok = rc == Z_STREAM_END && stream.total_out == dst_len;
+    inflateEnd(&stream);
+    return ok;
+}
+
+static bool decompress_zstd(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_len) {
+    ZSTD_DCtx* dctx = thread_dctx();
+    if (!dctx) return false;
+    size_t written = ZSTD_decompressDCtx(dctx, dst, dst_len, src, src_len);
+    return !ZSTD_isError(written) && written == dst_len;
+}
+
+// Subchunks whose compressed size equals their size are stored as is
+static bool decompress_chunked(const WAD_ARCHIVE& wad, const WAD_ENTRY& entry, const uint8_t* src, uint8_t* dst) {
+    if (entry.subchunk_count == 0 || (size_t)entry.first_subchunk + entry.subchunk_count > wad.subchunks.size()) {
+        return false;
+    }
+
+    size_t in_pos = 0, out_pos = 0;
+    for (uint32_t i = 0; i < entry.subchunk_count; i++) {
+        const WadSubchunk& chunk = wad.subchunks[entry.first_subchunk + i];
+        if (in_pos + chunk.compressed_size > entry.compressed_size || out_pos + chunk.size > entry.size) return false;
+
+        if (chunk.compressed_size == chunk.size) {
+            memcpy(dst + out_pos, src + in_pos, chunk.size);
+        } else if (!decompress_zstd(src + in_pos, chunk.compressed_size, dst + out_pos, chunk.size)) {
+            return false;
+        }
+        in_pos += chunk.compressed_size;
+        out_pos += chunk.size;
+    }
+    return out_pos == entry.size;
+}
+
+static int wad_extract(const WAD_ARCHIVE& wad, const WAD_ENTRY& entry, uint8_t* dst) {
+    if ((uint64_t)entry.offset + entry.compressed_size > wad.file.size()) return -2;
+    const uint8_t* src = wad.file.data() + entry.offset;
+    StatsTimer timer(NATIVE_STAGE_FILE_READ);
+    stats_add(NATIVE_COUNTER_READ_BYTES, entry.compressed_size);
+
+    switch (entry.type) {
+    case WAD_ENTRY_RAW:
+        if (entry.compressed_size != entry.size) return -2;
+        memcpy(dst, src, entry.size);
+        return 0;
+    case WAD_ENTRY_GZIP:
+        return inflate_gzip(src, entry.compressed_size, dst, entry.size) ? 0 : -2;
+    case WAD_ENTRY_ZSTD:
+        return decompress_zstd(src, entry.compressed_size, dst, entry.size) ? 0 : -2;
+    case WAD_ENTRY_ZSTD_CHUNKED:
+        return decompress_chunked(wad, entry, src, dst) ? 0 : -2;
+    default:
+        return -3;
+    }
+}
+
+// The subchunk TOC is stored as "<archive path>.subchunktoc" with the
+// ".client" suffix removed, e.g. "data/final/champions/ahri.wad.subchunktoc".
+// Only the file path is known here, so each suffix starting at a "data"
+// folder is tried.
+static void wad_load_subchunks(WAD_ARCHIVE& wad, const char* archive_path) {
+    std::string path = archive_path;
+    for (auto& c : path) {
+        if (c == '\\') c = '/';
+        else if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    const std::string client = ".client";
+    if (path.size() > client.size() && path.compare(path.size() - client.size(), client.size(), client) == 0) {
+        path.resize(path.size() - client.size());
+    }
+    path += ".subchunktoc";
+
+    const WAD_ENTRY* toc = nullptr;
+    for (size_t pos = 0; !toc && (pos = path.find("data/", pos)) != std::string::npos; pos++) {
+        if (pos > 0 && path[pos - 1] != '/') continue;
+        toc = wad.find(xxhash64(path.data() + pos, path.size() - pos));
+    }
+    if (!toc || toc->type == WAD_ENTRY_ZSTD_CHUNKED) return;
+
+    std::vector<uint8_t> data(toc->size);
+    if (wad_extract(wad, *toc, data.data()) != 0) return;
+
+    // 16 bytes per subchunk: compressed size, size, checksum
+    wad.subchunks.resize(data.size() / 16);
+    for (size_t i = 0; i < wad.subchunks.size(); i++) {
+        memcpy(&wad.subchunks[i].compressed_size, data.data() + i * 16, 4);
+        memcpy(&wad.subchunks[i].size, data.data() + i * 16 + 4, 4);
+    }
+}
+
+/*
+ * Open a WAD archive (v1 to v3)
+ *
+ * Parameters:
+ *   wad_path     - Path to the .wad.client file (UTF-8)
+ *   out_archive  - Receives the archive (close with wad_close)
+ *
+ * The archive stays mapped until wad_close. Reads don't modify it, so one
+ * archive can be read from several threads.
+ *
+ * Returns:
+ *   0 on success, -1 if the file can't be opened, -2 if it isn't a valid WAD,
+ *   -3 for an unsupported version, -4 on allocation failure, -5 on invalid
+ *   arguments
+ */
+DLL_EXPORT int wad_open(const char* wad_path, WAD_ARCHIVE** out_archive) {
+    if (!wad_path || !out_archive) return -5;
+    *out_archive = nullptr;
+
+    // Entry counts and sizes come from the file, so allocations can fail
+    WAD_ARCHIVE* wad = nullptr;
+    try {
+        wad = new WAD_ARCHIVE();
+        StatsTimer timer(NATIVE_STAGE_FILE_READ);
+        if (!wad->file.open(wad_path)) {
+            delete wad;
+            return -1;
+        }
+        int rc = wad_read_toc(*wad);
+        if (rc != 0) {
+            delete wad;
+            return rc;
+        }
+        wad_load_subchunks(*wad, wad_path);
+    } catch (const std::bad_alloc&) {
+        delete wad;
+        return -4;
+    }
+
+    *out_archive = wad;
+    return 0;
+}
+
+DLL_EXPORT void wad_close(WAD_ARCHIVE* archive) {
+    delete archive;
+}
+
+/*
+ * Hash of an asset path as used in WAD TOCs (case and slash direction ignored)
+ */
+DLL_EXPORT uint64_t wad_hash_path(const char* path) {
+    if (!path) return 0;
+    try {
+        return hash_path(path);
+    } catch (const std::bad_alloc&) {
+        return 0;
+    }
+}
+
+/*
+ * Entries of an archive, sorted by path hash
+ *
+ * Parameters:
+ *   archive      - Open archive
+ *   out_entries  - Receives a pointer to the entries, valid until wad_close
+ *   out_count    - Receives the number of entries
+ *
+ * Returns:
+ *   0 on success, -5 on invalid arguments
+ */
+DLL_EXPORT int wad_entries(const WAD_ARCHIVE* archive, const WAD_ENTRY** out_entries, uint32_t* out_count) {
+    if (!archive || !out_entries || !out_count) return -5;
+    *out_entries = archive->entries.data();
+    *out_count = (uint32_t)archive->entries.size();
+    return 0;
+}
+
+/*
+ * Look up an entry by path hash
+ *
+ * Returns:
+ *   0 if found (out_entry filled), 1 if the archive has no such entry,
+ *   -5 on invalid arguments
+ */
+DLL_EXPORT int wad_find(const WAD_ARCHIVE* archive, uint64_t path_hash, WAD_ENTRY* out_entry) {
+    if (!archive || !out_entry) return -5;
+    const WAD_ENTRY* entry = archive->find(path_hash);
+    if (!entry) return 1;
+    *out_entry = *entry;
+    return 0;
+}
+
+/*
+ * Decompress an entry
+ *
+ * Parameters:
+ *   archive    - Open archive
+ *   path_hash  - Entry to read (see wad_hash_path)
+ *   out_data   - Receives the decompressed data (free with free_bytes)
+ *   out_size   - Receives the size of the data in bytes
+ *
+ * Returns:
+ *   0 on success, 1 if the archive has no such entry, -2 if the entry data
+ *   is corrupt, -3 for satellite entries or unknown compression, -4 on
+ *   allocation failure, -5 on invalid arguments
+ */
+DLL_EXPORT int wad_read(const WAD_ARCHIVE* archive, uint64_t path_hash, uint8_t** out_data, uint32_t* out_size) {
+    if (!archive || !out_data || !out_size) return -5;
+    *out_data = nullptr;
+    *out_size = 0;
+
+    const WAD_ENTRY* entry = archive->find(path_hash);
+    if (!entry) return 1;
+
+    // One spare byte so an empty entry still gets a block
+    uint8_t* data = (uint8_t*)malloc((size_t)entry->size + 1);
+    if (!data) return -4;
+    stats_add(NATIVE_COUNTER_ALLOC_BYTES, (size_t)entry->size + 1);
+    int rc = wad_extract(*archive, *entry, data);
+    if (rc != 0) {
+        free(data);
+        return rc;
+    }
+    *out_data = data;
+    *out_size = entry->size;
+    return 0;
+}
+
+/*
+ * Decompress an entry into a caller-provided buffer
+ *
+ * Same as wad_read, writing to out_buf. Returns -6 if capacity is smaller
+ * than the entry (its size is in out_size either way).
+ */
+DLL_EXPORT int wad_read_into(const WAD_ARCHIVE* archive, uint64_t path_hash, uint8_t* out_buf, uint32_t capacity,
+                             uint32_t* out_size) {
+    if (!archive || !out_size || (!out_buf && capacity)) return -5;
+
+    const WAD_ENTRY* entry = archive->find(path_hash);
+    if (!entry) return 1;
+    *out_size = entry->size;
+    if (capacity < entry->size) return -6;
+    return wad_extract(*archive, *entry, out_buf);
+}
+
+// Decompresses an entry into a temporary buffer and hands it to fn
+template <typename Fn>
+static int with_entry(const WAD_ARCHIVE* archive, uint64_t path_hash, Fn&& fn) {
+    const WAD_ENTRY* entry = archive->find(path_hash);
+    if (!entry) return 1;
+
+    try {
+        std::vector<uint8_t> data((size_t)entry->size + 1);
+        int rc = wad_extract(*archive, *entry, data.data());
+        if (rc != 0) return rc;
+        return fn(data.data(), entry->size);
+    } catch (const std::bad_alloc&) {
+        return -4;
+    }
+}
+
+/*
+ * Convert a TEX entry of an archive to DDS
+ *
+ * Same as tex_to_dds_from_memory on the decompressed entry. Additionally
+ * returns 1 when the archive has no such entry.
+ */
+DLL_EXPORT int wad_tex_to_dds(const WAD_ARCHIVE* archive, uint64_t path_hash, uint8_t** out_data, uint32_t* out_size) {
+    if (!archive || !out_data || !out_size) return -5;
+    return with_entry(archive, path_hash, [&](const uint8_t* src, uint32_t len) {
+        return tex_to_dds_from_memory(src, len, out_data, out_size);
+    });
+}
@@ -9,7 +9,9 @@ then transfers weights back to the original.
 import bpy
 import bmesh
 import time
+import numpy as np
 from mathutils.kdtree import KDTree
+from . import voxel_heat
 from bpy.types import Operator, PropertyGroup
 from bpy.props import (
     FloatProperty, IntProperty, BoolProperty,
@@ -175,6 +177,27 @@ def smooth_weights(mesh_obj, iterations=2, factor=0.5):
     mesh = mesh_obj.data
     num_verts = len(mesh.vertices)
 
+    if voxel_heat.native_smoothing_available() and mesh_obj.vertex_groups:
+        # Native: read every group once, smooth all of them, write back once
+        matrix = np.zeros((num_verts, len(mesh_obj.vertex_groups)), dtype=np.float32)
+        for vi, vert in enumerate(mesh.vertices):
+            for g in vert.groups:
+                matrix[vi, g.group] = g.weight
+        original = matrix.copy()
+
+        if voxel_heat.smooth_weight_matrix(mesh, matrix, iterations, factor, min_weight=0.001, no_grow=True):
+            for vg in mesh_obj.vertex_groups:
+                column = matrix[:, vg.index]
+                # Changed weights, plus tiny ones dropped at the same threshold as below
+                touched = (original[:, vg.index] != column) | ((column > 0) & (column <= 0.001))
+                for vi in np.flatnonzero(touched):
+                    w = float(column[vi])
+                    if w > 0.001:
+                        vg.add([int(vi)], w, 'REPLACE')
+                    else:
+                        vg.remove([int(vi)])
+            return
+
     # Build adjacency from edges
     adjacency = [[] for _ in range(num_verts)]
     for edge in mesh.edges:
@@ -261,6 +284,27 @@ def apply_sharpness(mesh_obj, bone_names, power):
 class LOL_GeodesicVoxelProperties(PropertyGroup):
     """Properties for auto skinning"""
 
+    weight_method: EnumProperty(
+        name="Weights",
+        description="How the initial bone weights are computed",
+        items=[
+            ('HEAT_MAP', "Heat Map",
+             "Blender automatic weights on a manifold-fixed copy, transferred back"),
+            ('VOXEL_HEAT', "Voxel Heat",
+             "Native voxel heat diffusion on the mesh itself (no proxy, tolerates "
+             "non-manifold geometry; at most 4 influences per vertex)"),
+        ],
+        default='HEAT_MAP'
+    )
+
+    voxel_resolution: IntProperty(
+        name="Voxel Resolution",
+        description="Voxel grid cells along the longest side of the mesh",
+        default=64,
+        min=16,
+        max=256
+    )
+
     skinning_method: EnumProperty(
         name="Skinning",
         description="Deformation method used by the armature modifier",
@@ -376,7 +420,7 @@ class LOL_OT_GeodesicVoxelSkinning(Operator):
             return {'CANCELLED'}
 
         total_bones = len(armature.data.bones)
-        print(f"[AutoSkin] Falloff: {props.falloff} | Skinning: {props.skinning_method}")
+        print(f"[AutoSkin] Weights: {props.weight_method} | Falloff: {props.falloff} | Skinning: {props.skinning_method}")
         print(f"[AutoSkin] Processing {len(enabled_bones)} of {total_bones} bones")
 
         t_start = time.time()
@@ -416,10 +460,11 @@ class LOL_OT_GeodesicVoxelSkinning(Operator):
             mesh_obj.matrix_parent_inverse = armature.matrix_world.inverted()
 
     def _run_skinning(self, context, mesh_obj, armature, enabled_bones, props):
-        """Run heat map skinning with post-processing."""
-        num = self._run_heat_map(
-            context, mesh_obj, armature, enabled_bones, props
-        )
+        """Run heat map or voxel heat skinning with post-processing."""
+        if props.weight_method == 'VOXEL_HEAT':
+            self._run_voxel_heat(context, mesh_obj, armature, enabled_bones, props)
+        else:
+            self._run_heat_map(context, mesh_obj, armature, enabled_bones, props)
 
         # Post-processing
         bpy.ops.object.select_all(action='DESELECT')
@@ -467,6 +512,24 @@ class LOL_OT_GeodesicVoxelSkinning(Operator):
         print(f"[AutoSkin] Done: {num} vertices weighted")
         return num
 
+    def _run_voxel_heat(self, context, mesh_obj, armature, enabled_bones, props):
+        """Voxel Heat mode: native heat diffusion straight on the mesh."""
+        if not voxel_heat.native_heat_available():
+            self.report({'WARNING'}, "lol_native voxel heat solver not available: used distance weights instead")
+        influences = min(props.max_influences, voxel_heat.NATIVE_MAX_INFLUENCES)
+        if influences < props.max_influences:
+            print(f"[AutoSkin] Voxel heat keeps {influences} influences per vertex "
+                  f"(Max Influences is {props.max_influences})")
+
+        # Smoothing is left to the post-processing passes
+        if not voxel_heat.voxel_heat_diffuse_skinning(
+            context, mesh_obj, armature, enabled_bones,
+            resolution=props.voxel_resolution, iterations=0,
+            max_influences=influences
+        ):
+            raise RuntimeError("Voxel heat skinning failed - see the console")
+        return count_weighted_verts(mesh_obj)
+
     def _run_heat_map(self, context, mesh_obj, armature, enabled_bones, props):
         """Heat Map mode: duplicate, bmesh fix, Blender auto weights, transfer."""
         proxy_obj = None
@@ -714,12 +777,20 @@ def draw_geodesic_panel(layout, context):
 
     # Settings
     col = box.column(align=True)
+    col.prop(props, "weight_method")
     col.prop(props, "skinning_method")
     col.prop(props, "sharpness")
     col.prop(props, "max_influences")
-    col.prop(props, "falloff")
-    col.prop(props, "merge_distance")
-    col.prop(props, "face_interpolation")
+    if props.weight_method == 'VOXEL_HEAT':
+        if not voxel_heat.native_heat_available():
+            col.label(text="lol_native missing: distance weights will be used", icon='ERROR')
+        if props.max_influences > voxel_heat.NATIVE_MAX_INFLUENCES:
+            col.label(text=f"Voxel Heat keeps {voxel_heat.NATIVE_MAX_INFLUENCES} influences", icon='INFO')
+        col.prop(props, "voxel_resolution")
+    else:
+        col.prop(props, "falloff")
+        col.prop(props, "merge_distance")
+        col.prop(props, "face_interpolation")
 
     col.separator()
     col.prop(props, "smooth_iterations")
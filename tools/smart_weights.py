@@ -4,6 +4,7 @@ from bpy.types import Operator, Panel, PropertyGroup
 from bpy.props import PointerProperty, BoolProperty, CollectionProperty, StringProperty, IntProperty, EnumProperty
 from mathutils.geometry import intersect_point_line
 from ..ui import icons
+from ..utils import native_bvh
 
 # Try to import geodesic voxel module
 try:
@@ -370,18 +371,29 @@ class LOL_OT_BindToNearestBone(Operator):
 
         count = 0
 
-        for v in selected_verts:
-            v_world = mw_mesh @ v.co
+        # One batched BVH query instead of every vertex against every bone
+        nearest = None
+        if native_bvh.available():
+            segments = [(*head, *tail) for _, head, tail in bones]
+            with native_bvh.NativeBVH(segments=segments) as bvh:
+                nearest, _ = bvh.nearest([mw_mesh @ v.co for v in selected_verts], 1)
 
+        for vi, v in enumerate(selected_verts):
             best_bone_name = None
-            min_dist = 999999.0
 
-            for name, head, tail in bones:
-                dist, _, _ = get_bone_segment_distance(v_world, head, tail)
+            if nearest is not None:
+                if nearest[vi, 0] >= 0:
+                    best_bone_name = bones[nearest[vi, 0]][0]
+            else:
+                v_world = mw_mesh @ v.co
+                min_dist = 999999.0
+
+                for name, head, tail in bones:
+                    dist, _, _ = get_bone_segment_distance(v_world, head, tail)
 
-                if dist < min_dist:
-                    min_dist = dist
-                    best_bone_name = name
+                    if dist < min_dist:
+                        min_dist = dist
+                        best_bone_name = name
 
             if best_bone_name:
                 dvert = v[dvert_lay]
@@ -5,6 +5,10 @@ Smart Distance Skinning - Maya-Style Algorithm
 Pure distance-based automatic weighting inspired by Maya's 
 "Closest Distance + Classic Linear" bind method.
 
+When lol_native provides voxel_heat_weights, the weights come from heat
+diffusion through a voxelized copy of the mesh instead, so bones only
+influence geometry they are connected to through the volume.
+
 Features:
 - All bones compete equally on pure distance
 - Closest bone to each vertex naturally wins
@@ -17,10 +21,68 @@ License: Same as Aventurine addon
 """
 
 import bpy
+import ctypes
 import numpy as np
 from mathutils import Vector
 from mathutils.geometry import intersect_point_line
 import time
+from ..utils import texture_manager, native_bvh
+
+
+# --- Native solver (lol_native voxel_heat_weights) ---
+_SIGNATURES = {
+    'voxel_heat_weights': ([ctypes.c_void_p, ctypes.c_uint32, ctypes.c_void_p, ctypes.c_uint32,
+                            ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32,
+                            ctypes.c_float, ctypes.c_uint32, ctypes.c_void_p, ctypes.c_void_p], ctypes.c_int),
+    'mesh_adjacency_build': ([ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.POINTER(ctypes.c_void_p)],
+                             ctypes.c_int),
+    'mesh_adjacency_free': ([ctypes.c_void_p], None),
+    'smooth_weights': ([ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32,
+                        ctypes.c_float, ctypes.c_uint32, ctypes.c_float, ctypes.c_uint32], ctypes.c_int),
+}
+
+def _native(name):
+    """lol_native skinning export bound with its signature, or None if unavailable"""
+    return texture_manager.bind_native(name, *_SIGNATURES[name])
+
+
+SMOOTH_WEIGHTS_NO_GROW = 0x1
+# Influences per vertex voxel_heat_weights computes (VOXEL_MAX_INFLUENCES)
+NATIVE_MAX_INFLUENCES = 4
+
+
+def native_smoothing_available():
+    return _native('smooth_weights') is not None
+
+
+def native_heat_available():
+    """True if voxel_heat_diffuse_skinning runs voxel heat rather than falling back to distance weights"""
+    return _native('voxel_heat_weights') is not None
+
+
+def smooth_weight_matrix(mesh, weights, iterations, strength, max_influences=0, min_weight=0.0, no_grow=False):
+    """
+    Laplacian-smooth a (vertex_count, bone_count) float32 weight matrix in place with lol_native.
+    max_influences > 0 also limits and renormalizes every row afterwards.
+    Returns False if the native kernel is unavailable or failed.
+    """
+    if not native_smoothing_available():
+        return False
+
+    edges = np.empty(len(mesh.edges) * 2, dtype=np.int32)
+    mesh.edges.foreach_get('vertices', edges)
+
+    adjacency = ctypes.c_void_p()
+    if _native('mesh_adjacency_build')(edges.ctypes.data, len(edges) // 2, len(mesh.vertices),
+                                       ctypes.byref(adjacency)) != 0:
+        return False
+    try:
+        result = _native('smooth_weights')(adjacency, weights.ctypes.data, weights.shape[1], iterations,
+                                           strength, max_influences, min_weight,
+                                           SMOOTH_WEIGHTS_NO_GROW if no_grow else 0)
+    finally:
+        _native('mesh_adjacency_free')(adjacency)
+    return result == 0
 
 
 def get_bone_distance(point, bone_head, bone_tail):
@@ -86,6 +148,9 @@ def compute_smart_weights(mesh_obj, armature, enabled_bones,
     
     print(f"  Maya-style pure distance for {len(bones_data)} bones...")
     
+    if native_bvh.available() and max_influences <= native_bvh.MAX_NEAREST:
+        return _smart_weights_native(mesh, matrix, bones_data, max_influences, falloff_power, relative_threshold)
+    
     vertex_weights = {}
     
     # For each vertex
@@ -145,6 +210,106 @@ def compute_smart_weights(mesh_obj, armature, enabled_bones,
     return vertex_weights
 
 
+def _smart_weights_native(mesh, matrix, bones_data, max_influences, falloff_power, relative_threshold):
+    """
+    compute_smart_weights through a lol_native bone BVH: the closest
+    max_influences bones per vertex are the only ones that can survive the
+    top-N cut, so the rest are never measured.
+    """
+    segments = np.array([(*b['head'], *b['tail']) for b in bones_data], dtype=np.float32)
+    co = np.empty(len(mesh.vertices) * 3, dtype=np.float32)
+    mesh.vertices.foreach_get('co', co)
+    co = co.reshape(-1, 3)
+    m = np.array(matrix, dtype=np.float32)
+    world = co @ m[:3, :3].T + m[:3, 3]
+
+    k = min(max_influences, len(bones_data))
+    with native_bvh.NativeBVH(segments=segments) as bvh:
+        indices, distances = bvh.nearest(world, k)
+
+    # Distances are clamped before dividing: a vertex lying on a bone is 0 away
+    distances = np.maximum(distances, 0.0001)
+    relative = distances / distances[:, :1]
+    weights = 1.0 / np.power(relative, falloff_power)
+    weights[(relative > relative_threshold) | (weights <= 0.001) | (indices < 0)] = 0.0
+    totals = weights.sum(axis=1)
+
+    vertex_weights = {}
+    for v in np.nonzero(totals > 0)[0]:
+        row = weights[v] / totals[v]
+        vertex_weights[int(v)] = [(bones_data[indices[v, j]]['name'], float(row[j]))
+                                  for j in range(k) if row[j] > 0.0]
+    return vertex_weights
+
+
+def compute_heat_weights_native(mesh_obj, armature, enabled_bones,
+                                max_influences=4,
+                                resolution=64,
+                                iterations=64,
+                                heat_power=1.0):
+    """
+    Voxel heat diffusion weights computed by lol_native. max_influences is
+    clamped to NATIVE_MAX_INFLUENCES.
+
+    Returns:
+        dict: vertex_index -> [(bone_name, weight), ...], or None if the native solver is unavailable
+    """
+    voxel_heat_weights = _native('voxel_heat_weights')
+    if not voxel_heat_weights:
+        return None
+
+    mesh = mesh_obj.data
+    mesh.calc_loop_triangles()
+
+    vertex_count = len(mesh.vertices)
+    positions = np.empty(vertex_count * 3, dtype=np.float32)
+    mesh.vertices.foreach_get('co', positions)
+    matrix = np.array(mesh_obj.matrix_world, dtype=np.float32)
+    positions = positions.reshape(-1, 3) @ matrix[:3, :3].T + matrix[:3, 3]
+    positions = np.ascontiguousarray(positions, dtype=np.float32)
+
+    triangles = np.empty(len(mesh.loop_triangles) * 3, dtype=np.int32)
+    mesh.loop_triangles.foreach_get('vertices', triangles)
+
+    arm_matrix = armature.matrix_world
+    bone_names = [bone.name for bone in armature.data.bones if bone.name in enabled_bones]
+    if not bone_names:
+        print("  No bones to weight!")
+        return {}
+    segments = np.empty((len(bone_names), 6), dtype=np.float32)
+    for i, name in enumerate(bone_names):
+        bone = armature.data.bones[name]
+        segments[i, :3] = arm_matrix @ bone.head_local
+        segments[i, 3:] = arm_matrix @ bone.tail_local
+
+    max_influences = max(1, min(max_influences, NATIVE_MAX_INFLUENCES))
+    print(f"  Native voxel heat diffusion for {len(bone_names)} bones (resolution {resolution})...")
+
+    out_bones = np.empty(vertex_count * NATIVE_MAX_INFLUENCES, dtype=np.int32)
+    out_weights = np.empty(vertex_count * NATIVE_MAX_INFLUENCES, dtype=np.float32)
+    result = voxel_heat_weights(positions.ctypes.data, vertex_count,
+                                triangles.ctypes.data, len(triangles) // 3,
+                                segments.ctypes.data, len(bone_names),
+                                resolution, iterations, heat_power, max_influences,
+                                out_bones.ctypes.data, out_weights.ctypes.data)
+    if result != 0:
+        print(f"  Native voxel heat failed (error {result}), using distance weights")
+        return None
+
+    out_bones = out_bones.reshape(-1, NATIVE_MAX_INFLUENCES)
+    out_weights = out_weights.reshape(-1, NATIVE_MAX_INFLUENCES)
+    vertex_weights = {}
+    for v_idx in range(vertex_count):
+        weights = [(bone_names[b], w) for b, w in zip(out_bones[v_idx], out_weights[v_idx])
+                   if b >= 0 and w > 0.001]
+        if not weights:
+            continue
+        total = sum(w for _, w in weights)
+        vertex_weights[v_idx] = [(name, float(w / total)) for name, w in weights]
+
+    return vertex_weights
+
+
 def smooth_weights(mesh_obj, vertex_weights, iterations=2, strength=0.3, max_influences=4):
     """
     Smooth weights using vertex connectivity.
@@ -154,6 +319,24 @@ def smooth_weights(mesh_obj, vertex_weights, iterations=2, strength=0.3, max_inf
         return vertex_weights
     
     mesh = mesh_obj.data
+
+    # Native: one dense vertex x bone matrix, all iterations in one call
+    if native_smoothing_available():
+        bone_names = sorted({bone_name for weights in vertex_weights.values() for bone_name, _ in weights})
+        if not bone_names:
+            return vertex_weights
+        bone_index = {name: i for i, name in enumerate(bone_names)}
+        matrix = np.zeros((len(mesh.vertices), len(bone_names)), dtype=np.float32)
+        for vert_idx, weights in vertex_weights.items():
+            for bone_name, weight in weights:
+                matrix[vert_idx, bone_index[bone_name]] = weight
+
+        if smooth_weight_matrix(mesh, matrix, iterations, strength, max_influences, 0.001):
+            new_weights = {}
+            for vert_idx in np.flatnonzero(matrix.any(axis=1)):
+                row = matrix[vert_idx]
+                new_weights[int(vert_idx)] = [(bone_names[b], float(row[b])) for b in np.flatnonzero(row)]
+            return new_weights
     
     # Build adjacency
     adjacency = {i: set() for i in range(len(mesh.vertices))}
@@ -262,7 +445,7 @@ def voxel_heat_diffuse_skinning(context, mesh_obj, armature, enabled_bones,
     Main entry point for smart distance skinning.
     
     Parameters (mapped from UI):
-    - resolution: Not used (kept for UI compatibility)
+    - resolution: Voxel grid resolution for the native heat solver
     - iterations: Smoothing passes (0-10)
     - falloff: Controls falloff power (0.5 -> power 1.0, 0.9 -> power 3.0)
     - max_influences: Max bones per vertex
@@ -285,13 +468,21 @@ def voxel_heat_diffuse_skinning(context, mesh_obj, armature, enabled_bones,
         print(f"  Falloff power: {falloff_power:.2f}")
         print(f"  Max influences: {max_influences}")
         
-        # Compute weights
-        vertex_weights = compute_smart_weights(
+        # Compute weights: voxel heat natively, distance weights otherwise
+        vertex_weights = compute_heat_weights_native(
             mesh_obj, armature, enabled_bones,
             max_influences=max_influences,
-            falloff_power=falloff_power,
-            relative_threshold=3.0
+            resolution=max(4, min(256, resolution)),
+            iterations=max(16, resolution),
+            heat_power=1.0 + falloff
         )
+        if vertex_weights is None:
+            vertex_weights = compute_smart_weights(
+                mesh_obj, armature, enabled_bones,
+                max_influences=max_influences,
+                falloff_power=falloff_power,
+                relative_threshold=3.0
+            )
         
         if not vertex_weights:
             print("  No weights computed!")
@@ -131,6 +131,7 @@ class LOL_PT_MainPanel(Panel):
         row = box.row(align=True)
         row.scale_y = 1.2
         row.operator("lol.reload_textures", text="Reload Textures", icon='FILE_REFRESH')
+        row.operator("lol.save_texture_as_tex", text="Save as TEX", icon='EXPORT')
 
 
 
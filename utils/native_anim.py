@@ -0,0 +1,136 @@
+"""
+Native animation baking (lol_native anm_bake_fcurves), shared by the ANM
+importer and the retarget tool. Keyed TRS tracks go in as numpy arrays and
+come back as (frame, value) pairs per pose bone F-curve, which are written
+with keyframe_points.foreach_set instead of one insert per key.
+"""
+
+import ctypes
+import numpy as np
+from . import texture_manager
+
+
+# Same bits as ANM_DATA.key_flags / ANM_KEY_* in native/lol_native.cpp
+KEY_TRANSLATION = 0x1
+KEY_ROTATION = 0x2
+KEY_SCALE = 0x4
+
+BAKE_FLIP = 0x1       # Mirror track values across X (import flip)
+BAKE_BIND_KEY = 0x2   # Key every tracked bone at bind_frame from its defaults
+
+# F-curve groups in output order, with their array lengths
+CHANNEL_GROUPS = (('location', 3), ('rotation_quaternion', 4), ('scale', 3))
+
+
+class _NativeAnmBake(ctypes.Structure):
+    # Matches ANM_BAKE in native/anim_retarget.cpp
+    _fields_ = [
+        ('track_count', ctypes.c_uint32),
+        ('frame_slots', ctypes.c_uint32),
+        ('key_flags', ctypes.c_void_p),
+        ('translations', ctypes.c_void_p),
+        ('rotations', ctypes.c_void_p),
+        ('scales', ctypes.c_void_p),
+        ('slot_frames', ctypes.c_void_p),
+        ('bone_count', ctypes.c_uint32),
+        ('flags', ctypes.c_uint32),
+        ('bone_tracks', ctypes.c_void_p),
+        ('pre', ctypes.c_void_p),
+        ('post', ctypes.c_void_p),
+        ('defaults', ctypes.c_void_p),
+        ('translation_scale', ctypes.c_float),
+        ('bind_frame', ctypes.c_float),
+    ]
+
+
+def _native_bake():
+    """lol_native anm_bake_fcurves, or None if unavailable"""
+    return texture_manager.bind_native('anm_bake_fcurves', [ctypes.POINTER(_NativeAnmBake), ctypes.c_void_p,
+                                                            ctypes.POINTER(ctypes.POINTER(ctypes.c_float))])
+
+
+def available():
+    return _native_bake() is not None
+
+
+def matrices(mats):
+    """(len(mats), 16) float32 rows from mathutils 4x4 matrices"""
+    return np.array([[v for row in m for v in row] for m in mats], dtype=np.float32).reshape(-1, 16)
+
+
+def bake_fcurves(key_flags, translations, rotations, scales, slot_frames, bone_tracks, pre, post, defaults,
+                 flags=0, translation_scale=1.0, bind_frame=0.0):
+    """
+    Bake per-bone F-curve keys as pre @ (T @ R @ S) @ post, decomposed.
+
+    key_flags is (tracks, slots) KEY_* bits and translations / rotations /
+    scales are (tracks, slots, 3 / 4 (x, y, z, w) / 3). Each bone takes the
+    track in bone_tracks (-1 for none), its pre and post matrices (16 floats,
+    row-major) and defaults (translation xyz, rotation xyzw, scale xyz) for
+    channels a key lacks.
+
+    Returns one dict per bone mapping each keyed CHANNEL_GROUPS name to a list
+    of flat (frame, value) float32 arrays, one per array index.
+    """
+    anm_bake_fcurves = _native_bake()
+    if not anm_bake_fcurves:
+        raise Exception("Aventurine: native animation baking not available")
+
+    key_flags = np.ascontiguousarray(key_flags, dtype=np.uint8)
+    tracks, slots = key_flags.shape if key_flags.ndim == 2 else (0, 0)
+    translations = np.ascontiguousarray(translations, dtype=np.float32)
+    rotations = np.ascontiguousarray(rotations, dtype=np.float32)
+    scales = np.ascontiguousarray(scales, dtype=np.float32)
+    slot_frames = np.ascontiguousarray(slot_frames, dtype=np.float32)
+    bone_tracks = np.ascontiguousarray(bone_tracks, dtype=np.int32)
+    pre = np.ascontiguousarray(pre, dtype=np.float32)
+    post = np.ascontiguousarray(post, dtype=np.float32)
+    defaults = np.ascontiguousarray(defaults, dtype=np.float32)
+    bones = len(bone_tracks)
+
+    bake = _NativeAnmBake(tracks, slots, key_flags.ctypes.data, translations.ctypes.data, rotations.ctypes.data,
+                          scales.ctypes.data, slot_frames.ctypes.data, bones, flags, bone_tracks.ctypes.data,
+                          pre.ctypes.data, post.ctypes.data, defaults.ctypes.data, translation_scale, bind_frame)
+    counts = np.zeros((max(bones, 1), 3), dtype=np.uint32)
+    keys_ptr = ctypes.POINTER(ctypes.c_float)()
+    result = anm_bake_fcurves(ctypes.byref(bake), counts.ctypes.data, ctypes.byref(keys_ptr))
+    if result != 0:
+        raise Exception(f"Aventurine: Animation bake failed (error {result})")
+
+    baked = [{} for _ in range(bones)]
+    if not keys_ptr:
+        return baked
+
+    try:
+        total = int(sum(int(c[0]) * 3 + int(c[1]) * 4 + int(c[2]) * 3 for c in counts[:bones])) * 2
+        keys = np.ctypeslib.as_array(keys_ptr, shape=(total,)).copy()
+    finally:
+        texture_manager.free_native_bytes(keys_ptr)
+
+    offset = 0
+    for b in range(bones):
+        for g, (prop, width) in enumerate(CHANNEL_GROUPS):
+            size = int(counts[b][g]) * 2
+            if size == 0:
+                continue
+            baked[b][prop] = [keys[offset + i * size:offset + (i + 1) * size] for i in range(width)]
+            offset += size * width
+    return baked
+
+
+def set_keys(fcurve, co):
+    """Add flat (frame, value) pairs to an F-curve with one foreach_set, replacing keys on the same frames"""
+    points = fcurve.keyframe_points
+    if len(points):
+        existing = np.empty(len(points) * 2, dtype=np.float32)
+        points.foreach_get('co', existing)
+        for i in np.nonzero(np.isin(existing[0::2], co[0::2]))[0][::-1]:
+            points.remove(points[int(i)], fast=True)
+
+    start = len(points)
+    points.add(len(co) // 2)
+    values = np.empty(len(points) * 2, dtype=np.float32)
+    points.foreach_get('co', values)
+    values[start * 2:] = co
+    points.foreach_set('co', values)
+    fcurve.update()
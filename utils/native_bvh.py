@@ -0,0 +1,131 @@
+"""
+Native BVH queries (lol_native bvh_*), shared by the skinning tools and the
+wiggle-bone colliders. Trees are built over triangles (collider meshes) or
+capsules (bone segments) and queried in batches with numpy arrays.
+"""
+
+import ctypes
+import numpy as np
+from . import texture_manager
+
+
+# Matches BVH_HIT in native/bvh.cpp; primitive is -1 on a miss
+HIT_DTYPE = np.dtype([('primitive', '<i4'), ('distance', '<f4'), ('point', '<f4', 3), ('normal', '<f4', 3)])
+
+MAX_NEAREST = 16
+
+_HANDLE_OUT = ctypes.POINTER(ctypes.c_void_p)
+_SIGNATURES = {
+    'bvh_build_triangles': ([ctypes.c_void_p, ctypes.c_uint32, ctypes.c_void_p, ctypes.c_uint32, _HANDLE_OUT], ctypes.c_int),
+    'bvh_build_capsules': ([ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, _HANDLE_OUT], ctypes.c_int),
+    'bvh_free': ([ctypes.c_void_p], None),
+    'bvh_closest': ([ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_float, ctypes.c_void_p], ctypes.c_int),
+    'bvh_nearest': ([ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_float,
+                     ctypes.c_void_p, ctypes.c_void_p], ctypes.c_int),
+    'bvh_raycast': ([ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_float,
+                     ctypes.c_void_p], ctypes.c_int),
+    'bvh_capsule_query': ([ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_void_p], ctypes.c_int),
+}
+
+def _native(name):
+    """lol_native bvh_* export bound with its signature, or None if unavailable"""
+    return texture_manager.bind_native(name, *_SIGNATURES[name])
+
+
+def available():
+    return _native('bvh_build_triangles') is not None
+
+
+def _floats(values, width):
+    return np.ascontiguousarray(values, dtype=np.float32).reshape(-1, width)
+
+
+class NativeBVH:
+    """
+    A BVH owned by the native DLL. Indices in query results refer to the
+    triangles or capsules in the order they were passed to the constructor.
+    """
+
+    def __init__(self, positions=None, triangles=None, segments=None, radii=None):
+        if not available():
+            raise Exception("Aventurine: native BVH not available")
+        self._handle = ctypes.c_void_p()
+        if segments is not None:
+            segments = _floats(segments, 6)
+            if radii is not None:
+                radii = np.ascontiguousarray(radii, dtype=np.float32)
+            result = _native('bvh_build_capsules')(segments.ctypes.data, radii.ctypes.data if radii is not None else None,
+                                                   len(segments), ctypes.byref(self._handle))
+        else:
+            positions = _floats(positions, 3)
+            triangles = np.ascontiguousarray(triangles, dtype=np.int32).reshape(-1, 3)
+            result = _native('bvh_build_triangles')(positions.ctypes.data, len(positions), triangles.ctypes.data,
+                                                    len(triangles), ctypes.byref(self._handle))
+        if result != 0:
+            raise Exception(f"Aventurine: Failed to build BVH (error {result})")
+
+    @classmethod
+    def from_mesh(cls, mesh):
+        """Triangle BVH over a mesh datablock in its local space; hits index mesh.loop_triangles"""
+        mesh.calc_loop_triangles()
+        positions = np.empty(len(mesh.vertices) * 3, dtype=np.float32)
+        mesh.vertices.foreach_get('co', positions)
+        triangles = np.empty(len(mesh.loop_triangles) * 3, dtype=np.int32)
+        mesh.loop_triangles.foreach_get('vertices', triangles)
+        return cls(positions=positions, triangles=triangles)
+
+    def close(self):
+        if getattr(self, '_handle', None):
+            _native('bvh_free')(self._handle)
+            self._handle = ctypes.c_void_p()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+    def closest(self, points, max_distance=np.inf):
+        """HIT_DTYPE array with the closest surface point to each point"""
+        points = _floats(points, 3)
+        hits = np.empty(len(points), dtype=HIT_DTYPE)
+        result = _native('bvh_closest')(self._handle, points.ctypes.data, len(points), max_distance, hits.ctypes.data)
+        if result != 0:
+            raise Exception(f"Aventurine: BVH closest point query failed (error {result})")
+        return hits
+
+    def nearest(self, points, k, max_distance=np.inf):
+        """(indices, distances), each (len(points), k) and sorted nearest first; missing slots are -1 / inf"""
+        points = _floats(points, 3)
+        indices = np.empty((len(points), k), dtype=np.int32)
+        distances = np.empty((len(points), k), dtype=np.float32)
+        result = _native('bvh_nearest')(self._handle, points.ctypes.data, len(points), k, max_distance,
+                                        indices.ctypes.data, distances.ctypes.data)
+        if result != 0:
+            raise Exception(f"Aventurine: BVH nearest query failed (error {result})")
+        return indices, distances
+
+    def raycast(self, origins, directions, max_distance=np.inf):
+        """HIT_DTYPE array with the first hit along each ray"""
+        origins = _floats(origins, 3)
+        directions = _floats(directions, 3)
+        hits = np.empty(len(origins), dtype=HIT_DTYPE)
+        result = _native('bvh_raycast')(self._handle, origins.ctypes.data, directions.ctypes.data, len(origins),
+                                        max_distance, hits.ctypes.data)
+        if result != 0:
+            raise Exception(f"Aventurine: BVH raycast failed (error {result})")
+        return hits
+
+    def capsule_query(self, segments, radii):
+        """HIT_DTYPE array with the closest primitive within each capsule's radius"""
+        segments = _floats(segments, 6)
+        radii = np.ascontiguousarray(np.broadcast_to(np.asarray(radii, dtype=np.float32), (len(segments),)))
+        hits = np.empty(len(segments), dtype=HIT_DTYPE)
+        result = _native('bvh_capsule_query')(self._handle, segments.ctypes.data, radii.ctypes.data, len(segments),
+                                              hits.ctypes.data)
+        if result != 0:
+            raise Exception(f"Aventurine: BVH capsule query failed (error {result})")
+        return hits
@@ -2,21 +2,58 @@ import bpy
 import os
 import glob
 import ctypes
+import hashlib
+import io
+import struct
+import sys
+import tempfile
 import numpy as np
 
+# Shared library suffix of the native builds on this platform
+if sys.platform == 'win32':
+    _NATIVE_LIB_SUFFIX = '.dll'
+elif sys.platform == 'darwin':
+    _NATIVE_LIB_SUFFIX = '.dylib'
+else:
+    _NATIVE_LIB_SUFFIX = '.so'
+
+def _native_library_path(name):
+    """Path of a native library (tex_converter, lol_native, bin_parser) in the addon's native folder"""
+    return os.path.join(os.path.dirname(os.path.dirname(__file__)), 'native', name + _NATIVE_LIB_SUFFIX)
+
+
 # --- Native DLL for TEX to DDS conversion ---
 _tex_dll = None
 _tex_dll_convert = None
 _tex_dll_free = None
+_tex_dll_batch = None
+_tex_dll_query = None
+_tex_dll_into = None
+_tex_cache_ready = None
+
+# Converted DDS files kept across sessions, least recently used deleted past the cap
+TEX_CACHE_MAX_BYTES = 1 << 30
+
+class _TexCacheStats(ctypes.Structure):
+    # Matches TEX_CACHE_STATS in native/ritoddstex_dll.c
+    _fields_ = [
+        ('hits', ctypes.c_uint64),
+        ('misses', ctypes.c_uint64),
+        ('evictions', ctypes.c_uint64),
+        ('bytes', ctypes.c_uint64),
+        ('max_bytes', ctypes.c_uint64),
+        ('entries', ctypes.c_uint32),
+        ('reserved', ctypes.c_uint32),
+    ]
 
 def _load_tex_dll():
     """Load the native TEX converter DLL"""
-    global _tex_dll, _tex_dll_convert, _tex_dll_free
+    global _tex_dll, _tex_dll_convert, _tex_dll_free, _tex_dll_batch, _tex_dll_query, _tex_dll_into
 
     if _tex_dll is not None:
         return _tex_dll
 
-    dll_path = os.path.join(os.path.dirname(os.path.dirname(__file__)), 'native', 'tex_converter.dll')
+    dll_path = _native_library_path('tex_converter')
     if os.path.exists(dll_path):
         try:
             _tex_dll = ctypes.CDLL(dll_path)
@@ -26,6 +63,28 @@ def _load_tex_dll():
             _tex_dll.free_dds_bytes.restype = None
             _tex_dll_convert = _tex_dll.tex_to_dds_bytes
             _tex_dll_free = _tex_dll.free_dds_bytes
+
+            # Optional exports - older DLL builds don't have them
+            if hasattr(_tex_dll, 'tex_to_dds_batch'):
+                _tex_dll.tex_to_dds_batch.argtypes = [ctypes.POINTER(ctypes.c_char_p), ctypes.c_uint32, ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_int32), ctypes.c_uint32]
+                _tex_dll.tex_to_dds_batch.restype = ctypes.c_int
+                _tex_dll_batch = _tex_dll.tex_to_dds_batch
+            if hasattr(_tex_dll, 'tex_to_dds_query') and hasattr(_tex_dll, 'tex_to_dds_into'):
+                _tex_dll.tex_to_dds_query.argtypes = [ctypes.c_char_p, ctypes.POINTER(ctypes.c_uint32)]
+                _tex_dll.tex_to_dds_query.restype = ctypes.c_int
+                _tex_dll.tex_to_dds_into.argtypes = [ctypes.c_char_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32)]
+                _tex_dll.tex_to_dds_into.restype = ctypes.c_int
+                _tex_dll_query = _tex_dll.tex_to_dds_query
+                _tex_dll_into = _tex_dll.tex_to_dds_into
+            if hasattr(_tex_dll, 'tex_cache_open'):
+                _tex_dll.tex_cache_open.argtypes = [ctypes.c_char_p, ctypes.c_uint64]
+                _tex_dll.tex_cache_open.restype = ctypes.c_int
+                _tex_dll.tex_cache_close.argtypes = []
+                _tex_dll.tex_cache_close.restype = None
+                _tex_dll.tex_cache_dds_path.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_uint32]
+                _tex_dll.tex_cache_dds_path.restype = ctypes.c_int
+                _tex_dll.tex_cache_get_stats.argtypes = [ctypes.POINTER(_TexCacheStats)]
+                _tex_dll.tex_cache_get_stats.restype = ctypes.c_int
             return _tex_dll
         except Exception as e:
             print(f"Aventurine: Failed to load TEX DLL: {e}")
@@ -35,11 +94,60 @@ def _load_tex_dll():
     _tex_dll = False
     return False
 
+def tex_to_dds_size(tex_path):
+    """Size of the DDS data for a TEX file (reads only the header), or None if the DLL can't tell."""
+    if not _load_tex_dll() or _tex_dll_query is None:
+        return None
+
+    out_size = ctypes.c_uint32()
+    result = _tex_dll_query(tex_path.encode('utf-8'), ctypes.byref(out_size))
+    if result != 0:
+        raise Exception(f"Aventurine: TEX conversion failed (error {result})")
+    return out_size.value
+
+def _tex_to_dds_into(tex_path, buffer):
+    """tex_to_dds_into returning (error code, DDS size) instead of raising"""
+    view = memoryview(buffer).cast('B')
+    c_buf = (ctypes.c_uint8 * view.nbytes).from_buffer(view)
+    out_size = ctypes.c_uint32()
+    result = _tex_dll_into(tex_path.encode('utf-8'), c_buf, view.nbytes, ctypes.byref(out_size))
+    return result, out_size.value
+
+def tex_to_dds_into(tex_path, buffer):
+    """
+    Convert TEX file to DDS directly into a writable buffer (bytearray, numpy array, ...)
+    sized with tex_to_dds_size. Returns the number of bytes written.
+    """
+    if not _load_tex_dll() or _tex_dll_into is None:
+        raise Exception("Aventurine: TEX DLL not available")
+
+    result, written = _tex_to_dds_into(tex_path, buffer)
+    if result != 0:
+        raise Exception(f"Aventurine: TEX conversion failed (error {result})")
+    return written
+
 def tex_to_dds_bytes(tex_path):
     """Convert TEX file to DDS bytes using native DLL."""
     if not _load_tex_dll():
         raise Exception("Aventurine: TEX DLL not available")
 
+    # Let the DLL write straight into a Python-owned buffer when it can.
+    # The file may change between the size query and the conversion: a
+    # shrunk file is trimmed to what was written, a grown one (-6, with the
+    # new size) is retried once before using the DLL's own buffer
+    size = tex_to_dds_size(tex_path) if _tex_dll_into is not None else None
+    for _ in range(2):
+        if size is None:
+            break
+        dds_bytes = bytearray(size)
+        result, written = _tex_to_dds_into(tex_path, dds_bytes)
+        if result == 0:
+            del dds_bytes[written:]
+            return dds_bytes
+        if result != -6:
+            raise Exception(f"Aventurine: TEX conversion failed (error {result})")
+        size = written
+
     tex_path_bytes = tex_path.encode('utf-8')
     out_data = ctypes.POINTER(ctypes.c_uint8)()
     out_size = ctypes.c_uint32()
@@ -53,11 +161,630 @@ def tex_to_dds_bytes(tex_path):
     _tex_dll_free(out_data)
     return dds_bytes
 
+def tex_to_dds_bytes_batch(tex_paths, max_threads=0):
+    """
+    Convert several TEX files to DDS bytes in one native call.
+    Returns a list aligned with tex_paths holding DDS bytes, or None for files that failed.
+    """
+    if not _load_tex_dll():
+        raise Exception("Aventurine: TEX DLL not available")
+
+    count = len(tex_paths)
+    if count == 0:
+        return []
+
+    # Older DLL without the batch export: convert one by one
+    if _tex_dll_batch is None:
+        results = []
+        for path in tex_paths:
+            try:
+                results.append(tex_to_dds_bytes(path))
+            except Exception as e:
+                print(f"Aventurine: {e}")
+                results.append(None)
+        return results
+
+    paths_arr = (ctypes.c_char_p * count)(*[p.encode('utf-8') for p in tex_paths])
+    out_data = (ctypes.POINTER(ctypes.c_uint8) * count)()
+    out_sizes = (ctypes.c_uint32 * count)()
+    codes = (ctypes.c_int32 * count)()
+
+    _tex_dll_batch(paths_arr, count, out_data, out_sizes, codes, max_threads)
+
+    results = []
+    for i in range(count):
+        if codes[i] != 0:
+            print(f"Aventurine: TEX conversion failed for {tex_paths[i]} (error {codes[i]})")
+            results.append(None)
+            continue
+        size = out_sizes[i]
+        results.append(bytes(ctypes.cast(out_data[i], ctypes.POINTER(ctypes.c_uint8 * size)).contents))
+        _tex_dll_free(out_data[i])
+    return results
+
+def _tex_cache_available():
+    """Open the DLL's DDS cache in the temp folder on first use; False without it"""
+    global _tex_cache_ready
+
+    if _tex_cache_ready is not None:
+        return _tex_cache_ready
+
+    _tex_cache_ready = False
+    if _load_tex_dll() and hasattr(_tex_dll, 'tex_cache_open'):
+        cache_dir = os.path.join(tempfile.gettempdir(), 'aventurine_tex_cache')
+        result = _tex_dll.tex_cache_open(cache_dir.encode('utf-8'), TEX_CACHE_MAX_BYTES)
+        if result == 0:
+            _tex_cache_ready = True
+        else:
+            print(f"Aventurine: TEX cache unavailable (error {result})")
+    return _tex_cache_ready
+
+def tex_to_dds_file(tex_path):
+    """
+    DDS file Blender can load for a TEX file, as (path, is_temp).
+    Comes from the on-disk DDS cache when the DLL has one; otherwise a temp
+    file the caller deletes. Load a cached file before converting more, as
+    later conversions may evict it.
+    """
+    if _tex_cache_available():
+        out_path = ctypes.create_string_buffer(4096)
+        result = _tex_dll.tex_cache_dds_path(tex_path.encode('utf-8'), out_path, len(out_path))
+        if result == 0 or result == 1:
+            return out_path.value.decode('utf-8'), False
+        if result != -1:
+            raise Exception(f"Aventurine: TEX conversion failed (error {result})")
+        # -1 may only mean the entry couldn't be written: retry without the cache
+
+    dds_bytes = tex_to_dds_bytes(tex_path)
+    fd, temp_path = tempfile.mkstemp(suffix='.dds')
+    with os.fdopen(fd, 'wb') as f:
+        f.write(dds_bytes)
+    return temp_path, True
+
+def tex_cache_stats():
+    """DDS cache counters as a dict, or None if the DLL has no cache"""
+    if not _tex_cache_available():
+        return None
+    stats = _TexCacheStats()
+    if _tex_dll.tex_cache_get_stats(ctypes.byref(stats)) != 0:
+        return None
+    return {name: getattr(stats, name) for name, _ in _TexCacheStats._fields_ if name != 'reserved'}
+
+# --- Combined native DLL (lol_native) for direct TEX decoding ---
+_native_dll = None
+_native_decode = None
+
+TEX_DECODE_FLIP_Y = 0x1
+
+def _load_native_dll():
+    """Load the combined lol_native DLL (optional, provides direct pixel decoding)"""
+    global _native_dll, _native_decode
+
+    if _native_dll is not None:
+        return _native_dll
+
+    dll_path = _native_library_path('lol_native')
+    if os.path.exists(dll_path):
+        try:
+            _native_dll = ctypes.CDLL(dll_path)
+            if hasattr(_native_dll, 'tex_decode_rgba'):
+                _native_dll.tex_decode_rgba.argtypes = [ctypes.c_char_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32)]
+                _native_dll.tex_decode_rgba.restype = ctypes.c_int
+                _native_decode = _native_dll.tex_decode_rgba
+            if hasattr(_native_dll, 'fs_index_build'):
+                handle_out = ctypes.POINTER(ctypes.c_void_p)
+                _native_dll.fs_index_build.argtypes = [ctypes.c_char_p, handle_out]
+                _native_dll.fs_index_build.restype = ctypes.c_int
+                _native_dll.fs_index_load.argtypes = [ctypes.c_char_p, ctypes.c_char_p, handle_out]
+                _native_dll.fs_index_load.restype = ctypes.c_int
+                _native_dll.fs_index_save.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+                _native_dll.fs_index_save.restype = ctypes.c_int
+                _native_dll.fs_index_refresh.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint32)]
+                _native_dll.fs_index_refresh.restype = ctypes.c_int
+                _native_dll.fs_index_lookup.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_char_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32)]
+                _native_dll.fs_index_lookup.restype = ctypes.c_int
+                _native_dll.fs_index_find.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_char_p, ctypes.c_uint32,
+                                                      ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32)]
+                _native_dll.fs_index_find.restype = ctypes.c_int
+                _native_dll.fs_index_free.argtypes = [ctypes.c_void_p]
+                _native_dll.fs_index_free.restype = None
+            if hasattr(_native_dll, 'wad_open'):
+                bytes_out = [ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32)]
+                _native_dll.wad_open.argtypes = [ctypes.c_char_p, ctypes.POINTER(ctypes.c_void_p)]
+                _native_dll.wad_open.restype = ctypes.c_int
+                _native_dll.wad_close.argtypes = [ctypes.c_void_p]
+                _native_dll.wad_close.restype = None
+                _native_dll.wad_hash_path.argtypes = [ctypes.c_char_p]
+                _native_dll.wad_hash_path.restype = ctypes.c_uint64
+                for name in ('wad_read', 'wad_tex_to_dds'):
+                    getattr(_native_dll, name).argtypes = [ctypes.c_void_p, ctypes.c_uint64] + bytes_out
+                    getattr(_native_dll, name).restype = ctypes.c_int
+                _native_dll.free_bytes.argtypes = [ctypes.c_void_p]
+                _native_dll.free_bytes.restype = None
+            if hasattr(_native_dll, 'submit_tex_job'):
+                _native_dll.submit_tex_job.argtypes = [ctypes.c_char_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_void_p)]
+                _native_dll.submit_tex_job.restype = ctypes.c_int
+                _native_dll.poll_tex_jobs.argtypes = [ctypes.POINTER(ctypes.c_void_p), ctypes.c_uint32, ctypes.POINTER(ctypes.c_int32), ctypes.c_uint32]
+                _native_dll.poll_tex_jobs.restype = ctypes.c_int
+                _native_dll.tex_job_result.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+                                                       ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32)]
+                _native_dll.tex_job_result.restype = ctypes.c_int
+                _native_dll.tex_job_free.argtypes = [ctypes.c_void_p]
+                _native_dll.tex_job_free.restype = None
+            if hasattr(_native_dll, 'rgba_to_tex'):
+                _native_dll.rgba_to_tex.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32,
+                                                    ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32)]
+                _native_dll.rgba_to_tex.restype = ctypes.c_int
+                _native_dll.free_bytes.argtypes = [ctypes.c_void_p]
+                _native_dll.free_bytes.restype = None
+            return _native_dll
+        except Exception as e:
+            print(f"Aventurine: Failed to load native DLL: {e}")
+            _native_dll = False
+            return False
+
+    _native_dll = False
+    return False
+
+_native_bound = {}  # export name -> bound function, or False if missing
+
+def bind_native(name, argtypes, restype=ctypes.c_int):
+    """
+    lol_native export name with argtypes / restype set, or None if the DLL or
+    the export is unavailable. Each symbol is looked up and bound once.
+    """
+    fn = _native_bound.get(name)
+    if fn is None:
+        fn = False
+        dll = _load_native_dll()
+        if dll and hasattr(dll, name):
+            fn = getattr(dll, name)
+            fn.argtypes = argtypes
+            fn.restype = restype
+        _native_bound[name] = fn
+    return fn or None
+
+def free_native_bytes(ptr):
+    """free_bytes for memory a lol_native export allocated (any ctypes pointer)"""
+    bind_native('free_bytes', [ctypes.c_void_p], None)(ctypes.cast(ptr, ctypes.c_void_p))
+
+def native_decoder_available():
+    """True if TEX files can be decoded to pixels without a temp DDS round trip"""
+    return bool(_load_native_dll()) and _native_decode is not None
+
+def decode_tex_pixels(tex_path):
+    """
+    Decode a TEX file straight to float RGBA pixels in Blender row order.
+    Returns (width, height, float32 array) or None if the native decoder is not available.
+    """
+    if not _load_native_dll() or _native_decode is None:
+        return None
+
+    path_bytes = tex_path.encode('utf-8')
+    width = ctypes.c_uint32()
+    height = ctypes.c_uint32()
+
+    # First call only reports the size (-6: no buffer)
+    result = _native_decode(path_bytes, None, 0, TEX_DECODE_FLIP_Y, ctypes.byref(width), ctypes.byref(height))
+    if result != -6:
+        raise Exception(f"Aventurine: TEX decode failed (error {result})")
+
+    pixels = np.empty(width.value * height.value * 4, dtype=np.float32)
+    result = _native_decode(path_bytes, pixels.ctypes.data, pixels.size, TEX_DECODE_FLIP_Y, ctypes.byref(width), ctypes.byref(height))
+    if result != 0:
+        raise Exception(f"Aventurine: TEX decode failed (error {result})")
+    return width.value, height.value, pixels
+
+def decode_tex_pixels_from_memory(data):
+    """decode_tex_pixels for the bytes of a TEX file, or None without the native decoder"""
+    decode = bind_native('tex_decode_rgba_from_memory',
+                         [ctypes.c_char_p, ctypes.c_uint32, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32,
+                          ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32)])
+    if decode is None:
+        return None
+
+    width = ctypes.c_uint32()
+    height = ctypes.c_uint32()
+    result = decode(data, len(data), None, 0, TEX_DECODE_FLIP_Y, ctypes.byref(width), ctypes.byref(height))
+    if result != -6:
+        raise Exception(f"Aventurine: TEX decode failed (error {result})")
+
+    pixels = np.empty(width.value * height.value * 4, dtype=np.float32)
+    result = decode(data, len(data), pixels.ctypes.data, pixels.size, TEX_DECODE_FLIP_Y, ctypes.byref(width), ctypes.byref(height))
+    if result != 0:
+        raise Exception(f"Aventurine: TEX decode failed (error {result})")
+    return width.value, height.value, pixels
+
+# --- Asynchronous TEX decoding on the native thread pool ---
+TEX_JOB_PENDING = 1
+TEX_JOB_WAIT_FOREVER = 0xffffffff
+
+def native_tex_jobs_available():
+    """True if TEX files can be decoded in the background with submit_tex_job"""
+    return bool(_load_native_dll()) and hasattr(_native_dll, 'submit_tex_job')
+
+class TextureJobs:
+    """
+    TEX files decoding in the background, keyed by path. Pixels of a job are
+    native memory: use them before release(path) / close().
+    """
+
+    def __init__(self, tex_paths=()):
+        self._jobs = {}
+        for path in tex_paths:
+            self.submit(path)
+
+    def submit(self, tex_path, data=None):
+        """
+        Start decoding tex_path unless it's already queued; False if it can't be.
+        With data (the TEX file's bytes), tex_path is only the key and nothing
+        is read from disk.
+        """
+        if tex_path in self._jobs:
+            return True
+        if not native_tex_jobs_available() or not tex_path.lower().endswith('.tex'):
+            return False
+        job = ctypes.c_void_p()
+        if data is None:
+            result = _native_dll.submit_tex_job(tex_path.encode('utf-8'), TEX_DECODE_FLIP_Y, ctypes.byref(job))
+        else:
+            submit_from_memory = bind_native('submit_tex_job_from_memory',
+                                             [ctypes.c_char_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.POINTER(ctypes.c_void_p)])
+            if submit_from_memory is None:
+                return False
+            result = submit_from_memory(data, len(data), TEX_DECODE_FLIP_Y, ctypes.byref(job))
+        if result != 0:
+            return False
+        self._jobs[tex_path] = job
+        return True
+
+    def __contains__(self, tex_path):
+        return tex_path in self._jobs
+
+    def pending(self):
+        """Number of jobs still decoding"""
+        if not self._jobs:
+            return 0
+        count = len(self._jobs)
+        handles = (ctypes.c_void_p * count)(*[job.value for job in self._jobs.values()])
+        results = (ctypes.c_int32 * count)()
+        return _native_dll.poll_tex_jobs(handles, count, results, 0)
+
+    def wait(self, tex_path):
+        """
+        Wait for the decode of tex_path and return (width, height, float32 array)
+        in Blender row order, like decode_tex_pixels.
+        The array is a view of the job's pixels, valid until release(tex_path).
+        """
+        job = self._jobs[tex_path]
+        handles = (ctypes.c_void_p * 1)(job.value)
+        result = ctypes.c_int32()
+        _native_dll.poll_tex_jobs(handles, 1, ctypes.byref(result), TEX_JOB_WAIT_FOREVER)
+
+        pixels = ctypes.POINTER(ctypes.c_float)()
+        width = ctypes.c_uint32()
+        height = ctypes.c_uint32()
+        rc = _native_dll.tex_job_result(job, ctypes.byref(pixels), ctypes.byref(width), ctypes.byref(height))
+        if rc != 0:
+            raise Exception(f"Aventurine: TEX decode failed (error {rc})")
+        count = width.value * height.value * 4
+        return width.value, height.value, np.ctypeslib.as_array(pixels, shape=(count,))
+
+    def release(self, tex_path):
+        """Free the job of tex_path, dropping it if it hasn't finished"""
+        job = self._jobs.pop(tex_path, None)
+        if job:
+            _native_dll.tex_job_free(job)
+
+    def close(self):
+        for path in list(self._jobs):
+            self.release(path)
+
+# --- Native TEX encoding (BC1/BC3 with mips) ---
+TEX_FORMAT_DXT1 = 0x0A
+TEX_FORMAT_DXT5 = 0x0C
+TEX_FORMAT_BGRA8 = 0x14
+
+TEX_ENCODE_FLIP_Y = 0x1
+TEX_ENCODE_MIPMAPS = 0x2
+TEX_ENCODE_KAISER = 0x4
+TEX_ENCODE_SRGB = 0x8
+
+def native_encoder_available():
+    """True if Blender pixels can be written as TEX without external tools"""
+    return bool(_load_native_dll()) and hasattr(_native_dll, 'rgba_to_tex')
+
+def encode_tex_pixels(tex_path, width, height, pixels, tex_format=TEX_FORMAT_DXT5, mipmaps=True, kaiser=False, srgb=True):
+    """
+    Write float RGBA pixels in Blender row order (e.g. image.pixels) as a TEX file.
+    Mips are generated natively and stored smallest-first like the game's files.
+    Returns False if the native encoder is not available.
+    """
+    if not native_encoder_available():
+        return False
+
+    rgba8 = np.clip(np.asarray(pixels, dtype=np.float32) * 255.0 + 0.5, 0, 255).astype(np.uint8)
+    if rgba8.size != width * height * 4:
+        raise ValueError(f"Aventurine: expected {width * height * 4} pixel values, got {rgba8.size}")
+
+    flags = TEX_ENCODE_FLIP_Y
+    if mipmaps:
+        flags |= TEX_ENCODE_MIPMAPS
+    if kaiser:
+        flags |= TEX_ENCODE_KAISER
+    if srgb:
+        flags |= TEX_ENCODE_SRGB
+
+    data = ctypes.POINTER(ctypes.c_uint8)()
+    size = ctypes.c_uint32()
+    result = _native_dll.rgba_to_tex(rgba8.ctypes.data, width, height, tex_format, flags, ctypes.byref(data), ctypes.byref(size))
+    if result != 0:
+        raise Exception(f"Aventurine: TEX encode failed (error {result})")
+    try:
+        tex_bytes = ctypes.string_at(data, size.value)
+    finally:
+        _native_dll.free_bytes(data)
+
+    with open(tex_path, 'wb') as f:
+        f.write(tex_bytes)
+    return True
+
+# --- Native filesystem index of extracted WAD roots ---
+FS_FIND_RECURSIVE = 0x1
+
+_fs_indexes = {}  # normcase(root) -> native index handle
+
+def _fs_index_cache_path(root):
+    key = hashlib.sha1(os.path.normcase(os.path.abspath(root)).encode('utf-8')).hexdigest()[:16]
+    return os.path.join(tempfile.gettempdir(), f'aventurine_fs_{key}.idx')
+
+def get_fs_index(root):
+    """
+    Native index of every file under root, or None without the native DLL.
+    Loaded from the previous session's copy and refreshed when possible,
+    which only re-lists directories that changed. Kept for the session;
+    lookups that miss re-list the folder they searched (see
+    reset_fs_index_misses), so files extracted since are found.
+    """
+    if not root or not _load_native_dll() or not hasattr(_native_dll, 'fs_index_build'):
+        return None
+
+    key = os.path.normcase(os.path.abspath(root))
+    if key in _fs_indexes:
+        return _fs_indexes[key]
+
+    root_bytes = root.encode('utf-8')
+    cache_path = _fs_index_cache_path(root).encode('utf-8')
+    handle = ctypes.c_void_p()
+    listed = ctypes.c_uint32()
+    if _native_dll.fs_index_load(cache_path, root_bytes, ctypes.byref(handle)) == 0:
+        if _native_dll.fs_index_refresh(handle, ctypes.byref(listed)) != 0:
+            _native_dll.fs_index_free(handle)
+            handle = ctypes.c_void_p()
+    if not handle:
+        if _native_dll.fs_index_build(root_bytes, ctypes.byref(handle)) != 0:
+            # Not remembered: the root may exist by the next import
+            return None
+        listed.value = 1
+
+    if listed.value:
+        _native_dll.fs_index_save(handle, cache_path)
+    _fs_indexes[key] = handle
+    return handle
+
+_fs_index_misses = set()  # (index, rel dir, recursive) re-listed after a miss since the import started
+
+def reset_fs_index_misses():
+    """
+    Start of an import: the next miss in each indexed folder re-lists that
+    folder from disk again, instead of refreshing whole indexes up front
+    """
+    _fs_index_misses.clear()
+
+def _fs_index_refresh_miss(index, rel_dir, recursive):
+    """
+    Bring rel_dir (and with recursive, the folders below it) up to date after
+    a miss, once per import. True if anything changed on disk.
+    """
+    refresh = bind_native('fs_index_refresh_dir', [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint32,
+                                                   ctypes.POINTER(ctypes.c_uint32)])
+    key = (index.value, rel_dir.replace('\\', '/').strip('/').lower(), recursive)
+    if not refresh or key in _fs_index_misses:
+        return False
+    _fs_index_misses.add(key)
+    listed = ctypes.c_uint32()
+    flags = FS_FIND_RECURSIVE if recursive else 0
+    return refresh(index, rel_dir.encode('utf-8'), flags, ctypes.byref(listed)) == 0 and listed.value > 0
+
+def _fs_index_rel_dir(root, folder):
+    """folder relative to an index root with '/' separators ("" for the root), or None if outside it"""
+    try:
+        rel = os.path.relpath(folder, root)
+    except ValueError:
+        return None  # Other drive
+    if rel == os.curdir:
+        return ''
+    if rel == os.pardir or rel.startswith(os.pardir + os.sep):
+        return None
+    return rel.replace(os.sep, '/')
+
+def fs_index_lookup(index, rel_path):
+    """Absolute path of rel_path under the index root (any case), or None"""
+    path = _fs_index_lookup(index, rel_path)
+    if path is None:
+        rel_dir = rel_path.replace('\\', '/').rpartition('/')[0]
+        if _fs_index_refresh_miss(index, rel_dir, False):
+            path = _fs_index_lookup(index, rel_path)
+    return path
+
+def _fs_index_lookup(index, rel_path):
+    buf = ctypes.create_string_buffer(1024)
+    length = ctypes.c_uint32()
+    result = _native_dll.fs_index_lookup(index, rel_path.encode('utf-8'), buf, len(buf), ctypes.byref(length))
+    if result == -6:
+        buf = ctypes.create_string_buffer(length.value + 1)
+        result = _native_dll.fs_index_lookup(index, rel_path.encode('utf-8'), buf, len(buf), ctypes.byref(length))
+    if result != 0:
+        return None
+    return buf.value.decode('utf-8')
+
+def fs_index_find(index, rel_dir, pattern, recursive=False):
+    """Absolute paths of files matching a '*'/'?' pattern (any case) in rel_dir"""
+    paths = _fs_index_find(index, rel_dir, pattern, recursive)
+    if not paths and _fs_index_refresh_miss(index, rel_dir, recursive):
+        paths = _fs_index_find(index, rel_dir, pattern, recursive)
+    return paths
+
+def _fs_index_find(index, rel_dir, pattern, recursive):
+    out_data = ctypes.POINTER(ctypes.c_uint8)()
+    out_size = ctypes.c_uint32()
+    flags = FS_FIND_RECURSIVE if recursive else 0
+    result = _native_dll.fs_index_find(index, rel_dir.encode('utf-8'), pattern.encode('utf-8'), flags,
+                                       ctypes.byref(out_data), ctypes.byref(out_size))
+    if result != 0:
+        return []
+    try:
+        text = ctypes.string_at(out_data, out_size.value).decode('utf-8')
+    finally:
+        _native_dll.free_bytes(ctypes.cast(out_data, ctypes.c_void_p))
+    return text.splitlines()
+
+# --- Native WAD archive access ---
+class _WadEntry(ctypes.Structure):
+    _fields_ = [
+        ('path_hash', ctypes.c_uint64),
+        ('offset', ctypes.c_uint32),
+        ('compressed_size', ctypes.c_uint32),
+        ('size', ctypes.c_uint32),
+        ('type', ctypes.c_uint8),
+        ('subchunk_count', ctypes.c_uint8),
+        ('first_subchunk', ctypes.c_uint16),
+    ]
+
+class WadArchive:
+    """
+    A .wad.client archive read in place by the native DLL. Paths are asset
+    paths inside the archive (e.g. "assets/characters/ahri/skins/base/ahri_base_tx_cm.tex").
+    """
+
+    def __init__(self, wad_path):
+        if not _load_native_dll() or not hasattr(_native_dll, 'wad_open'):
+            raise Exception("Aventurine: native WAD reader not available")
+        self.path = wad_path
+        self._handle = ctypes.c_void_p()
+        result = _native_dll.wad_open(wad_path.encode('utf-8'), ctypes.byref(self._handle))
+        if result != 0:
+            raise Exception(f"Aventurine: Failed to open WAD {wad_path} (error {result})")
+
+    def close(self):
+        if getattr(self, '_handle', None):
+            _native_dll.wad_close(self._handle)
+            self._handle = ctypes.c_void_p()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+    def _call(self, func, path):
+        """Bytes returned by a wad_* export for path, or None if the archive lacks it"""
+        out_data = ctypes.POINTER(ctypes.c_uint8)()
+        out_size = ctypes.c_uint32()
+        result = func(self._handle, _native_dll.wad_hash_path(path.encode('utf-8')), ctypes.byref(out_data), ctypes.byref(out_size))
+        if result == 1:
+            return None
+        if result != 0:
+            raise Exception(f"Aventurine: Failed to read {path} from WAD (error {result})")
+        try:
+            return ctypes.string_at(out_data, out_size.value)
+        finally:
+            _native_dll.free_bytes(ctypes.cast(out_data, ctypes.c_void_p))
+
+    def read(self, path):
+        """Decompressed contents of an entry, or None"""
+        return self._call(_native_dll.wad_read, path)
+
+    def tex_to_dds(self, path):
+        """DDS bytes of a TEX entry, or None"""
+        return self._call(_native_dll.wad_tex_to_dds, path)
+
+    def parse_bin_textures(self, path):
+        """
+        Texture mappings of a skin BIN entry like parse_bin_for_textures,
+        resolving materials through the linked BINs of the same archive.
+        None when the archive lacks the entry or bin_parser the export.
+        """
+        data = self.read(path)
+        if data is None:
+            return None
+        linked = [self.read(link) for link in _read_linked_section(io.BytesIO(data))]
+        rows = native_parse_bin_batch_from_memory([data] + linked)
+        if rows is None:
+            return None
+        return {submesh: texture for submesh, texture, _, flags in rows if flags & BIN_TEXTURE_PRIMARY}
+
+    def has(self, path):
+        """True if the archive has an entry for path"""
+        find = bind_native('wad_find', [ctypes.c_void_p, ctypes.c_uint64, ctypes.POINTER(_WadEntry)])
+        entry = _WadEntry()
+        return find(self._handle, _native_dll.wad_hash_path(path.encode('utf-8')), ctypes.byref(entry)) == 0
+
+def find_character_wad(game_folder, skn_path):
+    """
+    The Champions/<name>.wad.client archive of the character an SKN belongs
+    to (.../characters/<name>/...), under a League "Game" folder. None when
+    either can't be found.
+    """
+    if not game_folder:
+        return None
+    parts = skn_path.replace('\\', '/').lower().split('/')
+    if 'characters' not in parts:
+        return None
+    chars_idx = len(parts) - 1 - parts[::-1].index('characters')
+    if chars_idx + 1 >= len(parts):
+        return None
+    wad_name = f"{parts[chars_idx + 1]}.wad.client"
+
+    for champions in (os.path.join(game_folder, 'DATA', 'FINAL', 'Champions'), os.path.join(game_folder, 'Champions')):
+        try:
+            names = os.listdir(champions)
+        except OSError:
+            continue
+        for name in names:
+            if name.lower() == wad_name:
+                return os.path.join(champions, name)
+    return None
+
+def open_character_wad(game_folder, skn_path):
+    """WadArchive of find_character_wad, or None when it can't be opened"""
+    wad_path = find_character_wad(game_folder, skn_path)
+    if not wad_path:
+        return None
+    try:
+        return WadArchive(wad_path)
+    except Exception as e:
+        print(e)
+        return None
+
 # --- Native DLL for BIN parsing ---
 _bin_dll = None
 _bin_parse = None
 _bin_free = None
 
+class _BinCacheStats(ctypes.Structure):
+    _fields_ = [
+        ('hits', ctypes.c_uint64),
+        ('misses', ctypes.c_uint64),
+        ('evictions', ctypes.c_uint64),
+        ('bytes', ctypes.c_uint64),
+        ('entries', ctypes.c_uint32),
+        ('capacity', ctypes.c_uint32),
+    ]
+
 def _load_bin_dll():
     """Load the native BIN parser DLL"""
     global _bin_dll, _bin_parse, _bin_free
@@ -65,7 +792,7 @@ def _load_bin_dll():
     if _bin_dll is not None:
         return _bin_dll
 
-    dll_path = os.path.join(os.path.dirname(os.path.dirname(__file__)), 'native', 'bin_parser.dll')
+    dll_path = _native_library_path('bin_parser')
     if os.path.exists(dll_path):
         try:
             _bin_dll = ctypes.CDLL(dll_path)
@@ -77,6 +804,30 @@ def _load_bin_dll():
             _bin_dll.free_bin_result.argtypes = [ctypes.POINTER(ctypes.c_uint8)]
             _bin_dll.free_bin_result.restype = None
 
+            if hasattr(_bin_dll, 'parse_bin_texture_table'):
+                _bin_dll.parse_bin_texture_table.argtypes = [ctypes.c_char_p, ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32)]
+                _bin_dll.parse_bin_texture_table.restype = ctypes.c_int
+
+            if hasattr(_bin_dll, 'parse_bin_materials'):
+                _bin_dll.parse_bin_materials.argtypes = [ctypes.c_char_p, ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32)]
+                _bin_dll.parse_bin_materials.restype = ctypes.c_int
+
+            if hasattr(_bin_dll, 'parse_bin_batch'):
+                _bin_dll.parse_bin_batch.argtypes = [ctypes.c_char_p, ctypes.POINTER(ctypes.c_char_p), ctypes.c_uint32, ctypes.c_uint32,
+                                                     ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32)]
+                _bin_dll.parse_bin_batch.restype = ctypes.c_int
+
+            if hasattr(_bin_dll, 'parse_bin_batch_from_memory'):
+                _bin_dll.parse_bin_batch_from_memory.argtypes = [ctypes.POINTER(ctypes.c_char_p), ctypes.POINTER(ctypes.c_uint32), ctypes.c_uint32,
+                                                                 ctypes.c_uint32, ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_uint32)]
+                _bin_dll.parse_bin_batch_from_memory.restype = ctypes.c_int
+
+            if hasattr(_bin_dll, 'bin_cache_stats'):
+                _bin_dll.bin_cache_stats.argtypes = [ctypes.POINTER(_BinCacheStats)]
+                _bin_dll.bin_cache_stats.restype = ctypes.c_int
+                _bin_dll.bin_cache_clear.argtypes = []
+                _bin_dll.bin_cache_clear.restype = None
+
             _bin_parse = _bin_dll.parse_bin_textures
             _bin_free = _bin_dll.free_bin_result
             return _bin_dll
@@ -88,11 +839,222 @@ def _load_bin_dll():
     _bin_dll = False
     return False
 
+# Row flag of parse_bin_texture_table: the texture used for the submesh
+BIN_TEXTURE_PRIMARY = 0x1
+# Material row flag of parse_bin_materials: the linked material is in the file
+BIN_MATERIAL_RESOLVED = 0x1
+
+def _read_bin_texture_table(table):
+    """Rows of a BIN_TEXTURE_TABLE as (submesh, texture, sampler, flags) tuples"""
+    row_count, row_size, pool_offset, pool_size = struct.unpack_from('<4I', table, 0)
+    pool = table[pool_offset:pool_offset + pool_size]
+
+    rows = []
+    for i in range(row_count):
+        fields = struct.unpack_from('<7I', table, 16 + i * row_size)
+        strings = [pool[fields[k]:fields[k] + fields[k + 1]].decode('utf-8') for k in (0, 2, 4)]
+        rows.append((strings[0], strings[1], strings[2], fields[6]))
+    return rows
+
+def native_parse_bin_texture_rows(bin_path):
+    """
+    Every texture of a skin BIN, with the other samplers of linked materials
+    (normal, mask...), as (submesh, texture, sampler, flags) tuples.
+    Returns None when the DLL is missing or older than the table export.
+    """
+    if not _load_bin_dll() or not hasattr(_bin_dll, 'parse_bin_texture_table'):
+        return None
+
+    out_data = ctypes.POINTER(ctypes.c_uint8)()
+    out_size = ctypes.c_uint32()
+    result = _bin_dll.parse_bin_texture_table(bin_path.encode('utf-8'), ctypes.byref(out_data), ctypes.byref(out_size))
+    if result != 0:
+        return None
+
+    try:
+        table = ctypes.string_at(out_data, out_size.value)
+    finally:
+        _bin_free(out_data)
+    return _read_bin_texture_table(table)
+
+def _read_bin_material_table(table):
+    """Dict of submesh -> material info from a BIN_MATERIAL_TABLE"""
+    (material_count, material_size, material_offset,
+     sampler_count, sampler_size, sampler_offset,
+     param_count, param_size, param_offset,
+     pool_offset, pool_size) = struct.unpack_from('<11I', table, 0)
+    pool = table[pool_offset:pool_offset + pool_size]
+
+    def string(offset, length):
+        return pool[offset:offset + length].decode('utf-8')
+
+    samplers = []
+    for i in range(sampler_count):
+        fields = struct.unpack_from('<4I', table, sampler_offset + i * sampler_size)
+        samplers.append((string(fields[0], fields[1]), string(fields[2], fields[3])))
+
+    params = []
+    for i in range(param_count):
+        name_offset, name_length, components = struct.unpack_from('<3I', table, param_offset + i * param_size)
+        value = struct.unpack_from('<4f', table, param_offset + i * param_size + 12)
+        params.append((string(name_offset, name_length), value[:components]))
+
+    materials = {}
+    for i in range(material_count):
+        fields = struct.unpack_from('<10I', table, material_offset + i * material_size)
+        sampler_start, sampler_num, param_start, param_num = fields[6:10]
+        materials[string(fields[0], fields[1])] = {
+            'texture': string(fields[2], fields[3]),
+            'material_hash': fields[4],
+            'resolved': bool(fields[5] & BIN_MATERIAL_RESOLVED),
+            'samplers': dict(samplers[sampler_start:sampler_start + sampler_num]),
+            'params': dict(params[param_start:param_start + param_num]),
+        }
+    return materials
+
+def native_parse_bin_materials(bin_path):
+    """
+    Materials of every submesh of a skin BIN in one native call, as
+    {submesh: {'texture', 'material_hash', 'resolved', 'samplers', 'params'}}
+    where samplers maps textureName -> texturePath and params maps a name to
+    a tuple of 1 to 4 floats. Returns None when the DLL lacks the export.
+    """
+    if not _load_bin_dll() or not hasattr(_bin_dll, 'parse_bin_materials'):
+        return None
+
+    out_data = ctypes.POINTER(ctypes.c_uint8)()
+    out_size = ctypes.c_uint32()
+    result = _bin_dll.parse_bin_materials(bin_path.encode('utf-8'), ctypes.byref(out_data), ctypes.byref(out_size))
+    if result != 0:
+        return None
+
+    try:
+        table = ctypes.string_at(out_data, out_size.value)
+    finally:
+        _bin_free(out_data)
+    return _read_bin_material_table(table)
+
+# Result kinds of parse_bin_batch
+BIN_RESULT_TEXTURES = 0
+BIN_RESULT_MATERIALS = 1
+
+def _read_linked_section(f):
+    """Paths of the "linked" section of the BIN read from file object f"""
+    try:
+        header = f.read(8)
+        if len(header) < 8 or header[:4] != b'PROP':
+            return []
+        version = struct.unpack('<I', header[4:8])[0]
+        if version < 2:
+            return []
+
+        linked = []
+        count = struct.unpack('<I', f.read(4))[0]
+        for _ in range(count):
+            length = struct.unpack('<H', f.read(2))[0]
+            linked.append(f.read(length).decode('utf-8', errors='replace'))
+        return linked
+    except struct.error:
+        return []
+
+def find_linked_bins(bin_path):
+    """
+    Files of the "linked" section of a BIN that exist on disk. Linked paths
+    are relative to the folder holding "data", e.g. DATA/Characters/Ahri/Ahri.bin
+    """
+    try:
+        with open(bin_path, 'rb') as f:
+            linked = _read_linked_section(f)
+    except OSError:
+        return []
+    if not linked:
+        return []
+
+    # Root is the parent of the "data" folder the BIN sits in
+    root = os.path.dirname(os.path.abspath(bin_path))
+    while os.path.basename(root).lower() != 'data':
+        parent = os.path.dirname(root)
+        if parent == root:
+            return []
+        root = parent
+    root = os.path.dirname(root)
+
+    found = []
+    for link in linked:
+        relative = link.replace('\\', '/').split('/')
+        for candidate in (relative, [part.lower() for part in relative]):
+            path = os.path.join(root, *candidate)
+            if os.path.isfile(path):
+                found.append(path)
+                break
+    return found
+
+def native_parse_bin_batch(bin_path, linked_paths, kind=BIN_RESULT_TEXTURES):
+    """
+    Parse a skin BIN with its linked BINs in one native call, resolving
+    material links across all of them. Returns the rows of
+    native_parse_bin_texture_rows or the dict of native_parse_bin_materials
+    depending on kind, or None when the DLL lacks the export.
+    """
+    if not _load_bin_dll() or not hasattr(_bin_dll, 'parse_bin_batch'):
+        return None
+
+    linked = (ctypes.c_char_p * max(len(linked_paths), 1))(*[p.encode('utf-8') for p in linked_paths])
+    out_data = ctypes.POINTER(ctypes.c_uint8)()
+    out_size = ctypes.c_uint32()
+    result = _bin_dll.parse_bin_batch(bin_path.encode('utf-8'), linked, len(linked_paths), kind,
+                                      ctypes.byref(out_data), ctypes.byref(out_size))
+    if result != 0:
+        return None
+
+    try:
+        table = ctypes.string_at(out_data, out_size.value)
+    finally:
+        _bin_free(out_data)
+    if kind == BIN_RESULT_MATERIALS:
+        return _read_bin_material_table(table)
+    return _read_bin_texture_table(table)
+
+def native_parse_bin_batch_from_memory(datas, kind=BIN_RESULT_TEXTURES):
+    """
+    native_parse_bin_batch on BIN contents: datas[0] is the skin BIN, the
+    others its linked BINs (None for one that is missing). None when the
+    DLL lacks the export or the skin BIN is invalid.
+    """
+    if not _load_bin_dll() or not hasattr(_bin_dll, 'parse_bin_batch_from_memory'):
+        return None
+
+    buffers = (ctypes.c_char_p * len(datas))(*datas)
+    sizes = (ctypes.c_uint32 * len(datas))(*[len(data) if data else 0 for data in datas])
+    out_data = ctypes.POINTER(ctypes.c_uint8)()
+    out_size = ctypes.c_uint32()
+    result = _bin_dll.parse_bin_batch_from_memory(buffers, sizes, len(datas), kind, ctypes.byref(out_data), ctypes.byref(out_size))
+    if result != 0:
+        return None
+
+    try:
+        table = ctypes.string_at(out_data, out_size.value)
+    finally:
+        _bin_free(out_data)
+    if kind == BIN_RESULT_MATERIALS:
+        return _read_bin_material_table(table)
+    return _read_bin_texture_table(table)
+
 def _native_parse_bin_textures(bin_path):
     """Parse BIN using native DLL, returns dict or None on failure"""
     if not _load_bin_dll():
         return None
 
+    if hasattr(_bin_dll, 'parse_bin_texture_table'):
+        try:
+            rows = native_parse_bin_texture_rows(bin_path)
+            if rows is None:
+                return None
+            return {submesh: texture for submesh, texture, _, flags in rows if flags & BIN_TEXTURE_PRIMARY}
+        except Exception as e:
+            print(f"Aventurine: Native BIN parsing error: {e}")
+            return None
+
     try:
         # Encode path to bytes
         bin_path_bytes = bin_path.encode('utf-8')
@@ -131,6 +1093,119 @@ def _native_parse_bin_textures(bin_path):
         print(f"Aventurine: Native BIN parsing error: {e}")
         return None
 
+def bin_cache_clear():
+    """Forget the BIN results cached by the native parser"""
+    if _load_bin_dll() and hasattr(_bin_dll, 'bin_cache_clear'):
+        _bin_dll.bin_cache_clear()
+
+def bin_cache_stats():
+    """Native BIN cache counters as a dict, or None if the DLL has no cache"""
+    if not _load_bin_dll() or not hasattr(_bin_dll, 'bin_cache_stats'):
+        return None
+    stats = _BinCacheStats()
+    if _bin_dll.bin_cache_stats(ctypes.byref(stats)) != 0:
+        return None
+    return {name: getattr(stats, name) for name, _ in _BinCacheStats._fields_}
+
+# --- Native instrumentation (native_stats.h, in lol_native and bin_parser) ---
+
+NATIVE_STAGES = ('file_read', 'parse', 'link_resolve', 'mip_reorder', 'decode')
+NATIVE_COUNTERS = ('alloc_bytes', 'read_bytes', 'cache_hits', 'cache_misses', 'trace_dropped')
+
+class _NativeStats(ctypes.Structure):
+    # Matches NATIVE_STATS in native/native_stats.h
+    _fields_ = [
+        ('stage_count', ctypes.c_uint32),
+        ('counter_count', ctypes.c_uint32),
+        ('thread_count', ctypes.c_uint32),
+        ('reserved', ctypes.c_uint32),
+        ('calls', ctypes.c_uint64 * len(NATIVE_STAGES)),
+        ('ns', ctypes.c_uint64 * len(NATIVE_STAGES)),
+        ('counters', ctypes.c_uint64 * len(NATIVE_COUNTERS)),
+    ]
+
+def _stats_dlls():
+    """(name, dll) of the loaded native DLLs that record stats, with the exports bound"""
+    dlls = []
+    for name, dll in (('lol_native', _load_native_dll()), ('bin_parser', _load_bin_dll())):
+        if not dll or not hasattr(dll, 'native_stats_get'):
+            continue
+        dll.native_stats_get.argtypes = [ctypes.POINTER(_NativeStats)]
+        dll.native_stats_get.restype = ctypes.c_int
+        dll.native_stats_reset.argtypes = []
+        dll.native_stats_reset.restype = None
+        dll.native_trace_start.argtypes = [ctypes.c_uint32]
+        dll.native_trace_start.restype = None
+        dll.native_trace_dump.argtypes = [ctypes.c_char_p]
+        dll.native_trace_dump.restype = ctypes.c_int
+        dlls.append((name, dll))
+    return dlls
+
+def native_stats():
+    """
+    Per-DLL stage timings and counters since the last native_stats_reset:
+    {dll: {'stages': {stage: (calls, ms)}, 'counters': {name: value}, 'threads': n}}
+    """
+    result = {}
+    for name, dll in _stats_dlls():
+        stats = _NativeStats()
+        if dll.native_stats_get(ctypes.byref(stats)) != 0 or stats.stage_count != len(NATIVE_STAGES):
+            continue
+        result[name] = {
+            'stages': {stage: (stats.calls[i], stats.ns[i] / 1e6) for i, stage in enumerate(NATIVE_STAGES)},
+            'counters': {counter: stats.counters[i] for i, counter in enumerate(NATIVE_COUNTERS)},
+            'threads': stats.thread_count,
+        }
+    return result
+
+def native_stats_reset():
+    """Zero the native timers and counters"""
+    for _, dll in _stats_dlls():
+        dll.native_stats_reset()
+
+def print_native_stats():
+    """Print native_stats as a table, for bug reports"""
+    for name, stats in native_stats().items():
+        print(f"[{name}] {stats['threads']} threads")
+        for stage, (calls, ms) in stats['stages'].items():
+            if calls:
+                print(f"  {stage:<13} {calls:>8} calls {ms:>11.2f} ms")
+        for counter, value in stats['counters'].items():
+            if value:
+                print(f"  {counter:<13} {value:>8}")
+
+def native_trace_start(events_per_thread=65536):
+    """Start recording a Chrome trace of the native stages"""
+    for _, dll in _stats_dlls():
+        dll.native_trace_start(events_per_thread)
+
+def native_trace_dump(json_path):
+    """
+    Stop tracing and write one Chrome trace JSON (chrome://tracing, Perfetto)
+    with a process per DLL. Returns False if no DLL could write its events.
+    """
+    import json
+
+    events = []
+    for pid, (name, dll) in enumerate(_stats_dlls(), 1):
+        temp_path = os.path.join(tempfile.gettempdir(), f"aventurine_trace_{name}_{os.getpid()}.json")
+        if dll.native_trace_dump(temp_path.encode('utf-8')) != 0:
+            continue
+        try:
+            with open(temp_path, 'r', encoding='utf-8') as f:
+                dll_events = json.load(f)['traceEvents']
+        finally:
+            os.remove(temp_path)
+        for event in dll_events:
+            event['pid'] = pid
+        events.extend(dll_events)
+
+    if not events:
+        return False
+    with open(json_path, 'w', encoding='utf-8') as f:
+        json.dump({'traceEvents': events}, f)
+    return True
+
 def _detect_skin_folder_name(skn_path):
     """
     Detect the skin folder name from the SKN path.
@@ -162,6 +1237,31 @@ def _detect_skin_folder_name(skn_path):
 
     return None
 
+def _skin_bin_name(skin_folder):
+    """Name of the skin BIN of an assets skin folder, without .bin"""
+    # Map "base" to "skin0"
+    skin_folder_lower = skin_folder.lower()
+    if skin_folder_lower == 'base':
+        return 'skin0'
+    # Normalize: skin01 -> skin1, skin007 -> skin7
+    if skin_folder_lower.startswith('skin') and skin_folder_lower[4:].isdigit():
+        return f'skin{int(skin_folder_lower[4:])}'
+    return skin_folder_lower
+
+def _wad_skin_bin_path(skn_path):
+    """
+    Archive path of the skin BIN of an SKN at
+    .../characters/{char}/skins/{skin}/file.skn, or None
+    """
+    parts = skn_path.replace('\\', '/').split('/')
+    lower = [part.lower() for part in parts]
+    if 'characters' not in lower:
+        return None
+    chars_idx = len(lower) - 1 - lower[::-1].index('characters')
+    if chars_idx + 3 >= len(parts) or lower[chars_idx + 2] != 'skins':
+        return None
+    return f"data/characters/{lower[chars_idx + 1]}/skins/{_skin_bin_name(parts[chars_idx + 3])}.bin"
+
 def find_bin_and_read(skn_path):
     # Try to find a bin file nearby
     start_folder = os.path.dirname(skn_path)
@@ -200,56 +1300,67 @@ def find_bin_and_read(skn_path):
             skin_folder = parts[chars_idx + 3]
 
             if skins_folder.lower() == 'skins':
-                # Map "base" to "skin0"
-                if skin_folder.lower() == 'base':
-                    skin_folder = 'skin0'
-                else:
-                    # Normalize: skin01 -> skin1, skin007 -> skin7
-                    skin_folder_lower = skin_folder.lower()
-                    if skin_folder_lower.startswith('skin') and len(skin_folder_lower) > 4:
-                        remainder = skin_folder_lower[4:]
-                        if remainder.isdigit():
-                            skin_folder = f'skin{int(remainder)}'
-                        else:
-                            skin_folder = skin_folder_lower
-                    else:
-                        skin_folder = skin_folder_lower
-
-                # Try exact match first
-                bin_path = os.path.join(base_path, 'data', 'characters', char_name, 'skins', f'{skin_folder}.bin')
-                if os.path.exists(bin_path):
-                    print(f"Aventurine: Found BIN at structured path: {bin_path}")
-                    return bin_path
-
-                # Only fall back to skin0.bin if we're actually looking for skin0
-                if skin_folder == 'skin0':
-                    bin_path_skin0 = os.path.join(base_path, 'data', 'characters', char_name, 'skins', 'skin0.bin')
-                    if os.path.exists(bin_path_skin0):
-                        return bin_path_skin0
-
-                # Try any skin*.bin in the skins folder, preferring the target skin
-                skins_data_folder = os.path.join(base_path, 'data', 'characters', char_name, 'skins')
-                if os.path.exists(skins_data_folder):
-                    bins = glob.glob(os.path.join(skins_data_folder, 'skin*.bin'))
+                skin_folder = _skin_bin_name(skin_folder)
+
+                # With a native index of the WAD root these are lookups, not disk probes
+                index = get_fs_index(base_path)
+                if index:
+                    skins_rel = f'data/characters/{char_name}/skins'
+                    bin_path = fs_index_lookup(index, f'{skins_rel}/{skin_folder}.bin')
+                    if bin_path:
+                        print(f"Aventurine: Found BIN at structured path: {bin_path}")
+                        return bin_path
+
+                    bins = fs_index_find(index, skins_rel, 'skin*.bin')
                     if bins:
-                        # Sort to prefer the target skin
                         bins.sort(key=lambda x: 0 if skin_folder in os.path.basename(x).lower() else 1)
                         return bins[0]
+                else:
+                    # Not indexed: probe the disk. Try exact match first
+                    bin_path = os.path.join(base_path, 'data', 'characters', char_name, 'skins', f'{skin_folder}.bin')
+                    if os.path.exists(bin_path):
+                        print(f"Aventurine: Found BIN at structured path: {bin_path}")
+                        return bin_path
+
+                    # Only fall back to skin0.bin if we're actually looking for skin0
+                    if skin_folder == 'skin0':
+                        bin_path_skin0 = os.path.join(base_path, 'data', 'characters', char_name, 'skins', 'skin0.bin')
+                        if os.path.exists(bin_path_skin0):
+                            return bin_path_skin0
+
+                    # Try any skin*.bin in the skins folder, preferring the target skin
+                    skins_data_folder = os.path.join(base_path, 'data', 'characters', char_name, 'skins')
+                    if os.path.exists(skins_data_folder):
+                        bins = glob.glob(os.path.join(skins_data_folder, 'skin*.bin'))
+                        if bins:
+                            # Sort to prefer the target skin
+                            bins.sort(key=lambda x: 0 if skin_folder in os.path.basename(x).lower() else 1)
+                            return bins[0]
 
     # Fallback: Search nearby folders
     search_folders = [start_folder]
 
+    # Folders under the WAD root are listed from its index
+    index = None
+    if assets_idx is not None:
+        index_root = path_sep.join(parts[:assets_idx])
+        index = get_fs_index(index_root)
+
     for folder_path in search_folders:
         folder = folder_path
         for _ in range(5):
-            if not os.path.exists(folder):
+            rel = _fs_index_rel_dir(index_root, folder) if index else None
+            if rel is not None:
+                skins_rel = f'{rel}/skins' if rel else 'skins'
+                bins = fs_index_find(index, rel, 'skin*.bin') + fs_index_find(index, skins_rel, 'skin*.bin')
+            elif not os.path.exists(folder):
                 parent = os.path.dirname(folder)
                 if parent == folder: break
                 folder = parent
                 continue
-
-            bins = glob.glob(os.path.join(folder, "skin*.bin")) \
-                 + glob.glob(os.path.join(folder, "skins", "skin*.bin"))
+            else:
+                bins = glob.glob(os.path.join(folder, "skin*.bin")) \
+                     + glob.glob(os.path.join(folder, "skins", "skin*.bin"))
 
             # Sort to prefer the target skin we detected from the path
             if target_skin:
@@ -271,17 +1382,83 @@ def find_bin_and_read(skn_path):
 
 def parse_bin_for_textures(bin_path):
     """Parse BIN file and extract texture mappings using native DLL."""
+    # Materials of a skin can live in its linked BINs
+    linked = find_linked_bins(bin_path)
+    if linked:
+        try:
+            rows = native_parse_bin_batch(bin_path, linked)
+        except Exception as e:
+            print(f"Aventurine: Native BIN batch parsing error: {e}")
+            rows = None
+        if rows is not None:
+            return {submesh: texture for submesh, texture, _, flags in rows if flags & BIN_TEXTURE_PRIMARY}
+
     result = _native_parse_bin_textures(bin_path)
     if result is not None:
         return result
     return {}
 
+def _asset_relative_path(tex_asset_path):
+    """An asset path from its "assets" folder on, '/' separated, or None"""
+    tex_parts = tex_asset_path.replace('\\', '/').split('/')
+    for i, part in enumerate(tex_parts):
+        if part.lower() == 'assets':
+            return '/'.join(tex_parts[i:])
+    return None
+
+def _resolve_texture_indexed(index, skn_dir, skn_rel, filename, tex_asset_path):
+    """The steps of resolve_texture_path as lookups in the index of the WAD root skn_dir is in"""
+    def under(rel, name):
+        return f'{rel}/{name}' if rel else name
+
+    # 1. Same dir as SKN
+    p = fs_index_lookup(index, under(skn_rel, filename))
+    if p: return p
+
+    # 2. Up to three folders below it, nearest first
+    nested = []
+    for found in fs_index_find(index, skn_rel, filename, recursive=True):
+        depth = os.path.relpath(found, skn_dir).count(os.sep)
+        if depth <= 3:
+            nested.append((depth, found))
+    if nested:
+        return min(nested)[1]
+
+    # 3. Parent folders
+    rel = skn_rel
+    for _ in range(3):
+        if not rel: break
+        rel = rel.rpartition('/')[0]
+        p = fs_index_lookup(index, under(rel, filename))
+        if p: return p
+
+    # 4. The full asset path relative to the root, in any case
+    relative_path = _asset_relative_path(tex_asset_path)
+    if relative_path:
+        return fs_index_lookup(index, relative_path)
+    return None
+
 def resolve_texture_path(skn_path, tex_asset_path):
     if not tex_asset_path: return None
 
     filename = os.path.basename(tex_asset_path)
     skn_dir = os.path.dirname(skn_path)
 
+    # Base path is everything before the SKN's "assets" folder
+    parts = os.path.normpath(skn_path).split(os.sep)
+    assets_idx = None
+    for i, part in enumerate(parts):
+        if part.lower() == 'assets':
+            assets_idx = i
+            break
+    base_path = os.sep.join(parts[:assets_idx]) if assets_idx is not None else None
+
+    # Under an indexed WAD root every step is a lookup; a miss re-lists the folder it searched
+    index = get_fs_index(base_path) if base_path else None
+    skn_rel = _fs_index_rel_dir(base_path, skn_dir) if index else None
+    if skn_rel is not None:
+        return _resolve_texture_indexed(index, skn_dir, skn_rel, filename, tex_asset_path)
+
     # 1. Check same dir as SKN
     p = os.path.join(skn_dir, filename)
     if os.path.exists(p): return p
@@ -304,53 +1481,149 @@ def resolve_texture_path(skn_path, tex_asset_path):
 
     # 4. Try resolving the full asset path relative to the base folder
     # e.g., "ASSETS/Shared/Materials/UVAnimate/texture.tex" -> "{base}/assets/Shared/Materials/UVAnimate/texture.tex"
-    tex_asset_normalized = tex_asset_path.replace('\\', '/').lower()
-    if 'assets/' in tex_asset_normalized or tex_asset_normalized.startswith('assets'):
-        # Find base path by going up from skn_path until we find "assets"
-        norm_skn = os.path.normpath(skn_path)
-        parts = norm_skn.split(os.sep)
-
-        assets_idx = None
-        for i, part in enumerate(parts):
-            if part.lower() == 'assets':
-                assets_idx = i
-                break
-
-        if assets_idx is not None:
-            base_path = os.sep.join(parts[:assets_idx])
-
-            # Normalize the asset path and construct full path
-            # Handle both "ASSETS/..." and "assets/..." formats
-            tex_parts = tex_asset_path.replace('\\', '/').split('/')
-            # Find where "assets" starts in the texture path
-            tex_assets_idx = None
-            for i, part in enumerate(tex_parts):
-                if part.lower() == 'assets':
-                    tex_assets_idx = i
-                    break
-
-            if tex_assets_idx is not None:
-                # Rebuild path from assets onwards, preserving original case in filesystem
-                relative_path = '/'.join(tex_parts[tex_assets_idx:])
-                full_path = os.path.join(base_path, relative_path.replace('/', os.sep))
-                if os.path.exists(full_path):
-                    return full_path
-
-                # Try lowercase "assets" variant
-                tex_parts_lower = tex_parts[tex_assets_idx:]
-                tex_parts_lower[0] = 'assets'  # lowercase
-                relative_path_lower = '/'.join(tex_parts_lower)
-                full_path_lower = os.path.join(base_path, relative_path_lower.replace('/', os.sep))
-                if os.path.exists(full_path_lower):
-                    return full_path_lower
+    relative_path = _asset_relative_path(tex_asset_path)
+    if base_path is not None and relative_path:
+        # Rebuild path from assets onwards, preserving original case in filesystem
+        full_path = os.path.join(base_path, relative_path.replace('/', os.sep))
+        if os.path.exists(full_path):
+            return full_path
+
+        # Try lowercase "assets" variant
+        relative_path_lower = 'assets' + relative_path[len('assets'):]
+        full_path_lower = os.path.join(base_path, relative_path_lower.replace('/', os.sep))
+        if os.path.exists(full_path_lower):
+            return full_path_lower
 
     return None
 
-def import_textures(skn_object, skn_path):
-    bin_path = find_bin_and_read(skn_path)
-    tex_map = {}
-    if bin_path:
-        tex_map = parse_bin_for_textures(bin_path)
+def _fallback_texture_names(skn_path):
+    """Texture names tried next to an SKN when its BIN maps no textures"""
+    base_name = os.path.splitext(os.path.basename(skn_path))[0]
+    return [f"{base_name}.tex", f"{base_name}.dds", f"{base_name}_TX_CM.tex", f"{base_name}_TX_CM.dds"]
+
+class TexturePrefetch:
+    """
+    Texture lookup of one SKN: the BIN texture map, the local files its
+    entries resolve to and, with decode, those TEX files decoding in the
+    background (TextureJobs) until import_textures picks them up.
+    wad is the character's WadArchive (the caller closes it); the BIN and
+    textures that aren't on disk are read from it, in memory. Such textures
+    resolve to a key under the archive's path rather than to a file: use
+    decode / dds_file to read them.
+    """
+
+    def __init__(self, skn_path, decode=True, wad=None):
+        self.skn_path = skn_path
+        self.wad = wad
+        self.local_paths = {}
+        self.wad_paths = {}  # resolved key -> asset path, for textures read from wad
+        self.jobs = TextureJobs()
+
+        bin_path = find_bin_and_read(skn_path)
+        if bin_path:
+            self.tex_map = parse_bin_for_textures(bin_path)
+        else:
+            self.tex_map = self._wad_tex_map() or {}
+
+        if decode and native_tex_jobs_available():
+            if self.tex_map:
+                for tex_asset_path in self.tex_map.values():
+                    local_path = self.resolve(tex_asset_path)
+                    if local_path:
+                        self._submit(local_path)
+            else:
+                for name in _fallback_texture_names(skn_path):
+                    local_path = self.resolve(name)
+                    if local_path:
+                        self._submit(local_path)
+                        break
+
+    def _wad_tex_map(self):
+        wad_bin_path = _wad_skin_bin_path(self.skn_path) if self.wad else None
+        if not wad_bin_path:
+            return None
+        try:
+            tex_map = self.wad.parse_bin_textures(wad_bin_path)
+        except Exception as e:
+            print(e)
+            return None
+        if tex_map:
+            print(f"Aventurine: Read BIN {wad_bin_path} from {os.path.basename(self.wad.path)}")
+        return tex_map
+
+    def resolve(self, tex_asset_path):
+        """resolve_texture_path for this SKN, once per asset path"""
+        if tex_asset_path not in self.local_paths:
+            local_path = resolve_texture_path(self.skn_path, tex_asset_path)
+            # Only full asset paths can be looked up in the archive
+            asset_path = tex_asset_path.replace('\\', '/').lower()
+            if not local_path and self.wad and '/' in asset_path and self.wad.has(asset_path):
+                local_path = f"{self.wad.path}/{asset_path}"
+                self.wad_paths[local_path] = asset_path
+            self.local_paths[tex_asset_path] = local_path
+        return self.local_paths[tex_asset_path]
+
+    def is_wad_entry(self, local_path):
+        """True if local_path was resolved to an archive entry rather than a file"""
+        return local_path in self.wad_paths
+
+    def _read_wad(self, local_path, convert=None):
+        asset_path = self.wad_paths[local_path]
+        data = (convert or self.wad.read)(asset_path)
+        if data is None:
+            raise Exception(f"Aventurine: {asset_path} is missing from {os.path.basename(self.wad.path)}")
+        return data
+
+    def _submit(self, local_path):
+        if not self.is_wad_entry(local_path):
+            return self.jobs.submit(local_path)
+        if not local_path.lower().endswith('.tex'):
+            return False
+        try:
+            return self.jobs.submit(local_path, self._read_wad(local_path))
+        except Exception as e:
+            print(e)
+            return False
+
+    def decode(self, local_path):
+        """
+        Pixels of a resolved TEX texture like decode_tex_pixels, from its
+        background job when one was started. None for other formats.
+        """
+        if local_path in self.jobs:
+            return self.jobs.wait(local_path)
+        if not local_path.lower().endswith('.tex'):
+            return None
+        if self.is_wad_entry(local_path):
+            return decode_tex_pixels_from_memory(self._read_wad(local_path))
+        return decode_tex_pixels(local_path)
+
+    def dds_file(self, local_path):
+        """
+        File Blender can load for a resolved texture, as (path, is_temp) like
+        tex_to_dds_file. Archive entries are written to a temp file.
+        """
+        is_tex = local_path.lower().endswith('.tex')
+        if not self.is_wad_entry(local_path):
+            return tex_to_dds_file(local_path) if is_tex else (local_path, False)
+
+        data = self._read_wad(local_path, self.wad.tex_to_dds if is_tex else None)
+        fd, temp_path = tempfile.mkstemp(suffix='.dds' if is_tex else os.path.splitext(local_path)[1])
+        with os.fdopen(fd, 'wb') as f:
+            f.write(data)
+        return temp_path, True
+
+    def close(self):
+        self.jobs.close()
+
+def import_textures(skn_object, skn_path, prefetch=None):
+    """
+    Assign the textures of an SKN to the materials of skn_object.
+    prefetch is a TexturePrefetch started earlier for skn_path; the caller
+    closes it.
+    """
+    textures = prefetch if prefetch is not None else TexturePrefetch(skn_path, decode=False)
+    tex_map = textures.tex_map
 
     # Debug: Show what the BIN parser found
     if tex_map:
@@ -377,17 +1650,15 @@ def import_textures(skn_object, skn_path):
 
         local_path = None
         if tex_path_asset:
-            local_path = resolve_texture_path(skn_path, tex_path_asset)
+            local_path = textures.resolve(tex_path_asset)
 
         # Debug: Show material to texture mapping
         print(f"Aventurine: Material '{mat.name}' -> asset='{os.path.basename(tex_path_asset) if tex_path_asset else 'None'}' -> local='{local_path}'")
         
         # Fallback
         if not local_path and not tex_map:
-             base_name = os.path.splitext(os.path.basename(skn_path))[0]
-             potential_names = [f"{base_name}.tex", f"{base_name}.dds", f"{base_name}_TX_CM.tex", f"{base_name}_TX_CM.dds"]
-             for name in potential_names:
-                 local_path = resolve_texture_path(skn_path, name)
+             for name in _fallback_texture_names(skn_path):
+                 local_path = textures.resolve(name)
                  if local_path: break
 
         if local_path:
@@ -427,51 +1698,65 @@ def import_textures(skn_object, skn_path):
             bpy_image = None
             temp_dds_path = None
 
-            # --- Load texture using Blender's native DDS support ---
+            # --- Decode TEX directly when the native decoder is available ---
             try:
-                load_path = local_path
-                print(f"Aventurine:   -> Loading new texture: {local_path}")
-
-                # Convert TEX to temp DDS (just header swap, fast)
-                if local_path.lower().endswith('.tex'):
-                    import tempfile
-                    dds_bytes = tex_to_dds_bytes(local_path)
-                    fd, temp_dds_path = tempfile.mkstemp(suffix='.dds')
-                    os.close(fd)
-                    with open(temp_dds_path, 'wb') as f:
-                        f.write(dds_bytes)
-                    load_path = temp_dds_path
-
-                # Load with Blender native (fast C++ decoder)
-                temp_img = bpy.data.images.load(load_path, check_existing=False)
-
-                # Convert to uncompressed format for painting
-                # by reading pixels and creating a new image
-                fb = os.path.basename(local_path).rsplit('.', 1)[0]
-                width, height = temp_img.size
+                decoded = textures.decode(local_path)
+            except Exception as e:
+                print(f"Aventurine: {e}")
+                decoded = None
 
+            if decoded:
+                print(f"Aventurine:   -> Decoding new texture: {local_path}")
+                fb = os.path.basename(local_path).rsplit('.', 1)[0]
+                width, height, pixels = decoded
                 bpy_image = bpy.data.images.new(name=fb, width=width, height=height, alpha=True)
-
-                # Fast pixel transfer using numpy foreach_get/foreach_set
-                pixel_count = width * height * 4
-                pixels = np.empty(pixel_count, dtype=np.float32)
-                temp_img.pixels.foreach_get(pixels)
                 bpy_image.pixels.foreach_set(pixels)
-                bpy_image["lol_source_path"] = local_path
+                textures.jobs.release(local_path)
+                if not textures.is_wad_entry(local_path):
+                    bpy_image["lol_source_path"] = local_path
                 bpy_image.pack()
 
-                # Remove the temp image
-                bpy.data.images.remove(temp_img)
-
-                # Clean up temp DDS file
-                if temp_dds_path and os.path.exists(temp_dds_path):
-                    os.remove(temp_dds_path)
-
-            except Exception as e:
-                print(f"Aventurine: Failed to load texture: {e}")
-                # Clean up temp file on error
-                if temp_dds_path and os.path.exists(temp_dds_path):
-                    os.remove(temp_dds_path)
+            # --- Load texture using Blender's native DDS support ---
+            else:
+                try:
+                    print(f"Aventurine:   -> Loading new texture: {local_path}")
+
+                    # TEX to DDS is just a header swap; cached on disk when possible
+                    load_path, is_temp = textures.dds_file(local_path)
+                    if is_temp:
+                        temp_dds_path = load_path
+
+                    # Load with Blender native (fast C++ decoder)
+                    temp_img = bpy.data.images.load(load_path, check_existing=False)
+
+                    # Convert to uncompressed format for painting
+                    # by reading pixels and creating a new image
+                    fb = os.path.basename(local_path).rsplit('.', 1)[0]
+                    width, height = temp_img.size
+
+                    bpy_image = bpy.data.images.new(name=fb, width=width, height=height, alpha=True)
+
+                    # Fast pixel transfer using numpy foreach_get/foreach_set
+                    pixel_count = width * height * 4
+                    pixels = np.empty(pixel_count, dtype=np.float32)
+                    temp_img.pixels.foreach_get(pixels)
+                    bpy_image.pixels.foreach_set(pixels)
+                    if not textures.is_wad_entry(local_path):
+                        bpy_image["lol_source_path"] = local_path
+                    bpy_image.pack()
+
+                    # Remove the temp image
+                    bpy.data.images.remove(temp_img)
+
+                    # Clean up temp DDS file
+                    if temp_dds_path and os.path.exists(temp_dds_path):
+                        os.remove(temp_dds_path)
+
+                except Exception as e:
+                    print(f"Aventurine: Failed to load texture: {e}")
+                    # Clean up temp file on error
+                    if temp_dds_path and os.path.exists(temp_dds_path):
+                        os.remove(temp_dds_path)
 
             # --- Assignment ---
             if bpy_image: